@@ -0,0 +1,55 @@
+// The automaton description, System and timing helper shared by the benchmarks.
+
+#ifndef HYBRID_AUTOMATON_EXAMPLES_BENCHMARK_COMMON_H_
+#define HYBRID_AUTOMATON_EXAMPLES_BENCHMARK_COMMON_H_
+
+#include <sstream>
+#include <string>
+
+#include <boost/chrono.hpp>
+
+#include "hybrid_automaton/System.h"
+
+namespace benchmark {
+	class BenchmarkSystem : public ha::System {
+	public:
+		virtual int getDof() const { return 7; }
+		virtual ::Eigen::MatrixXd getJointConfiguration() const { return ::Eigen::MatrixXd::Zero(7,1); }
+		virtual ::Eigen::MatrixXd getJointVelocity() const { return ::Eigen::MatrixXd::Zero(7,1); }
+		virtual ::Eigen::MatrixXd getForceTorqueMeasurement(const int& port) const { return ::Eigen::MatrixXd::Zero(6,1); }
+		virtual ::Eigen::MatrixXd getFramePose(const std::string& frame_id) const { return ::Eigen::MatrixXd::Identity(4,4); }
+	};
+
+	// a chain of joint space modes, each left when its controller converged or after a timeout
+	inline std::string createDescription(int number_of_modes)
+	{
+		const std::string vector7 = "[7,1]0.1;0.2;0.3;0.4;0.5;0.6;0.7";
+		std::ostringstream xml;
+		xml << "<HybridAutomaton name=\"benchmark\" current_control_mode=\"mode0\">" << std::endl;
+		for (int i = 0; i < number_of_modes; ++i)
+		{
+			xml << "<ControlMode name=\"mode" << i << "\"><ControlSet type=\"JointSet\" name=\"set" << i << "\">";
+			for (int j = 0; j < 3; ++j)
+				xml << "<Controller type=\"JointController\" name=\"ctrl" << i << "_" << j << "\" goal=\"" << vector7 << "\" kp=\"" << vector7
+					<< "\" kv=\"" << vector7 << "\" completion_times=\"[1,1]2\" v_max=\"" << vector7 << "\" a_max=\"" << vector7
+					<< "\" goal_is_relative=\"0\" reinterpolation=\"0\" priority=\"" << j << "\"/>";
+			xml << "</ControlSet></ControlMode>" << std::endl;
+		}
+		for (int i = 0; i + 1 < number_of_modes; ++i)
+		{
+			xml << "<ControlSwitch name=\"switch" << i << "\" source=\"mode" << i << "\" target=\"mode" << i + 1 << "\">"
+				<< "<JumpCondition controller=\"ctrl" << i << "_0\" jump_criterion=\"NORM_L2\" epsilon=\"0.01\"><Sensor type=\"JointConfigurationSensor\"/></JumpCondition>"
+				<< "<JumpCondition goal=\"[1,1]10\" jump_criterion=\"THRESH_UPPER_BOUND\" epsilon=\"0\"><Sensor type=\"ClockSensor\"/></JumpCondition>"
+				<< "</ControlSwitch>" << std::endl;
+		}
+		xml << "</HybridAutomaton>" << std::endl;
+		return xml.str();
+	}
+
+	inline double milliseconds(const boost::chrono::steady_clock::duration& d)
+	{
+		return boost::chrono::duration_cast<boost::chrono::microseconds>(d).count() / 1000.0;
+	}
+}
+
+#endif
@@ -0,0 +1,66 @@
+// Measures the time needed to load a large hybrid automaton: from a DescriptionTreeXML with 1..n
+// deserialization threads, and with the streaming HybridAutomatonXMLReader.
+//
+// usage: deserialization_benchmark [number of modes (500)] [repetitions (10)]
+
+#include <iostream>
+#include <sstream>
+#include <cstdlib>
+
+#include <boost/chrono.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "hybrid_automaton/HybridAutomaton.h"
+#include "hybrid_automaton/HybridAutomatonXMLReader.h"
+#include "hybrid_automaton/DescriptionTreeXML.h"
+
+#include "benchmark_common.h"
+
+using namespace benchmark;
+
+int main(int argc, char* argv[])
+{
+	int number_of_modes = (argc > 1) ? std::atoi(argv[1]) : 500;
+	int repetitions = (argc > 2) ? std::atoi(argv[2]) : 10;
+	if (number_of_modes < 1 || repetitions < 1) {
+		std::cerr << "usage: " << argv[0] << " [number of modes] [repetitions]" << std::endl;
+		return 1;
+	}
+
+	const std::string xml = createDescription(number_of_modes);
+	ha::System::ConstPtr system(new BenchmarkSystem);
+	std::cout << number_of_modes << " modes, " << xml.size() / 1024 << " KiB of XML, " << repetitions << " repetitions" << std::endl;
+
+	boost::chrono::steady_clock::time_point start = boost::chrono::steady_clock::now();
+	ha::DescriptionTreeXML::Ptr tree(new ha::DescriptionTreeXML);
+	for (int r = 0; r < repetitions; ++r)
+		tree->initTree(xml);
+	std::cout << "parse DOM:                  " << milliseconds(boost::chrono::steady_clock::now() - start) / repetitions << " ms" << std::endl;
+
+	unsigned int max_threads = std::max(1u, boost::thread::hardware_concurrency());
+	for (unsigned int threads = 1; threads <= max_threads; threads *= 2)
+	{
+		start = boost::chrono::steady_clock::now();
+		for (int r = 0; r < repetitions; ++r)
+		{
+			ha::HybridAutomaton ha;
+			ha.setDeserializeDefaultEntities(true);
+			ha.setDeserializationThreads(threads);
+			ha.deserialize(tree->getRootNode(), system);
+		}
+		std::cout << "deserialize, " << threads << " thread(s):" << (threads < 10 ? "  " : " ")
+			<< milliseconds(boost::chrono::steady_clock::now() - start) / repetitions << " ms" << std::endl;
+	}
+
+	start = boost::chrono::steady_clock::now();
+	ha::HybridAutomatonXMLReader reader(system);
+	for (int r = 0; r < repetitions; ++r)
+	{
+		ha::HybridAutomaton ha;
+		ha.setDeserializeDefaultEntities(true);
+		reader.read(xml, ha);
+	}
+	std::cout << "stream (parse+deserialize): " << milliseconds(boost::chrono::steady_clock::now() - start) / repetitions << " ms" << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,64 @@
+// Measures the size of the description tree of a large hybrid automaton and the time needed to encode
+// and decode it with the DescriptionTreeTransport, with and without compression.
+//
+// usage: transport_benchmark [number of modes (500)] [repetitions (10)]
+
+#include <iostream>
+#include <cstdlib>
+
+#include "hybrid_automaton/DescriptionTreeStream.h"
+#include "hybrid_automaton/DescriptionTreeTransport.h"
+#include "hybrid_automaton/DescriptionTreeXML.h"
+
+#include "benchmark_common.h"
+
+using namespace benchmark;
+
+int main(int argc, char* argv[])
+{
+	int number_of_modes = (argc > 1) ? std::atoi(argv[1]) : 500;
+	int repetitions = (argc > 2) ? std::atoi(argv[2]) : 10;
+	if (number_of_modes < 1 || repetitions < 1) {
+		std::cerr << "usage: " << argv[0] << " [number of modes] [repetitions]" << std::endl;
+		return 1;
+	}
+
+	// the description tree is transported as it is - the automaton is not deserialized, so no sensors need to be registered
+	const std::string xml = createDescription(number_of_modes);
+	ha::DescriptionTreeXML::Ptr xml_tree(new ha::DescriptionTreeXML);
+	if (!xml_tree->initTree(xml)) {
+		std::cerr << "cannot parse the description" << std::endl;
+		return 1;
+	}
+	ha::DescriptionTreeNode::Ptr root = xml_tree->getRootNode();
+	ha::DescriptionTreeStream::Ptr tree(new ha::DescriptionTreeStream);
+	std::cout << number_of_modes << " modes, " << xml.size() << " bytes of XML, " << repetitions << " repetitions" << std::endl;
+
+	for (int compress = 0; compress < 2; ++compress)
+	{
+		ha::DescriptionTreeTransport::Options options;
+		options.compress = (compress != 0);
+		ha::DescriptionTreeTransport::Statistics statistics;
+		std::string encoded;
+
+		boost::chrono::steady_clock::time_point start = boost::chrono::steady_clock::now();
+		for (int r = 0; r < repetitions; ++r)
+		{
+			encoded.clear();
+			ha::DescriptionTreeTransport::encode(root, encoded, options, &statistics);
+		}
+		double encode_time = milliseconds(boost::chrono::steady_clock::now() - start) / repetitions;
+
+		start = boost::chrono::steady_clock::now();
+		for (int r = 0; r < repetitions; ++r)
+			ha::DescriptionTreeTransport::decode(encoded, tree);
+		double decode_time = milliseconds(boost::chrono::steady_clock::now() - start) / repetitions;
+
+		std::cout << (compress ? "pooled + compressed: " : "pooled:              ") << encoded.size() << " bytes ("
+			<< 100.0 * encoded.size() / xml.size() << "% of the XML, " << statistics.pooled_strings << " distinct of "
+			<< statistics.attributes << " attributes, " << statistics.chunks << " chunks), encode " << encode_time
+			<< " ms, decode " << decode_time << " ms" << std::endl;
+	}
+
+	return 0;
+}
@@ -0,0 +1,133 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef HYBRID_AUTOMATON_BATCH_REPLAY_H_
+#define HYBRID_AUTOMATON_BATCH_REPLAY_H_
+
+#include "hybrid_automaton/DescriptionTreeNode.h"
+#include "hybrid_automaton/HybridAutomaton.h"
+#include "hybrid_automaton/ReplayDriver.h"
+
+#include <boost/shared_ptr.hpp>
+
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ha {
+
+	class BatchReplay;
+	typedef boost::shared_ptr<BatchReplay> BatchReplayPtr;
+	typedef boost::shared_ptr<const BatchReplay> BatchReplayConstPtr;
+
+	/**
+	 * @brief Replays one hybrid automaton against many logs in parallel
+	 *
+	 * The description of the automaton is parsed once; for every log a new automaton is deserialized from it
+	 * with the ReplaySystem of that log, so that its sensors read the logged values. A clone() would not do:
+	 * it copies the sensors, jump conditions and controllers together with the System they were deserialized
+	 * with, and there is no way to rebind them to another one.
+	 * The logs are distributed over the worker threads, idle workers steal logs from the queues of busy ones.
+	 *
+	 * Derive from this class and override createAutomaton() to build the automaton in a different way.
+	 */
+	class BatchReplay
+	{
+	public:
+
+		typedef boost::shared_ptr<BatchReplay> Ptr;
+		typedef boost::shared_ptr<const BatchReplay> ConstPtr;
+
+		struct Run
+		{
+			std::string log;
+			bool failed;
+			std::string error;
+			ReplayDriver::Result result;
+
+			Run() : failed(false) {
+			}
+		};
+
+		struct Summary
+		{
+			std::size_t logs;
+			std::size_t failed;
+			std::size_t steps;
+
+			// number of times each control switch fired over all logs
+			std::map<std::string, std::size_t> switch_counts;
+			// number of times a watchdog or the safe control mode took over over all logs
+			std::size_t fallbacks;
+			// logged time spent in each control mode over all logs
+			std::map<std::string, double> time_in_mode;
+			// number of logs that ended in each control mode
+			std::map<std::string, std::size_t> terminal_modes;
+
+			Summary() : logs(0), failed(0), steps(0), fallbacks(0) {
+			}
+
+			void add(const Run& run);
+
+			void write(std::ostream& out) const;
+		};
+
+		/**
+		 * @param description The root node of the serialized HybridAutomaton, must stay valid while replaying
+		 */
+		BatchReplay(const DescriptionTreeNode::ConstPtr& description = DescriptionTreeNode::ConstPtr());
+
+		virtual ~BatchReplay();
+
+		/**
+		 * @brief Replays all \a logs on \a number_of_threads threads (0: one per core)
+		 *
+		 * Errors in single logs do not stop the batch, they are reported in the Run of the log.
+		 */
+		std::vector<Run> run(const std::vector<std::string>& logs, unsigned int number_of_threads = 0) const;
+
+		static Summary summarize(const std::vector<Run>& runs);
+
+		/**
+		 * @brief Writes the summary followed by one line per log
+		 */
+		static void writeSummary(const std::vector<Run>& runs, std::ostream& out);
+
+		/**
+		 * @brief Creates the automaton that is replayed against the log read by \a system
+		 */
+		virtual HybridAutomaton::Ptr createAutomaton(const System::ConstPtr& system) const;
+
+	protected:
+
+		void _replay(const std::string& log, Run& run) const;
+
+		DescriptionTreeNode::ConstPtr _description;
+	};
+
+}
+
+#endif
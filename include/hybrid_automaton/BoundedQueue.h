@@ -0,0 +1,163 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef HYBRID_AUTOMATON_BOUNDED_QUEUE_H_
+#define HYBRID_AUTOMATON_BOUNDED_QUEUE_H_
+
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
+
+#include <cstddef>
+
+namespace ha {
+
+	/**
+	 * @brief A fixed size queue for several producer threads and one consumer thread
+	 *
+	 * Every slot carries a sequence number. A producer reserves a slot with a compare-and-swap on the enqueue
+	 * position, copies its value and publishes the slot by advancing its sequence number - producers never
+	 * wait for each other and push() never allocates. If the queue is full, push() returns false.
+	 *
+	 * A producer that is preempted between reserving and publishing its slot delays only the consumer: pop()
+	 * returns false at that slot until it is published, the other producers keep going.
+	 */
+	template <typename T>
+	class BoundedQueue
+	{
+	public:
+		/**
+		 * @brief Creates a queue for \a capacity values (rounded up to a power of two)
+		 */
+		explicit BoundedQueue(std::size_t capacity)
+		{
+			std::size_t size = 1;
+			while (size < capacity)
+				size <<= 1;
+			_cells = new Cell[size];
+			_mask = size - 1;
+			clear();
+		}
+
+		~BoundedQueue()
+		{
+			delete[] _cells;
+		}
+
+		/**
+		 * @brief Copies \a value into the queue - false if the queue is full. Can be called from any thread.
+		 */
+		bool push(const T& value)
+		{
+			std::size_t position = _enqueue_position.load(boost::memory_order_relaxed);
+			Cell* cell;
+			for (;;)
+			{
+				cell = &_cells[position & _mask];
+				std::size_t sequence = cell->sequence.load(boost::memory_order_acquire);
+				std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+				if (difference == 0)
+				{
+					// the slot is free - reserve it unless another producer was faster
+					if (_enqueue_position.compare_exchange_weak(position, position + 1, boost::memory_order_relaxed))
+						break;
+				}
+				else if (difference < 0)
+				{
+					// the slot still holds the value from the previous round
+					return false;
+				}
+				else
+				{
+					position = _enqueue_position.load(boost::memory_order_relaxed);
+				}
+			}
+
+			cell->value = value;
+			cell->sequence.store(position + 1, boost::memory_order_release);
+			return true;
+		}
+
+		/**
+		 * @brief Takes the oldest value from the queue - false if there is none. Must only be called from one thread.
+		 */
+		bool pop(T& value)
+		{
+			std::size_t position = _dequeue_position.load(boost::memory_order_relaxed);
+			Cell& cell = _cells[position & _mask];
+			if (cell.sequence.load(boost::memory_order_acquire) != position + 1)
+				return false;
+
+			value = cell.value;
+			cell.sequence.store(position + _mask + 1, boost::memory_order_release);
+			_dequeue_position.store(position + 1, boost::memory_order_release);
+			return true;
+		}
+
+		/**
+		 * @brief true if every reserved slot has been popped - a push() may still be in flight if this is false
+		 */
+		bool isEmpty() const
+		{
+			return _enqueue_position.load(boost::memory_order_acquire) == _dequeue_position.load(boost::memory_order_acquire);
+		}
+
+		/**
+		 * @brief Drops all values - only while no other thread uses the queue
+		 */
+		void clear()
+		{
+			for (std::size_t i = 0; i <= _mask; ++i)
+				_cells[i].sequence.store(i, boost::memory_order_relaxed);
+			_enqueue_position.store(0, boost::memory_order_relaxed);
+			_dequeue_position.store(0, boost::memory_order_release);
+		}
+
+		std::size_t getCapacity() const
+		{
+			return _mask + 1;
+		}
+
+	protected:
+		struct Cell
+		{
+			boost::atomic<std::size_t> sequence;
+			T value;
+		};
+
+		Cell* _cells;
+		std::size_t _mask;
+
+		boost::atomic<std::size_t> _enqueue_position;
+		// only written by the consumer
+		boost::atomic<std::size_t> _dequeue_position;
+
+	private:
+		BoundedQueue(const BoundedQueue&);
+		BoundedQueue& operator=(const BoundedQueue&);
+	};
+
+}
+
+#endif
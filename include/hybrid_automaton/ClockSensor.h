@@ -66,6 +66,8 @@ namespace ha {
          */
 		virtual ::Eigen::MatrixXd getCurrentValue() const;
 
+		virtual bool getDimensions(int& rows, int& cols) const;
+
 		virtual void initialize(const double& t); 
 		virtual void step(const double& t);
 
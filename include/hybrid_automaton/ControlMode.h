@@ -28,7 +28,10 @@
 
 #include "hybrid_automaton/ControlSet.h"
 #include "hybrid_automaton/Serializable.h"
+#include "hybrid_automaton/Watchdog.h"
+#include "hybrid_automaton/ErrorRecord.h"
 #include "hybrid_automaton/error_handling.h"
+#include "hybrid_automaton/Profiler.h"
 
 #include <boost/shared_ptr.hpp>
 
@@ -59,6 +62,9 @@ namespace ha {
 		ControlMode() {}
 		ControlMode(const std::string& name);
 
+		// copies have their own ControlSet and Watchdog
+		ControlMode(const ControlMode& cm);
+
 		virtual ~ControlMode() {}
 
         /**
@@ -90,11 +96,17 @@ namespace ha {
          *
          * Is called from the HybridAutomaton - once within each control loop
          */
-		virtual ::Eigen::MatrixXd step(const double& t) {
-			if (_control_set)
-				return _control_set->step(t);
-			else
-				HA_THROW_ERROR("ControlSet.step", "No control set defined.");
+		virtual ::Eigen::MatrixXd step(const double& t);
+
+        /**
+         * @brief Like step(), but returns false and fills \a error instead of throwing
+         *
+         * The default calls step() - override it if your ControlMode can detect faults without throwing.
+         * Errors thrown by step() are caught by HybridAutomaton::tryStep.
+         */
+		virtual bool tryStep(const double& t, ::Eigen::MatrixXd& control, ErrorRecord& /*error*/) {
+			control = this->step(t);
+			return true;
 		}
 
 		virtual void switchControlMode(ControlMode::Ptr otherMode)
@@ -110,6 +122,19 @@ namespace ha {
 			return _control_set;
 		}    
 
+        /**
+         * @brief Supervise this ControlMode with \a watchdog (or not at all if NULL)
+         *
+         * @see Watchdog
+         */
+		virtual void setWatchdog(const Watchdog::Ptr& watchdog) {
+			_watchdog = watchdog;
+		}
+
+		virtual const Watchdog::Ptr& getWatchdog() const {
+			return _watchdog;
+		}
+
 		virtual Controller::ConstPtr getControllerByName(const std::string& name) const {
 			return _control_set->getControllerByName(name);
 		}    
@@ -134,6 +159,9 @@ namespace ha {
 			return new ControlMode(*this);
 		}
 
+		// read the optional Watchdog child of \a tree
+		void _deserializeWatchdog(const DescriptionTreeNode::ConstPtr& tree, const System::ConstPtr& system, const HybridAutomaton* ha);
+
 	protected:
 
         /**
@@ -141,11 +169,21 @@ namespace ha {
          */
 		ControlSet::Ptr _control_set;
 
+        /**
+         * @brief Optional supervision of this ControlMode
+         */
+		Watchdog::Ptr _watchdog;
+
         /**
          * @brief identifier of this ControlMode - must be unique within each HybridAutomaton!
          */
 		std::string _name;
 
+        /**
+         * @brief The run time counters of step() - see HA_PROFILE_SCOPE
+         */
+		ProfileHandle _step_profile;
+
 	};
 
 }
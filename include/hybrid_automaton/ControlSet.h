@@ -35,6 +35,7 @@
 #include <Eigen/Dense>
 
 #include <map>
+#include <vector>
 
 namespace ha {
 
@@ -158,10 +159,31 @@ namespace ha {
             return _controllers;
         }
 
-		virtual std::map<std::string, Controller::Ptr> getControllers() const {
+		virtual const std::map<std::string, Controller::Ptr>& getControllers() const {
             return _controllers;
         }
 
+        /**
+         * @brief The stored controllers by descending priority - controllers of equal priority in the order they were added
+         *
+         * The vector is kept sorted by appendController and setControllerPriority, so iterating it in step()
+         * neither copies nor sorts.
+         */
+		const std::vector<Controller::Ptr>& getControllersByPriority() const;
+
+        /**
+         * @brief Change the priority of the contained Controller with name \a name and reorder the controllers - throws if it does not exist
+         */
+		void setControllerPriority(const std::string& name, double priority);
+
+        /**
+         * @brief Rebuild the order of getControllersByPriority from _controllers
+         *
+         * Call this after changing the priority of a contained Controller with Controller::setPriority, or after a
+         * subclass changed _controllers directly.
+         */
+		void sortControllersByPriority();
+
     protected:
 		virtual void setArgumentString(const std::string& name, const std::string& value)
 		{
@@ -201,6 +223,11 @@ namespace ha {
          * @brief The Controllers contained in this ControlSet
          */
 		std::map<std::string, Controller::Ptr>	_controllers;
+
+        /**
+         * @brief The Controllers in _controllers by descending priority - see getControllersByPriority
+         */
+		std::vector<Controller::Ptr> _controllers_by_priority;
 	
         /**
          * @brief A list of optional attributes for specific ControlSet implementations.
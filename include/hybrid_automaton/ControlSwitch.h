@@ -31,8 +31,10 @@
 #include <vector>
 
 #include "hybrid_automaton/JumpCondition.h" 
+#include "hybrid_automaton/JumpConditionExpression.h"
 #include "hybrid_automaton/ControlMode.h" 
 #include "hybrid_automaton/Serializable.h"
+#include "hybrid_automaton/Profiler.h"
 
 namespace ha {
   //class HybridAutomaton;
@@ -48,7 +50,7 @@ namespace ha {
    *
    * A ControlSwitch contains one or more JumpConditions. these JumpConditions are conditional statements.
    * If they all evaluate to "true", this ControlSwitch will become active and the ControlMode this switch points to
-   * will be executed.
+   * will be executed. Other combinations can be given as an expression -- see setExpression.
    *
    * @see ControlSet
    * @see Controller
@@ -59,7 +61,10 @@ namespace ha {
     typedef boost::shared_ptr<ControlSwitch> Ptr;
 	typedef boost::shared_ptr<const ControlSwitch> ConstPtr;
 
-    ControlSwitch() {}
+    ControlSwitch() : _evaluation_period(0.0), _next_evaluation_time(0.0), _priority(0), _evaluations(0), _activations(0) {}
+
+    // copies have their own JumpConditions
+    ControlSwitch(const ControlSwitch& cs);
 
     virtual ~ControlSwitch() {}
 
@@ -86,14 +91,44 @@ namespace ha {
 	virtual void step(const double& t);
 
     /**
-     * @brief Check if all contained JumpConditions evaluate to true
+     * @brief Like step(), but returns false and fills \a error instead of throwing
+     *
+     * HybridAutomaton::tryStep evaluates the switches with tryStep() and tryIsActive(). A ControlSwitch
+     * reports its errors without throwing; for subclasses the defaults call the virtual step() and isActive()
+     * and turn their exceptions into \a error, so subclasses only need to override those.
+     */
+	virtual bool tryStep(const double& t, ErrorRecord& error);
+
+    /**
+     * @brief Check if all contained JumpConditions (or the expression over them) evaluate to true
      * Is called from the HybridAutomaton once within each control loop
      */
     virtual bool isActive() const;
 
+    /**
+     * @brief Like isActive(), but returns false and fills \a error instead of throwing
+     */
+	virtual bool tryIsActive(bool& active, ErrorRecord& error) const;
+
 	virtual void add(const JumpConditionPtr& jump_condition);
 	virtual const std::vector<JumpConditionPtr>& getJumpConditions();
 
+    /**
+     * @brief Combine the JumpConditions with a boolean expression instead of a conjunction - throws on syntax errors
+     *
+     * The JumpConditions are referred to by their index, e.g. "0 and (1 or not 2)" or "atleast(2, 0, 1, 3)".
+     * The expression is compiled once and evaluated with short-circuiting - see JumpConditionExpression.
+     * An empty expression restores the conjunction of all JumpConditions. An invalid expression keeps the
+     * previous one.
+     */
+	virtual void setExpression(const std::string& expression);
+	virtual const std::string& getExpression() const;
+
+    /**
+     * @brief Validate all contained JumpConditions - problems are added to \a report
+     */
+	virtual void validate(ValidationReport& report);
+
 	virtual DescriptionTreeNode::Ptr serialize(const DescriptionTree::ConstPtr& factory) const;
 	virtual void deserialize(const DescriptionTreeNode::ConstPtr& tree, const System::ConstPtr& system, const HybridAutomaton* ha);
 
@@ -102,6 +137,54 @@ namespace ha {
 
 	void setHybridAutomaton(const HybridAutomaton* hybrid_automaton);
 
+    /**
+     * @brief Set the rate (in Hz) at which this ControlSwitch is supervised
+     *
+     * Controllers are stepped in every call to HybridAutomaton::step, but expensive JumpConditions
+     * (e.g. vision based ones) often only need to be checked at a fraction of the servo rate.
+     * A rate of 0 (the default) evaluates the switch in every control cycle.
+     */
+	virtual void setEvaluationRate(const double& rate);
+	virtual double getEvaluationRate() const;
+
+    /**
+     * @brief Check if this ControlSwitch needs to be evaluated at time \a t according to its evaluation rate
+     */
+	virtual bool isEvaluationDue(const double& t) const;
+
+    /**
+     * @brief Advance the evaluation schedule - is called by the HybridAutomaton after evaluating this switch at time \a t
+     */
+	virtual void scheduleNextEvaluation(const double& t);
+
+    /**
+     * @brief Set the priority of this ControlSwitch among the switches leaving the same ControlMode
+     *
+     * Switches with a higher priority are evaluated first and win if several are active; switches with
+     * the same priority are evaluated in the order they were added. The default is 0. The evaluation order
+     * is compiled in HybridAutomaton::initialize, so the priorities are frozen while the automaton is active:
+     * a priority set after initialize() only takes effect when the automaton is initialized again.
+     */
+	virtual void setPriority(int priority);
+	virtual int getPriority() const;
+
+    /**
+     * @brief How often this ControlSwitch was evaluated by the HybridAutomaton
+     */
+	unsigned long getNumberOfEvaluations() const;
+
+    /**
+     * @brief How often this ControlSwitch was active when it was evaluated, i.e. how often it fired
+     */
+	unsigned long getNumberOfActivations() const;
+
+    /**
+     * @brief Count one evaluation - is called by the HybridAutomaton after evaluating this switch
+     */
+	void recordEvaluation(bool active);
+
+	void resetStatistics();
+
   protected:
     /**
      * @brief The JumpConditions in this ControlSwitch - all need to evaluate to ture for this switch to become active
@@ -113,6 +196,43 @@ namespace ha {
      */
 	std::string _name;
 
+    /**
+     * @brief The time between two evaluations of this ControlSwitch in seconds - 0 means every control cycle
+     */
+	double _evaluation_period;
+
+    /**
+     * @brief The time at which this ControlSwitch will be evaluated next
+     */
+	double _next_evaluation_time;
+
+    /**
+     * @brief The compiled expression over the JumpConditions - empty for a conjunction of all
+     */
+	JumpConditionExpression _expression;
+
+    /**
+     * @brief Switches with a higher priority are evaluated first
+     */
+	int _priority;
+
+    /**
+     * @brief Evaluation statistics - written by the thread that supervises the switches
+     */
+	unsigned long _evaluations;
+	unsigned long _activations;
+
+    /**
+     * @brief The run time counters of step() and isActive() - see HA_PROFILE_SCOPE
+     */
+	ProfileHandle _step_profile;
+	mutable ProfileHandle _is_active_profile;
+
+    // the implementation of step() and isActive() - false and \a error filled on failure, step() and
+    // isActive() only turn the error into an exception
+	bool _step(const double& t, ErrorRecord& error);
+	bool _isActive(bool& active, ErrorRecord& error) const;
+
     virtual ControlSwitch* _doClone() const
     {
       return (new ControlSwitch(*this));
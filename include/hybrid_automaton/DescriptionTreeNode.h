@@ -176,6 +176,40 @@ namespace ha {
 		virtual DescriptionTreeNode* _doClone() const = 0;
 	};
 
+	// the types the entities serialize are formatted without a ha_stringstream
+	template <> inline void DescriptionTreeNode::setAttribute<std::string>(const std::string& field_name, const std::string& field_value)
+	{
+		this->setAttributeString(field_name, field_value);
+	}
+
+	template <> inline void DescriptionTreeNode::setAttribute<double>(const std::string& field_name, const double& field_value)
+	{
+		std::string value;
+		ha_append(value, field_value);
+		this->setAttributeString(field_name, value);
+	}
+
+	template <> inline void DescriptionTreeNode::setAttribute<int>(const std::string& field_name, const int& field_value)
+	{
+		std::string value;
+		ha_append(value, field_value);
+		this->setAttributeString(field_name, value);
+	}
+
+	template <> inline void DescriptionTreeNode::setAttribute<bool>(const std::string& field_name, const bool& field_value)
+	{
+		std::string value;
+		ha_append(value, field_value);
+		this->setAttributeString(field_name, value);
+	}
+
+	template <> inline void DescriptionTreeNode::setAttribute< ::Eigen::MatrixXd>(const std::string& field_name, const ::Eigen::MatrixXd& field_value)
+	{
+		std::string value;
+		ha_append(value, field_value);
+		this->setAttributeString(field_name, value);
+	}
+
 }
 
 #endif
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef HYBRID_AUTOMATON_DESCRIPTION_TREE_NODE_STREAM_H_
+#define HYBRID_AUTOMATON_DESCRIPTION_TREE_NODE_STREAM_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+#include "hybrid_automaton/DescriptionTreeNode.h"
+
+namespace ha {
+
+	class DescriptionTreeNodeStream;
+	typedef boost::shared_ptr<DescriptionTreeNodeStream> DescriptionTreeNodeStreamPtr;
+	typedef boost::shared_ptr<const DescriptionTreeNodeStream> DescriptionTreeNodeStreamConstPtr;
+
+    /**
+    * @brief A lightweight in-memory DescriptionTreeNode
+    *
+    * HybridAutomatonXMLReader builds one ControlMode or ControlSwitch element at a time from these nodes,
+    * so the existing deserialize methods can read it, and drops it afterwards.
+    */
+	class DescriptionTreeNodeStream: public DescriptionTreeNode {
+
+	public:
+		typedef boost::shared_ptr<DescriptionTreeNodeStream> Ptr;
+		typedef boost::shared_ptr<const DescriptionTreeNodeStream> ConstPtr;
+
+		typedef std::vector< std::pair<std::string, std::string> > AttributeList;
+
+		DescriptionTreeNodeStream(const std::string& type);
+
+		DescriptionTreeNodeStream(const std::string& type, const AttributeList& attributes);
+
+		DescriptionTreeNodeStream(const DescriptionTreeNodeStream& dtn);
+
+		virtual ~DescriptionTreeNodeStream();
+
+		DescriptionTreeNodeStreamPtr clone() const {
+			return DescriptionTreeNodeStreamPtr(_doClone());
+		}
+
+		virtual const std::string getType() const;
+
+		virtual bool getChildrenNodes(const std::string& type, ConstNodeList& children) const;
+
+		virtual bool getChildrenNodes(ConstNodeList& children) const;
+
+		virtual void addChildNode(const DescriptionTreeNode::Ptr& child);
+
+		virtual void getAllAttributes(std::map<std::string, std::string> & attrs) const;
+
+		/**
+		 * @brief The attributes in the order they were set
+		 */
+		const AttributeList& getAttributes() const;
+
+		const std::vector<DescriptionTreeNode::ConstPtr>& getChildren() const;
+
+	protected:
+
+		virtual bool getAttributeString(const std::string& field_name, std::string& field_value) const;
+
+		virtual void setAttributeString(const std::string& field_name, const std::string& field_value);
+
+		virtual DescriptionTreeNodeStream* _doClone() const {
+			return new DescriptionTreeNodeStream(*this);
+		}
+
+		std::string _type;
+
+		// in document order - elements have only a handful of attributes, so they are searched linearly
+		AttributeList _attributes;
+
+		std::vector<DescriptionTreeNode::ConstPtr> _children;
+	};
+
+}
+
+#endif
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef HYBRID_AUTOMATON_DESCRIPTION_TREE_STREAM_H_
+#define HYBRID_AUTOMATON_DESCRIPTION_TREE_STREAM_H_
+
+#include <ostream>
+#include <string>
+
+#include <boost/shared_ptr.hpp>
+
+#include "hybrid_automaton/DescriptionTree.h"
+#include "hybrid_automaton/DescriptionTreeNodeStream.h"
+
+namespace ha {
+
+	class DescriptionTreeStream;
+	typedef boost::shared_ptr<DescriptionTreeStream> DescriptionTreeStreamPtr;
+	typedef boost::shared_ptr<const DescriptionTreeStream> DescriptionTreeStreamConstPtr;
+
+    /**
+    * @brief A DescriptionTree of DescriptionTreeNodeStreams that writes XML directly to a std::ostream
+    *
+    * HybridAutomaton::serialize(std::ostream&) serializes one ControlMode or ControlSwitch at a time into
+    * this tree, writes it and drops it.
+    */
+	class DescriptionTreeStream: public DescriptionTree {
+	public:
+		typedef boost::shared_ptr<DescriptionTreeStream> Ptr;
+		typedef boost::shared_ptr<const DescriptionTreeStream> ConstPtr;
+
+		DescriptionTreeStream();
+
+		virtual ~DescriptionTreeStream();
+
+		virtual DescriptionTreeNode::Ptr createNode(const std::string& type) const;
+
+		virtual DescriptionTreeNode::Ptr getRootNode();
+
+		virtual void setRootNode(const DescriptionTreeNode::Ptr& root_node);
+
+        /**
+         * @brief Write the root node as XML to \a out
+         */
+		void writeTreeXML(std::ostream& out) const;
+
+        /**
+         * @brief Write \a node (created by this tree) and its children as XML, indented by \a depth tabs
+         */
+		static void writeXML(const DescriptionTreeNode::ConstPtr& node, std::ostream& out, int depth = 0);
+
+        /**
+         * @brief Write the opening tag of \a node without its children - close it with writeEndElement
+         */
+		static void writeStartElement(const DescriptionTreeNode::ConstPtr& node, std::ostream& out, int depth = 0);
+
+		static void writeEndElement(const std::string& type, std::ostream& out, int depth = 0);
+
+	protected:
+		DescriptionTreeNode::Ptr _root_node;
+	};
+}
+
+#endif
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef HYBRID_AUTOMATON_DESCRIPTION_TREE_TRANSPORT_H_
+#define HYBRID_AUTOMATON_DESCRIPTION_TREE_TRANSPORT_H_
+
+#include "hybrid_automaton/DescriptionTree.h"
+#include "hybrid_automaton/DescriptionTreeNode.h"
+
+#include <string>
+
+namespace ha {
+
+	/**
+	 * @brief A compact transport encoding of DescriptionTrees, e.g. of serialized HybridAutomata
+	 *
+	 * Identical strings - element types, attribute names and values, in particular the gain matrices that
+	 * are repeated across many controllers - are stored once in a constant pool and referenced by index.
+	 * The encoded tree is split into length-prefixed chunks, each optionally compressed with an LZ4-style
+	 * block compressor and protected by a CRC-32:
+	 *
+	 *   "HATP" version flags { raw_length stored_length crc32 data }* 0 0 0
+	 *
+	 * The chunks can be written to a socket as they are produced and checked one by one on the receiver.
+	 * Attributes are encoded in the order of getAllAttributes().
+	 */
+	class DescriptionTreeTransport
+	{
+	public:
+		struct Options
+		{
+			Options() : compress(true), chunk_size(64 * 1024) {}
+
+			// compress the chunks (chunks that do not shrink are stored uncompressed)
+			bool compress;
+
+			// the number of bytes of the encoded tree per chunk
+			std::size_t chunk_size;
+		};
+
+		struct Statistics
+		{
+			Statistics() : nodes(0), attributes(0), pooled_strings(0), tree_bytes(0), encoded_bytes(0), chunks(0) {}
+
+			std::size_t nodes;
+			std::size_t attributes;
+
+			// the number of distinct strings in the constant pool
+			std::size_t pooled_strings;
+
+			// the size of the encoded tree before compression and framing
+			std::size_t tree_bytes;
+
+			std::size_t encoded_bytes;
+			std::size_t chunks;
+		};
+
+		/**
+		 * @brief Encode \a node and its children into \a out
+		 */
+		static void encode(const DescriptionTreeNode::ConstPtr& node, std::string& out, const Options& options = Options(), Statistics* statistics = NULL);
+
+		/**
+		 * @brief Decode a tree written by encode() with the nodes created by \a factory
+		 *
+		 * @throws Error if the data is truncated or corrupted
+		 */
+		static DescriptionTreeNode::Ptr decode(const std::string& in, const DescriptionTree::ConstPtr& factory);
+
+		/**
+		 * @brief Append the LZ4-style compressed \a size bytes at \a in to \a out
+		 */
+		static void compressBlock(const char* in, std::size_t size, std::string& out);
+
+		/**
+		 * @brief Append the \a raw_size bytes compressed at \a in to \a out
+		 *
+		 * @throws Error if the block is corrupted
+		 */
+		static void decompressBlock(const char* in, std::size_t size, std::size_t raw_size, std::string& out);
+	};
+}
+
+#endif
@@ -0,0 +1,114 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef HYBRID_AUTOMATON_ERROR_QUEUE_H_
+#define HYBRID_AUTOMATON_ERROR_QUEUE_H_
+
+#include "hybrid_automaton/ErrorRecord.h"
+#include "hybrid_automaton/BoundedQueue.h"
+
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread.hpp>
+
+#include <iostream>
+
+namespace ha {
+
+	class ErrorQueue;
+	typedef boost::shared_ptr<ErrorQueue> ErrorQueuePtr;
+	typedef boost::shared_ptr<const ErrorQueue> ErrorQueueConstPtr;
+
+	/**
+	 * @brief Hands ErrorRecords from the control loop to a logging thread
+	 *
+	 * The records are copied into a preallocated BoundedQueue, so push() never allocates and never waits for
+	 * another producer - if the queue is full, the record is dropped and counted. Either pop() the records
+	 * yourself or let the thread started with startLogging() write them to a stream.
+	 */
+	class ErrorQueue
+	{
+	public:
+
+		typedef boost::shared_ptr<ErrorQueue> Ptr;
+		typedef boost::shared_ptr<const ErrorQueue> ConstPtr;
+
+		/**
+		 * @brief Creates a queue that can buffer \a capacity records (rounded up to a power of two)
+		 */
+		ErrorQueue(std::size_t capacity = 64);
+
+		virtual ~ErrorQueue();
+
+		/**
+		 * @brief Copies \a record into the queue - false if the queue is full
+		 */
+		bool push(const ErrorRecord& record);
+
+		/**
+		 * @brief Takes the oldest record from the queue - false if the queue is empty
+		 *
+		 * Only one thread may pop - do not call it while the logging thread is running.
+		 */
+		bool pop(ErrorRecord& record);
+
+		/**
+		 * @brief Starts a thread that writes all records to \a out
+		 */
+		void startLogging(std::ostream& out = std::cerr);
+
+		/**
+		 * @brief Writes the pending records and stops the logging thread
+		 */
+		void stopLogging();
+
+		boost::uint64_t getNumberOfDroppedRecords() const;
+
+		static void write(const ErrorRecord& record, std::ostream& out);
+
+	protected:
+
+		void _logLoop();
+
+		void _log();
+
+		// several automata may share a queue - any thread pushes, one thread pops
+		BoundedQueue<ErrorRecord> _queue;
+
+		boost::atomic<boost::uint64_t> _dropped;
+
+		boost::atomic<bool> _logging;
+		std::ostream* _out;
+		boost::shared_ptr<boost::thread> _log_thread;
+
+	private:
+		ErrorQueue(const ErrorQueue&);
+		ErrorQueue& operator=(const ErrorQueue&);
+	};
+
+}
+
+#endif
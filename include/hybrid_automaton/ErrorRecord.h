@@ -0,0 +1,78 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef HYBRID_AUTOMATON_ERROR_RECORD_H_
+#define HYBRID_AUTOMATON_ERROR_RECORD_H_
+
+#include <cstddef>
+
+namespace ha {
+
+	/**
+	 * @brief A fixed-size description of an error in the control loop
+	 *
+	 * Filling a record does not allocate, so it can be done in the real-time thread. The text is truncated
+	 * to the size of the buffers.
+	 */
+	struct ErrorRecord
+	{
+		// not ERROR_*, windows.h defines many of these as macros
+		enum Code {
+			FAULT_NONE = 0,
+			FAULT_NOT_ACTIVE,
+			FAULT_SUPERVISION,
+			FAULT_JUMP_CONDITION,
+			FAULT_CONTROL_MODE,
+			FAULT_EXCEPTION,
+			FAULT_WATCHDOG
+		};
+
+		static const std::size_t ORIGIN_SIZE = 64;
+		static const std::size_t MESSAGE_SIZE = 256;
+
+		Code code;
+		double time;
+		char origin[ORIGIN_SIZE];
+		char message[MESSAGE_SIZE];
+
+		ErrorRecord();
+
+		void clear();
+
+		/**
+		 * @brief Set the code, origin and a printf-style formatted message
+		 */
+		void set(Code error_code, const char* error_origin, const char* format, ...)
+#ifdef __GNUC__
+			__attribute__((format(printf, 4, 5)))
+#endif
+			;
+
+		static const char* getCodeName(Code code);
+	};
+
+}
+
+#endif
@@ -0,0 +1,129 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef FILTERED_SENSOR_H
+#define FILTERED_SENSOR_H
+
+#include "hybrid_automaton/Sensor.h"
+#include "hybrid_automaton/SensorFilter.h"
+
+#include <boost/shared_ptr.hpp>
+
+#include <vector>
+
+namespace ha {
+
+	class FilteredSensor;
+	typedef boost::shared_ptr<FilteredSensor> FilteredSensorPtr;
+	typedef boost::shared_ptr<const FilteredSensor> FilteredSensorConstPtr;
+
+    /**
+     * @brief Runs the values of another Sensor through a pipeline of SensorFilters
+     *
+     * HybridAutomaton::createSensor wraps every sensor whose description contains "Filter" children
+     * into a FilteredSensor. Identical filtered sensors within one HybridAutomaton are shared - the
+     * pipeline is therefore evaluated at most once per time step, no matter how many JumpConditions
+     * call step().
+     */
+	class FilteredSensor : public Sensor
+	{
+	public:
+
+		typedef boost::shared_ptr<FilteredSensor> Ptr;
+		typedef boost::shared_ptr<const FilteredSensor> ConstPtr;
+
+		FilteredSensor(const Sensor::Ptr& sensor);
+
+		virtual ~FilteredSensor();
+
+		FilteredSensor(const FilteredSensor& ss);
+
+		FilteredSensorPtr clone() const
+		{
+			return (FilteredSensorPtr(_doClone()));
+		};
+
+		/**
+		 * @brief Append a filter to the end of the pipeline
+		 */
+		virtual void addFilter(const SensorFilter::Ptr& filter);
+		virtual const std::vector<SensorFilter::Ptr>& getFilters() const;
+
+		/**
+		 * @brief The sensor whose values are filtered
+		 */
+		virtual Sensor::ConstPtr getUnfilteredSensor() const;
+
+        /**
+         * @brief Return the output of the last filter, computed in the last call to step()
+         */
+		virtual ::Eigen::MatrixXd getCurrentValue() const;
+
+		virtual bool getDimensions(int& rows, int& cols) const;
+
+		virtual const std::string getType() const;
+
+		virtual void setSystem(const System::ConstPtr& system);
+
+		virtual void initialize(const double& t);
+
+		virtual void terminate();
+
+        /**
+         * @brief Step the unfiltered sensor and the filters - only once for each \a t
+         */
+		virtual void step(const double& t);
+
+		virtual bool isActive() const;
+
+		virtual DescriptionTreeNode::Ptr serialize(const DescriptionTree::ConstPtr& factory) const;
+
+        /**
+         * @brief Read the "Filter" children of \a tree - the unfiltered sensor is deserialized by HybridAutomaton::createSensor
+         */
+		virtual void deserialize(const DescriptionTreeNode::ConstPtr& tree, const System::ConstPtr& system, const HybridAutomaton* ha);
+
+	protected:
+
+		virtual FilteredSensor* _doClone() const
+		{
+			return (new FilteredSensor(*this));
+		}
+
+		Sensor::Ptr _sensor;
+
+		std::vector<SensorFilter::Ptr> _filters;
+
+		// input of the first stage and output of each filter stage, sized in initialize()
+		::Eigen::MatrixXd _raw_value;
+		std::vector< ::Eigen::MatrixXd> _stage_values;
+
+		bool _stepped;
+		double _last_step_time;
+	};
+
+}
+
+#endif
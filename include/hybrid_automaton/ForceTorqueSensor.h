@@ -29,6 +29,8 @@
 #include "hybrid_automaton/Sensor.h"
 #include "hybrid_automaton/HybridAutomaton.h"
 
+#include <vector>
+
 #include <boost/shared_ptr.hpp>
 
 namespace ha {
@@ -64,9 +66,13 @@ namespace ha {
 		* Optionally transforms the force into frame _frame if parameter is given
 		*
 		* x ,y ,z ,rot_x, rot_y, rot_z
+		*
+		* If several ports are given, the transformed wrenches of all ports are stacked into a 6Nx1 vector.
 		*/
 		virtual ::Eigen::MatrixXd getCurrentValue() const;
 
+		virtual bool getDimensions(int& rows, int& cols) const;
+
 		virtual DescriptionTreeNode::Ptr serialize(const DescriptionTree::ConstPtr& factory) const;
 
 		virtual void deserialize(const DescriptionTreeNode::ConstPtr& tree, const System::ConstPtr& system, const HybridAutomaton* ha);
@@ -87,14 +93,25 @@ namespace ha {
 			return _frame_id;
 		}
 
-		virtual void setFrame(const Eigen::MatrixXd& frame) {
-			_frame = frame;
-		}
+		virtual void setFrame(const Eigen::MatrixXd& frame);
 
 		virtual ::Eigen::MatrixXd getFrame() const {
 			return _frame;
 		}
 
+		virtual void setPorts(const std::vector<int>& ports);
+
+		virtual const std::vector<int>& getPorts() const {
+			return _ports;
+		}
+
+		/**
+		* @brief The 6x6 matrix that maps a wrench to the one expressed in the frame \a transform
+		*
+		* Same transformation as transformWrench(): f' = R^T f, m' = R^T (m - p x f')
+		*/
+		static void computeWrenchTransform(const ::Eigen::Matrix4d& transform, ::Eigen::Matrix<double, 6, 6>& wrench_transform);
+
 	protected:
 
         /**
@@ -111,12 +128,30 @@ namespace ha {
 		// The port of the force-torque sensor to query values from
 		int _port;
 
+		// Optional list of ports that are read in one call, overrides _port if not empty
+		std::vector<int> _ports;
+
+		// Wrench transformation of _frame, computed once when the frame is set
+		::Eigen::Matrix<double, 6, 6> _frame_wrench_transform;
+
+		// Cached wrench transformation into _frame via the world frame - only recomputed when the EE pose changes
+		mutable ::Eigen::Matrix4d _ee_pose;
+		mutable ::Eigen::Matrix<double, 6, 6> _world_wrench_transform;
+		mutable bool _world_wrench_transform_valid;
+
+		mutable ::Eigen::MatrixXd _measurements;
+
+		const ::Eigen::Matrix<double, 6, 6>& _getWrenchTransform() const;
+
 		virtual ForceTorqueSensor* _doClone() const
 		{
 			return (new ForceTorqueSensor(*this));
 		}
 
 		::Eigen::MatrixXd transformWrench(const ::Eigen::MatrixXd& wrench, const ::Eigen::MatrixXd& transform) const;
+
+	public:
+		EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 	};
 
 }
@@ -26,7 +26,7 @@
 #ifndef FRAME_DISPLACEMENT_SENSOR_H
 #define FRAME_DISPLACEMENT_SENSOR_H
 
-#include "hybrid_automaton/Sensor.h"
+#include "hybrid_automaton/FrameSensor.h"
 #include "hybrid_automaton/HybridAutomaton.h"
 
 #include <boost/shared_ptr.hpp>
@@ -40,7 +40,7 @@ namespace ha {
     /**
      * @brief An interface to measure the position of the given frame usinf forward kinematics
      */
-	class FrameDisplacementSensor : public Sensor
+	class FrameDisplacementSensor : public FrameSensor
 	{
 	public:
 
@@ -58,17 +58,8 @@ namespace ha {
 			return (FrameDisplacementSensorPtr(_doClone()));
 		};
 
-		virtual void initialize(const double& t); 
-		
-		virtual ::Eigen::MatrixXd getRelativeCurrentValue() const;
+		virtual bool getDimensions(int& rows, int& cols) const;
 
-        /**
-         * @brief Returns the current frame position as a 3x1 vector
-         */
-		virtual ::Eigen::MatrixXd getCurrentValue() const;
-
-		virtual ::Eigen::MatrixXd getInitialValue() const;
-		
 		virtual DescriptionTreeNode::Ptr serialize(const DescriptionTree::ConstPtr& factory) const;
 
 		virtual void deserialize(const DescriptionTreeNode::ConstPtr& tree, const System::ConstPtr& system, const HybridAutomaton* ha);
@@ -82,7 +73,10 @@ namespace ha {
 
 	protected:
 
-		std::string _frame_id;
+        /**
+         * @brief Selects the frame position as a 3x1 vector
+         */
+		virtual ::Eigen::MatrixXd _poseToValue(const ::Eigen::Matrix4d& pose) const;
 
 		virtual FrameDisplacementSensor* _doClone() const
 		{
@@ -26,7 +26,7 @@
 #ifndef FRAME_ORIENTATION_SENSOR_H
 #define FRAME_ORIENTATION_SENSOR_H
 
-#include "hybrid_automaton/Sensor.h"
+#include "hybrid_automaton/FrameSensor.h"
 #include "hybrid_automaton/HybridAutomaton.h"
 
 #include <boost/shared_ptr.hpp>
@@ -37,7 +37,7 @@ namespace ha {
 	typedef boost::shared_ptr<FrameOrientationSensor> FrameOrientationSensorPtr;
 	typedef boost::shared_ptr<const FrameOrientationSensor> FrameOrientationSensorConstPtr;
 
-	class FrameOrientationSensor : public Sensor
+	class FrameOrientationSensor : public FrameSensor
 	{
 	public:
 
@@ -58,16 +58,7 @@ namespace ha {
 			return (FrameOrientationSensorPtr(_doClone()));
 		};
 
-		virtual void initialize(const double& t); 
-
-		virtual ::Eigen::MatrixXd getInitialValue() const;
-
-        /**
-         * @brief Returns the current frame osition as a 3x3 mrotation matrix
-         */
-		virtual ::Eigen::MatrixXd getCurrentValue() const;
-		
-		virtual ::Eigen::MatrixXd getRelativeCurrentValue() const;
+		virtual bool getDimensions(int& rows, int& cols) const;
 
 		virtual DescriptionTreeNode::Ptr serialize(const DescriptionTree::ConstPtr& factory) const;
 
@@ -82,7 +73,10 @@ namespace ha {
 
 	protected:
 
-		std::string _frame_id;
+        /**
+         * @brief Selects the frame orientation as a 3x3 rotation matrix
+         */
+		virtual ::Eigen::MatrixXd _poseToValue(const ::Eigen::Matrix4d& pose) const;
 
 		virtual FrameOrientationSensor* _doClone() const
 		{
@@ -26,7 +26,7 @@
 #ifndef FRAME_POSE_SENSOR_H
 #define FRAME_POSE_SENSOR_H
 
-#include "hybrid_automaton/Sensor.h"
+#include "hybrid_automaton/FrameSensor.h"
 #include "hybrid_automaton/HybridAutomaton.h"
 
 #include <boost/shared_ptr.hpp>
@@ -40,7 +40,7 @@ namespace ha {
     /**
      * @brief An interface to measure the pose of the given robot frame using forward kinematics
      */
-	class FramePoseSensor : public Sensor
+	class FramePoseSensor : public FrameSensor
 	{
 	public:
 
@@ -58,17 +58,7 @@ namespace ha {
 			return (FramePoseSensorPtr(_doClone()));
 		};
 
-		virtual void initialize(const double& t); 
-
-
-        /**
-         * @brief Returns the current frame pose as a 4x4 homogenuous transformation matrix
-         */
-		virtual ::Eigen::MatrixXd getCurrentValue() const;
-		
-		virtual ::Eigen::MatrixXd getRelativeCurrentValue() const;
-
-		virtual ::Eigen::MatrixXd getInitialValue() const;
+		virtual bool getDimensions(int& rows, int& cols) const;
 
 		virtual DescriptionTreeNode::Ptr serialize(const DescriptionTree::ConstPtr& factory) const;
 
@@ -83,9 +73,12 @@ namespace ha {
 
 	protected:
 
-		std::string _frame_id;
+        /**
+         * @brief Selects the full pose as a 4x4 homogenuous transformation matrix
+         */
+		virtual ::Eigen::MatrixXd _poseToValue(const ::Eigen::Matrix4d& pose) const;
 
-    std::string _reference_frame;
+		std::string _reference_frame;
 
 		virtual FramePoseSensor* _doClone() const
 		{
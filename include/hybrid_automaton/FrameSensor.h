@@ -0,0 +1,110 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef FRAME_SENSOR_H
+#define FRAME_SENSOR_H
+
+#include "hybrid_automaton/Sensor.h"
+
+#include <boost/shared_ptr.hpp>
+
+namespace ha {
+
+	class FrameSensor;
+	typedef boost::shared_ptr<FrameSensor> FrameSensorPtr;
+	typedef boost::shared_ptr<const FrameSensor> FrameSensorConstPtr;
+
+    /**
+     * @brief Common base of the sensors that measure (parts of) the pose of a robot frame
+     *
+     * Poses are read into fixed-size 4x4 matrices and treated as rigid transforms: the initial pose and its
+     * inverse are computed once in initialize(), relative poses are composed without a general matrix inverse.
+     * Derived sensors only select the part of the (relative) pose they return.
+     *
+     * @see FramePoseSensor, FrameDisplacementSensor, FrameOrientationSensor
+     */
+	class FrameSensor : public Sensor
+	{
+	public:
+
+		typedef boost::shared_ptr<FrameSensor> Ptr;
+		typedef boost::shared_ptr<const FrameSensor> ConstPtr;
+
+		FrameSensor(const std::string& frame_id = std::string("EE"));
+
+		virtual ~FrameSensor();
+
+		FrameSensor(const FrameSensor& ss);
+
+        /**
+         * @brief Stores the initial pose and its inverse
+         */
+		virtual void initialize(const double& t);
+
+		virtual ::Eigen::MatrixXd getCurrentValue() const;
+
+        /**
+         * @brief The value of the pose relative to the initial pose
+         *
+         * The relative pose is T_0^-1 * T, or T * T_0^-1 if the motion is expressed in the world frame
+         */
+		virtual ::Eigen::MatrixXd getRelativeCurrentValue() const;
+
+		virtual const std::string& getFrameId() const;
+
+        /**
+         * @brief Inverse of the rigid transform \a pose: [R^T, -R^T p]
+         */
+		static void invertRigidTransform(const ::Eigen::Matrix4d& pose, ::Eigen::Matrix4d& inverse);
+
+        /**
+         * @brief Product \a a * \a b of two rigid transforms
+         */
+		static void composeRigidTransforms(const ::Eigen::Matrix4d& a, const ::Eigen::Matrix4d& b, ::Eigen::Matrix4d& result);
+
+	protected:
+
+        /**
+         * @brief Select the value of this sensor from a (relative) pose
+         */
+		virtual ::Eigen::MatrixXd _poseToValue(const ::Eigen::Matrix4d& pose) const = 0;
+
+		void _readFramePose(::Eigen::Matrix4d& pose) const;
+
+		std::string _frame_id;
+
+		// if true the relative pose is expressed in the world frame, otherwise in the initial frame
+		bool _relative_to_world;
+
+		::Eigen::Matrix4d _initial_pose;
+		::Eigen::Matrix4d _initial_pose_inverse;
+
+	public:
+		EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+	};
+
+}
+
+#endif
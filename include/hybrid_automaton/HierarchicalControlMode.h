@@ -0,0 +1,109 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef HYBRID_AUTOMATON_HIERARCHICAL_CONTROL_MODE_H_
+#define HYBRID_AUTOMATON_HIERARCHICAL_CONTROL_MODE_H_
+
+#include "hybrid_automaton/ControlMode.h"
+#include "hybrid_automaton/HybridAutomaton.h"
+
+#include <boost/shared_ptr.hpp>
+
+namespace ha {
+
+	class HierarchicalControlMode;
+	typedef boost::shared_ptr<HierarchicalControlMode> HierarchicalControlModePtr;
+	typedef boost::shared_ptr<const HierarchicalControlMode> HierarchicalControlModeConstPtr;
+
+	/**
+	 * @brief A ControlMode that executes a nested HybridAutomaton
+	 *
+	 * The ControlSwitches leaving a HierarchicalControlMode are shared by all modes of the nested automaton:
+	 * they are evaluated once per control cycle by the outer automaton, whichever sub-mode is active, while
+	 * the nested automaton only evaluates the switches of its active sub-mode. Common exits (e.g. a force
+	 * limit or a timeout) are therefore added once to the super-mode instead of to every mode.
+	 *
+	 * Every time the super-mode is entered, the nested automaton starts in its initial control mode
+	 * (the current control mode when it was set).
+	 *
+	 * Serialized as a ControlMode with a HybridAutomaton instead of a ControlSet:
+	 * <ControlMode name="grasp"><HybridAutomaton name="grasp" current_control_mode="approach">...</HybridAutomaton></ControlMode>
+	 */
+	class HierarchicalControlMode : public ControlMode
+	{
+	public:
+		typedef boost::shared_ptr<HierarchicalControlMode> Ptr;
+		typedef boost::shared_ptr<const HierarchicalControlMode> ConstPtr;
+
+		HierarchicalControlMode();
+		HierarchicalControlMode(const std::string& name);
+		HierarchicalControlMode(const HierarchicalControlMode& cm);
+
+		virtual ~HierarchicalControlMode();
+
+		/**
+		 * @brief Set the nested automaton - its current control mode becomes the initial one
+		 */
+		virtual void setSubAutomaton(const HybridAutomaton::Ptr& sub_automaton);
+		virtual HybridAutomaton::Ptr getSubAutomaton() const;
+
+		const std::string& getInitialControlMode() const;
+
+		/**
+		 * @brief The active mode of the nested automaton
+		 */
+		virtual ControlMode::Ptr getCurrentSubControlMode() const;
+
+		virtual void initialize();
+		virtual void terminate();
+		virtual ::Eigen::MatrixXd step(const double& t);
+		virtual bool tryStep(const double& t, ::Eigen::MatrixXd& control, ErrorRecord& error);
+		virtual void switchControlMode(ControlMode::Ptr otherMode);
+
+		/**
+		 * @brief The ControlSet of the active sub-mode - used by the next mode to take over smoothly
+		 */
+		virtual ControlSet::Ptr getControlSet() const;
+		virtual Controller::ConstPtr getControllerByName(const std::string& name) const;
+
+		virtual DescriptionTreeNode::Ptr serialize(const DescriptionTree::ConstPtr& factory) const;
+		virtual void deserialize(const DescriptionTreeNode::ConstPtr& tree, const System::ConstPtr& system, const HybridAutomaton* ha);
+
+	protected:
+		virtual ControlMode* _doClone() const {
+			return new HierarchicalControlMode(*this);
+		}
+
+		// the nested automaton needs the time to start - it is initialized in the first step after initialize()
+		void _startSubAutomaton(const double& t);
+
+		HybridAutomaton::Ptr _sub_automaton;
+		std::string _initial_control_mode;
+		bool _start_pending;
+	};
+
+}
+
+#endif
@@ -33,6 +33,10 @@
 
 #include "hybrid_automaton/System.h"
 #include "hybrid_automaton/DescriptionTreeNode.h"
+#include "hybrid_automaton/TraceRecorder.h"
+#include "hybrid_automaton/ErrorQueue.h"
+#include "hybrid_automaton/StepResult.h"
+#include "hybrid_automaton/Profiler.h"
 
 #include <string>
 #include <map>
@@ -42,6 +46,7 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/graph/labeled_graph.hpp>
+#include <boost/thread/shared_mutex.hpp>
 
 #include <Eigen/Dense>
 
@@ -51,6 +56,7 @@ namespace ha {
 
 	class HybridAutomaton;
 	typedef boost::shared_ptr<HybridAutomaton> HybridAutomatonPtr;
+	class SupervisionThread;
 	typedef boost::shared_ptr<const HybridAutomaton> HybridAutomatonConstPtr;
 
 	/**
@@ -141,9 +147,146 @@ namespace ha {
          */
 		bool _active;
 
+        /**
+         * @brief true, if the ControlSwitches are evaluated on a separate thread
+         */
+		bool _asynchronous_supervision;
+
+        /**
+         * @brief the thread evaluating the ControlSwitches if _asynchronous_supervision is set - only exists while active
+         */
+		boost::shared_ptr<SupervisionThread> _supervision_thread;
+
+        /**
+         * @brief the run time counters of step() and tryStep() - see HA_PROFILE_SCOPE
+         */
+		ProfileHandle _step_profile;
+
+        /**
+         * @brief optional recorder of the modes, jump condition values and transitions - see setTraceRecorder
+         */
+		TraceRecorder::Ptr _trace_recorder;
+
+        /**
+         * @brief the control mode tryStep() falls back to after a fault - empty if there is none
+         */
+		std::string _safe_control_mode;
+
+        /**
+         * @brief true while the current control mode was entered because of a fault (safe or fallback control mode)
+         */
+		bool _safe_mode_active;
+
+        /**
+         * @brief the last fault in tryStep(), preallocated so that reporting a fault does not allocate
+         */
+		ErrorRecord _last_error;
+
+        /**
+         * @brief optional queue the faults in tryStep() are handed to - see setErrorQueue
+         */
+		ErrorQueue::Ptr _error_queue;
+
+        /**
+         * @brief the number of threads deserialize() creates the control modes on - see setDeserializationThreads
+         */
+		unsigned int _deserialization_threads;
+
+        /**
+         * @brief the indices of the out-going switches of every mode in evaluation order - see _compileTransitionTable
+         */
+		std::vector<std::vector<std::size_t> > _transition_table;
+
+		// sort the out-going switches of every mode by priority into _transition_table - is called by initialize(),
+		// later calls of ControlSwitch::setPriority do not change the table until the next initialize()
+		void _compileTransitionTable();
+
+		// the indices of the out-going switches of \a mode, sorted by descending priority and then insertion order
+		void _getEvaluationOrder(const ModeHandle& mode, std::vector<std::size_t>& order) const;
+
+		// the compiled evaluation order of \a mode - NULL if the switches of the mode changed after initialize()
+		const std::vector<std::size_t>* _getCompiledEvaluationOrder(const ModeHandle& mode) const;
+
+		// record the values of the jump conditions that were evaluated by control_switch->isActive()
+		void _traceControlSwitch(const ControlSwitch::Ptr& control_switch, const double& t);
+
 		// helper function -- not virtual!
 		void _activateCurrentControlMode(const double& t);
 
+		// switch to the target of the active switch the supervision thread found and hand it the current mode
+		void _applySupervisionResult(const double& t);
+
+		// evaluate the due out-going switches of the current mode and switch to the target of the first active one
+		void _superviseCurrentControlMode(const double& t);
+
+		// like _superviseCurrentControlMode, but returns false and fills \a error if the evaluation failed
+		bool _trySuperviseCurrentControlMode(const double& t, ErrorRecord& error);
+
+		// returns true and the index of the first active out-going switch of \a mode - throws if the evaluation failed
+		bool _findActiveControlSwitch(const ModeHandle& mode, const double& t, std::size_t& out_edge_index);
+
+		// evaluates the due out-going switches of \a mode with tryStep/tryIsActive - sets \a found and the index
+		// of the first active one, returns false and fills \a error if the evaluation failed
+		bool _tryFindActiveControlSwitch(const ModeHandle& mode, const double& t, bool& found, std::size_t& out_edge_index, ErrorRecord& error);
+
+		// supervise and step the current control mode - false if a fault was written to _last_error
+		bool _tryStepCurrentControlMode(const double& t, ::Eigen::MatrixXd& control, bool supervise);
+
+		// time stamp _last_error and hand it to the error queue
+		void _reportError(const double& t);
+
+		// step the current control mode and check its watchdog - false if a fault was written to _last_error
+		bool _tryStepControlMode(const double& t, ::Eigen::MatrixXd& control);
+
+		// switch to the fallback of the current control mode's watchdog, or the safe control mode, after a fault
+		// - false if there is none or the switch failed
+		bool _enterFallbackControlMode(const double& t);
+
+		// hand the sensors of the out-going switches to the watchdogs of the control modes
+		void _bindWatchdogs();
+
+		// leave the current control mode through \a switch_handle and activate its target
+		void _switchControlMode(const SwitchHandle& switch_handle, const double& t);
+
+		// leave the current control mode through its out-going switch number \a out_edge_index
+		void _switchControlMode(const ModeHandle& mode, std::size_t out_edge_index, const double& t);
+
+		// set the attributes of the HybridAutomaton element
+		void _serializeAttributes(const DescriptionTreeNode::Ptr& tree_node) const;
+
+		// the steps of deserialize - also called by HybridAutomatonXMLReader for one element at a time
+		void _beginDeserialization(const DescriptionTreeNode::ConstPtr& tree);
+		void _deserializeControlMode(const DescriptionTreeNode::ConstPtr& node, const System::ConstPtr& system);
+		ControlMode::Ptr _createControlMode(const DescriptionTreeNode::ConstPtr& node, const System::ConstPtr& system) const;
+		// create the control modes of \a nodes - on _deserialization_threads threads
+		void _createControlModes(const std::vector<DescriptionTreeNode::ConstPtr>& nodes, const System::ConstPtr& system, std::vector<ControlMode::Ptr>& modes) const;
+		void _deserializeControlSwitch(const DescriptionTreeNode::ConstPtr& node, const System::ConstPtr& system);
+		// set the current and safe control mode given by the attributes of \a tree and validate the automaton
+		void _finishDeserialization(const DescriptionTreeNode::ConstPtr& tree);
+
+		friend class SupervisionThread;
+		friend class HybridAutomatonXMLReader;
+
+        /**
+         * @brief filtered sensors created during deserialization, keyed by their description - see createSensor
+         */
+		mutable std::map<std::string, Sensor::Ptr> _shared_sensors;
+
+        /**
+         * @brief unused copies of the controllers created during deserialization, keyed by their description -
+         * identical descriptions are cloned from them instead of deserialized again, see createController
+         */
+		mutable std::map<std::string, Controller::ConstPtr> _controller_prototypes;
+
+		// create the controller of type \a ctrl_type from \a node with its registered creator
+		static Controller::Ptr _deserializeController(const DescriptionTreeNode::ConstPtr& node, const std::string& ctrl_type, const System::ConstPtr& system, const HybridAutomaton* ha);
+
+		// write a canonical string representation of \a node and its children
+		static void _describeNode(const DescriptionTreeNode::ConstPtr& node, std::ostream& out);
+
+		// like _describeNode, but without the type of \a node itself
+		static void _describeNodeContent(const DescriptionTreeNode::ConstPtr& node, std::ostream& out);
+
 	private:  
 
 		// see http://stackoverflow.com/questions/8057682/accessing-a-static-map-from-a-static-member-function-segmentation-fault-c
@@ -162,6 +305,12 @@ namespace ha {
 			return sensor_type_map; 
 		}
 
+		// guards the type maps, which are read by the deserialization threads
+		static boost::shared_mutex & getTypeMapMutex() {
+			static boost::shared_mutex type_map_mutex;
+			return type_map_mutex;
+		}
+
         bool _deserialize_default_entities; /**< if true deserialization will not try to find the actual controller etc., but deserialize them raw */
 
 	public:
@@ -172,6 +321,9 @@ namespace ha {
          * @brief Instantiate a Controller of given type
 		 *
          * In order to work you must register your Controller properly
+		 *
+		 * Within one deserialization of \a ha, identical descriptions are only deserialized once and cloned for
+		 * the other control modes - clone() of your Controller must give the state deserialize() leaves it in.
 		 */
 		static Controller::Ptr createController(const DescriptionTreeNode::ConstPtr& node, const System::ConstPtr& system, const HybridAutomaton* ha);
 
@@ -186,6 +338,9 @@ namespace ha {
          * @brief Instantiate a Sensor of given type
          *
          * In order to work you must register your sensor properly
+         *
+         * If the description contains "Filter" children, the sensor is wrapped into a FilteredSensor.
+         * Filtered sensors with identical descriptions are shared within \a ha.
          */
 		static Sensor::Ptr createSensor(const DescriptionTreeNode::ConstPtr& node, const System::ConstPtr& system, const HybridAutomaton* ha);
 
@@ -286,9 +441,89 @@ namespace ha {
          *
          * @param t the current time of your system
          * @return the control output to your hardware (usually a dim x 1 torque vector)
+         *
+         * If the current ControlMode has a Watchdog that fires, the automaton switches to its fallback
+         * ControlMode, which computes the output of this cycle.
          */
 		::Eigen::MatrixXd step(const double& t);
 
+        /**
+         * @brief Like step(), but reports faults with a status instead of throwing
+         *
+         * Faults of the supervision, the JumpConditions and the ControlMode are written to a preallocated
+         * record (see getLastError) and handed to the ErrorQueue if one is set, so a fault does not allocate,
+         * block or unwind the stack in the control loop. Errors thrown by user code (e.g. Controllers or
+         * Systems) are caught here as a last resort.
+         *
+         * After a fault the automaton switches to the fallback of the current ControlMode's Watchdog or to the
+         * safe control mode (see setSafeControlMode), which computes \a control in the same cycle and is
+         * supervised as usual from then on.
+         *
+         * @param t the current time of your system
+         * @param control the control output to your hardware - not valid if the step failed
+         */
+		StepResult tryStep(const double& t, ::Eigen::MatrixXd& control);
+
+        /**
+         * @brief The ControlMode tryStep() switches to after a fault - an empty name disables the fallback
+         */
+		void setSafeControlMode(const std::string& control_mode);
+		const std::string& getSafeControlMode() const;
+
+        /**
+         * @brief Hand the faults in tryStep() to \a queue (or stop if NULL)
+         *
+         * Start the logging of the queue with ErrorQueue::startLogging or pop the records yourself.
+         */
+		void setErrorQueue(const ErrorQueue::Ptr& queue);
+		ErrorQueue::Ptr getErrorQueue() const;
+
+        /**
+         * @brief The last fault in tryStep()
+         */
+		const ErrorRecord& getLastError() const;
+
+        /**
+         * @brief If set to true the ControlSwitches are evaluated on a separate, non-real-time thread
+         *
+         * step() then only computes the control output and hands the current time over to the supervision
+         * thread. Transitions found by the supervision thread are applied in the next call to step().
+         * Use ControlSwitch::setEvaluationRate to evaluate individual switches at a lower rate in both modes.
+         *
+         * Must be set before initialize() is called.
+         */
+		void setAsynchronousSupervision(bool b);
+		bool getAsynchronousSupervision() const;
+
+        /**
+         * @brief Create the ControlModes in deserialize() on \a number_of_threads threads (0: one per core)
+         *
+         * The modes (with their ControlSets, Controllers and Sensors) are independent of each other and are
+         * created in parallel, then the ControlSwitches are added serially. Registered Controller, ControlSet
+         * and Sensor types must be safe to deserialize concurrently. The default is 1 (serial).
+         */
+		void setDeserializationThreads(unsigned int number_of_threads);
+		unsigned int getDeserializationThreads() const;
+
+        /**
+         * @brief Record the execution of this HybridAutomaton with \a recorder (or stop recording if NULL)
+         *
+         * Every step records the active control mode, the criterion values of the evaluated jump conditions
+         * and the transitions. Start the recorder with TraceRecorder::start.
+         */
+		void setTraceRecorder(const TraceRecorder::Ptr& recorder);
+		TraceRecorder::Ptr getTraceRecorder() const;
+
+        /**
+         * @brief Write how often each ControlSwitch was evaluated and how often it fired to \a out
+         *
+         * The switches are listed per ControlMode in the order they are evaluated (see ControlSwitch::setPriority).
+         * Switches that are evaluated often but rarely fire while later switches fire often are candidates for a
+         * lower priority.
+         */
+		void reportControlSwitchStatistics(std::ostream& out = std::cout) const;
+		void resetControlSwitchStatistics();
+
 		void setName(const std::string& name);
 		const std::string getName() const;
 
@@ -311,9 +546,20 @@ namespace ha {
          */
 		virtual DescriptionTreeNode::Ptr serialize(const DescriptionTree::ConstPtr& factory) const;
 
+        /**
+         * @brief write this HybridAutomaton as XML to \a out
+         *
+         * Writes the same document as serialize() into a DescriptionTreeXML, but streams every ControlMode and
+         * ControlSwitch as soon as it is serialized instead of building the whole tree first.
+         */
+		virtual void serialize(std::ostream& out) const;
+
         /**
          * @brief write the contents of DescriptionTreeNode into this HybridAutomaton.
          *
+         * The automaton is validated afterwards; validation errors are thrown, warnings are dropped - call
+         * validate() to get them.
+         *
          * @param tree the DescriptionTreeNode containing the parameters
          * @param system a System pointer to the currently active robot
          */
@@ -326,6 +572,16 @@ namespace ha {
          */
 		virtual void deserialize(const DescriptionTreeNode::ConstPtr& tree, const System::ConstPtr& system, const HybridAutomaton* ha);
 
+        /**
+         * @brief Check the automaton before it is executed - problems are added to \a report
+         *
+         * Checks that the sensors, goals, weights and criteria of all JumpConditions fit together (using
+         * the dimensions the sensors infer from the System) and reports ControlModes that cannot be reached
+         * from the current control mode or cannot be left. JumpConditions that passed the validation skip
+         * their dimension checks in the control loop.
+         */
+		virtual void validate(ValidationReport& report);
+
         /**
          * @brief returns if ControlMode \a control_mode is part of this HybridAutomaton
          */
@@ -401,9 +657,8 @@ namespace ha {
 		}
 
 	protected:
-		virtual HybridAutomaton* _doClone() const {
-			return new HybridAutomaton(*this);
-		}
+		// a deep copy - the clone has its own control modes, switches, jump conditions and sensors
+		virtual HybridAutomaton* _doClone() const;
 	};
 
 }
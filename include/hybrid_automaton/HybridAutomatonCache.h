@@ -0,0 +1,144 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef HYBRID_AUTOMATON_CACHE_H_
+#define HYBRID_AUTOMATON_CACHE_H_
+
+#include "hybrid_automaton/HybridAutomaton.h"
+
+#include <boost/cstdint.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <list>
+#include <map>
+#include <string>
+
+namespace ha {
+
+	class HybridAutomatonCache;
+	typedef boost::shared_ptr<HybridAutomatonCache> HybridAutomatonCachePtr;
+	typedef boost::shared_ptr<const HybridAutomatonCache> HybridAutomatonCacheConstPtr;
+
+	/**
+	 * @brief Caches deserialized HybridAutomata by their XML description
+	 *
+	 * The first get() of a description deserializes it with a HybridAutomatonXMLReader into a prototype,
+	 * which is never handed out. Every get() returns a clone of the prototype, so executing the same
+	 * description again skips parsing and the creation of controllers, control sets and sensors.
+	 *
+	 * The descriptions are keyed by a 64 bit FNV-1a hash and compared on a hit. The least recently used
+	 * prototypes are evicted when the estimated memory of all prototypes exceeds the budget.
+	 * All methods may be called from several threads.
+	 */
+	class HybridAutomatonCache
+	{
+	public:
+		typedef boost::shared_ptr<HybridAutomatonCache> Ptr;
+		typedef boost::shared_ptr<const HybridAutomatonCache> ConstPtr;
+
+		struct Statistics
+		{
+			Statistics() : hits(0), misses(0), evictions(0), entries(0), memory(0) {}
+
+			std::size_t hits;
+			std::size_t misses;
+			std::size_t evictions;
+			std::size_t entries;
+
+			// the estimated memory of the cached prototypes in bytes
+			std::size_t memory;
+		};
+
+		HybridAutomatonCache(const System::ConstPtr& system, std::size_t memory_budget = 64 * 1024 * 1024);
+
+		virtual ~HybridAutomatonCache();
+
+		/**
+		 * @brief A new automaton deserialized from the XML \a description
+		 *
+		 * @throws Error if the description cannot be deserialized - failures are not cached
+		 */
+		HybridAutomaton::Ptr get(const std::string& description);
+
+		/**
+		 * @brief Deserialize new descriptions with default entities - see HybridAutomaton::setDeserializeDefaultEntities
+		 *
+		 * Clears the cache.
+		 */
+		void setDeserializeDefaultEntities(bool b);
+		bool getDeserializeDefaultEntities() const;
+
+		/**
+		 * @brief The memory the cached prototypes may use - evicts prototypes if necessary
+		 */
+		void setMemoryBudget(std::size_t memory_budget);
+		std::size_t getMemoryBudget() const;
+
+		void clear();
+
+		Statistics getStatistics() const;
+
+		/**
+		 * @brief The key of \a description
+		 */
+		static boost::uint64_t hash(const std::string& description);
+
+	protected:
+		struct Entry
+		{
+			boost::uint64_t hash;
+			std::string description;
+			HybridAutomaton::ConstPtr prototype;
+			std::size_t memory;
+		};
+
+		// most recently used first
+		typedef std::list<Entry> EntryList;
+
+		// the stored description plus an object graph of roughly the same size
+		static std::size_t _estimateMemory(const std::string& description);
+
+		// evict the least recently used entries until the budget is met - expects _mutex to be locked
+		void _evict();
+
+		System::ConstPtr _system;
+		bool _deserialize_default_entities;
+		std::size_t _memory_budget;
+
+		EntryList _entries;
+		std::map<boost::uint64_t, EntryList::iterator> _index;
+		Statistics _statistics;
+
+		mutable boost::mutex _mutex;
+
+	private:
+		HybridAutomatonCache(const HybridAutomatonCache&);
+		HybridAutomatonCache& operator=(const HybridAutomatonCache&);
+	};
+
+}
+
+#endif
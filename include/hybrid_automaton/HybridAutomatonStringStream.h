@@ -28,6 +28,8 @@
 
 // FIXME remove
 #include <iostream>
+#include <sstream>
+#include <string>
 #include <Eigen/Dense>
 
 namespace ha {
@@ -86,6 +88,17 @@ class ha_stringstream
 
 	template <>
     ha_stringstream& ha_stringstream::operator>>(Eigen::MatrixXd& matrix);
+
+	/**
+	* @brief Append the text ha_stringstream writes for \a value to \a out - without constructing a stream
+	*
+	* Used by the serialization, which formats a handful of values per entity.
+	*/
+	void ha_append(std::string& out, const std::string& value);
+	void ha_append(std::string& out, const double& value);
+	void ha_append(std::string& out, const int& value);
+	void ha_append(std::string& out, const bool& value);
+	void ha_append(std::string& out, const ::Eigen::MatrixXd& value);
 }
 
 #endif
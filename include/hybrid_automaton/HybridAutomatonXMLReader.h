@@ -0,0 +1,119 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef HYBRID_AUTOMATON_XML_READER_H_
+#define HYBRID_AUTOMATON_XML_READER_H_
+
+#include "hybrid_automaton/HybridAutomaton.h"
+#include "hybrid_automaton/DescriptionTreeNodeStream.h"
+#include "hybrid_automaton/XMLStreamParser.h"
+
+#include <boost/shared_ptr.hpp>
+
+#include <istream>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace ha {
+
+	class HybridAutomatonXMLReader;
+	typedef boost::shared_ptr<HybridAutomatonXMLReader> HybridAutomatonXMLReaderPtr;
+	typedef boost::shared_ptr<const HybridAutomatonXMLReader> HybridAutomatonXMLReaderConstPtr;
+
+	/**
+	 * @brief Deserializes a HybridAutomaton from XML in one pass, without building a document tree
+	 *
+	 * The document is parsed with an XMLStreamParser. Each top-level ControlMode and ControlSwitch element is
+	 * collected into a small DescriptionTreeNodeStream subtree, deserialized as soon as it is closed and then
+	 * dropped, so the memory needed does not grow with the size of the document. The result is the same as
+	 * HybridAutomaton::deserialize on a DescriptionTreeXML of the document.
+	 *
+	 * A ControlSwitch that refers to a ControlMode further down in the document is deferred and resolved
+	 * after the last element - as are the later switches of the same source mode, so that the order of the
+	 * out-going switches of every mode is the document order.
+	 */
+	class HybridAutomatonXMLReader : protected XMLStreamHandler
+	{
+	public:
+		typedef boost::shared_ptr<HybridAutomatonXMLReader> Ptr;
+		typedef boost::shared_ptr<const HybridAutomatonXMLReader> ConstPtr;
+
+		HybridAutomatonXMLReader(const System::ConstPtr& system);
+
+		virtual ~HybridAutomatonXMLReader();
+
+		/**
+		 * @brief Deserializes the automaton in \a input into \a ha
+		 *
+		 * @throws Error on XML syntax errors and everything HybridAutomaton::deserialize throws
+		 */
+		void read(std::istream& input, HybridAutomaton& ha);
+
+		/**
+		 * @brief Deserializes the automaton in the string \a input into \a ha
+		 */
+		void read(const std::string& input, HybridAutomaton& ha);
+
+		/**
+		 * @brief The number of ControlSwitches the last read() had to defer until the end of the document
+		 */
+		std::size_t getNumberOfDeferredControlSwitches() const;
+
+	protected:
+		virtual void startElement(const std::string& name, const AttributeList& attributes);
+
+		virtual void endElement(const std::string& name);
+
+		// deserialize the top-level element \a node of the automaton - or defer it
+		void _deserializeElement(const DescriptionTreeNodeStream::Ptr& node);
+
+		// deserialize the deferred switches, set the current mode and validate
+		void _finish();
+
+		System::ConstPtr _system;
+
+		XMLStreamParser _parser;
+
+		HybridAutomaton* _ha;
+
+		// the attributes of the HybridAutomaton element - without children
+		DescriptionTreeNodeStream::Ptr _root;
+
+		// the open elements below the root, the first one is the top-level element being collected
+		std::vector<DescriptionTreeNodeStream::Ptr> _open_nodes;
+
+		std::size_t _number_of_control_modes;
+
+		std::vector<DescriptionTreeNode::ConstPtr> _deferred_switches;
+
+		// source modes of the deferred switches
+		std::set<std::string> _deferred_sources;
+
+		std::size_t _number_of_deferred_switches;
+	};
+}
+
+#endif
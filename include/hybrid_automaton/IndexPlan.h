@@ -0,0 +1,107 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef HYBRID_AUTOMATON_INDEX_PLAN_H_
+#define HYBRID_AUTOMATON_INDEX_PLAN_H_
+
+#include <Eigen/Dense>
+
+#include <string>
+#include <vector>
+
+namespace ha {
+
+    /**
+     * @brief A precomputed gather of selected entries of a vector
+     *
+     * The index vector is split once into runs of consecutive indices, so that gather() copies contiguous
+     * blocks instead of single elements. Used by the subjoint sensors to select joints from the full
+     * joint vector.
+     */
+	class IndexPlan
+	{
+	public:
+
+		IndexPlan();
+
+		IndexPlan(const std::vector<int>& index);
+
+		virtual ~IndexPlan();
+
+		void setIndex(const std::vector<int>& index);
+
+		/**
+		 * @brief Set the index from a column or row vector of integer values
+		 *
+		 * Throws if a value is not an integer.
+		 */
+		void setIndex(const ::Eigen::MatrixXd& index);
+
+		const std::vector<int>& getIndex() const;
+
+		::Eigen::MatrixXd getIndexMatrix() const;
+
+		std::size_t size() const;
+
+		std::size_t getNumberOfRuns() const;
+
+		/**
+		 * @brief Throws if an index is out of [0, dimension) or occurs twice
+		 */
+		void validate(int dimension) const;
+
+		/**
+		 * @brief Writes in(index[0]), ..., in(index[n]) into \a out
+		 *
+		 * \a out is only resized if it does not have the size of the index yet.
+		 */
+		void gather(const ::Eigen::MatrixXd& in, ::Eigen::MatrixXd& out) const;
+
+		/**
+		 * @brief Adds in(0), ..., in(n) to out(index[0]), ..., out(index[n]) - the inverse of gather()
+		 *
+		 * \a out must be large enough for all indices.
+		 */
+		void scatterAdd(const ::Eigen::MatrixXd& in, ::Eigen::MatrixXd& out) const;
+
+	protected:
+
+		struct Run
+		{
+			int source;
+			int target;
+			int length;
+		};
+
+		void _computeRuns();
+
+		std::vector<int> _index;
+
+		std::vector<Run> _runs;
+	};
+
+}
+
+#endif
@@ -63,6 +63,8 @@ namespace ha {
          */
 		virtual ::Eigen::MatrixXd getCurrentValue() const;
 
+		virtual bool getDimensions(int& rows, int& cols) const;
+
 		virtual DescriptionTreeNode::Ptr serialize(const DescriptionTree::ConstPtr& factory) const;
 
 		virtual void deserialize(const DescriptionTreeNode::ConstPtr& tree, const System::ConstPtr& system, const HybridAutomaton* ha);
@@ -30,7 +30,11 @@
 #include "hybrid_automaton/error_handling.h"
 
 #include "hybrid_automaton/Sensor.h"
+#include "hybrid_automaton/SensorFilter.h"
+#include "hybrid_automaton/ValidationReport.h"
+#include "hybrid_automaton/ErrorRecord.h"
 #include "hybrid_automaton/Controller.h"
+#include "hybrid_automaton/Profiler.h"
 
 
 #include <boost/shared_ptr.hpp>
@@ -40,6 +44,8 @@ namespace ha {
 	class JumpCondition;
 	typedef boost::shared_ptr<JumpCondition> JumpConditionPtr;
 
+	class JumpCriterionEvaluator;
+
 	/**
 	 * @brief A JumpCondition is a necessary condition for a ControlSwitch to become active.
 	 *
@@ -85,6 +91,19 @@ namespace ha {
          */
 		enum GoalSource {CONSTANT, CONTROLLER, ROSTOPIC, ROSTOPIC_TF}; 
 
+        /**
+         * @brief A filter that is applied to the sensor value before comparing it against the goal
+         *
+         * NO_FILTER: the raw sensor value is used
+         *
+         * FILTER_MOVING_AVERAGE: the mean of the last \a _filter_window sensor values (element-wise)
+         *
+         * FILTER_EXPONENTIAL: exponential smoothing with factor \a _filter_alpha (element-wise)
+         *
+         * The filters are the MovingAverageFilter and ExponentialFilter stages of the sensor filter pipeline.
+         */
+		enum FilterType {NO_FILTER, FILTER_MOVING_AVERAGE, FILTER_EXPONENTIAL};
+
 		typedef boost::shared_ptr<JumpCondition> Ptr;
 
 		JumpCondition();
@@ -116,6 +135,15 @@ namespace ha {
         */
 		virtual void step(const double& t);
 
+        /**
+        * @brief Like step(), but returns false and fills \a error instead of throwing - for the real-time path
+        *
+        * Used by HybridAutomaton::tryStep. A JumpCondition reports its errors without throwing; for subclasses
+        * the default calls the virtual step() and turns its exceptions into \a error, so they only need to
+        * override step().
+        */
+		virtual bool tryStep(const double& t, ErrorRecord& error);
+
         /**
         * @brief Computes ||goal - sensor||_N < epsilon in the given norm N. Is called from ControlSwitch, once in a control cycle.
         *
@@ -127,6 +155,13 @@ namespace ha {
         */
 		virtual bool isActive() const;
 
+        /**
+        * @brief Like isActive(), but returns false and fills \a error instead of throwing - for the real-time path
+        *
+        * Like tryStep(), subclasses that only override isActive() are called through it.
+        */
+		virtual bool tryIsActive(bool& active, ErrorRecord& error) const;
+
 		/**
 		 * @brief Set a controller goal
 		 * 
@@ -134,6 +169,19 @@ namespace ha {
 		 * This allows to match the convergence of a controller with the activation of a jump condition.
 		 */
 		virtual void setControllerGoal(const Controller::ConstPtr& controller);
+
+		/**
+		 * @brief The controller whose goal is the goal of this condition - null if it has no controller goal
+		 */
+		virtual Controller::ConstPtr getGoalController() const;
+
+		/**
+		 * @brief Replace the sensor and the goal controller by copies of them, e.g. in a cloned HybridAutomaton
+		 *
+		 * The copies have the dimensions of the originals, so a validated condition stays validated.
+		 * An empty \a controller keeps the current goal.
+		 */
+		virtual void rebind(const Sensor::Ptr& sensor, const Controller::ConstPtr& controller);
 		
 		/**
 		 * @brief Set a constant goal
@@ -217,12 +265,91 @@ namespace ha {
 		virtual void setEpsilon(double epsilon);
 		virtual double getEpsilon() const;
 
+		/**
+		 * @brief The criterion value of the last evaluation - NaN if it could not be computed (inactive sensor, no goal)
+		 *
+		 * With temporal qualifiers this is the value computed in the last step().
+		 */
+		virtual double getLastCriterionValue() const;
+
+		/**
+		 * @brief The result of the last call to isActive()
+		 */
+		virtual bool wasLastEvaluationActive() const;
+
+		/**
+		 * @brief True if the last evaluation of the ControlSwitch called tryIsActive() on this condition
+		 *
+		 * Expressions short-circuit, e.g. the second condition of "0 || 1" is skipped if the first one is active.
+		 * The criterion value and result of a skipped condition are the ones of an earlier tick.
+		 */
+		virtual bool wasEvaluated() const;
+
+		/**
+		 * @brief Called by the ControlSwitch before it evaluates its conditions - see wasEvaluated
+		 */
+		virtual void clearEvaluated();
+
+		/**
+		 * @brief The condition only becomes active after the criterion was met in \a ticks consecutive evaluations
+		 *
+		 * Debounces noisy sensors. A value of 0 or 1 disables the check.
+		 */
+		virtual void setHoldTicks(int ticks);
+		virtual int getHoldTicks() const;
+
+		/**
+		 * @brief The condition only becomes active after the criterion was met continuously for \a time seconds
+		 */
+		virtual void setHoldTime(double time);
+		virtual double getHoldTime() const;
+
+		/**
+		 * @brief Set a hysteresis band around epsilon
+		 *
+		 * Once the criterion is met, it stays met until the distance exceeds epsilon + hysteresis
+		 * (or falls below epsilon - hysteresis if the condition is negated).
+		 */
+		virtual void setHysteresis(double hysteresis);
+		virtual double getHysteresis() const;
+
+		/**
+		 * @brief Compare the mean of the last \a window sensor values against the goal
+		 */
+		virtual void setMovingAverageFilter(int window);
+
+		/**
+		 * @brief Compare the exponentially smoothed sensor value against the goal: y = alpha * x + (1 - alpha) * y
+		 */
+		virtual void setExponentialFilter(double alpha);
+
+		virtual void removeFilter();
+		virtual FilterType getFilterType() const;
+
 		/**
 		* @brief Set the name of the mode this jumpCondition emanates from. This function needs to be called
 		* before deserializing! 
 		*/
 		virtual void setSourceModeName(const std::string& sourceModeName);
 
+		/**
+		 * @brief Check that sensor, goal, norm weights and jump criterion fit together - problems are added to \a report
+		 *
+		 * If the dimensions of the sensor and a CONSTANT goal are known and compatible, the dimension checks
+		 * are skipped in isActive(). Goals of controllers and ROS topics are only known at run time, so
+		 * conditions with such goals keep checking the dimensions on every tick. Changing the sensor, goal or criterion requires a new validation.
+		 * For common sizes (e.g. 1x1, 6x1, 4x4) a JumpCriterionEvaluator specialized for the size and
+		 * criterion is selected as well.
+		 */
+		virtual void validate(ValidationReport& report, const std::string& origin);
+
+		/**
+		 * @brief True if the last validate() selected a specialized JumpCriterionEvaluator
+		 */
+		virtual bool hasSpecializedCriterion() const;
+
+		virtual bool areDimensionsValidated() const;
+
 		virtual DescriptionTreeNode::Ptr serialize(const DescriptionTree::ConstPtr& factory) const;
 
 		virtual void deserialize(const DescriptionTreeNode::ConstPtr& tree, const System::ConstPtr& system, const HybridAutomaton* ha);
@@ -257,7 +384,67 @@ namespace ha {
 
         bool _negate;
 
-		double _computeJumpCriterion(const ::Eigen::MatrixXd& x, const ::Eigen::MatrixXd& y) const;
+		// temporal qualifiers -- see setHoldTicks, setHoldTime, setHysteresis
+		int _hold_ticks;
+		double _hold_time;
+		double _hysteresis;
+
+		FilterType _filter_type;
+		int _filter_window;
+		double _filter_alpha;
+
+		// state of the temporal qualifiers, updated in step()
+		bool _criterion_met;
+		bool _qualified_active;
+		int _hold_ticks_count;
+		double _hold_start_time;
+
+		// set by validate() if sensor, CONSTANT goal and criterion are known to fit - disables the per tick dimension checks.
+		// Never set for goals of controllers or ROS topics, their dimensions are only known at run time.
+		bool _dimensions_validated;
+
+		// selected by validate() for the validated dimensions - only used while _dimensions_validated is set
+		boost::shared_ptr<const JumpCriterionEvaluator> _criterion_evaluator;
+
+		// result of the last evaluation -- see getLastCriterionValue, wasLastEvaluationActive
+		mutable double _last_criterion_value;
+		mutable bool _last_evaluation_active;
+
+		// set by tryIsActive(), cleared by the ControlSwitch before every evaluation -- see wasEvaluated
+		mutable bool _evaluated;
+
+		// throttles the message about a missing goal - per instance, regions and supervision evaluate on other threads
+		mutable unsigned int _missing_goal_count;
+
+		// run time counters of isActive() and of reading the sensor - see HA_PROFILE_SCOPE
+		mutable ProfileHandle _is_active_profile;
+		mutable ProfileHandle _sensor_profile;
+
+		// the stage that implements _filter_type, created and sized in initialize() - seeded with the first sensor
+		// value that is evaluated
+		SensorFilter::Ptr _filter;
+		bool _filter_seeded;
+		::Eigen::MatrixXd _filtered_value;
+
+		bool _hasTemporalQualifiers() const;
+
+		// the implementation of step() and isActive() - false and \a error filled on failure, step() and
+		// isActive() only turn the error into an exception
+		bool _step(const double& t, ErrorRecord& error);
+		bool _isActive(bool& active, ErrorRecord& error) const;
+
+		// fetch current sensor value (absolute or relative) and goal and check their dimensions - false on error
+		bool _getCurrentAndGoal(::Eigen::MatrixXd& current, ::Eigen::MatrixXd& desired, bool& has_goal, ErrorRecord& error) const;
+
+		// compare the criterion to epsilon - the hysteresis band is applied if the criterion was met before
+		bool _compareToEpsilon(double criterion, bool was_met) const;
+
+		bool _updateTemporalQualifiers(const double& t, ErrorRecord& error);
+
+		// NULL on error
+		const ::Eigen::MatrixXd* _filterSensorValue(const ::Eigen::MatrixXd& current, const double& t, ErrorRecord& error);
+
+		bool _computeJumpCriterion(const ::Eigen::MatrixXd& x, const ::Eigen::MatrixXd& y, double& criterion, ErrorRecord& error) const;
 
 		virtual JumpCondition* _doClone() const
 		{
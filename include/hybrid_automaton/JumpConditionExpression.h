@@ -0,0 +1,136 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef HYBRID_AUTOMATON_JUMP_CONDITION_EXPRESSION_H
+#define HYBRID_AUTOMATON_JUMP_CONDITION_EXPRESSION_H
+
+#include "hybrid_automaton/JumpCondition.h"
+#include "hybrid_automaton/ErrorRecord.h"
+
+#include <boost/shared_ptr.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ha {
+
+	/**
+	 * @brief A boolean expression over the JumpConditions of a ControlSwitch
+	 *
+	 * The JumpConditions are referred to by their index in the ControlSwitch, e.g.
+	 *   "0 and (1 or not 2)"   or   "atleast(2, 0, 1, 3)"
+	 * The operators can also be written as &, | and !. "and" binds stronger than "or".
+	 *
+	 * compile() translates the expression into a short-circuiting stack program. Subexpressions that
+	 * occur more than once and all JumpConditions are evaluated at most once per evaluation. All buffers
+	 * are allocated in compile() - evaluate() does not allocate.
+	 *
+	 * evaluate() works in these buffers, so it is not re-entrant: an expression must only be evaluated by one
+	 * thread at a time. With HybridAutomaton::setAsynchronousSupervision the ControlSwitches are evaluated by
+	 * the supervision thread only - do not evaluate them from the control loop as well.
+	 */
+	class JumpConditionExpression
+	{
+	public:
+		JumpConditionExpression();
+
+		/**
+		 * @brief Parse and compile \a expression - throws on syntax errors and keeps the previous expression
+		 *
+		 * An empty expression clears the program.
+		 */
+		void compile(const std::string& expression);
+
+		void swap(JumpConditionExpression& other);
+
+		const std::string& getExpression() const;
+
+		bool empty() const;
+
+		/**
+		 * @brief The number of JumpConditions the expression needs - the highest index plus one
+		 */
+		std::size_t getNumberOfConditions() const;
+
+		/**
+		 * @brief True if the JumpCondition with \a index appears in the expression
+		 */
+		bool usesCondition(std::size_t index) const;
+
+		/**
+		 * @brief The number of instructions of the compiled program
+		 */
+		std::size_t getNumberOfInstructions() const;
+
+		/**
+		 * @brief Evaluate the expression with the values of \a conditions - false and \a error on failure
+		 *
+		 * Not re-entrant - see the class description.
+		 */
+		bool evaluate(const std::vector<JumpConditionPtr>& conditions, bool& active, ErrorRecord& error) const;
+
+	protected:
+		enum Opcode {
+			OP_CONDITION,		// push the (memoized) value of JumpCondition argument
+			OP_CONSTANT,		// push argument
+			OP_NOT,				// negate the top
+			OP_AND,				// keep false and jump to target, otherwise pop
+			OP_OR,				// keep true and jump to target, otherwise pop
+			OP_AT_LEAST,		// add the top to the count below it - jump to target once the result (count >= argument) is decided
+			OP_LOAD_SHARED,		// push the shared result argument and jump to target if it was computed already
+			OP_STORE_SHARED		// store the top as shared result argument
+		};
+
+		struct Node;
+		typedef boost::shared_ptr<Node> NodePtr;
+		class Parser;
+
+		struct Instruction
+		{
+			Opcode opcode;
+			int argument;
+			int remaining;		// OP_AT_LEAST: operands after this one
+			int target;
+		};
+
+		// canonical text of every subexpression - identical ones share their result if they occur more than once
+		static void _countSubexpressions(const NodePtr& node, std::map<std::string, int>& occurrences);
+		void _emit(const NodePtr& node, const std::map<std::string, int>& occurrences, std::map<std::string, int>& shared_slots);
+		void _emitOperator(const NodePtr& node, const std::map<std::string, int>& occurrences, std::map<std::string, int>& shared_slots);
+
+		std::string _expression;
+		std::vector<Instruction> _program;
+		std::vector<bool> _used_conditions;
+
+		// evaluation state, sized by compile()
+		mutable std::vector<int> _stack;
+		mutable std::vector<signed char> _condition_results;
+		mutable std::vector<signed char> _shared_results;
+	};
+
+}
+
+#endif
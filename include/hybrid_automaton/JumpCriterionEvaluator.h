@@ -0,0 +1,72 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef HYBRID_AUTOMATON_JUMP_CRITERION_EVALUATOR_H
+#define HYBRID_AUTOMATON_JUMP_CRITERION_EVALUATOR_H
+
+#include "hybrid_automaton/JumpCondition.h"
+
+#include <boost/shared_ptr.hpp>
+
+namespace ha {
+
+	/**
+	 * @brief Computes the jump criterion of a JumpCondition for one criterion and one size of the sensor value
+	 *
+	 * JumpCondition::validate() selects an evaluator once the dimensions of sensor and goal are known.
+	 * The evaluators are instantiated for fixed-size matrices (1x1 clocks, 3x1 positions, 6x1 wrenches,
+	 * 7x1 joint configurations, 3x3 rotations, 4x4 poses) with the norm weights applied at construction,
+	 * so isActive() neither dispatches on the criterion nor allocates a weight matrix. The current value
+	 * and the goal are still read as dynamic matrices from the Sensor and the goal source. Other sizes use
+	 * the generic implementation in JumpCondition.
+	 *
+	 * Evaluators have no state and can be shared between copies of a JumpCondition.
+	 */
+	class JumpCriterionEvaluator
+	{
+	public:
+		typedef boost::shared_ptr<JumpCriterionEvaluator> Ptr;
+		typedef boost::shared_ptr<const JumpCriterionEvaluator> ConstPtr;
+
+		virtual ~JumpCriterionEvaluator();
+
+		/**
+		 * @brief The evaluator for \a criterion on \a rows x \a cols values - NULL if there is no specialization
+		 *
+		 * \a weights are the norm weights of the JumpCondition and must have been validated.
+		 */
+		static ConstPtr create(JumpCondition::JumpCriterion criterion, int rows, int cols, const ::Eigen::MatrixXd& weights);
+
+		/**
+		 * @brief Compute the criterion between the current value \a x and the goal \a y
+		 *
+		 * Returns false (and leaves \a criterion untouched) if the values do not have the size of the evaluator.
+		 */
+		virtual bool evaluate(const ::Eigen::MatrixXd& x, const ::Eigen::MatrixXd& y, double& criterion) const = 0;
+	};
+
+}
+
+#endif
@@ -0,0 +1,172 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef HYBRID_AUTOMATON_PARALLEL_CONTROL_MODE_H_
+#define HYBRID_AUTOMATON_PARALLEL_CONTROL_MODE_H_
+
+#include "hybrid_automaton/ControlMode.h"
+#include "hybrid_automaton/HybridAutomaton.h"
+#include "hybrid_automaton/IndexPlan.h"
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread.hpp>
+#include <boost/thread/barrier.hpp>
+#include <boost/atomic.hpp>
+
+#include <string>
+#include <vector>
+
+namespace ha {
+
+	class ParallelControlMode;
+	typedef boost::shared_ptr<ParallelControlMode> ParallelControlModePtr;
+	typedef boost::shared_ptr<const ParallelControlMode> ParallelControlModeConstPtr;
+
+	/**
+	 * @brief A ControlMode with orthogonal regions, e.g. for arm, base and gripper
+	 *
+	 * Each region is a nested HybridAutomaton with its own current mode and switches. All regions are
+	 * stepped in every control cycle and their outputs are added into the command vector: the output of
+	 * a region with an index goes to the rows given by the index, the output of a region without an index
+	 * must have the size of the whole command. This replaces the cartesian product of the regions' modes
+	 * by their sum.
+	 *
+	 * With setNumberOfThreads(n > 1) the regions are stepped in parallel by n - 1 worker threads and the
+	 * control thread. The workers are started once and wait on a barrier in between control cycles. The
+	 * sensors of the regions then read the System concurrently, so it must be thread-safe - see System.
+	 *
+	 * Like a HierarchicalControlMode, the switches leaving this mode are shared by all regions, and the
+	 * regions start in their initial modes whenever this mode is entered.
+	 *
+	 * Serialized as a ControlMode with Region children:
+	 * <ControlMode name="pick" threads="2" dimension="10"><Region index="..."><HybridAutomaton .../></Region>...</ControlMode>
+	 */
+	class ParallelControlMode : public ControlMode
+	{
+	public:
+		typedef boost::shared_ptr<ParallelControlMode> Ptr;
+		typedef boost::shared_ptr<const ParallelControlMode> ConstPtr;
+
+		ParallelControlMode();
+		ParallelControlMode(const std::string& name);
+		ParallelControlMode(const ParallelControlMode& cm);
+
+		virtual ~ParallelControlMode();
+
+		/**
+		 * @brief Add a region - its current control mode becomes the initial one
+		 *
+		 * @param index the rows of the command the output of the region is added to - all rows if empty
+		 */
+		virtual void addRegion(const HybridAutomaton::Ptr& automaton, const std::vector<int>& index = std::vector<int>());
+
+		std::size_t getNumberOfRegions() const;
+		HybridAutomaton::Ptr getRegion(std::size_t region) const;
+		const std::vector<int>& getRegionIndex(std::size_t region) const;
+
+		/**
+		 * @brief The size of the command vector - if 0, it is the largest index + 1 or the size of the region outputs
+		 */
+		void setDimension(int dimension);
+		int getDimension() const;
+
+		/**
+		 * @brief Step the regions on \a threads threads (including the control thread) - 1 steps them sequentially
+		 */
+		void setNumberOfThreads(int threads);
+		int getNumberOfThreads() const;
+
+		virtual void initialize();
+		virtual void terminate();
+		virtual ::Eigen::MatrixXd step(const double& t);
+		virtual bool tryStep(const double& t, ::Eigen::MatrixXd& control, ErrorRecord& error);
+		virtual void switchControlMode(ControlMode::Ptr otherMode);
+
+		/**
+		 * @brief The ControlSet of the active mode of the first region
+		 */
+		virtual ControlSet::Ptr getControlSet() const;
+
+		/**
+		 * @brief The Controller \a name of the active mode of the first region that has one
+		 */
+		virtual Controller::ConstPtr getControllerByName(const std::string& name) const;
+
+		virtual DescriptionTreeNode::Ptr serialize(const DescriptionTree::ConstPtr& factory) const;
+		virtual void deserialize(const DescriptionTreeNode::ConstPtr& tree, const System::ConstPtr& system, const HybridAutomaton* ha);
+
+	protected:
+		virtual ControlMode* _doClone() const {
+			return new ParallelControlMode(*this);
+		}
+
+		struct Region
+		{
+			HybridAutomaton::Ptr automaton;
+			IndexPlan index;
+			std::string initial_control_mode;
+
+			// written by the thread that steps the region
+			::Eigen::MatrixXd output;
+			bool failed;
+			std::string exception;
+		};
+
+		// step all regions, on the workers if there are any
+		void _stepRegions(const double& t, bool nothrow);
+
+		// step the regions worker, worker + threads, ...
+		void _stepRegions(std::size_t worker, std::size_t threads, const double& t, bool nothrow);
+
+		// add the outputs of the regions into \a control - false if a dimension does not fit
+		bool _compose(::Eigen::MatrixXd& control, ErrorRecord& error) const;
+
+		void _startWorkers();
+		void _stopWorkers();
+		void _workerLoop(std::size_t worker, std::size_t threads);
+
+		std::vector<Region> _regions;
+		int _dimension;
+		int _threads;
+
+		// the size of the command - computed in initialize(), 0 if it is given by the region outputs
+		int _command_dimension;
+		bool _start_pending;
+
+		// the worker pool - only exists while the number of threads is > 1 and the mode was initialized
+		std::vector<boost::shared_ptr<boost::thread> > _workers;
+		boost::shared_ptr<boost::barrier> _tick_started;
+		boost::shared_ptr<boost::barrier> _tick_done;
+		boost::atomic<bool> _stopping;
+		double _tick_time;
+		bool _tick_nothrow;
+
+	private:
+		ParallelControlMode& operator=(const ParallelControlMode&);
+	};
+
+}
+
+#endif
@@ -0,0 +1,212 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef HYBRID_AUTOMATON_PROFILER_H_
+#define HYBRID_AUTOMATON_PROFILER_H_
+
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Measure the run time of the enclosing scope and account it to \a name within \a category
+ *
+ * \a handle is a ProfileHandle of the measured entity that caches its counters - \a category and \a name are
+ * only evaluated in the first measurement. \a category must be a string literal, \a name any expression
+ * yielding a std::string. Scoped timers are only compiled in if the library is built with the CMake option
+ * HA_ENABLE_PROFILING - otherwise the macro expands to nothing and its arguments are not evaluated. Only use
+ * it in source files of the library, never in inline functions of its headers.
+ */
+#ifdef HA_ENABLE_PROFILING
+#define HA_PROFILE_CONCAT_IMPL(a, b) a##b
+#define HA_PROFILE_CONCAT(a, b) HA_PROFILE_CONCAT_IMPL(a, b)
+#define HA_PROFILE_SCOPE(handle, category, name) ::ha::ProfileScope HA_PROFILE_CONCAT(ha_profile_scope_, __LINE__)((handle).getEntry() ? *(handle).getEntry() : (handle).bind(category, name))
+#else
+#define HA_PROFILE_SCOPE(handle, category, name)
+#endif
+
+namespace ha {
+
+	/**
+	 * @brief Collects run time statistics of the entities of a HybridAutomaton
+	 *
+	 * The counters of an entity are registered once and shared by all threads that measure it. They are
+	 * updated with atomic operations, so recording and resetting do not need any locks. Durations are kept in
+	 * a histogram with logarithmic (power of two nanoseconds) bins.
+	 */
+	class Profiler
+	{
+	public:
+
+		enum { NUMBER_OF_BINS = 32 };
+
+		/**
+		 * @brief Counters of a single entity - a measurement that overlaps reset() may be counted partially
+		 */
+		struct Entry
+		{
+			Entry();
+
+			void add(boost::uint64_t nanoseconds);
+
+			void reset();
+
+			boost::atomic<boost::uint64_t> count;
+			boost::atomic<boost::uint64_t> total;
+			boost::atomic<boost::uint64_t> min;
+			boost::atomic<boost::uint64_t> max;
+			boost::atomic<boost::uint64_t> histogram[NUMBER_OF_BINS];
+		};
+
+		/**
+		 * @brief Merged statistics of an entity, durations in nanoseconds
+		 */
+		struct Statistics
+		{
+			std::string category;
+			std::string name;
+			boost::uint64_t count;
+			boost::uint64_t total;
+			boost::uint64_t min;
+			boost::uint64_t max;
+			std::vector<boost::uint64_t> histogram;
+
+			/**
+			 * @brief Upper bound of the duration below which \a fraction of the measurements lie
+			 */
+			boost::uint64_t getPercentile(double fraction) const;
+		};
+
+		/**
+		 * @brief True if the library was built with HA_ENABLE_PROFILING
+		 */
+		static bool isEnabled();
+
+		/**
+		 * @brief Returns the counters of \a name within \a category - registers them on the first call
+		 *
+		 * Takes a lock and may allocate, cache the result in a ProfileHandle.
+		 */
+		static Entry& getEntry(const char* category, const std::string& name);
+
+		/**
+		 * @brief Current time of a monotonic clock in nanoseconds
+		 */
+		static boost::uint64_t now();
+
+		static std::vector<Statistics> getStatistics();
+
+		/**
+		 * @brief Writes a table of all entities that were measured so far
+		 */
+		static void report(std::ostream& out = std::cout);
+
+		/**
+		 * @brief Sets all counters to zero
+		 */
+		static void reset();
+
+		static int getBin(boost::uint64_t nanoseconds);
+	};
+
+	/**
+	 * @brief Caches the counters of a measured entity - see HA_PROFILE_SCOPE
+	 *
+	 * Copies start without counters, as the copied entity may be renamed.
+	 */
+	class ProfileHandle
+	{
+	public:
+		ProfileHandle()
+			: _entry(NULL)
+		{
+		}
+
+		ProfileHandle(const ProfileHandle&)
+			: _entry(NULL)
+		{
+		}
+
+		ProfileHandle& operator=(const ProfileHandle&)
+		{
+			_entry.store(NULL, boost::memory_order_release);
+			return *this;
+		}
+
+		Profiler::Entry* getEntry() const
+		{
+			return _entry.load(boost::memory_order_acquire);
+		}
+
+		/**
+		 * @brief Looks up the counters of \a name within \a category and caches them
+		 */
+		Profiler::Entry& bind(const char* category, const std::string& name)
+		{
+			Profiler::Entry& entry = Profiler::getEntry(category, name);
+			_entry.store(&entry, boost::memory_order_release);
+			return entry;
+		}
+
+	private:
+		boost::atomic<Profiler::Entry*> _entry;
+	};
+
+	/**
+	 * @brief Measures the time between its construction and destruction - use HA_PROFILE_SCOPE
+	 */
+	class ProfileScope
+	{
+	public:
+		ProfileScope(Profiler::Entry& entry)
+			: _entry(entry), _start(Profiler::now())
+		{
+		}
+
+		ProfileScope(const char* category, const std::string& name)
+			: _entry(Profiler::getEntry(category, name)), _start(Profiler::now())
+		{
+		}
+
+		~ProfileScope()
+		{
+			_entry.add(Profiler::now() - _start);
+		}
+
+	private:
+		ProfileScope(const ProfileScope&);
+		ProfileScope& operator=(const ProfileScope&);
+
+		Profiler::Entry& _entry;
+		boost::uint64_t _start;
+	};
+
+}
+
+#endif
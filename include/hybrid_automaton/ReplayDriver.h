@@ -0,0 +1,93 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef HYBRID_AUTOMATON_REPLAY_DRIVER_H_
+#define HYBRID_AUTOMATON_REPLAY_DRIVER_H_
+
+#include "hybrid_automaton/HybridAutomaton.h"
+#include "hybrid_automaton/ReplaySystem.h"
+
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ha {
+
+	/**
+	 * @brief Steps a HybridAutomaton through all samples of a ReplaySystem as fast as possible
+	 *
+	 * The automaton must have been deserialized with the ReplaySystem, so that its sensors read the logged
+	 * values. The time stamps of the log are passed to HybridAutomaton::step, so a replay is deterministic and
+	 * independent of the speed of the machine it runs on.
+	 */
+	class ReplayDriver
+	{
+	public:
+
+		struct Transition
+		{
+			double time;
+			// empty for a fallback
+			std::string control_switch;
+			std::string source_mode;
+			std::string target_mode;
+			// the watchdog or the safe control mode took over - no control switch fired
+			bool fallback;
+
+			Transition() : time(0.0), fallback(false) {
+			}
+		};
+
+		struct Result
+		{
+			std::vector<Transition> transitions;
+			std::string initial_mode;
+			std::string terminal_mode;
+			std::size_t steps;
+			double start_time;
+			double end_time;
+
+			// logged time spent in each control mode
+			std::map<std::string, double> time_in_mode;
+
+			Result() : steps(0), start_time(0.0), end_time(0.0) {
+			}
+
+			/**
+			 * @brief Writes the transitions and the time per mode in a human readable form
+			 */
+			void report(std::ostream& out) const;
+		};
+
+		/**
+		 * @brief Replays all samples of \a system starting in the current control mode of \a ha
+		 */
+		static Result run(const HybridAutomaton::Ptr& ha, const ReplaySystem::Ptr& system);
+	};
+
+}
+
+#endif
@@ -0,0 +1,169 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef HYBRID_AUTOMATON_REPLAY_SYSTEM_H_
+#define HYBRID_AUTOMATON_REPLAY_SYSTEM_H_
+
+#include "hybrid_automaton/System.h"
+
+#include <boost/shared_ptr.hpp>
+#include <boost/cstdint.hpp>
+
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace boost {
+	namespace interprocess {
+		class file_mapping;
+		class mapped_region;
+	}
+}
+
+namespace ha {
+
+	class ReplaySystem;
+	typedef boost::shared_ptr<ReplaySystem> ReplaySystemPtr;
+	typedef boost::shared_ptr<const ReplaySystem> ReplaySystemConstPtr;
+
+	/**
+	 * @brief Writes the state of a System into a log that can be replayed with ReplaySystem
+	 *
+	 * Log layout (native byte order): the magic "HALOG001", the dof, the recorded F/T ports and frame ids, padding
+	 * to a multiple of 8 bytes and then one fixed size sample per call to write():
+	 * time, joint configuration, joint velocity, the F/T measurements of all ports and the poses (column major)
+	 * of all frames.
+	 */
+	class ReplayLogWriter
+	{
+	public:
+
+		typedef boost::shared_ptr<ReplayLogWriter> Ptr;
+		typedef boost::shared_ptr<const ReplayLogWriter> ConstPtr;
+
+		ReplayLogWriter(const std::string& filename, int dof, const std::vector<int>& ft_ports, const std::vector<std::string>& frame_ids);
+
+		virtual ~ReplayLogWriter();
+
+		/**
+		 * @brief Appends the current state of \a system at time \a t
+		 */
+		void write(const System& system, double t);
+
+		void close();
+
+	protected:
+		void _writeMatrix(const ::Eigen::MatrixXd& matrix, int rows, int cols, const char* what);
+
+		std::ofstream _file;
+		int _dof;
+		std::vector<int> _ft_ports;
+		std::vector<std::string> _frame_ids;
+	};
+
+	/**
+	 * @brief A System that replays a log written by ReplayLogWriter
+	 *
+	 * The log is memory mapped, so arbitrarily long logs can be replayed without reading them into memory.
+	 * Select the sample that the System returns with setSample() or next().
+	 */
+	class ReplaySystem : public System
+	{
+	public:
+
+		typedef boost::shared_ptr<ReplaySystem> Ptr;
+		typedef boost::shared_ptr<const ReplaySystem> ConstPtr;
+
+		ReplaySystem(const std::string& filename);
+
+		virtual ~ReplaySystem();
+
+		std::size_t getNumberOfSamples() const;
+
+		void setSample(std::size_t sample);
+
+		std::size_t getSample() const;
+
+		/**
+		 * @brief Selects the next sample - returns false if the end of the log was reached
+		 */
+		bool next();
+
+		/**
+		 * @brief The time stamp of the current sample
+		 */
+		double getTime() const;
+
+		const std::vector<int>& getForceTorquePorts() const;
+
+		const std::vector<std::string>& getFrameIds() const;
+
+		virtual int getDof() const;
+
+		virtual ::Eigen::MatrixXd getJointConfiguration() const;
+
+		virtual ::Eigen::MatrixXd getJointVelocity() const;
+
+		virtual ::Eigen::MatrixXd getForceTorqueMeasurement(const int& port = DEFAULT_FT_PORT) const;
+
+		virtual void getForceTorqueMeasurementsInto(const std::vector<int>& ports, ::Eigen::MatrixXd& measurements) const;
+
+		virtual ::Eigen::MatrixXd getFramePose(const std::string& frame_id) const;
+
+		virtual void getFramePoseInto(const std::string& frame_id, ::Eigen::Matrix4d& pose) const;
+
+	protected:
+
+		const double* _getSampleData() const;
+
+		int _getPortOffset(int port) const;
+
+		int _getFrameOffset(const std::string& frame_id) const;
+
+		boost::shared_ptr<boost::interprocess::file_mapping> _file;
+		boost::shared_ptr<boost::interprocess::mapped_region> _region;
+
+		int _dof;
+		std::vector<int> _ft_ports;
+		std::vector<std::string> _frame_ids;
+
+		// offsets (in doubles) of the values within a sample
+		std::map<int, int> _port_offsets;
+		std::map<std::string, int> _frame_offsets;
+
+		std::size_t _data_offset;
+		std::size_t _sample_size;
+		std::size_t _number_of_samples;
+		std::size_t _sample;
+
+	private:
+		ReplaySystem(const ReplaySystem&);
+		ReplaySystem& operator=(const ReplaySystem&);
+	};
+
+}
+
+#endif
@@ -78,6 +78,14 @@ namespace ha {
         */
 		virtual ::Eigen::MatrixXd getRelativeCurrentValue() const;
 
+        /**
+        * @brief The dimensions of getCurrentValue() - false if they are not known before the sensor is read
+        *
+        * Used to validate JumpConditions when the automaton is loaded. Override this if the dimensions
+        * of your sensor only depend on its configuration and the System.
+        */
+		virtual bool getDimensions(int& rows, int& cols) const;
+
         // automatically implemented by HA_SENSOR_INSTANCE macro
         virtual const std::string getType() const;
 		virtual void setType(const std::string& new_type);
@@ -0,0 +1,282 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef HYBRID_AUTOMATON_SENSOR_FILTER_H
+#define HYBRID_AUTOMATON_SENSOR_FILTER_H
+
+#include "hybrid_automaton/Serializable.h"
+#include "hybrid_automaton/error_handling.h"
+
+#include <boost/shared_ptr.hpp>
+
+#include <vector>
+
+namespace ha {
+
+	class SensorFilter;
+	typedef boost::shared_ptr<SensorFilter> SensorFilterPtr;
+	typedef boost::shared_ptr<const SensorFilter> SensorFilterConstPtr;
+
+	/**
+	 * @brief One stage of a filter pipeline that post-processes sensor values
+	 *
+	 * Filters are attached to a Sensor in its description, i.e.
+	 *   <Sensor type="ForceTorqueSensor"><Filter type="lowpass" cutoff="20"/></Sensor>
+	 * and are executed in the order they appear.
+	 *
+	 * All state is sized in initialize() - step() writes into the preallocated output and does not allocate
+	 * as long as the dimension of the input does not change.
+	 *
+	 * @see FilteredSensor
+	 */
+	class SensorFilter : public Serializable
+	{
+	public:
+		typedef boost::shared_ptr<SensorFilter> Ptr;
+		typedef boost::shared_ptr<const SensorFilter> ConstPtr;
+
+		SensorFilter();
+		virtual ~SensorFilter();
+
+		SensorFilterPtr clone() const
+		{
+			return (SensorFilterPtr(_doClone()));
+		}
+
+		/**
+		 * @brief Instantiate a filter from a "Filter" node - the type attribute selects the filter
+		 *
+		 * Known types: lowpass, median, moving_average, exponential, derivative, integrator, transform
+		 */
+		static SensorFilter::Ptr create(const DescriptionTreeNode::ConstPtr& node, const System::ConstPtr& system, const HybridAutomaton* ha);
+
+		/**
+		 * @brief Reset the filter state to the first value \a input and size the output
+		 */
+		virtual void initialize(const ::Eigen::MatrixXd& input, const double& t, ::Eigen::MatrixXd& output) = 0;
+
+		/**
+		 * @brief Filter the next value \a input at time \a t into \a output
+		 */
+		virtual void step(const ::Eigen::MatrixXd& input, const double& t, ::Eigen::MatrixXd& output) = 0;
+
+		virtual const std::string getType() const = 0;
+
+		/**
+		 * @brief Map the dimensions of the input to the dimensions of the output - false if the input cannot be filtered
+		 *
+		 * The default implementation keeps the dimensions.
+		 */
+		virtual bool getOutputDimensions(int& rows, int& cols) const;
+
+	protected:
+		virtual SensorFilter* _doClone() const = 0;
+
+		// throws if the dimension of input differs from the one seen in initialize
+		void _checkDimensions(const ::Eigen::MatrixXd& input) const;
+
+		int _rows;
+		int _cols;
+		double _last_time;
+	};
+
+	/**
+	 * @brief First-order low-pass filter with cutoff frequency \a cutoff (in Hz)
+	 */
+	class LowPassFilter : public SensorFilter
+	{
+	public:
+		typedef boost::shared_ptr<LowPassFilter> Ptr;
+
+		LowPassFilter(double cutoff = 1.0);
+
+		virtual void initialize(const ::Eigen::MatrixXd& input, const double& t, ::Eigen::MatrixXd& output);
+		virtual void step(const ::Eigen::MatrixXd& input, const double& t, ::Eigen::MatrixXd& output);
+		virtual const std::string getType() const { return "lowpass"; }
+
+		virtual DescriptionTreeNode::Ptr serialize(const DescriptionTree::ConstPtr& factory) const;
+		virtual void deserialize(const DescriptionTreeNode::ConstPtr& tree, const System::ConstPtr& system, const HybridAutomaton* ha);
+
+	protected:
+		virtual LowPassFilter* _doClone() const { return new LowPassFilter(*this); }
+
+		double _cutoff;
+	};
+
+	/**
+	 * @brief Element-wise median of the last \a window values
+	 */
+	class MedianFilter : public SensorFilter
+	{
+	public:
+		typedef boost::shared_ptr<MedianFilter> Ptr;
+
+		MedianFilter(int window = 3);
+
+		virtual void initialize(const ::Eigen::MatrixXd& input, const double& t, ::Eigen::MatrixXd& output);
+		virtual void step(const ::Eigen::MatrixXd& input, const double& t, ::Eigen::MatrixXd& output);
+		virtual const std::string getType() const { return "median"; }
+
+		virtual DescriptionTreeNode::Ptr serialize(const DescriptionTree::ConstPtr& factory) const;
+		virtual void deserialize(const DescriptionTreeNode::ConstPtr& tree, const System::ConstPtr& system, const HybridAutomaton* ha);
+
+	protected:
+		virtual MedianFilter* _doClone() const { return new MedianFilter(*this); }
+
+		int _window;
+
+		// ring buffer: one row per element, one column per sample
+		::Eigen::MatrixXd _buffer;
+		int _head;
+		int _count;
+		std::vector<double> _scratch;
+	};
+
+	/**
+	 * @brief Element-wise mean of the last \a window values
+	 */
+	class MovingAverageFilter : public SensorFilter
+	{
+	public:
+		typedef boost::shared_ptr<MovingAverageFilter> Ptr;
+
+		MovingAverageFilter(int window = 1);
+
+		virtual void initialize(const ::Eigen::MatrixXd& input, const double& t, ::Eigen::MatrixXd& output);
+		virtual void step(const ::Eigen::MatrixXd& input, const double& t, ::Eigen::MatrixXd& output);
+		virtual const std::string getType() const { return "moving_average"; }
+
+		virtual DescriptionTreeNode::Ptr serialize(const DescriptionTree::ConstPtr& factory) const;
+		virtual void deserialize(const DescriptionTreeNode::ConstPtr& tree, const System::ConstPtr& system, const HybridAutomaton* ha);
+
+	protected:
+		virtual MovingAverageFilter* _doClone() const { return new MovingAverageFilter(*this); }
+
+		int _window;
+
+		// ring buffer: one row per element, one column per sample - and the running sum of its rows
+		::Eigen::MatrixXd _buffer;
+		::Eigen::VectorXd _sum;
+		int _head;
+		int _count;
+	};
+
+	/**
+	 * @brief Element-wise exponential smoothing with factor \a alpha in (0, 1] - independent of the sample time
+	 */
+	class ExponentialFilter : public SensorFilter
+	{
+	public:
+		typedef boost::shared_ptr<ExponentialFilter> Ptr;
+
+		ExponentialFilter(double alpha = 1.0);
+
+		virtual void initialize(const ::Eigen::MatrixXd& input, const double& t, ::Eigen::MatrixXd& output);
+		virtual void step(const ::Eigen::MatrixXd& input, const double& t, ::Eigen::MatrixXd& output);
+		virtual const std::string getType() const { return "exponential"; }
+
+		virtual DescriptionTreeNode::Ptr serialize(const DescriptionTree::ConstPtr& factory) const;
+		virtual void deserialize(const DescriptionTreeNode::ConstPtr& tree, const System::ConstPtr& system, const HybridAutomaton* ha);
+
+	protected:
+		virtual ExponentialFilter* _doClone() const { return new ExponentialFilter(*this); }
+
+		double _alpha;
+	};
+
+	/**
+	 * @brief Time derivative of the input (finite differences)
+	 */
+	class DerivativeFilter : public SensorFilter
+	{
+	public:
+		typedef boost::shared_ptr<DerivativeFilter> Ptr;
+
+		virtual void initialize(const ::Eigen::MatrixXd& input, const double& t, ::Eigen::MatrixXd& output);
+		virtual void step(const ::Eigen::MatrixXd& input, const double& t, ::Eigen::MatrixXd& output);
+		virtual const std::string getType() const { return "derivative"; }
+
+		virtual DescriptionTreeNode::Ptr serialize(const DescriptionTree::ConstPtr& factory) const;
+		virtual void deserialize(const DescriptionTreeNode::ConstPtr& tree, const System::ConstPtr& system, const HybridAutomaton* ha);
+
+	protected:
+		virtual DerivativeFilter* _doClone() const { return new DerivativeFilter(*this); }
+
+		::Eigen::MatrixXd _previous;
+	};
+
+	/**
+	 * @brief Time integral of the input since initialization (trapezoidal rule)
+	 */
+	class IntegratorFilter : public SensorFilter
+	{
+	public:
+		typedef boost::shared_ptr<IntegratorFilter> Ptr;
+
+		virtual void initialize(const ::Eigen::MatrixXd& input, const double& t, ::Eigen::MatrixXd& output);
+		virtual void step(const ::Eigen::MatrixXd& input, const double& t, ::Eigen::MatrixXd& output);
+		virtual const std::string getType() const { return "integrator"; }
+
+		virtual DescriptionTreeNode::Ptr serialize(const DescriptionTree::ConstPtr& factory) const;
+		virtual void deserialize(const DescriptionTreeNode::ConstPtr& tree, const System::ConstPtr& system, const HybridAutomaton* ha);
+
+	protected:
+		virtual IntegratorFilter* _doClone() const { return new IntegratorFilter(*this); }
+
+		::Eigen::MatrixXd _previous;
+	};
+
+	/**
+	 * @brief Multiplies the input with a constant \a matrix - from the left (default) or from the right
+	 *
+	 * Use it to express values in another frame, e.g. a 4x4 homogeneous transform for poses,
+	 * a 3x3 rotation for vectors or a 6x6 adjoint for wrenches.
+	 */
+	class TransformFilter : public SensorFilter
+	{
+	public:
+		typedef boost::shared_ptr<TransformFilter> Ptr;
+
+		TransformFilter();
+		TransformFilter(const ::Eigen::MatrixXd& matrix, bool multiply_from_right = false);
+
+		virtual void initialize(const ::Eigen::MatrixXd& input, const double& t, ::Eigen::MatrixXd& output);
+		virtual void step(const ::Eigen::MatrixXd& input, const double& t, ::Eigen::MatrixXd& output);
+		virtual const std::string getType() const { return "transform"; }
+		virtual bool getOutputDimensions(int& rows, int& cols) const;
+
+		virtual DescriptionTreeNode::Ptr serialize(const DescriptionTree::ConstPtr& factory) const;
+		virtual void deserialize(const DescriptionTreeNode::ConstPtr& tree, const System::ConstPtr& system, const HybridAutomaton* ha);
+
+	protected:
+		virtual TransformFilter* _doClone() const { return new TransformFilter(*this); }
+
+		::Eigen::MatrixXd _matrix;
+		bool _multiply_from_right;
+	};
+
+}
+
+#endif
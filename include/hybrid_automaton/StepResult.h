@@ -0,0 +1,69 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef HYBRID_AUTOMATON_STEP_RESULT_H_
+#define HYBRID_AUTOMATON_STEP_RESULT_H_
+
+#include "hybrid_automaton/ErrorRecord.h"
+
+namespace ha {
+
+	/**
+	 * @brief The outcome of HybridAutomaton::tryStep
+	 *
+	 * The details of a fault are in HybridAutomaton::getLastError.
+	 */
+	struct StepResult
+	{
+		// not OK/FAILED, windows.h defines FAILED as a macro
+		enum Status {
+			STEP_OK = 0,       /**< the control output was computed */
+			STEP_SAFE_MODE,    /**< a fault occurred, the output was computed by the safe control mode */
+			STEP_FAILED        /**< a fault occurred and there is no safe control mode to fall back to - the output is not valid */
+		};
+
+		Status status;
+
+		/**
+		 * @brief The fault that led to the safe control mode or the failure - FAULT_NONE if there was none
+		 */
+		ErrorRecord::Code error;
+
+		StepResult(Status step_status = STEP_OK, ErrorRecord::Code error_code = ErrorRecord::FAULT_NONE)
+			: status(step_status), error(error_code)
+		{
+		}
+
+		/**
+		 * @brief true if the control output is valid (possibly computed by the safe control mode)
+		 */
+		bool ok() const {
+			return status != STEP_FAILED;
+		}
+	};
+
+}
+
+#endif
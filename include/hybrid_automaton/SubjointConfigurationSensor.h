@@ -28,6 +28,7 @@
 
 #include "hybrid_automaton/Sensor.h"
 #include "hybrid_automaton/HybridAutomaton.h"
+#include "hybrid_automaton/IndexPlan.h"
 
 #include <boost/shared_ptr.hpp>
 
@@ -59,25 +60,25 @@ namespace ha {
 
         virtual std::vector<int> getIndex() const
         {
-            return _index;
+            return _index_plan.getIndex();
         }
 
         virtual void setIndex(const std::vector<int>& index)
         {
-            _index = index;
+            _index_plan.setIndex(index);
         }
 
         virtual void setIndex(const Eigen::MatrixXd& index)
         {
-            _index.resize(index.size());
-            for(int i=0; i<index.rows(); i++)
-            {
-                _index.at(i) = (int)index(i,0);
-            }
+            _index_plan.setIndex(index);
         }
 
+		virtual void initialize(const double& t);
+
 		virtual ::Eigen::MatrixXd getCurrentValue() const;
 
+		virtual bool getDimensions(int& rows, int& cols) const;
+
 		virtual DescriptionTreeNode::Ptr serialize(const DescriptionTree::ConstPtr& factory) const;
 
 		virtual void deserialize(const DescriptionTreeNode::ConstPtr& tree, const System::ConstPtr& system, const HybridAutomaton* ha);
@@ -96,7 +97,7 @@ namespace ha {
 		}
 
 
-        std::vector<int> _index;
+        IndexPlan _index_plan;
 
 	};
 
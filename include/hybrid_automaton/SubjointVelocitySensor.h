@@ -28,6 +28,7 @@
 
 #include "hybrid_automaton/Sensor.h"
 #include "hybrid_automaton/HybridAutomaton.h"
+#include "hybrid_automaton/IndexPlan.h"
 
 #include <boost/shared_ptr.hpp>
 
@@ -62,7 +63,7 @@ namespace ha {
 
         virtual std::vector<int> getIndex() const
         {
-            return _index;
+            return _index_plan.getIndex();
         }
 
         /**
@@ -72,7 +73,7 @@ namespace ha {
          */
         virtual void setIndex(const std::vector<int>& index)
         {
-            _index = index;
+            _index_plan.setIndex(index);
         }
 
         /**
@@ -82,13 +83,11 @@ namespace ha {
          */
         virtual void setIndex(const Eigen::MatrixXd& index)
         {
-            _index.resize(index.size());
-            for(int i=0; i<index.rows(); i++)
-            {
-                _index.at(i) = (int)index(i,0);
-            }
+            _index_plan.setIndex(index);
         }
 
+		virtual void initialize(const double& t);
+
         /**
          * @brief Returns a subset of the joint velcoity vector of as a matrix of size dim(index)x1
          *
@@ -96,6 +95,8 @@ namespace ha {
          */
 		virtual ::Eigen::MatrixXd getCurrentValue() const;
 
+		virtual bool getDimensions(int& rows, int& cols) const;
+
 		virtual DescriptionTreeNode::Ptr serialize(const DescriptionTree::ConstPtr& factory) const;
 
 		virtual void deserialize(const DescriptionTreeNode::ConstPtr& tree, const System::ConstPtr& system, const HybridAutomaton* ha);
@@ -114,7 +115,7 @@ namespace ha {
 		}
 
 
-        std::vector<int> _index;
+        IndexPlan _index_plan;
 
 	};
 
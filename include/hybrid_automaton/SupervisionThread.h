@@ -0,0 +1,157 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef HYBRID_AUTOMATON_SUPERVISION_THREAD_H_
+#define HYBRID_AUTOMATON_SUPERVISION_THREAD_H_
+
+#include "hybrid_automaton/ErrorRecord.h"
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
+
+#include <cstddef>
+
+namespace ha {
+
+	class HybridAutomaton;
+
+	class SupervisionThread;
+	typedef boost::shared_ptr<SupervisionThread> SupervisionThreadPtr;
+	typedef boost::shared_ptr<const SupervisionThread> SupervisionThreadConstPtr;
+
+	/**
+	 * @brief Evaluates the ControlSwitches of a HybridAutomaton on a separate (non-real-time) thread
+	 *
+	 * The control thread publishes the current time and ControlMode in every call to HybridAutomaton::step
+	 * and polls for a transition found by the supervision thread. Both directions are handed over through
+	 * atomic words only, the control thread never blocks and never allocates.
+	 *
+	 * Every change of the current ControlMode starts a new epoch. Results are tagged with the epoch of the
+	 * request they were computed for, so a transition that was found for a ControlMode which is no longer
+	 * active is discarded by the control thread.
+	 *
+	 * The ControlSwitches and JumpConditions are not copied: the supervision thread holds getMutex() while it
+	 * evaluates them and the control thread holds it while it changes the current ControlMode (which terminates
+	 * and initializes switches). The control thread only tries to take the lock for regular transitions and
+	 * applies them a cycle later if an evaluation is running - it blocks for at most one evaluation when it
+	 * enters a fallback ControlMode. ControlMode::step still runs concurrently to the evaluation, so sensors
+	 * and controllers read by jump conditions must be safe to read while the current ControlMode is stepped.
+	 *
+	 * @see HybridAutomaton::setAsynchronousSupervision
+	 */
+	class SupervisionThread
+	{
+	public:
+		typedef boost::shared_ptr<SupervisionThread> Ptr;
+		typedef boost::shared_ptr<const SupervisionThread> ConstPtr;
+
+		/**
+		 * @param hybrid_automaton the automaton whose switches will be evaluated
+		 * @param idle_time time (in seconds) the supervision thread sleeps if there is no new control cycle to supervise
+		 */
+		SupervisionThread(HybridAutomaton* hybrid_automaton, const double& idle_time = 0.0001);
+		virtual ~SupervisionThread();
+
+		/**
+		 * @brief Start supervising control mode \a mode, beginning at time \a t
+		 */
+		void start(std::size_t mode, const double& t);
+
+		/**
+		 * @brief Stop the supervision thread and wait for it to finish the current evaluation
+		 */
+		void stop();
+
+		bool isRunning() const;
+
+		/**
+		 * @brief Hand the current time and control mode to the supervision thread - called by the control thread
+		 */
+		void publish(std::size_t mode, const double& t);
+
+		/**
+		 * @brief Fetch a pending transition for the control mode that was published last - called by the control thread
+		 *
+		 * @param out_edge_index the index of the active switch within the out-edges of the current control mode
+		 * @return true if a switch of the current control mode became active
+		 */
+		bool fetchActiveSwitch(std::size_t& out_edge_index);
+
+		/**
+		 * @brief true if evaluating a switch on the supervision thread threw an error
+		 */
+		bool hasFailed() const;
+
+		/**
+		 * @brief The error that stopped the supervision thread - only valid if hasFailed()
+		 */
+		const ErrorRecord& getError() const;
+
+		/**
+		 * @brief Held by the supervision thread while it evaluates switches - the control thread must hold it
+		 * while it changes the current control mode and publishes the new one
+		 */
+		boost::mutex& getMutex();
+
+	protected:
+		void _run();
+
+		static boost::uint64_t _pack(boost::uint32_t epoch, std::size_t value);
+
+		HybridAutomaton* _hybrid_automaton;
+		double _idle_time;
+
+		boost::shared_ptr<boost::thread> _thread;
+
+		boost::mutex _mutex;
+
+		boost::atomic<bool> _running;
+		boost::atomic<bool> _failed;
+
+		// written by the supervision thread before it sets _failed
+		ErrorRecord _error;
+
+		// epoch << 32 | control mode -- written by the control thread
+		boost::atomic<boost::uint64_t> _request;
+		boost::atomic<double> _request_time;
+
+		// epoch << 32 | (out-edge index + 1), 0 if there is no result -- written by the supervision thread
+		boost::atomic<boost::uint64_t> _result;
+
+		// only accessed by the control thread
+		boost::uint32_t _epoch;
+		std::size_t _mode;
+
+	private:
+		SupervisionThread(const SupervisionThread&);
+		SupervisionThread& operator=(const SupervisionThread&);
+	};
+
+}
+
+#endif
@@ -30,6 +30,8 @@
 
 #include <boost/shared_ptr.hpp>
 
+#include <vector>
+
 #include <Eigen/Dense>
 
 
@@ -54,6 +56,10 @@ namespace ha {
         * @brief An interface to your robot system
         *
         * Overload all virtual functions to connect to your hardware
+        *
+        * The sensors of a ParallelControlMode with more than one thread, and of an automaton with
+        * asynchronous supervision, call the const getters (getJointConfiguration, getForceTorqueMeasurement,
+        * getFramePose, the ...Into variants) from several threads at the same time. They must be thread-safe then.
         */
 		System() {
 		}
@@ -81,11 +87,39 @@ namespace ha {
         */
 		virtual ::Eigen::MatrixXd getForceTorqueMeasurement(const int& port = DEFAULT_FT_PORT) const = 0;
 
+        /**
+        * @brief Write the Force-torque measurements of all \a ports into the columns of \a measurements (6xN)
+        *
+        * Override this if your system can read several sensors at once. The default implementation calls
+        * getForceTorqueMeasurement for each port.
+        */
+		virtual void getForceTorqueMeasurementsInto(const std::vector<int>& ports, ::Eigen::MatrixXd& measurements) const {
+			measurements.resize(6, ports.size());
+			for (std::size_t i = 0; i < ports.size(); ++i)
+				measurements.col(i) = this->getForceTorqueMeasurement(ports[i]);
+		}
+
         /**
         * @brief Return the pose of a frame with id \a frame_id (4x4)
         */
 		virtual ::Eigen::MatrixXd getFramePose(const std::string& frame_id) const = 0;
 
+        /**
+        * @brief Write the pose of a frame with id \a frame_id into a fixed-size matrix
+        *
+        * Override this in systems that can provide the pose without a dynamic allocation. The default
+        * implementation copies the result of getFramePose(frame_id). It is not an overload of getFramePose,
+        * so that a System overriding one of them does not hide the other.
+        */
+		virtual void getFramePoseInto(const std::string& frame_id, ::Eigen::Matrix4d& pose) const {
+			::Eigen::MatrixXd dynamic_pose = this->getFramePose(frame_id);
+			if (dynamic_pose.rows() != 4 || dynamic_pose.cols() != 4) {
+				HA_THROW_ERROR("System.getFramePoseInto", "Pose of frame '" << frame_id << "' must be 4x4, not "
+					<< dynamic_pose.rows() << "x" << dynamic_pose.cols() << "!");
+			}
+			pose = dynamic_pose;
+		}
+
 		virtual bool subscribeToROSMessage(const std::string& topic) const {
 			HA_THROW_ERROR("System.subscribeToROSMessage", "Not implemented");
 		}
@@ -0,0 +1,153 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef HYBRID_AUTOMATON_TRACE_RECORDER_H_
+#define HYBRID_AUTOMATON_TRACE_RECORDER_H_
+
+#include "hybrid_automaton/BoundedQueue.h"
+
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread.hpp>
+
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ha {
+
+	class TraceRecorder;
+	typedef boost::shared_ptr<TraceRecorder> TraceRecorderPtr;
+	typedef boost::shared_ptr<const TraceRecorder> TraceRecorderConstPtr;
+
+	/**
+	 * @brief A flight recorder for the execution of a HybridAutomaton
+	 *
+	 * Records the active control mode of every step, the criterion values of the evaluated jump conditions and the
+	 * transitions into a preallocated BoundedQueue. A background thread writes the queue to a binary file, so
+	 * recording never blocks the control loop and the control and supervision threads never wait for each
+	 * other - if the queue is full, records are dropped and counted.
+	 *
+	 * File layout (native byte order): the magic "HATRACE1", a sequence of fixed size Records, an END record whose
+	 * id is the number of names that follow and whose value is the number of dropped records, and the names
+	 * (uint64 id, uint32 length, characters) of the modes and switches.
+	 *
+	 * Use HybridAutomaton::setTraceRecorder to attach a recorder and convertToCsv (or the tool
+	 * hybrid_automaton_trace_to_csv) to read a trace.
+	 */
+	class TraceRecorder
+	{
+	public:
+
+		typedef boost::shared_ptr<TraceRecorder> Ptr;
+		typedef boost::shared_ptr<const TraceRecorder> ConstPtr;
+
+		enum RecordType {
+			TICK = 1,		///< a step of the HybridAutomaton, id is the active control mode
+			CONDITION = 2,	///< an evaluated jump condition, id is its control switch
+			TRANSITION = 3,	///< a control switch fired, id is the control switch
+			END = 255
+		};
+
+		struct Record
+		{
+			boost::uint8_t type;
+			boost::uint8_t active;		// CONDITION: the condition was met
+			boost::uint16_t index;		// CONDITION: index of the jump condition within its switch
+			boost::uint32_t reserved;
+			boost::uint64_t id;			// identifies the mode or switch, see setName
+			double time;
+			double value;				// CONDITION: criterion value
+			double epsilon;				// CONDITION: epsilon of the jump condition
+		};
+
+		/**
+		 * @brief Creates a recorder that can buffer \a capacity records (rounded up to a power of two)
+		 */
+		TraceRecorder(std::size_t capacity = 65536);
+
+		virtual ~TraceRecorder();
+
+		/**
+		 * @brief Opens \a filename and starts the thread that writes the records to it
+		 */
+		void start(const std::string& filename);
+
+		/**
+		 * @brief Writes all pending records and the names and closes the file
+		 */
+		void stop();
+
+		bool isRecording() const;
+
+		/**
+		 * @brief Associates the control mode or control switch \a entity with \a name in the trace
+		 */
+		void setName(const void* entity, const std::string& name);
+
+		void recordTick(double t, const void* control_mode);
+
+		void recordCondition(double t, const void* control_switch, int index, double value, double epsilon, bool active);
+
+		void recordTransition(double t, const void* control_switch);
+
+		boost::uint64_t getNumberOfDroppedRecords() const;
+
+		/**
+		 * @brief Converts a binary trace to comma separated values (time,event,name,condition,value,epsilon,active)
+		 */
+		static void convertToCsv(std::istream& trace, std::ostream& csv);
+
+	protected:
+
+		void _push(const Record& record);
+
+		void _flushLoop();
+
+		void _flush();
+
+		// pushed to by the control and the supervision thread, popped by the flush thread
+		BoundedQueue<Record> _queue;
+
+		boost::atomic<bool> _recording;
+		boost::atomic<boost::uint64_t> _dropped;
+
+		boost::mutex _names_mutex;
+		std::map<boost::uint64_t, std::string> _names;
+
+		std::ofstream _file;
+		boost::shared_ptr<boost::thread> _flush_thread;
+
+	private:
+		TraceRecorder(const TraceRecorder&);
+		TraceRecorder& operator=(const TraceRecorder&);
+	};
+
+}
+
+#endif
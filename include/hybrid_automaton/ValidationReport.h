@@ -0,0 +1,88 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef HYBRID_AUTOMATON_VALIDATION_REPORT_H_
+#define HYBRID_AUTOMATON_VALIDATION_REPORT_H_
+
+#include <boost/shared_ptr.hpp>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace ha {
+
+	class ValidationReport;
+	typedef boost::shared_ptr<ValidationReport> ValidationReportPtr;
+	typedef boost::shared_ptr<const ValidationReport> ValidationReportConstPtr;
+
+	/**
+	 * @brief The problems found by HybridAutomaton::validate
+	 *
+	 * Errors make the automaton fail at run time (e.g. a goal that does not fit the sensor),
+	 * warnings point at structures that are probably not intended (e.g. unreachable control modes).
+	 */
+	class ValidationReport
+	{
+	public:
+
+		typedef boost::shared_ptr<ValidationReport> Ptr;
+		typedef boost::shared_ptr<const ValidationReport> ConstPtr;
+
+		// not ERROR/WARNING, windows.h defines ERROR as a macro
+		enum Severity {SEVERITY_WARNING, SEVERITY_ERROR};
+
+		struct Issue
+		{
+			Severity severity;
+			// the entity the issue was found in, e.g. "switch 'grasped' / JumpCondition 0"
+			std::string origin;
+			std::string message;
+		};
+
+		void addError(const std::string& origin, const std::string& message);
+
+		void addWarning(const std::string& origin, const std::string& message);
+
+		const std::vector<Issue>& getIssues() const;
+
+		bool hasErrors() const;
+
+		std::size_t getNumberOfErrors() const;
+
+		std::size_t getNumberOfWarnings() const;
+
+		/**
+		 * @brief Writes one line per issue
+		 */
+		void write(std::ostream& out) const;
+
+	protected:
+		std::vector<Issue> _issues;
+	};
+
+}
+
+#endif
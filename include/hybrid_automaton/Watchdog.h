@@ -0,0 +1,132 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef HYBRID_AUTOMATON_WATCHDOG_H_
+#define HYBRID_AUTOMATON_WATCHDOG_H_
+
+#include "hybrid_automaton/Serializable.h"
+#include "hybrid_automaton/Sensor.h"
+#include "hybrid_automaton/ErrorRecord.h"
+
+#include <boost/shared_ptr.hpp>
+#include <boost/cstdint.hpp>
+
+#include <string>
+#include <vector>
+
+namespace ha {
+
+	class Watchdog;
+	typedef boost::shared_ptr<Watchdog> WatchdogPtr;
+	typedef boost::shared_ptr<const Watchdog> WatchdogConstPtr;
+
+	/**
+	 * @brief Supervises the execution of a ControlMode and names the ControlMode to fall back to
+	 *
+	 * A watchdog fires if
+	 *  - the ControlMode takes longer than max_tick_time seconds (wall clock) to compute its output,
+	 *  - a sensor of the out-going ControlSwitches is inactive for longer than max_sensor_age seconds, or
+	 *  - the ControlMode throws.
+	 *
+	 * The HybridAutomaton then switches to the fallback ControlMode, which computes the output of the same
+	 * control cycle. The checks do not allocate and take constant time per sensor.
+	 *
+	 * Serialized as child of the ControlMode: <Watchdog fallback="hold" max_tick_time="0.0005" max_sensor_age="0.1"/>
+	 */
+	class Watchdog : public Serializable
+	{
+	public:
+		typedef boost::shared_ptr<Watchdog> Ptr;
+		typedef boost::shared_ptr<const Watchdog> ConstPtr;
+
+		Watchdog();
+		virtual ~Watchdog();
+
+		WatchdogPtr clone() const
+		{
+			return WatchdogPtr(_doClone());
+		}
+
+		/**
+		 * @brief Maximum time the ControlMode may take to compute its output - 0 disables the check
+		 */
+		void setMaxTickTime(const double& max_tick_time);
+		double getMaxTickTime() const;
+
+		/**
+		 * @brief Maximum time a sensor may be inactive - 0 disables the check
+		 */
+		void setMaxSensorAge(const double& max_sensor_age);
+		double getMaxSensorAge() const;
+
+		/**
+		 * @brief The ControlMode to switch to if the watchdog fires - empty to use the safe control mode of the HybridAutomaton
+		 */
+		void setFallbackControlMode(const std::string& control_mode);
+		const std::string& getFallbackControlMode() const;
+
+		/**
+		 * @brief The sensors whose age is checked - set by HybridAutomaton::initialize
+		 */
+		void setSensors(const std::vector<Sensor::ConstPtr>& sensors);
+		const std::vector<Sensor::ConstPtr>& getSensors() const;
+
+		/**
+		 * @brief Restart the supervision - is called when the ControlMode is activated at time \a t
+		 */
+		void reset(const double& t);
+
+		/**
+		 * @brief Returns false and fills \a error if a sensor has been inactive for too long
+		 */
+		bool checkSensors(const double& t, ErrorRecord& error);
+
+		/**
+		 * @brief Returns false and fills \a error if \a tick_time (in seconds) exceeds the maximum tick time
+		 */
+		bool checkTickTime(const double& tick_time, ErrorRecord& error) const;
+
+		virtual DescriptionTreeNode::Ptr serialize(const DescriptionTree::ConstPtr& factory) const;
+		virtual void deserialize(const DescriptionTreeNode::ConstPtr& tree, const System::ConstPtr& system, const HybridAutomaton* ha);
+
+	protected:
+		virtual Watchdog* _doClone() const
+		{
+			return new Watchdog(*this);
+		}
+
+		double _max_tick_time;
+		double _max_sensor_age;
+		std::string _fallback_control_mode;
+
+		std::vector<Sensor::ConstPtr> _sensors;
+
+		// time since which each sensor is inactive - the activation time until it has been active once
+		std::vector<double> _inactive_since;
+	};
+
+}
+
+#endif
@@ -0,0 +1,133 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef HYBRID_AUTOMATON_XML_STREAM_PARSER_H_
+#define HYBRID_AUTOMATON_XML_STREAM_PARSER_H_
+
+#include <boost/shared_ptr.hpp>
+
+#include <istream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ha {
+
+	/**
+	 * @brief Receives the elements found by the XMLStreamParser
+	 */
+	class XMLStreamHandler
+	{
+	public:
+		typedef std::vector< std::pair<std::string, std::string> > AttributeList;
+
+		virtual ~XMLStreamHandler() {}
+
+		/**
+		 * @brief Called for every opening (or empty) element with its decoded attributes in document order
+		 */
+		virtual void startElement(const std::string& name, const AttributeList& attributes) = 0;
+
+		/**
+		 * @brief Called for every closing element - and right after startElement for empty elements
+		 */
+		virtual void endElement(const std::string& name) = 0;
+	};
+
+	/**
+	 * @brief A streaming (SAX-style) parser for the XML subset used by hybrid automaton descriptions
+	 *
+	 * The input is read in chunks and every element is handed to an XMLStreamHandler while it is parsed -
+	 * no document tree is built. The declaration, comments, processing instructions, DOCTYPE and CDATA
+	 * sections are skipped, as is character data between the elements. The predefined entities and
+	 * character references are decoded in attribute values.
+	 */
+	class XMLStreamParser
+	{
+	public:
+		typedef boost::shared_ptr<XMLStreamParser> Ptr;
+		typedef boost::shared_ptr<const XMLStreamParser> ConstPtr;
+
+		XMLStreamParser(std::size_t buffer_size = 65536);
+
+		virtual ~XMLStreamParser();
+
+		/**
+		 * @brief Parses the document in \a input and hands its elements to \a handler
+		 *
+		 * @throws Error on syntax errors and mismatched or missing closing elements
+		 */
+		void parse(std::istream& input, XMLStreamHandler& handler);
+
+		/**
+		 * @brief Parses the document in the string \a input
+		 */
+		void parse(const std::string& input, XMLStreamHandler& handler);
+
+	protected:
+		// next character of the input, -1 at its end
+		int _get();
+
+		// next character without consuming it
+		int _peek();
+
+		// like _get, but throws at the end of the input
+		int _expect(const char* context);
+
+		void _skipWhitespace();
+
+		// consume the input up to and including \a terminator
+		void _skipPast(const char* terminator, const char* context);
+
+		// read an element or attribute name starting with \a first
+		void _readName(int first, std::string& name);
+
+		void _readAttributeValue(int quote, std::string& value);
+
+		// skip a comment, CDATA section or declaration after "<!"
+		void _parseMarkup();
+
+		void _parseElement(int first, XMLStreamHandler& handler);
+
+		void _parseClosingElement(XMLStreamHandler& handler);
+
+		std::istream* _input;
+		std::vector<char> _buffer;
+		std::size_t _position;
+		std::size_t _end;
+		std::size_t _line;
+
+		// names of the open elements - the first _depth entries are valid
+		std::vector<std::string> _open_elements;
+		std::size_t _depth;
+		bool _root_closed;
+
+		// reused between elements to avoid allocations
+		XMLStreamHandler::AttributeList _attributes;
+		std::string _name;
+	};
+}
+
+#endif
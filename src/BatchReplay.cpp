@@ -0,0 +1,240 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "hybrid_automaton/BatchReplay.h"
+
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <algorithm>
+#include <deque>
+
+namespace ha {
+
+	namespace {
+
+		// each worker takes jobs from the front of its own queue and steals from the back of the others
+		class WorkStealingQueues
+		{
+		public:
+			WorkStealingQueues(std::size_t number_of_workers, std::size_t number_of_jobs)
+				: _queues(number_of_workers), _mutexes(number_of_workers)
+			{
+				for (std::size_t i = 0; i < _mutexes.size(); ++i)
+					_mutexes[i].reset(new boost::mutex);
+				// contiguous ranges, so that a worker only competes for its queue once the others are idle
+				for (std::size_t job = 0; job < number_of_jobs; ++job)
+					_queues[job * number_of_workers / number_of_jobs].push_back(job);
+			}
+
+			bool pop(std::size_t worker, std::size_t& job)
+			{
+				{
+					boost::mutex::scoped_lock lock(*_mutexes[worker]);
+					if (!_queues[worker].empty()) {
+						job = _queues[worker].front();
+						_queues[worker].pop_front();
+						return true;
+					}
+				}
+				for (std::size_t i = 1; i < _queues.size(); ++i) {
+					std::size_t victim = (worker + i) % _queues.size();
+					boost::mutex::scoped_lock lock(*_mutexes[victim]);
+					if (!_queues[victim].empty()) {
+						job = _queues[victim].back();
+						_queues[victim].pop_back();
+						return true;
+					}
+				}
+				return false;
+			}
+
+		private:
+			std::vector<std::deque<std::size_t> > _queues;
+			std::vector<boost::shared_ptr<boost::mutex> > _mutexes;
+		};
+
+		struct Worker
+		{
+			const BatchReplay* batch;
+			void (BatchReplay::*replay)(const std::string&, BatchReplay::Run&) const;
+			WorkStealingQueues* queues;
+			const std::vector<std::string>* logs;
+			std::vector<BatchReplay::Run>* runs;
+			std::size_t id;
+
+			void operator()() const
+			{
+				std::size_t job;
+				while (queues->pop(id, job))
+					(batch->*replay)((*logs)[job], (*runs)[job]);
+			}
+		};
+	}
+
+	BatchReplay::BatchReplay(const DescriptionTreeNode::ConstPtr& description)
+		: _description(description)
+	{
+	}
+
+	BatchReplay::~BatchReplay()
+	{
+	}
+
+	HybridAutomaton::Ptr BatchReplay::createAutomaton(const System::ConstPtr& system) const
+	{
+		if (!_description) {
+			HA_THROW_ERROR("BatchReplay.createAutomaton", "No description of the hybrid automaton given!");
+		}
+		HybridAutomaton::Ptr ha(new HybridAutomaton);
+		ha->deserialize(_description, system);
+		return ha;
+	}
+
+	std::vector<BatchReplay::Run> BatchReplay::run(const std::vector<std::string>& logs, unsigned int number_of_threads) const
+	{
+		std::vector<Run> runs(logs.size());
+		if (logs.empty())
+			return runs;
+
+		if (number_of_threads == 0)
+			number_of_threads = std::max(1u, boost::thread::hardware_concurrency());
+		if (number_of_threads > logs.size())
+			number_of_threads = logs.size();
+
+		WorkStealingQueues queues(number_of_threads, logs.size());
+
+		Worker worker;
+		worker.batch = this;
+		worker.replay = &BatchReplay::_replay;
+		worker.queues = &queues;
+		worker.logs = &logs;
+		worker.runs = &runs;
+
+		boost::thread_group threads;
+		for (unsigned int i = 1; i < number_of_threads; ++i) {
+			worker.id = i;
+			threads.create_thread(worker);
+		}
+		// the calling thread is worker 0
+		worker.id = 0;
+		worker();
+		threads.join_all();
+
+		return runs;
+	}
+
+	void BatchReplay::_replay(const std::string& log, Run& run) const
+	{
+		run.log = log;
+		try {
+			ReplaySystem::Ptr system(new ReplaySystem(log));
+			HybridAutomaton::Ptr ha = createAutomaton(system);
+			run.result = ReplayDriver::run(ha, system);
+		}
+		catch (const std::string& error) {
+			run.failed = true;
+			run.error = error;
+		}
+		catch (const std::exception& e) {
+			run.failed = true;
+			run.error = e.what();
+		}
+		catch (...) {
+			run.failed = true;
+			run.error = "Unknown exception.";
+		}
+	}
+
+	BatchReplay::Summary BatchReplay::summarize(const std::vector<Run>& runs)
+	{
+		Summary summary;
+		for (std::size_t i = 0; i < runs.size(); ++i)
+			summary.add(runs[i]);
+		return summary;
+	}
+
+	void BatchReplay::Summary::add(const Run& run)
+	{
+		++logs;
+		if (run.failed) {
+			++failed;
+			return;
+		}
+
+		steps += run.result.steps;
+		for (std::size_t i = 0; i < run.result.transitions.size(); ++i) {
+			if (run.result.transitions[i].fallback)
+				++fallbacks;
+			else
+				++switch_counts[run.result.transitions[i].control_switch];
+		}
+		for (std::map<std::string, double>::const_iterator it = run.result.time_in_mode.begin(); it != run.result.time_in_mode.end(); ++it)
+			time_in_mode[it->first] += it->second;
+		++terminal_modes[run.result.terminal_mode];
+	}
+
+	void BatchReplay::Summary::write(std::ostream& out) const
+	{
+		out << "logs: " << logs << std::endl;
+		out << "failed: " << failed << std::endl;
+		out << "steps: " << steps << std::endl;
+
+		out << "switches:" << std::endl;
+		for (std::map<std::string, std::size_t>::const_iterator it = switch_counts.begin(); it != switch_counts.end(); ++it)
+			out << "  " << it->first << ": " << it->second << std::endl;
+		out << "fallbacks: " << fallbacks << std::endl;
+
+		out << "time_in_mode:" << std::endl;
+		for (std::map<std::string, double>::const_iterator it = time_in_mode.begin(); it != time_in_mode.end(); ++it)
+			out << "  " << it->first << ": " << it->second << std::endl;
+
+		out << "terminal_modes:" << std::endl;
+		for (std::map<std::string, std::size_t>::const_iterator it = terminal_modes.begin(); it != terminal_modes.end(); ++it)
+			out << "  " << it->first << ": " << it->second << std::endl;
+	}
+
+	void BatchReplay::writeSummary(const std::vector<Run>& runs, std::ostream& out)
+	{
+		summarize(runs).write(out);
+
+		out << "runs:" << std::endl;
+		for (std::size_t i = 0; i < runs.size(); ++i) {
+			out << "  " << runs[i].log << ": ";
+			if (runs[i].failed) {
+				// errors end with a newline
+				std::string error = runs[i].error;
+				while (!error.empty() && (error[error.size() - 1] == '\n'))
+					error.erase(error.size() - 1);
+				out << "FAILED " << error << std::endl;
+			}
+			else {
+				out << runs[i].result.terminal_mode << " after " << runs[i].result.transitions.size()
+					<< " transitions" << std::endl;
+			}
+		}
+	}
+
+}
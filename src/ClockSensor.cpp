@@ -51,6 +51,13 @@ namespace ha
 		return ret;
 	}
 
+	bool ClockSensor::getDimensions(int& rows, int& cols) const
+	{
+		rows = 1;
+		cols = 1;
+		return true;
+	}
+
 	void ClockSensor::initialize(const double& t) 
 	{
 		this->_current_time = t;
@@ -27,13 +27,33 @@
 #include "hybrid_automaton/System.h"
 #include "hybrid_automaton/HybridAutomaton.h"
 #include "hybrid_automaton/error_handling.h"
+#include "hybrid_automaton/Profiler.h"
 
 namespace ha {
 	ControlMode::ControlMode(const std::string& name)
 		: _name(name)
 	{
 	}
+
+	ControlMode::ControlMode(const ControlMode& cm)
+		: _name(cm._name)
+	{
+		if (cm._control_set)
+			_control_set = cm._control_set->clone();
+		if (cm._watchdog)
+			_watchdog = cm._watchdog->clone();
+	}
 	
+	::Eigen::MatrixXd ControlMode::step(const double& t)
+	{
+		// out of line: HA_PROFILE_SCOPE depends on how the library was built, not on the includer
+		HA_PROFILE_SCOPE(_step_profile, "ControlMode.step", _name);
+		if (_control_set)
+			return _control_set->step(t);
+		else
+			HA_THROW_ERROR("ControlSet.step", "No control set defined.");
+	}
+
 	DescriptionTreeNode::Ptr ControlMode::serialize(const DescriptionTree::ConstPtr& factory) const 
 	{
 		DescriptionTreeNode::Ptr tree_node = factory->createNode("ControlMode");
@@ -43,6 +63,9 @@ namespace ha {
 			HA_THROW_ERROR("ControlMode.serialize", "Control set is null!");
 		}
 		tree_node->addChildNode(this->_control_set->serialize(factory));
+
+		if (_watchdog)
+			tree_node->addChildNode(_watchdog->serialize(factory));
 		return tree_node;
 	}
 	
@@ -68,6 +91,24 @@ namespace ha {
 		DescriptionTreeNode::ConstPtr first = * (control_set.begin());
 		this->_control_set = HybridAutomaton::createControlSet(first, system, ha);
 
+		_deserializeWatchdog(tree, system, ha);
+	}
+
+	void ControlMode::_deserializeWatchdog(const DescriptionTreeNode::ConstPtr& tree, const System::ConstPtr& system, const HybridAutomaton* ha)
+	{
+		DescriptionTreeNode::ConstNodeList watchdog;
+		tree->getChildrenNodes("Watchdog", watchdog);
+
+		if (watchdog.size() > 1) {
+			HA_THROW_ERROR("ControlMode.deserialize", "Too many (>1) watchdogs found!");
+		}
+
+		_watchdog.reset();
+		if (!watchdog.empty()) {
+			_watchdog.reset(new Watchdog);
+			_watchdog->deserialize(*watchdog.begin(), system, ha);
+		}
+
 	}
 
 }
\ No newline at end of file
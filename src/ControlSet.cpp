@@ -27,16 +27,35 @@
 #include "hybrid_automaton/HybridAutomaton.h"
 #include "hybrid_automaton/error_handling.h"
 
+#include <algorithm>
+
 namespace ha {
 
+	namespace {
+		bool hasHigherPriority(const Controller::Ptr& c1, const Controller::Ptr& c2)
+		{
+			return c1->getPriority() > c2->getPriority();
+		}
+	}
+
 	ControlSet::ControlSet()
 	{
 	}
 
 	ControlSet::ControlSet(const ControlSet& cs)
 	{
+		this->_name = cs._name;
 		this->_type = cs._type;
-		this->_controllers = cs._controllers;
+		this->_additional_arguments = cs._additional_arguments;
+
+		// controllers have state - every copy needs its own
+		const std::vector<Controller::Ptr>& controllers = cs.getControllersByPriority();
+		for (std::vector<Controller::Ptr>::const_iterator it = controllers.begin(); it != controllers.end(); ++it)
+		{
+			Controller::Ptr controller = (*it)->clone();
+			this->_controllers[controller->getName()] = controller;
+			this->_controllers_by_priority.push_back(controller);
+		}
 	}
 
 	void ControlSet::initialize() {
@@ -133,9 +152,45 @@ namespace ha {
 		}
 
 		this->_controllers[name] = controller;
+		this->_controllers_by_priority.insert(std::upper_bound(_controllers_by_priority.begin(), _controllers_by_priority.end(), controller, hasHigherPriority), controller);
 		this->_addController(controller); // call user defined overloaded method
 	}
 
+	const std::vector<Controller::Ptr>& ControlSet::getControllersByPriority() const
+	{
+		return _controllers_by_priority;
+	}
+
+	void ControlSet::setControllerPriority(const std::string& name, double priority)
+	{
+		std::map<std::string, Controller::Ptr>::iterator it = _controllers.find(name);
+		if (it == _controllers.end()) {
+			HA_THROW_ERROR("ControlSet.setControllerPriority", "No controller with name: " << name);
+		}
+		it->second->setPriority(priority);
+		std::stable_sort(_controllers_by_priority.begin(), _controllers_by_priority.end(), hasHigherPriority);
+	}
+
+	void ControlSet::sortControllersByPriority()
+	{
+		// keep the order of the known controllers, the new ones follow in the order of their names
+		std::vector<Controller::Ptr> controllers;
+		controllers.reserve(_controllers.size());
+		for (std::vector<Controller::Ptr>::const_iterator it = _controllers_by_priority.begin(); it != _controllers_by_priority.end(); ++it)
+		{
+			std::map<std::string, Controller::Ptr>::const_iterator found = _controllers.find((*it)->getName());
+			if (found != _controllers.end() && found->second == *it)
+				controllers.push_back(*it);
+		}
+		for (std::map<std::string, Controller::Ptr>::const_iterator it = _controllers.begin(); it != _controllers.end(); ++it)
+		{
+			if (std::find(controllers.begin(), controllers.end(), it->second) == controllers.end())
+				controllers.push_back(it->second);
+		}
+		std::stable_sort(controllers.begin(), controllers.end(), hasHigherPriority);
+		_controllers_by_priority.swap(controllers);
+	}
+
 	/*
 	const std::vector<Controller::Ptr>& ControlSet::getControllers() const
 	{
@@ -25,8 +25,25 @@
  */
 #include "hybrid_automaton/ControlSwitch.h"
 #include "hybrid_automaton/HybridAutomaton.h"
+#include "hybrid_automaton/Profiler.h"
+
+#include <typeinfo>
 
 namespace ha {
+
+	// evaluation times are compared with this tolerance to avoid skipping a slot due to rounding errors in t
+	static const double EVALUATION_TIME_TOLERANCE = 1e-9;
+
+	ControlSwitch::ControlSwitch(const ControlSwitch& cs)
+		: _name(cs._name), _evaluation_period(cs._evaluation_period), _next_evaluation_time(0.0), _expression(cs._expression),
+		  _priority(cs._priority), _evaluations(0), _activations(0),
+		  _hybrid_automaton(cs._hybrid_automaton)
+	{
+		// jump conditions have state - every copy needs its own
+		for (std::vector<JumpConditionPtr>::const_iterator it = cs._jump_conditions.begin(); it != cs._jump_conditions.end(); ++it)
+			_jump_conditions.push_back((*it)->clone());
+	}
+
 	void ControlSwitch::add(const JumpConditionPtr& jump_condition)
 	{
 		_jump_conditions.push_back(jump_condition);
@@ -37,18 +54,103 @@ namespace ha {
 		return _jump_conditions;
 	}
 
+	void ControlSwitch::setExpression(const std::string& expression)
+	{
+		_expression.compile(expression);
+	}
+
+	const std::string& ControlSwitch::getExpression() const
+	{
+		return _expression.getExpression();
+	}
+
+	void ControlSwitch::validate(ValidationReport& report)
+	{
+		if (_jump_conditions.empty())
+			report.addWarning("ControlSwitch '" + _name + "'", "No JumpConditions - the switch is active in every control cycle.");
+
+		for (std::size_t i = 0; i < _jump_conditions.size(); ++i) {
+			std::ostringstream origin;
+			origin << "ControlSwitch '" << _name << "', JumpCondition " << i;
+			_jump_conditions[i]->validate(report, origin.str());
+
+			if (!_expression.empty() && !_expression.usesCondition(i))
+				report.addWarning(origin.str(), "Not used in the expression '" + _expression.getExpression() + "'.");
+		}
+
+		if (_expression.getNumberOfConditions() > _jump_conditions.size()) {
+			std::ostringstream message;
+			message << "The expression '" << _expression.getExpression() << "' refers to JumpCondition "
+				<< _expression.getNumberOfConditions() - 1 << ", but there are only " << _jump_conditions.size() << "!";
+			report.addError("ControlSwitch '" + _name + "'", message.str());
+		}
+	}
+
 	bool ControlSwitch::isActive() const 
 	{
+		ErrorRecord error;
+		bool active = false;
+		if (!_isActive(active, error)) {
+			HA_THROW_ERROR(error.origin, error.message);
+		}
+		if (active) {
+			HA_INFO("ControlSwitch.isActive", "Jump condition: "<<this->getName());
+		}
+		return active;
+	}
+
+	bool ControlSwitch::tryIsActive(bool& active, ErrorRecord& error) const
+	{
+		active = false;
+		// a subclass may override isActive() - only then the virtual call and its exceptions need to be handled
+		try
+		{
+			if (typeid(*this) == typeid(ControlSwitch))
+				return _isActive(active, error);
+			active = this->isActive();
+			return true;
+		}
+		catch (const std::string& e)
+		{
+			error.set(ErrorRecord::FAULT_JUMP_CONDITION, "ControlSwitch.isActive", "%s", e.c_str());
+		}
+		catch (const std::exception& e)
+		{
+			error.set(ErrorRecord::FAULT_JUMP_CONDITION, "ControlSwitch.isActive", "%s", e.what());
+		}
+		catch (...)
+		{
+			error.set(ErrorRecord::FAULT_JUMP_CONDITION, "ControlSwitch.isActive", "Unknown exception in control switch '%s'.", _name.c_str());
+		}
+		active = false;
+		return false;
+	}
+
+	bool ControlSwitch::_isActive(bool& active, ErrorRecord& error) const
+	{
+		HA_PROFILE_SCOPE(_is_active_profile, "ControlSwitch.isActive", _name);
+		for (std::vector<JumpConditionPtr>::const_iterator it = _jump_conditions.begin(); it != _jump_conditions.end(); ++it)
+			(*it)->clearEvaluated();
+
+		if (!_expression.empty())
+			return _expression.evaluate(_jump_conditions, active, error);
+
+		active = false;
 		for (std::vector<JumpConditionPtr>::const_iterator it = _jump_conditions.begin(); it != _jump_conditions.end(); ++it) {
-			if (!(*it)->isActive())
+			bool condition_active = false;
+			if (!(*it)->tryIsActive(condition_active, error))
 				return false;
+			if (!condition_active)
+				return true;
 		}
-		HA_INFO("ControlSwitch.isActive", "Jump condition: "<<this->getName());
+		active = true;
 		return true;
 	}
 
 	void ControlSwitch::initialize(const double& t) 
 	{
+		_next_evaluation_time = t;
+
 		for (std::vector<JumpConditionPtr>::const_iterator it = _jump_conditions.begin(); it != _jump_conditions.end(); ++it) {
 			(*it)->initialize(t);
 		}
@@ -63,10 +165,109 @@ namespace ha {
 
 	void ControlSwitch::step(const double& t) 
 	{
+		ErrorRecord error;
+		if (!_step(t, error)) {
+			HA_THROW_ERROR(error.origin, error.message);
+		}
+	}
+
+	bool ControlSwitch::tryStep(const double& t, ErrorRecord& error) 
+	{
+		// a subclass may override step() - only then the virtual call and its exceptions need to be handled
+		try
+		{
+			if (typeid(*this) == typeid(ControlSwitch))
+				return _step(t, error);
+			this->step(t);
+			return true;
+		}
+		catch (const std::string& e)
+		{
+			error.set(ErrorRecord::FAULT_JUMP_CONDITION, "ControlSwitch.step", "%s", e.c_str());
+		}
+		catch (const std::exception& e)
+		{
+			error.set(ErrorRecord::FAULT_JUMP_CONDITION, "ControlSwitch.step", "%s", e.what());
+		}
+		catch (...)
+		{
+			error.set(ErrorRecord::FAULT_JUMP_CONDITION, "ControlSwitch.step", "Unknown exception in control switch '%s'.", _name.c_str());
+		}
+		return false;
+	}
+
+	bool ControlSwitch::_step(const double& t, ErrorRecord& error)
+	{
+		HA_PROFILE_SCOPE(_step_profile, "ControlSwitch.step", _name);
 		for (std::vector<JumpConditionPtr>::const_iterator it = _jump_conditions.begin(); it != _jump_conditions.end(); ++it) 
 		{
-			(*it)->step(t);
+			if (!(*it)->tryStep(t, error))
+				return false;
 		}
+		return true;
+	}
+
+	void ControlSwitch::setEvaluationRate(const double& rate)
+	{
+		if (rate < 0.0) {
+			HA_THROW_ERROR("ControlSwitch.setEvaluationRate", "Evaluation rate of control switch '" << _name << "' must not be negative!");
+		}
+		_evaluation_period = (rate > 0.0) ? 1.0 / rate : 0.0;
+	}
+
+	double ControlSwitch::getEvaluationRate() const
+	{
+		return (_evaluation_period > 0.0) ? 1.0 / _evaluation_period : 0.0;
+	}
+
+	bool ControlSwitch::isEvaluationDue(const double& t) const
+	{
+		return (_evaluation_period <= 0.0 || t >= _next_evaluation_time - EVALUATION_TIME_TOLERANCE);
+	}
+
+	void ControlSwitch::scheduleNextEvaluation(const double& t)
+	{
+		if (_evaluation_period <= 0.0)
+			return;
+
+		_next_evaluation_time += _evaluation_period;
+
+		// do not try to catch up on missed evaluations (e.g. after an overrun) - continue from now
+		if (_next_evaluation_time < t - EVALUATION_TIME_TOLERANCE)
+			_next_evaluation_time = t + _evaluation_period;
+	}
+
+	void ControlSwitch::setPriority(int priority)
+	{
+		_priority = priority;
+	}
+
+	int ControlSwitch::getPriority() const
+	{
+		return _priority;
+	}
+
+	unsigned long ControlSwitch::getNumberOfEvaluations() const
+	{
+		return _evaluations;
+	}
+
+	unsigned long ControlSwitch::getNumberOfActivations() const
+	{
+		return _activations;
+	}
+
+	void ControlSwitch::recordEvaluation(bool active)
+	{
+		_evaluations++;
+		if (active)
+			_activations++;
+	}
+
+	void ControlSwitch::resetStatistics()
+	{
+		_evaluations = 0;
+		_activations = 0;
 	}
 
 	void ControlSwitch::setName(const std::string& name) 
@@ -85,6 +286,15 @@ namespace ha {
 		tree_node->setAttribute<std::string>(std::string("name"), this->getName());
 		tree_node->setAttribute<std::string>(std::string("source"), _hybrid_automaton->getSourceControlMode(this->_name)->getName());
 		tree_node->setAttribute<std::string>(std::string("target"), _hybrid_automaton->getTargetControlMode(this->_name)->getName());
+
+		if (_evaluation_period > 0.0)
+			tree_node->setAttribute<double>(std::string("evaluation_rate"), this->getEvaluationRate());
+
+		if (_priority != 0)
+			tree_node->setAttribute<int>(std::string("priority"), _priority);
+
+		if (!_expression.empty())
+			tree_node->setAttribute<std::string>(std::string("expression"), _expression.getExpression());
 		
 		for (std::vector<JumpConditionPtr>::const_iterator it = _jump_conditions.begin(); it != _jump_conditions.end(); ++it) {
 			tree_node->addChildNode((*it)->serialize(factory));
@@ -101,6 +311,12 @@ namespace ha {
 
 		tree->getAttribute<std::string>("name", _name, "");
 
+		double evaluation_rate;
+		tree->getAttribute<double>("evaluation_rate", evaluation_rate, 0.0);
+		this->setEvaluationRate(evaluation_rate);
+
+		tree->getAttribute<int>("priority", _priority, 0);
+
 		DescriptionTreeNode::ConstNodeList jump_conditions;
 		tree->getChildrenNodes("JumpCondition", jump_conditions);
 
@@ -125,6 +341,15 @@ namespace ha {
 			js->deserialize(*js_it, system, ha);
 			this->add(js);
 		}
+
+		std::string expression;
+		tree->getAttribute<std::string>("expression", expression, "");
+		this->setExpression(expression);
+
+		if (_expression.getNumberOfConditions() > _jump_conditions.size()) {
+			HA_THROW_ERROR("ControlSwitch.deserialize", "The expression '" << expression << "' of control switch '" << _name << "' refers to JumpCondition "
+				<< _expression.getNumberOfConditions() - 1 << ", but there are only " << _jump_conditions.size() << "!");
+		}
 	}
 
 	void ControlSwitch::setHybridAutomaton(const HybridAutomaton* hybrid_automaton)
@@ -60,6 +60,9 @@ namespace ha {
 		this->_do_reinterpolation = controller._do_reinterpolation;
 		this->_priority = controller._priority;
 		this->_name = controller._name;
+		this->_type = controller._type;
+		this->_system = controller._system;
+		this->_additional_arguments = controller._additional_arguments;
 	}
 
 	DescriptionTreeNode::Ptr Controller::serialize(const DescriptionTree::ConstPtr& factory) const 
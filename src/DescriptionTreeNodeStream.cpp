@@ -0,0 +1,121 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "hybrid_automaton/DescriptionTreeNodeStream.h"
+
+namespace ha {
+
+	DescriptionTreeNodeStream::DescriptionTreeNodeStream(const std::string& type)
+		: _type(type)
+	{
+	}
+
+	DescriptionTreeNodeStream::DescriptionTreeNodeStream(const std::string& type, const AttributeList& attributes)
+		: _type(type), _attributes(attributes)
+	{
+	}
+
+	DescriptionTreeNodeStream::DescriptionTreeNodeStream(const DescriptionTreeNodeStream& dtn)
+		: DescriptionTreeNode(dtn), _type(dtn._type), _attributes(dtn._attributes), _children(dtn._children)
+	{
+	}
+
+	DescriptionTreeNodeStream::~DescriptionTreeNodeStream()
+	{
+	}
+
+	const std::string DescriptionTreeNodeStream::getType() const
+	{
+		return _type;
+	}
+
+	bool DescriptionTreeNodeStream::getAttributeString(const std::string& field_name, std::string& field_value) const
+	{
+		for (AttributeList::const_iterator it = _attributes.begin(); it != _attributes.end(); ++it)
+		{
+			if (it->first == field_name)
+			{
+				field_value = it->second;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void DescriptionTreeNodeStream::setAttributeString(const std::string& field_name, const std::string& field_value)
+	{
+		for (AttributeList::iterator it = _attributes.begin(); it != _attributes.end(); ++it)
+		{
+			if (it->first == field_name)
+			{
+				it->second = field_value;
+				return;
+			}
+		}
+		_attributes.push_back(std::make_pair(field_name, field_value));
+	}
+
+	bool DescriptionTreeNodeStream::getChildrenNodes(const std::string& type, ConstNodeList& children) const
+	{
+		bool foundChildren = false;
+		for (std::size_t i = 0; i < _children.size(); ++i)
+		{
+			if (_children[i]->getType() == type)
+			{
+				children.push_back(_children[i]);
+				foundChildren = true;
+			}
+		}
+		return foundChildren;
+	}
+
+	bool DescriptionTreeNodeStream::getChildrenNodes(ConstNodeList& children) const
+	{
+		children.insert(children.end(), _children.begin(), _children.end());
+		return !_children.empty();
+	}
+
+	void DescriptionTreeNodeStream::addChildNode(const DescriptionTreeNode::Ptr& child)
+	{
+		_children.push_back(child);
+	}
+
+	void DescriptionTreeNodeStream::getAllAttributes(std::map<std::string, std::string> & attrs) const
+	{
+		attrs.clear();
+		attrs.insert(_attributes.begin(), _attributes.end());
+	}
+
+	const DescriptionTreeNodeStream::AttributeList& DescriptionTreeNodeStream::getAttributes() const
+	{
+		return _attributes;
+	}
+
+	const std::vector<DescriptionTreeNode::ConstPtr>& DescriptionTreeNodeStream::getChildren() const
+	{
+		return _children;
+	}
+
+}
@@ -0,0 +1,144 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "hybrid_automaton/DescriptionTreeStream.h"
+#include "hybrid_automaton/error_handling.h"
+
+namespace ha {
+
+	namespace {
+		void writeIndent(std::ostream& out, int depth)
+		{
+			for (int i = 0; i < depth; ++i)
+				out.put('\t');
+		}
+
+		// the characters TinyXML encodes in attribute values
+		void writeEscaped(std::ostream& out, const std::string& value)
+		{
+			std::size_t begin = 0;
+			for (std::size_t i = 0; i < value.size(); ++i)
+			{
+				const char* entity = NULL;
+				switch (value[i]) {
+					case '&': entity = "&amp;"; break;
+					case '<': entity = "&lt;"; break;
+					case '>': entity = "&gt;"; break;
+					case '"': entity = "&quot;"; break;
+					case '\'': entity = "&apos;"; break;
+					case '\n': entity = "&#x0A;"; break;
+					case '\r': entity = "&#x0D;"; break;
+					case '\t': entity = "&#x09;"; break;
+					default: break;
+				}
+				if (entity) {
+					out.write(value.data() + begin, i - begin);
+					out << entity;
+					begin = i + 1;
+				}
+			}
+			out.write(value.data() + begin, value.size() - begin);
+		}
+
+		const DescriptionTreeNodeStream& streamNode(const DescriptionTreeNode::ConstPtr& node)
+		{
+			const DescriptionTreeNodeStream* stream_node = dynamic_cast<const DescriptionTreeNodeStream*>(node.get());
+			if (!stream_node)
+				HA_THROW_ERROR("DescriptionTreeStream.writeXML", "Node '" << (node ? node->getType() : std::string("NULL")) << "' was not created by a DescriptionTreeStream!");
+			return *stream_node;
+		}
+
+		void writeOpeningTag(const DescriptionTreeNodeStream& node, std::ostream& out, int depth)
+		{
+			writeIndent(out, depth);
+			out << '<' << node.getType();
+			const DescriptionTreeNodeStream::AttributeList& attributes = node.getAttributes();
+			for (std::size_t i = 0; i < attributes.size(); ++i)
+			{
+				out << ' ' << attributes[i].first << "=\"";
+				writeEscaped(out, attributes[i].second);
+				out.put('"');
+			}
+		}
+	}
+
+	DescriptionTreeStream::DescriptionTreeStream()
+	{
+	}
+
+	DescriptionTreeStream::~DescriptionTreeStream()
+	{
+	}
+
+	DescriptionTreeNode::Ptr DescriptionTreeStream::createNode(const std::string& type) const
+	{
+		return DescriptionTreeNode::Ptr(new DescriptionTreeNodeStream(type));
+	}
+
+	DescriptionTreeNode::Ptr DescriptionTreeStream::getRootNode()
+	{
+		return _root_node;
+	}
+
+	void DescriptionTreeStream::setRootNode(const DescriptionTreeNode::Ptr& root_node)
+	{
+		_root_node = root_node;
+	}
+
+	void DescriptionTreeStream::writeTreeXML(std::ostream& out) const
+	{
+		if (_root_node)
+			writeXML(_root_node, out);
+	}
+
+	void DescriptionTreeStream::writeXML(const DescriptionTreeNode::ConstPtr& node, std::ostream& out, int depth)
+	{
+		const DescriptionTreeNodeStream& stream_node = streamNode(node);
+		const std::vector<DescriptionTreeNode::ConstPtr>& children = stream_node.getChildren();
+
+		writeOpeningTag(stream_node, out, depth);
+		if (children.empty()) {
+			out << " />\n";
+			return;
+		}
+
+		out << ">\n";
+		for (std::size_t i = 0; i < children.size(); ++i)
+			writeXML(children[i], out, depth + 1);
+		writeEndElement(stream_node.getType(), out, depth);
+	}
+
+	void DescriptionTreeStream::writeStartElement(const DescriptionTreeNode::ConstPtr& node, std::ostream& out, int depth)
+	{
+		writeOpeningTag(streamNode(node), out, depth);
+		out << ">\n";
+	}
+
+	void DescriptionTreeStream::writeEndElement(const std::string& type, std::ostream& out, int depth)
+	{
+		writeIndent(out, depth);
+		out << "</" << type << ">\n";
+	}
+}
@@ -0,0 +1,484 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "hybrid_automaton/DescriptionTreeTransport.h"
+#include "hybrid_automaton/error_handling.h"
+
+#include <boost/crc.hpp>
+#include <boost/cstdint.hpp>
+
+#include <cstring>
+#include <map>
+#include <vector>
+
+namespace ha {
+
+	namespace {
+		const char MAGIC[] = { 'H', 'A', 'T', 'P' };
+		const unsigned char VERSION = 1;
+
+		// the high bit of the stored length marks a compressed chunk
+		const unsigned long COMPRESSED_CHUNK = 0x80000000UL;
+
+		// LZ4-style block parameters
+		const std::size_t MIN_MATCH = 4;
+		const std::size_t MAX_OFFSET = 65535;
+		const std::size_t LAST_LITERALS = 5;
+		const int HASH_BITS = 14;
+
+		// a compressed byte expands to at most 255 bytes (one more byte of an extended match length)
+		const std::size_t MAX_EXPANSION = 255;
+
+		void writeUInt32(std::string& out, unsigned long value)
+		{
+			for (int i = 0; i < 4; ++i)
+				out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+		}
+
+		void writeVarint(std::string& out, std::size_t value)
+		{
+			while (value >= 0x80)
+			{
+				out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+				value >>= 7;
+			}
+			out.push_back(static_cast<char>(value));
+		}
+
+		void writeLength(std::string& out, std::size_t length)
+		{
+			for (; length >= 255; length -= 255)
+				out.push_back(static_cast<char>(255));
+			out.push_back(static_cast<char>(length));
+		}
+
+		unsigned long crc32(const char* data, std::size_t size)
+		{
+			boost::crc_32_type crc;
+			crc.process_bytes(data, size);
+			return crc.checksum();
+		}
+
+		inline unsigned long read32(const char* p)
+		{
+			boost::uint32_t value;
+			std::memcpy(&value, p, 4);
+			return value;
+		}
+
+		inline std::size_t hash32(unsigned long value)
+		{
+			return ((value * 2654435761UL) & 0xffffffffUL) >> (32 - HASH_BITS);
+		}
+
+		// bounds checked reading of an encoded buffer
+		class Reader
+		{
+		public:
+			Reader(const char* data, std::size_t size, const char* origin)
+				: _data(data), _size(size), _pos(0), _origin(origin)
+			{
+			}
+
+			bool atEnd() const
+			{
+				return _pos == _size;
+			}
+
+			const char* take(std::size_t count)
+			{
+				if (count > _size - _pos)
+					HA_THROW_ERROR(_origin, "Unexpected end of the data at byte " << _pos << ".");
+				const char* p = _data + _pos;
+				_pos += count;
+				return p;
+			}
+
+			unsigned char readByte()
+			{
+				return static_cast<unsigned char>(*take(1));
+			}
+
+			unsigned long readUInt32()
+			{
+				const unsigned char* p = reinterpret_cast<const unsigned char*>(take(4));
+				return static_cast<unsigned long>(p[0]) | (static_cast<unsigned long>(p[1]) << 8)
+					| (static_cast<unsigned long>(p[2]) << 16) | (static_cast<unsigned long>(p[3]) << 24);
+			}
+
+			std::size_t readVarint()
+			{
+				std::size_t value = 0;
+				for (int shift = 0; shift < 64; shift += 7)
+				{
+					unsigned char byte = readByte();
+					value |= static_cast<std::size_t>(byte & 0x7f) << shift;
+					if (!(byte & 0x80))
+						return value;
+				}
+				HA_THROW_ERROR(_origin, "Invalid number at byte " << _pos << ".");
+			}
+
+			std::size_t readLength(std::size_t length)
+			{
+				unsigned char byte;
+				do
+				{
+					byte = readByte();
+					length += byte;
+				} while (byte == 255);
+				return length;
+			}
+
+		private:
+			const char* _data;
+			std::size_t _size;
+			std::size_t _pos;
+			const char* _origin;
+		};
+
+		class TreeEncoder
+		{
+		public:
+			TreeEncoder(DescriptionTreeTransport::Statistics& statistics)
+				: _statistics(statistics)
+			{
+			}
+
+			void encode(const DescriptionTreeNode::ConstPtr& root, std::string& out)
+			{
+				_encodeNode(root);
+
+				writeVarint(out, _pool.size());
+				for (std::vector<const std::string*>::const_iterator it = _pool.begin(); it != _pool.end(); ++it)
+				{
+					writeVarint(out, (*it)->size());
+					out.append(**it);
+				}
+				out.append(_nodes);
+				_statistics.pooled_strings = _pool.size();
+			}
+
+		private:
+			void _writeString(const std::string& value)
+			{
+				std::map<std::string, std::size_t>::iterator it = _index.lower_bound(value);
+				if (it == _index.end() || it->first != value)
+				{
+					it = _index.insert(it, std::make_pair(value, _pool.size()));
+					_pool.push_back(&it->first);
+				}
+				writeVarint(_nodes, it->second);
+			}
+
+			void _encodeNode(const DescriptionTreeNode::ConstPtr& node)
+			{
+				++_statistics.nodes;
+				_writeString(node->getType());
+
+				std::map<std::string, std::string> attributes;
+				node->getAllAttributes(attributes);
+				writeVarint(_nodes, attributes.size());
+				for (std::map<std::string, std::string>::const_iterator it = attributes.begin(); it != attributes.end(); ++it)
+				{
+					_writeString(it->first);
+					_writeString(it->second);
+				}
+				_statistics.attributes += attributes.size();
+
+				DescriptionTreeNode::ConstNodeList children;
+				node->getChildrenNodes(children);
+				writeVarint(_nodes, children.size());
+				for (DescriptionTreeNode::ConstNodeListIterator it = children.begin(); it != children.end(); ++it)
+					_encodeNode(*it);
+			}
+
+			DescriptionTreeTransport::Statistics& _statistics;
+			std::map<std::string, std::size_t> _index;
+			std::vector<const std::string*> _pool;
+			std::string _nodes;
+		};
+
+		class TreeDecoder
+		{
+		public:
+			TreeDecoder(const std::string& data, const DescriptionTree::ConstPtr& factory)
+				: _reader(data.data(), data.size(), "DescriptionTreeTransport.decode"), _factory(factory)
+			{
+			}
+
+			DescriptionTreeNode::Ptr decode()
+			{
+				std::size_t pool_size = _reader.readVarint();
+				for (std::size_t i = 0; i < pool_size; ++i)
+				{
+					std::size_t length = _reader.readVarint();
+					_pool.push_back(std::string(_reader.take(length), length));
+				}
+
+				DescriptionTreeNode::Ptr root = _decodeNode(0);
+				if (!_reader.atEnd())
+					HA_THROW_ERROR("DescriptionTreeTransport.decode", "Unexpected data after the root node.");
+				return root;
+			}
+
+		private:
+			// guards against stack overflows on corrupted data
+			static const int MAX_DEPTH = 256;
+
+			const std::string& _readString()
+			{
+				std::size_t index = _reader.readVarint();
+				if (index >= _pool.size())
+					HA_THROW_ERROR("DescriptionTreeTransport.decode", "Invalid string index " << index << ".");
+				return _pool[index];
+			}
+
+			DescriptionTreeNode::Ptr _decodeNode(int depth)
+			{
+				if (depth > MAX_DEPTH)
+					HA_THROW_ERROR("DescriptionTreeTransport.decode", "The tree is nested deeper than " << MAX_DEPTH << " levels.");
+
+				DescriptionTreeNode::Ptr node = _factory->createNode(_readString());
+
+				std::size_t attributes = _reader.readVarint();
+				for (std::size_t i = 0; i < attributes; ++i)
+				{
+					const std::string& name = _readString();
+					node->setAttribute<std::string>(name, _readString());
+				}
+
+				std::size_t children = _reader.readVarint();
+				for (std::size_t i = 0; i < children; ++i)
+					node->addChildNode(_decodeNode(depth + 1));
+
+				return node;
+			}
+
+			Reader _reader;
+			DescriptionTree::ConstPtr _factory;
+			std::vector<std::string> _pool;
+		};
+	}
+
+	void DescriptionTreeTransport::encode(const DescriptionTreeNode::ConstPtr& node, std::string& out, const Options& options, Statistics* statistics)
+	{
+		if (!node)
+			HA_THROW_ERROR("DescriptionTreeTransport.encode", "The node is empty.");
+		if (options.chunk_size == 0 || options.chunk_size >= COMPRESSED_CHUNK)
+			HA_THROW_ERROR("DescriptionTreeTransport.encode", "Invalid chunk size " << options.chunk_size << ".");
+
+		Statistics local_statistics;
+		Statistics& stats = statistics ? *statistics : local_statistics;
+		stats = Statistics();
+
+		std::string tree;
+		TreeEncoder(stats).encode(node, tree);
+		stats.tree_bytes = tree.size();
+
+		std::size_t start = out.size();
+		out.append(MAGIC, sizeof(MAGIC));
+		out.push_back(static_cast<char>(VERSION));
+		out.push_back(static_cast<char>(options.compress ? 1 : 0));
+
+		std::string compressed;
+		for (std::size_t offset = 0; offset < tree.size(); offset += options.chunk_size)
+		{
+			const char* chunk = tree.data() + offset;
+			std::size_t size = std::min(options.chunk_size, tree.size() - offset);
+
+			writeUInt32(out, size);
+			if (options.compress)
+			{
+				compressed.clear();
+				compressBlock(chunk, size, compressed);
+			}
+
+			if (options.compress && compressed.size() < size)
+			{
+				writeUInt32(out, compressed.size() | COMPRESSED_CHUNK);
+				writeUInt32(out, crc32(chunk, size));
+				out.append(compressed);
+			}
+			else
+			{
+				writeUInt32(out, size);
+				writeUInt32(out, crc32(chunk, size));
+				out.append(chunk, size);
+			}
+			++stats.chunks;
+		}
+
+		writeUInt32(out, 0);
+		writeUInt32(out, 0);
+		writeUInt32(out, 0);
+		stats.encoded_bytes = out.size() - start;
+	}
+
+	DescriptionTreeNode::Ptr DescriptionTreeTransport::decode(const std::string& in, const DescriptionTree::ConstPtr& factory)
+	{
+		Reader reader(in.data(), in.size(), "DescriptionTreeTransport.decode");
+
+		if (std::memcmp(reader.take(sizeof(MAGIC)), MAGIC, sizeof(MAGIC)) != 0)
+			HA_THROW_ERROR("DescriptionTreeTransport.decode", "The data is not an encoded description tree.");
+		unsigned char version = reader.readByte();
+		if (version != VERSION)
+			HA_THROW_ERROR("DescriptionTreeTransport.decode", "Unsupported version " << static_cast<int>(version) << ".");
+		reader.readByte();
+
+		std::string tree;
+		for (std::size_t chunk = 0; ; ++chunk)
+		{
+			std::size_t raw_size = reader.readUInt32();
+			unsigned long stored = reader.readUInt32();
+			unsigned long checksum = reader.readUInt32();
+			if (raw_size == 0)
+				break;
+
+			std::size_t stored_size = stored & ~COMPRESSED_CHUNK;
+			const char* data = reader.take(stored_size);
+			std::size_t offset = tree.size();
+			if (stored & COMPRESSED_CHUNK)
+			{
+				decompressBlock(data, stored_size, raw_size, tree);
+			}
+			else
+			{
+				if (stored_size != raw_size)
+					HA_THROW_ERROR("DescriptionTreeTransport.decode", "Chunk " << chunk << " has an invalid length.");
+				tree.append(data, stored_size);
+			}
+
+			if (crc32(tree.data() + offset, raw_size) != checksum)
+				HA_THROW_ERROR("DescriptionTreeTransport.decode", "Checksum mismatch in chunk " << chunk << ".");
+		}
+
+		if (!reader.atEnd())
+			HA_THROW_ERROR("DescriptionTreeTransport.decode", "Unexpected data after the last chunk.");
+
+		return TreeDecoder(tree, factory).decode();
+	}
+
+	// Greedy LZ77 with a single hash table entry per 4 byte prefix. Each sequence is a token
+	// (4 bits literal length, 4 bits match length - 4), extended lengths, the literals and the
+	// 16 bit offset of the match. The last sequence consists of literals only.
+	void DescriptionTreeTransport::compressBlock(const char* in, std::size_t size, std::string& out)
+	{
+		std::size_t anchor = 0;
+
+		if (size > MIN_MATCH + LAST_LITERALS)
+		{
+			std::vector<long> table(1 << HASH_BITS, -1);
+			std::size_t limit = size - MIN_MATCH - LAST_LITERALS;
+
+			for (std::size_t pos = 0; pos < limit; )
+			{
+				unsigned long sequence = read32(in + pos);
+				std::size_t h = hash32(sequence);
+				long candidate = table[h];
+				table[h] = static_cast<long>(pos);
+
+				if (candidate < 0 || pos - candidate > MAX_OFFSET || read32(in + candidate) != sequence)
+				{
+					++pos;
+					continue;
+				}
+
+				std::size_t length = MIN_MATCH;
+				while (pos + length < size - LAST_LITERALS && in[candidate + length] == in[pos + length])
+					++length;
+
+				std::size_t literals = pos - anchor;
+				std::size_t match = length - MIN_MATCH;
+				out.push_back(static_cast<char>((std::min<std::size_t>(literals, 15) << 4) | std::min<std::size_t>(match, 15)));
+				if (literals >= 15)
+					writeLength(out, literals - 15);
+				out.append(in + anchor, literals);
+
+				std::size_t offset = pos - candidate;
+				out.push_back(static_cast<char>(offset & 0xff));
+				out.push_back(static_cast<char>(offset >> 8));
+				if (match >= 15)
+					writeLength(out, match - 15);
+
+				pos += length;
+				anchor = pos;
+			}
+		}
+
+		std::size_t literals = size - anchor;
+		out.push_back(static_cast<char>(std::min<std::size_t>(literals, 15) << 4));
+		if (literals >= 15)
+			writeLength(out, literals - 15);
+		out.append(in + anchor, literals);
+	}
+
+	void DescriptionTreeTransport::decompressBlock(const char* in, std::size_t size, std::size_t raw_size, std::string& out)
+	{
+		// raw_size comes from the header of the chunk - check it before it is used to allocate
+		if (raw_size / MAX_EXPANSION > size)
+			HA_THROW_ERROR("DescriptionTreeTransport.decompressBlock", "A block of " << size << " bytes cannot expand to " << raw_size << " bytes.");
+
+		Reader reader(in, size, "DescriptionTreeTransport.decompressBlock");
+		std::size_t start = out.size();
+		out.reserve(start + raw_size);
+
+		while (true)
+		{
+			unsigned char token = reader.readByte();
+
+			std::size_t literals = token >> 4;
+			if (literals == 15)
+				literals = reader.readLength(literals);
+			if (literals > raw_size - (out.size() - start))
+				HA_THROW_ERROR("DescriptionTreeTransport.decompressBlock", "The block is longer than " << raw_size << " bytes.");
+			out.append(reader.take(literals), literals);
+
+			if (reader.atEnd())
+				break;
+
+			std::size_t offset = reader.readByte();
+			offset |= static_cast<std::size_t>(reader.readByte()) << 8;
+			std::size_t length = token & 0x0f;
+			if (length == 15)
+				length = reader.readLength(length);
+			length += MIN_MATCH;
+
+			if (offset == 0 || offset > out.size() - start)
+				HA_THROW_ERROR("DescriptionTreeTransport.decompressBlock", "Invalid match offset " << offset << ".");
+			if (length > raw_size - (out.size() - start))
+				HA_THROW_ERROR("DescriptionTreeTransport.decompressBlock", "The block is longer than " << raw_size << " bytes.");
+
+			// byte by byte, the match may overlap the bytes it produces
+			std::size_t from = out.size() - offset;
+			for (std::size_t i = 0; i < length; ++i)
+				out.push_back(out[from + i]);
+		}
+
+		if (out.size() - start != raw_size)
+			HA_THROW_ERROR("DescriptionTreeTransport.decompressBlock", "The block is shorter than " << raw_size << " bytes.");
+	}
+
+}
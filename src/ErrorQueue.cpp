@@ -0,0 +1,111 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "hybrid_automaton/ErrorQueue.h"
+#include "hybrid_automaton/error_handling.h"
+
+namespace ha {
+
+	namespace {
+		// how often the logging thread looks for new records
+		const long LOG_PERIOD_MS = 10;
+	}
+
+	ErrorQueue::ErrorQueue(std::size_t capacity)
+		: _queue(capacity), _dropped(0), _logging(false), _out(NULL)
+	{
+	}
+
+	ErrorQueue::~ErrorQueue()
+	{
+		try {
+			stopLogging();
+		}
+		catch (...) {
+		}
+	}
+
+	bool ErrorQueue::push(const ErrorRecord& record)
+	{
+		if (_queue.push(record))
+			return true;
+
+		_dropped.fetch_add(1, boost::memory_order_relaxed);
+		return false;
+	}
+
+	bool ErrorQueue::pop(ErrorRecord& record)
+	{
+		return _queue.pop(record);
+	}
+
+	void ErrorQueue::startLogging(std::ostream& out)
+	{
+		if (_logging.load())
+			HA_THROW_ERROR("ErrorQueue.startLogging", "Error queue is already logging!");
+
+		_out = &out;
+		_logging.store(true);
+		_log_thread.reset(new boost::thread(&ErrorQueue::_logLoop, this));
+	}
+
+	void ErrorQueue::stopLogging()
+	{
+		if (!_logging.exchange(false))
+			return;
+
+		_log_thread->join();
+		_log_thread.reset();
+		_log();
+	}
+
+	boost::uint64_t ErrorQueue::getNumberOfDroppedRecords() const
+	{
+		return _dropped.load();
+	}
+
+	void ErrorQueue::write(const ErrorRecord& record, std::ostream& out)
+	{
+		out << "[" << record.origin << "] ERROR: " << record.message << " (t=" << record.time << ", "
+			<< ErrorRecord::getCodeName(record.code) << ")" << std::endl;
+	}
+
+	void ErrorQueue::_logLoop()
+	{
+		while (_logging.load())
+		{
+			_log();
+			boost::this_thread::sleep(boost::posix_time::milliseconds(LOG_PERIOD_MS));
+		}
+	}
+
+	void ErrorQueue::_log()
+	{
+		ErrorRecord record;
+		while (pop(record))
+			write(record, *_out);
+	}
+
+}
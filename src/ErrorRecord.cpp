@@ -0,0 +1,82 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "hybrid_automaton/ErrorRecord.h"
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+namespace ha {
+
+	ErrorRecord::ErrorRecord()
+	{
+		clear();
+	}
+
+	void ErrorRecord::clear()
+	{
+		code = FAULT_NONE;
+		time = 0.0;
+		origin[0] = '\0';
+		message[0] = '\0';
+	}
+
+	void ErrorRecord::set(Code error_code, const char* error_origin, const char* format, ...)
+	{
+		code = error_code;
+
+		std::strncpy(origin, error_origin, ORIGIN_SIZE - 1);
+		origin[ORIGIN_SIZE - 1] = '\0';
+
+		va_list args;
+		va_start(args, format);
+		std::vsnprintf(message, MESSAGE_SIZE, format, args);
+		va_end(args);
+	}
+
+	const char* ErrorRecord::getCodeName(Code code)
+	{
+		switch (code)
+		{
+			case FAULT_NONE:
+				return "FAULT_NONE";
+			case FAULT_NOT_ACTIVE:
+				return "FAULT_NOT_ACTIVE";
+			case FAULT_SUPERVISION:
+				return "FAULT_SUPERVISION";
+			case FAULT_JUMP_CONDITION:
+				return "FAULT_JUMP_CONDITION";
+			case FAULT_CONTROL_MODE:
+				return "FAULT_CONTROL_MODE";
+			case FAULT_EXCEPTION:
+				return "FAULT_EXCEPTION";
+			case FAULT_WATCHDOG:
+				return "FAULT_WATCHDOG";
+		}
+		return "UNKNOWN";
+	}
+
+}
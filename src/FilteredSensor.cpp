@@ -0,0 +1,162 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "hybrid_automaton/FilteredSensor.h"
+
+namespace ha
+{
+
+	FilteredSensor::FilteredSensor(const Sensor::Ptr& sensor)
+		: _sensor(sensor), _stepped(false), _last_step_time(0.0)
+	{
+		if (!_sensor) {
+			HA_THROW_ERROR("FilteredSensor.FilteredSensor", "Cannot filter an empty sensor!");
+		}
+	}
+
+	FilteredSensor::~FilteredSensor()
+	{
+	}
+
+	FilteredSensor::FilteredSensor(const FilteredSensor& ss)
+		:Sensor(ss), _raw_value(ss._raw_value), _stage_values(ss._stage_values), _stepped(false), _last_step_time(0.0)
+	{
+		// filters have state - every copy needs its own pipeline
+		_sensor = ss._sensor->clone();
+		for (std::vector<SensorFilter::Ptr>::const_iterator it = ss._filters.begin(); it != ss._filters.end(); ++it)
+			_filters.push_back((*it)->clone());
+	}
+
+	void FilteredSensor::addFilter(const SensorFilter::Ptr& filter)
+	{
+		_filters.push_back(filter);
+		_stage_values.resize(_filters.size());
+	}
+
+	const std::vector<SensorFilter::Ptr>& FilteredSensor::getFilters() const
+	{
+		return _filters;
+	}
+
+	Sensor::ConstPtr FilteredSensor::getUnfilteredSensor() const
+	{
+		return _sensor;
+	}
+
+	::Eigen::MatrixXd FilteredSensor::getCurrentValue() const
+	{
+		if (_stage_values.empty())
+			return _sensor->getCurrentValue();
+		return _stage_values.back();
+	}
+
+	bool FilteredSensor::getDimensions(int& rows, int& cols) const
+	{
+		if (!_sensor->getDimensions(rows, cols))
+			return false;
+		for (std::size_t i = 0; i < _filters.size(); ++i) {
+			if (!_filters[i]->getOutputDimensions(rows, cols)) {
+				HA_THROW_ERROR("FilteredSensor.getDimensions", "Filter '" << _filters[i]->getType() << "' cannot be applied to a "
+					<< rows << "x" << cols << " value of sensor " << _sensor->getType() << "!");
+			}
+		}
+		return true;
+	}
+
+	const std::string FilteredSensor::getType() const
+	{
+		return _sensor->getType();
+	}
+
+	void FilteredSensor::setSystem(const System::ConstPtr& system)
+	{
+		_sensor->setSystem(system);
+		_system = system;
+	}
+
+	void FilteredSensor::initialize(const double& t)
+	{
+		_sensor->initialize(t);
+
+		_raw_value = _sensor->getCurrentValue();
+		for (std::size_t i = 0; i < _filters.size(); i++)
+			_filters[i]->initialize(i == 0 ? _raw_value : _stage_values[i - 1], t, _stage_values[i]);
+
+		_stepped = false;
+		Sensor::initialize(t);
+	}
+
+	void FilteredSensor::terminate()
+	{
+		_sensor->terminate();
+	}
+
+	void FilteredSensor::step(const double& t)
+	{
+		// shared sensors are stepped by every JumpCondition that uses them
+		if (_stepped && t == _last_step_time)
+			return;
+		_stepped = true;
+		_last_step_time = t;
+
+		_sensor->step(t);
+
+		// copied into the buffer sized in initialize() - the stages read it in place
+		_raw_value = _sensor->getCurrentValue();
+		for (std::size_t i = 0; i < _filters.size(); i++)
+			_filters[i]->step(i == 0 ? _raw_value : _stage_values[i - 1], t, _stage_values[i]);
+	}
+
+	bool FilteredSensor::isActive() const
+	{
+		return _sensor->isActive();
+	}
+
+	DescriptionTreeNode::Ptr FilteredSensor::serialize(const DescriptionTree::ConstPtr& factory) const
+	{
+		DescriptionTreeNode::Ptr tree = _sensor->serialize(factory);
+		for (std::vector<SensorFilter::Ptr>::const_iterator it = _filters.begin(); it != _filters.end(); ++it)
+			tree->addChildNode((*it)->serialize(factory));
+		return tree;
+	}
+
+	void FilteredSensor::deserialize(const DescriptionTreeNode::ConstPtr& tree, const System::ConstPtr& system, const HybridAutomaton* ha)
+	{
+		if (tree->getType() != "Sensor") {
+			HA_THROW_ERROR("FilteredSensor.deserialize", "DescriptionTreeNode must have type 'Sensor', not '" << tree->getType() << "'!");
+		}
+
+		DescriptionTreeNode::ConstNodeList filters;
+		tree->getChildrenNodes("Filter", filters);
+
+		_filters.clear();
+		_stage_values.clear();
+		for (DescriptionTreeNode::ConstNodeList::iterator it = filters.begin(); it != filters.end(); ++it)
+			this->addFilter(SensorFilter::create(*it, system, ha));
+
+		_system = system;
+	}
+
+}
@@ -24,13 +24,15 @@
 * POSSIBILITY OF SUCH DAMAGE.
 */
 #include "hybrid_automaton/ForceTorqueSensor.h"
+#include "hybrid_automaton/FrameSensor.h"
 
 namespace ha
 {
 	HA_SENSOR_REGISTER("ForceTorqueSensor", ForceTorqueSensor);
 
-	ForceTorqueSensor::ForceTorqueSensor() : _port(DEFAULT_FT_PORT)
+	ForceTorqueSensor::ForceTorqueSensor() : _port(DEFAULT_FT_PORT), _world_wrench_transform_valid(false)
 	{
+		_frame_wrench_transform.setIdentity();
 	}
 
 	ForceTorqueSensor::~ForceTorqueSensor()
@@ -38,49 +40,100 @@ namespace ha
 	}
 
 	ForceTorqueSensor::ForceTorqueSensor(const ForceTorqueSensor& ss)
-		:Sensor(ss)
+		:Sensor(ss), _frame_id(ss._frame_id), _frame(ss._frame), _ports(ss._ports),
+		_frame_wrench_transform(ss._frame_wrench_transform), _world_wrench_transform_valid(false)
 	{
 		_port = ss._port;
 	}
+
 	::Eigen::MatrixXd ForceTorqueSensor::transformWrench(const ::Eigen::MatrixXd& wrench, const ::Eigen::MatrixXd& transform) const
 	{
-		::Eigen::Matrix3d frameRot = transform.block(0,0,3,3);
-		::Eigen::Vector3d frameTrans(transform(0,3), transform(1,3), transform(2,3));
-		::Eigen::Vector3d forcePart(wrench(0,0), wrench(1,0),wrench(2,0));
-		::Eigen::Vector3d momentPart(wrench(3,0), wrench(4,0),wrench(5,0));
-
-		forcePart = frameRot.transpose()*forcePart;
-		momentPart = frameRot.transpose()*(momentPart - frameTrans.cross(forcePart));
-
-		Eigen::MatrixXd wrenchOut(6,1);
-		wrenchOut(0) = forcePart(0); wrenchOut(1) = forcePart(1); wrenchOut(2) = forcePart(2);
-		wrenchOut(3) = momentPart(0); wrenchOut(4) = momentPart(1); wrenchOut(5) = momentPart(2);
-		return wrenchOut;
+		::Eigen::Matrix<double, 6, 6> wrench_transform;
+		computeWrenchTransform(transform, wrench_transform);
+		return wrench_transform * wrench;
 	}
 
-	::Eigen::MatrixXd ForceTorqueSensor::getCurrentValue() const
+	void ForceTorqueSensor::computeWrenchTransform(const ::Eigen::Matrix4d& transform, ::Eigen::Matrix<double, 6, 6>& wrench_transform)
 	{
-		//This is the F/T wrench from the hardware - It must be in EE frame
-		::Eigen::MatrixXd forceTorque = _system->getForceTorqueMeasurement(_port);
-		Eigen::MatrixXd ftOut = forceTorque;
-		
-		if(_frame_id == "world")
+		::Eigen::Matrix3d rot_t = transform.topLeftCorner<3,3>().transpose();
+		::Eigen::Matrix3d trans_cross;
+		trans_cross <<              0.0, -transform(2,3),  transform(1,3),
+		                 transform(2,3),             0.0, -transform(0,3),
+		                -transform(1,3),  transform(0,3),             0.0;
+
+		wrench_transform.topLeftCorner<3,3>() = rot_t;
+		wrench_transform.topRightCorner<3,3>().setZero();
+		wrench_transform.bottomLeftCorner<3,3>().noalias() = -rot_t * trans_cross * rot_t;
+		wrench_transform.bottomRightCorner<3,3>() = rot_t;
+	}
+
+	void ForceTorqueSensor::setFrame(const Eigen::MatrixXd& frame)
+	{
+		if(frame.cols()!=4 || frame.rows()!=4)
 		{
-			::Eigen::MatrixXd eeFrame = _system->getFramePose("EE");
+			HA_THROW_ERROR("ForceTorqueSensor.setFrame", "frame parameter must be 4x4 homogeneous transform!");
+		}
+		_frame = frame;
+		computeWrenchTransform(_frame, _frame_wrench_transform);
+		_world_wrench_transform_valid = false;
+	}
 
-			//Transform FT wrench to world frame
-			ftOut = transformWrench(forceTorque, eeFrame.inverse());
+	void ForceTorqueSensor::setPorts(const std::vector<int>& ports)
+	{
+		for (std::size_t i = 0; i < ports.size(); ++i)
+		{
+			if(ports[i] > 2 || ports[i] <0)
+			{
+				HA_THROW_ERROR("ForceTorqueSensor.setPorts", "Port number " << ports[i] << " "
+					<< "invalid - it must be between 0 and 2!");
+			}
 		}
+		_ports = ports;
+	}
 
-		//Transform FT wrench to given frame
-		ftOut = transformWrench(ftOut, _frame);
+	const ::Eigen::Matrix<double, 6, 6>& ForceTorqueSensor::_getWrenchTransform() const
+	{
+		if(_frame_id != "world")
+			return _frame_wrench_transform;
 
-		//if((k++)%2000 == 0)
-		//	HA_INFO("ForceTorqueSensor.getCurrentValue","ftout: "<<ftOut.transpose());
+		// The wrench is measured in EE frame - transform it to world frame first
+		::Eigen::Matrix4d ee_pose;
+		_system->getFramePoseInto("EE", ee_pose);
+		if(!_world_wrench_transform_valid || ee_pose != _ee_pose)
+		{
+			::Eigen::Matrix4d ee_pose_inverse;
+			::Eigen::Matrix<double, 6, 6> ee_wrench_transform;
+			FrameSensor::invertRigidTransform(ee_pose, ee_pose_inverse);
+			computeWrenchTransform(ee_pose_inverse, ee_wrench_transform);
+			_world_wrench_transform.noalias() = _frame_wrench_transform * ee_wrench_transform;
+			_ee_pose = ee_pose;
+			_world_wrench_transform_valid = true;
+		}
+		return _world_wrench_transform;
+	}
+
+	::Eigen::MatrixXd ForceTorqueSensor::getCurrentValue() const
+	{
+		const ::Eigen::Matrix<double, 6, 6>& wrench_transform = _getWrenchTransform();
+
+		//This is the F/T wrench from the hardware - It must be in EE frame
+		if(_ports.empty())
+			return wrench_transform * _system->getForceTorqueMeasurement(_port);
 
+		_system->getForceTorqueMeasurementsInto(_ports, _measurements);
+		::Eigen::MatrixXd ftOut(6 * _ports.size(), 1);
+		for (std::size_t i = 0; i < _ports.size(); ++i)
+			ftOut.block<6,1>(6 * i, 0).noalias() = wrench_transform * _measurements.col(i);
 		return ftOut;
 	}
 
+	bool ForceTorqueSensor::getDimensions(int& rows, int& cols) const
+	{
+		rows = _ports.empty() ? 6 : 6 * _ports.size();
+		cols = 1;
+		return true;
+	}
+
 	DescriptionTreeNode::Ptr ForceTorqueSensor::serialize(const DescriptionTree::ConstPtr& factory) const
 	{
 		DescriptionTreeNode::Ptr tree = factory->createNode("Sensor");
@@ -88,6 +141,13 @@ namespace ha
 		tree->setAttribute<int>(std::string("port"), _port);
 		tree->setAttribute<Eigen::MatrixXd>(std::string("frame"), _frame);
 		tree->setAttribute<std::string>(std::string("frame_id"), _frame_id);
+		if(!_ports.empty())
+		{
+			Eigen::MatrixXd ports_mat(_ports.size(), 1);
+			for(int j=0; j<ports_mat.rows(); j++)
+				ports_mat(j) = _ports[j];
+			tree->setAttribute< Eigen::MatrixXd >(std::string("ports"), ports_mat);
+		}
 		return tree;
 	}
 
@@ -127,6 +187,17 @@ namespace ha
 				HA_THROW_ERROR("ForceTorqueSensor.deserialize", "frame parameter must be 4x4 homogeneous transform!");
 			}
 		}
+		setFrame(_frame);
+
+		::Eigen::MatrixXd ports_mat;
+		std::vector<int> ports;
+		if(tree->getAttribute< ::Eigen::MatrixXd >("ports", ports_mat))
+		{
+			ports.resize(ports_mat.size());
+			for(int j=0; j<ports_mat.size(); j++)
+				ports[j] = (int)ports_mat(j);
+		}
+		setPorts(ports);
 
 		_system = system;
 	}
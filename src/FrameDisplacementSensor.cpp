@@ -31,7 +31,7 @@ namespace ha
 	HA_SENSOR_REGISTER("FrameDisplacementSensor", FrameDisplacementSensor);
 
 	FrameDisplacementSensor::FrameDisplacementSensor(const std::string& frame_id)
-		: _frame_id(frame_id)
+		: FrameSensor(frame_id)
 	{
 	}
 
@@ -40,39 +40,20 @@ namespace ha
 	}
 
 	FrameDisplacementSensor::FrameDisplacementSensor(const FrameDisplacementSensor& ss)
-		:Sensor(ss)
+		:FrameSensor(ss)
 	{
 	}
 
-	void FrameDisplacementSensor::initialize(const double& t) 
+	::Eigen::MatrixXd FrameDisplacementSensor::_poseToValue(const ::Eigen::Matrix4d& pose) const
 	{
-		this->_initial_sensor_value = this->_system->getFramePose(this->_frame_id);
+		return pose.topRightCorner<3,1>();
 	}
 
-	::Eigen::MatrixXd FrameDisplacementSensor::getCurrentValue() const
+	bool FrameDisplacementSensor::getDimensions(int& rows, int& cols) const
 	{
-		::Eigen::MatrixXd pose = this->_system->getFramePose(this->_frame_id);
-		pose = pose.col(3);
-		pose.conservativeResize(3,1);
-		return pose;
-	}
-
-	::Eigen::MatrixXd FrameDisplacementSensor::getInitialValue() const
-	{
-		::Eigen::MatrixXd ret = this->_initial_sensor_value.col(3);
-		ret.conservativeResize(3,1);
-		return ret;
-	}
-
-	::Eigen::MatrixXd FrameDisplacementSensor::getRelativeCurrentValue() const
-	{
-		
-		::Eigen::MatrixXd pose = this->_system->getFramePose(this->_frame_id);
-		pose=_initial_sensor_value.inverse()*pose;
-		pose = pose.col(3);
-		pose.conservativeResize(3,1);
-		
-		return pose;
+		rows = 3;
+		cols = 1;
+		return true;
 	}
 
 	DescriptionTreeNode::Ptr FrameDisplacementSensor::serialize(const DescriptionTree::ConstPtr& factory) const
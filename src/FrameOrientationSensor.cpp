@@ -31,7 +31,7 @@ namespace ha
 	HA_SENSOR_REGISTER("FrameOrientationSensor", FrameOrientationSensor);
 
 	FrameOrientationSensor::FrameOrientationSensor(const std::string& frame_id)
-		: _frame_id(frame_id)
+		: FrameSensor(frame_id)
 	{
 	}
 
@@ -40,35 +40,20 @@ namespace ha
 	}
 
 	FrameOrientationSensor::FrameOrientationSensor(const FrameOrientationSensor& ss)
-		:Sensor(ss)
+		:FrameSensor(ss)
 	{
 	}
 
-	void FrameOrientationSensor::initialize(const double& t) 
+	::Eigen::MatrixXd FrameOrientationSensor::_poseToValue(const ::Eigen::Matrix4d& pose) const
 	{
-		::Eigen::MatrixXd pose = this->_system->getFramePose(this->_frame_id);
-		pose.conservativeResize(3,3);
-		this->_initial_sensor_value = pose;
+		return pose.topLeftCorner<3,3>();
 	}
 
-	::Eigen::MatrixXd FrameOrientationSensor::getCurrentValue() const
+	bool FrameOrientationSensor::getDimensions(int& rows, int& cols) const
 	{
-		::Eigen::MatrixXd pose = this->_system->getFramePose(this->_frame_id);
-		pose.conservativeResize(3,3);
-		return pose;
-	}
-	
-	::Eigen::MatrixXd FrameOrientationSensor::getInitialValue() const
-	{
-		return this->_initial_sensor_value;
-	}
-
-	::Eigen::MatrixXd FrameOrientationSensor::getRelativeCurrentValue() const
-	{
-		::Eigen::MatrixXd pose = this->_system->getFramePose(this->_frame_id);
-		pose.conservativeResize(3,3);
-		pose = _initial_sensor_value.inverse()*pose;
-		return pose;
+		rows = 3;
+		cols = 3;
+		return true;
 	}
 
 	DescriptionTreeNode::Ptr FrameOrientationSensor::serialize(const DescriptionTree::ConstPtr& factory) const
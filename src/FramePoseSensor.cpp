@@ -31,7 +31,7 @@ namespace ha
 	HA_SENSOR_REGISTER("FramePoseSensor", FramePoseSensor);
 
 	FramePoseSensor::FramePoseSensor(const std::string& frame_id)
-		: _frame_id(frame_id)
+		: FrameSensor(frame_id), _reference_frame("EE")
 	{
 	}
 
@@ -40,34 +40,20 @@ namespace ha
 	}
 
 	FramePoseSensor::FramePoseSensor(const FramePoseSensor& ss)
-		:Sensor(ss)
+		:FrameSensor(ss), _reference_frame(ss._reference_frame)
 	{
 	}
 
-
-	void FramePoseSensor::initialize(const double& t) 
-	{
-		this->_initial_sensor_value = this->_system->getFramePose(this->_frame_id);
-	}
-
-	::Eigen::MatrixXd FramePoseSensor::getCurrentValue() const
-	{
-		return this->_system->getFramePose(this->_frame_id);
-	}
-
-	::Eigen::MatrixXd FramePoseSensor::getRelativeCurrentValue() const
+	::Eigen::MatrixXd FramePoseSensor::_poseToValue(const ::Eigen::Matrix4d& pose) const
 	{
-		::Eigen::MatrixXd pose = this->_system->getFramePose(this->_frame_id);
-    if(_reference_frame == "world")
-      pose = pose*_initial_sensor_value.inverse();
-    else
-      pose = _initial_sensor_value.inverse()*pose;
 		return pose;
 	}
 
-	::Eigen::MatrixXd FramePoseSensor::getInitialValue() const
+	bool FramePoseSensor::getDimensions(int& rows, int& cols) const
 	{
-		return this->_initial_sensor_value;
+		rows = 4;
+		cols = 4;
+		return true;
 	}
 
 	DescriptionTreeNode::Ptr FramePoseSensor::serialize(const DescriptionTree::ConstPtr& factory) const
@@ -104,6 +90,7 @@ namespace ha
       HA_WARN("FramePoseSensor::deserialize", "reference_frame not defined. using default value EE");
       _reference_frame = "EE";
     }
+		_relative_to_world = (_reference_frame == "world");
 
 
 		
@@ -0,0 +1,98 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "hybrid_automaton/FrameSensor.h"
+
+namespace ha
+{
+
+	FrameSensor::FrameSensor(const std::string& frame_id)
+		: _frame_id(frame_id), _relative_to_world(false)
+	{
+		_initial_pose.setIdentity();
+		_initial_pose_inverse.setIdentity();
+	}
+
+	FrameSensor::~FrameSensor()
+	{
+	}
+
+	FrameSensor::FrameSensor(const FrameSensor& ss)
+		:Sensor(ss), _frame_id(ss._frame_id), _relative_to_world(ss._relative_to_world),
+		_initial_pose(ss._initial_pose), _initial_pose_inverse(ss._initial_pose_inverse)
+	{
+	}
+
+	void FrameSensor::initialize(const double& t)
+	{
+		_readFramePose(_initial_pose);
+		invertRigidTransform(_initial_pose, _initial_pose_inverse);
+		this->_initial_sensor_value = _poseToValue(_initial_pose);
+	}
+
+	::Eigen::MatrixXd FrameSensor::getCurrentValue() const
+	{
+		::Eigen::Matrix4d pose;
+		_readFramePose(pose);
+		return _poseToValue(pose);
+	}
+
+	::Eigen::MatrixXd FrameSensor::getRelativeCurrentValue() const
+	{
+		::Eigen::Matrix4d pose, relative_pose;
+		_readFramePose(pose);
+		if (_relative_to_world)
+			composeRigidTransforms(pose, _initial_pose_inverse, relative_pose);
+		else
+			composeRigidTransforms(_initial_pose_inverse, pose, relative_pose);
+		return _poseToValue(relative_pose);
+	}
+
+	const std::string& FrameSensor::getFrameId() const
+	{
+		return _frame_id;
+	}
+
+	void FrameSensor::_readFramePose(::Eigen::Matrix4d& pose) const
+	{
+		this->_system->getFramePoseInto(this->_frame_id, pose);
+	}
+
+	void FrameSensor::invertRigidTransform(const ::Eigen::Matrix4d& pose, ::Eigen::Matrix4d& inverse)
+	{
+		inverse.topLeftCorner<3,3>() = pose.topLeftCorner<3,3>().transpose();
+		inverse.topRightCorner<3,1>().noalias() = -inverse.topLeftCorner<3,3>() * pose.topRightCorner<3,1>();
+		inverse.row(3) << 0.0, 0.0, 0.0, 1.0;
+	}
+
+	void FrameSensor::composeRigidTransforms(const ::Eigen::Matrix4d& a, const ::Eigen::Matrix4d& b, ::Eigen::Matrix4d& result)
+	{
+		result.topLeftCorner<3,3>().noalias() = a.topLeftCorner<3,3>() * b.topLeftCorner<3,3>();
+		result.topRightCorner<3,1>() = a.topRightCorner<3,1>();
+		result.topRightCorner<3,1>().noalias() += a.topLeftCorner<3,3>() * b.topRightCorner<3,1>();
+		result.row(3) << 0.0, 0.0, 0.0, 1.0;
+	}
+
+}
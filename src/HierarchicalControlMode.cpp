@@ -0,0 +1,191 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "hybrid_automaton/HierarchicalControlMode.h"
+#include "hybrid_automaton/error_handling.h"
+#include "hybrid_automaton/Profiler.h"
+
+namespace ha {
+
+	HierarchicalControlMode::HierarchicalControlMode()
+		: _start_pending(false)
+	{
+	}
+
+	HierarchicalControlMode::HierarchicalControlMode(const std::string& name)
+		: ControlMode(name), _start_pending(false)
+	{
+	}
+
+	HierarchicalControlMode::HierarchicalControlMode(const HierarchicalControlMode& cm)
+		: ControlMode(cm), _initial_control_mode(cm._initial_control_mode), _start_pending(false)
+	{
+		// the clone must not share the state of the nested automaton
+		if (cm._sub_automaton)
+			_sub_automaton = cm._sub_automaton->clone();
+	}
+
+	HierarchicalControlMode::~HierarchicalControlMode()
+	{
+	}
+
+	void HierarchicalControlMode::setSubAutomaton(const HybridAutomaton::Ptr& sub_automaton)
+	{
+		if (!sub_automaton || !sub_automaton->getCurrentControlMode()) {
+			HA_THROW_ERROR("HierarchicalControlMode.setSubAutomaton", "The nested automaton of control mode '" << _name << "' needs a current control mode!");
+		}
+		_sub_automaton = sub_automaton;
+		_initial_control_mode = sub_automaton->getCurrentControlMode()->getName();
+	}
+
+	HybridAutomaton::Ptr HierarchicalControlMode::getSubAutomaton() const
+	{
+		return _sub_automaton;
+	}
+
+	const std::string& HierarchicalControlMode::getInitialControlMode() const
+	{
+		return _initial_control_mode;
+	}
+
+	ControlMode::Ptr HierarchicalControlMode::getCurrentSubControlMode() const
+	{
+		if (!_sub_automaton)
+			return ControlMode::Ptr();
+		return _sub_automaton->getCurrentControlMode();
+	}
+
+	void HierarchicalControlMode::initialize()
+	{
+		if (!_sub_automaton) {
+			HA_THROW_ERROR("HierarchicalControlMode.initialize", "No nested automaton defined.");
+		}
+
+		if (_sub_automaton->getCurrentControlMode()->getName() != _initial_control_mode)
+			_sub_automaton->setCurrentControlMode(_initial_control_mode);
+		_start_pending = true;
+	}
+
+	void HierarchicalControlMode::terminate()
+	{
+		_start_pending = false;
+		if (_sub_automaton && _sub_automaton->isActive())
+			_sub_automaton->terminate();
+	}
+
+	void HierarchicalControlMode::_startSubAutomaton(const double& t)
+	{
+		_start_pending = false;
+		_sub_automaton->initialize(t);
+	}
+
+	::Eigen::MatrixXd HierarchicalControlMode::step(const double& t)
+	{
+		HA_PROFILE_SCOPE(_step_profile, "ControlMode.step", _name);
+		if (_start_pending)
+			_startSubAutomaton(t);
+		return _sub_automaton->step(t);
+	}
+
+	bool HierarchicalControlMode::tryStep(const double& t, ::Eigen::MatrixXd& control, ErrorRecord& error)
+	{
+		if (_start_pending)
+			_startSubAutomaton(t);
+
+		// a fault the nested automaton handled with its own safe control mode is no fault of this mode
+		if (_sub_automaton->tryStep(t, control).ok())
+			return true;
+
+		error = _sub_automaton->getLastError();
+		return false;
+	}
+
+	void HierarchicalControlMode::switchControlMode(ControlMode::Ptr otherMode)
+	{
+		// the initial sub-mode takes over from the previous mode
+		if (_sub_automaton)
+			_sub_automaton->getCurrentControlMode()->switchControlMode(otherMode);
+	}
+
+	ControlSet::Ptr HierarchicalControlMode::getControlSet() const
+	{
+		ControlMode::Ptr sub_mode = getCurrentSubControlMode();
+		return sub_mode ? sub_mode->getControlSet() : ControlSet::Ptr();
+	}
+
+	Controller::ConstPtr HierarchicalControlMode::getControllerByName(const std::string& name) const
+	{
+		ControlMode::Ptr sub_mode = getCurrentSubControlMode();
+		if (!sub_mode) {
+			HA_THROW_ERROR("HierarchicalControlMode.getControllerByName", "No nested automaton defined.");
+		}
+		return sub_mode->getControllerByName(name);
+	}
+
+	DescriptionTreeNode::Ptr HierarchicalControlMode::serialize(const DescriptionTree::ConstPtr& factory) const
+	{
+		DescriptionTreeNode::Ptr tree_node = factory->createNode("ControlMode");
+		tree_node->setAttribute<std::string>(std::string("name"), this->getName());
+
+		if (!_sub_automaton) {
+			HA_THROW_ERROR("HierarchicalControlMode.serialize", "Nested automaton is null!");
+		}
+
+		// serialize the nested automaton starting in its initial control mode
+		DescriptionTreeNode::Ptr sub_node = _sub_automaton->serialize(factory);
+		sub_node->setAttribute<std::string>(std::string("current_control_mode"), _initial_control_mode);
+		tree_node->addChildNode(sub_node);
+
+		if (_watchdog)
+			tree_node->addChildNode(_watchdog->serialize(factory));
+		return tree_node;
+	}
+
+	void HierarchicalControlMode::deserialize(const DescriptionTreeNode::ConstPtr& tree, const System::ConstPtr& system, const HybridAutomaton* ha)
+	{
+		if (tree->getType() != "ControlMode") {
+			HA_THROW_ERROR("HierarchicalControlMode.deserialize", "DescriptionTreeNode must have type 'ControlMode', not '" << tree->getType() << "'!");
+		}
+
+		if(!tree->getAttribute<std::string>("name", _name))
+			HA_WARN("HierarchicalControlMode.deserialize", "No \"name\" parameter given in ControlMode - using default value");
+
+		DescriptionTreeNode::ConstNodeList sub_automaton;
+		tree->getChildrenNodes("HybridAutomaton", sub_automaton);
+
+		if (sub_automaton.size() != 1) {
+			HA_THROW_ERROR("HierarchicalControlMode.deserialize", "Control mode '" << _name << "' needs exactly one nested automaton, found " << sub_automaton.size() << "!");
+		}
+
+		HybridAutomaton::Ptr sub(new HybridAutomaton);
+		if (ha)
+			sub->setDeserializeDefaultEntities(ha->getDeserializeDefaultEntities());
+		sub->deserialize(*sub_automaton.begin(), system);
+		setSubAutomaton(sub);
+
+		_deserializeWatchdog(tree, system, ha);
+	}
+
+}
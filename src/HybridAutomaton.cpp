@@ -26,26 +26,45 @@
 #include "hybrid_automaton/HybridAutomaton.h"
 
 #include "hybrid_automaton/DescriptionTreeNode.h"
+#include "hybrid_automaton/DescriptionTreeStream.h"
+#include "hybrid_automaton/SupervisionThread.h"
+#include "hybrid_automaton/FilteredSensor.h"
+#include "hybrid_automaton/HierarchicalControlMode.h"
+#include "hybrid_automaton/ParallelControlMode.h"
 #include "hybrid_automaton/error_handling.h"
+#include "hybrid_automaton/Profiler.h"
 
 #include <boost/graph/graphviz.hpp>
 #include <boost/algorithm/string.hpp>
+#include <boost/atomic.hpp>
+#include <boost/thread/thread.hpp>
 
 #include <sstream>
+#include <iterator>
+#include <algorithm>
 
 namespace ha {
 
+	namespace {
+		// guard HybridAutomaton::_shared_sensors and _controller_prototypes while control modes are deserialized in parallel
+		boost::mutex shared_sensors_mutex;
+		boost::mutex controller_prototypes_mutex;
+	}
+
 	HybridAutomaton::HybridAutomaton()
-        : _active(false), _deserialize_default_entities(false)
+        : _active(false), _asynchronous_supervision(false), _safe_mode_active(false), _deserialization_threads(1), _deserialize_default_entities(false)
     {
     }
 
 	HybridAutomaton::~HybridAutomaton()
 	{
+		if (_supervision_thread)
+			_supervision_thread->stop();
 	}
 
 	void HybridAutomaton::registerController(const std::string& ctrl_type, ControllerCreator cc) 
 	{
+		boost::unique_lock<boost::shared_mutex> lock(getTypeMapMutex());
 		std::map<std::string, HybridAutomaton::ControllerCreator>& controller_type_map = getControllerTypeMap();
 		assert ( controller_type_map.find(ctrl_type) == controller_type_map.end() );
 		controller_type_map[ctrl_type] = cc;
@@ -53,12 +72,14 @@ namespace ha {
 
 	bool HybridAutomaton::isControllerRegistered(const std::string& ctrl_type) 
 	{
+		boost::shared_lock<boost::shared_mutex> lock(getTypeMapMutex());
 		std::map<std::string, HybridAutomaton::ControllerCreator>& controller_type_map = getControllerTypeMap();
 		return ( controller_type_map.find(ctrl_type) != controller_type_map.end() );
 	}
 
 	void HybridAutomaton::unregisterController(const std::string& ctrl_type) 
 	{
+		boost::unique_lock<boost::shared_mutex> lock(getTypeMapMutex());
 		std::map<std::string, HybridAutomaton::ControllerCreator>& controller_type_map = getControllerTypeMap();
 		std::map<std::string, HybridAutomaton::ControllerCreator>::iterator it = controller_type_map.find(ctrl_type);
 		if (it == controller_type_map.end()) return;
@@ -76,22 +97,52 @@ namespace ha {
 			HA_THROW_ERROR("HybridAutomaton.createController", "Cannot get controller type from node");
 		}
 
+		// identical descriptions (e.g. the same controller in several modes) are deserialized once and cloned
+		std::ostringstream key;
+		_describeNodeContent(node, key);
+		Controller::ConstPtr prototype;
+		{
+			boost::mutex::scoped_lock lock(controller_prototypes_mutex);
+			std::map<std::string, Controller::ConstPtr>::const_iterator it = ha->_controller_prototypes.find(key.str());
+			if (it != ha->_controller_prototypes.end())
+				prototype = it->second;
+		}
+		if (prototype)
+			return prototype->clone();
+
+		Controller::Ptr ctrl = _deserializeController(node, ctrl_type, system, ha);
+
+		// another deserialization thread may have added the same description in the meantime - both are fresh
+		boost::mutex::scoped_lock lock(controller_prototypes_mutex);
+		ha->_controller_prototypes.insert(std::make_pair(key.str(), Controller::ConstPtr(ctrl->clone())));
+		return ctrl;
+	}
+
+	Controller::Ptr HybridAutomaton::_deserializeController(const DescriptionTreeNode::ConstPtr& node, const std::string& ctrl_type, const System::ConstPtr& system, const HybridAutomaton* ha)
+	{
         if (ha->getDeserializeDefaultEntities()) {
             Controller::Ptr ctrl(new Controller);
             ctrl->deserialize(node, system, ha);
             return ctrl;
         } else {
-            std::map<std::string, HybridAutomaton::ControllerCreator>& controller_type_map = getControllerTypeMap();
-            std::map<std::string, HybridAutomaton::ControllerCreator>::iterator it = controller_type_map.find(ctrl_type);
-            if ( !isControllerRegistered(ctrl_type) ) {
+            ControllerCreator creator = NULL;
+            {
+                boost::shared_lock<boost::shared_mutex> lock(getTypeMapMutex());
+                std::map<std::string, HybridAutomaton::ControllerCreator>& controller_type_map = getControllerTypeMap();
+                std::map<std::string, HybridAutomaton::ControllerCreator>::iterator it = controller_type_map.find(ctrl_type);
+                if (it != controller_type_map.end())
+                    creator = it->second;
+            }
+            if ( !creator ) {
                 HA_THROW_ERROR("HybridAutomaton.createController", "Controller type not registered: " << ctrl_type);
             }
-            return (*(it->second))(node, system, ha);
+            return (*creator)(node, system, ha);
         }
 	}
 
 	void HybridAutomaton::registerControlSet(const std::string& ctrl_type, ControlSetCreator cc) 
 	{
+		boost::unique_lock<boost::shared_mutex> lock(getTypeMapMutex());
 		std::map<std::string, HybridAutomaton::ControlSetCreator>& controlset_type_map = getControlSetTypeMap();
 		assert ( controlset_type_map.find(ctrl_type) == controlset_type_map.end() );
 		controlset_type_map[ctrl_type] = cc;
@@ -99,6 +150,7 @@ namespace ha {
 
 	bool HybridAutomaton::isControlSetRegistered(const std::string& ctrl_type) 
 	{
+		boost::shared_lock<boost::shared_mutex> lock(getTypeMapMutex());
 		std::map<std::string, HybridAutomaton::ControlSetCreator>& controlset_type_map = getControlSetTypeMap();
 		return ( controlset_type_map.find(ctrl_type) != controlset_type_map.end() );
 	}
@@ -119,16 +171,23 @@ namespace ha {
             cs->deserialize(node, system, ha);
             return cs;
         } else {
-            std::map<std::string, HybridAutomaton::ControlSetCreator>& controlset_type_map = getControlSetTypeMap();
-            std::map<std::string, HybridAutomaton::ControlSetCreator>::iterator it = controlset_type_map.find(ctrl_type);
-            if ( !isControlSetRegistered(ctrl_type) ) {
+            ControlSetCreator creator = NULL;
+            {
+                boost::shared_lock<boost::shared_mutex> lock(getTypeMapMutex());
+                std::map<std::string, HybridAutomaton::ControlSetCreator>& controlset_type_map = getControlSetTypeMap();
+                std::map<std::string, HybridAutomaton::ControlSetCreator>::iterator it = controlset_type_map.find(ctrl_type);
+                if (it != controlset_type_map.end())
+                    creator = it->second;
+            }
+            if ( !creator ) {
                 HA_THROW_ERROR("HybridAutomaton.createControlSet", "ControlSet type not registered: " << ctrl_type);
             }
-            return (*(it->second))(node, system, ha);
+            return (*creator)(node, system, ha);
         }
     }
 
 	void HybridAutomaton::unregisterControlSet(const std::string& ctrl_type) {
+		boost::unique_lock<boost::shared_mutex> lock(getTypeMapMutex());
 		std::map<std::string, HybridAutomaton::ControlSetCreator>& controlset_type_map = getControlSetTypeMap();
 		std::map<std::string, HybridAutomaton::ControlSetCreator>::iterator it = controlset_type_map.find(ctrl_type);
 		if (it == controlset_type_map.end()) return;
@@ -137,6 +196,7 @@ namespace ha {
 
 	void HybridAutomaton::registerSensor(const std::string& sensor_type, SensorCreator sc)
 	{
+		boost::unique_lock<boost::shared_mutex> lock(getTypeMapMutex());
 		std::map<std::string, HybridAutomaton::SensorCreator>& sensor_type_map = getSensorTypeMap();
 		assert ( sensor_type_map.find(sensor_type) == sensor_type_map.end() );
 		sensor_type_map[sensor_type] = sc;
@@ -144,12 +204,14 @@ namespace ha {
 
 	bool HybridAutomaton::isSensorRegistered(const std::string& sensor_type)
 	{
+		boost::shared_lock<boost::shared_mutex> lock(getTypeMapMutex());
 		std::map<std::string, HybridAutomaton::SensorCreator>& sensor_type_map = getSensorTypeMap();
 		return ( sensor_type_map.find(sensor_type) != sensor_type_map.end() );
 	}
 
 	void HybridAutomaton::unregisterSensor(const std::string& sensor_type)
 	{
+		boost::unique_lock<boost::shared_mutex> lock(getTypeMapMutex());
 		std::map<std::string, HybridAutomaton::SensorCreator>& sensor_type_map = getSensorTypeMap();
 		std::map<std::string, HybridAutomaton::SensorCreator>::iterator it = sensor_type_map.find(sensor_type);
 		if (it == sensor_type_map.end()) return;
@@ -167,20 +229,150 @@ namespace ha {
 			HA_THROW_ERROR("HybridAutomaton.createSensor", "Cannot get sensor type from node");
 		}
 
-        std::map<std::string, HybridAutomaton::SensorCreator>& sensor_type_map = getSensorTypeMap();
-        std::map<std::string, HybridAutomaton::SensorCreator>::iterator it = sensor_type_map.find(sensor_type);
-        if ( !isSensorRegistered(sensor_type) ) {
+        SensorCreator creator = NULL;
+        {
+            boost::shared_lock<boost::shared_mutex> lock(getTypeMapMutex());
+            std::map<std::string, HybridAutomaton::SensorCreator>& sensor_type_map = getSensorTypeMap();
+            std::map<std::string, HybridAutomaton::SensorCreator>::iterator it = sensor_type_map.find(sensor_type);
+            if (it != sensor_type_map.end())
+                creator = it->second;
+        }
+        if ( !creator ) {
             HA_THROW_ERROR("HybridAutomaton.createSensor", "Sensor type not registered: " << sensor_type);
         }
-        return (*(it->second))(node, system, ha);
+
+		// sensors with a filter pipeline are wrapped - and shared between identical descriptions
+		DescriptionTreeNode::ConstNodeList filters;
+		node->getChildrenNodes("Filter", filters);
+		if (filters.empty())
+			return (*creator)(node, system, ha);
+
+		std::ostringstream key;
+		_describeNode(node, key);
+		if (ha)
+		{
+			boost::mutex::scoped_lock lock(shared_sensors_mutex);
+			std::map<std::string, Sensor::Ptr>::const_iterator shared = ha->_shared_sensors.find(key.str());
+			if (shared != ha->_shared_sensors.end())
+				return shared->second;
+		}
+
+		FilteredSensor::Ptr sensor(new FilteredSensor((*creator)(node, system, ha)));
+		sensor->deserialize(node, system, ha);
+
+		if (ha)
+		{
+			// another deserialization thread may have created the same sensor in the meantime
+			boost::mutex::scoped_lock lock(shared_sensors_mutex);
+			std::pair<std::map<std::string, Sensor::Ptr>::iterator, bool> inserted = ha->_shared_sensors.insert(std::make_pair(key.str(), Sensor::Ptr(sensor)));
+			return inserted.first->second;
+		}
+		return sensor;
 	}
 
+	void HybridAutomaton::_describeNode(const DescriptionTreeNode::ConstPtr& node, std::ostream& out)
+	{
+		out << node->getType();
+		_describeNodeContent(node, out);
+	}
+
+	void HybridAutomaton::_describeNodeContent(const DescriptionTreeNode::ConstPtr& node, std::ostream& out)
+	{
+		out << "(";
+
+		std::map<std::string, std::string> attributes;
+		node->getAllAttributes(attributes);
+		for (std::map<std::string, std::string>::const_iterator it = attributes.begin(); it != attributes.end(); ++it)
+			out << it->first << "=\"" << it->second << "\" ";
+
+		DescriptionTreeNode::ConstNodeList children;
+		node->getChildrenNodes(children);
+		for (DescriptionTreeNode::ConstNodeList::const_iterator it = children.begin(); it != children.end(); ++it)
+			_describeNode(*it, out);
+
+		out << ")";
+	}
+
+
+	namespace {
+		// clone every sensor once, so that sensors shared by several jump conditions stay shared
+		Sensor::Ptr cloneSensor(const Sensor::ConstPtr& sensor, std::map<const Sensor*, Sensor::Ptr>& clones)
+		{
+			Sensor::Ptr& clone = clones[sensor.get()];
+			if (!clone)
+				clone = sensor->clone();
+			return clone;
+		}
+	}
+
+	HybridAutomaton* HybridAutomaton::_doClone() const
+	{
+		HybridAutomaton* ha = new HybridAutomaton(*this);
+		// the supervision thread and the trace recorder belong to this automaton only
+		ha->_supervision_thread.reset();
+		ha->_trace_recorder.reset();
+		ha->_active = false;
+		ha->_safe_mode_active = false;
+		ha->_last_active_control_switch.reset();
+		ha->_current_control_mode.reset();
+		ha->_graph = Graph();
+		ha->_switchMap.clear();
+
+		std::map<const Sensor*, Sensor::Ptr> sensors;
+		for (std::map<std::string, Sensor::Ptr>::iterator it = ha->_shared_sensors.begin(); it != ha->_shared_sensors.end(); ++it)
+			it->second = cloneSensor(it->second, sensors);
+
+		// the vertices are added in the same order, so the clone's vertex descriptors equal the original ones
+		const AdjacencyListGraph& g = _graph.graph();
+		ModeIterator mode_it, mode_end;
+		for (boost::tie(mode_it, mode_end) = boost::vertices(g); mode_it != mode_end; ++mode_it)
+		{
+			ControlMode::Ptr mode = g[*mode_it]->clone();
+			ha->addControlMode(mode);
+			if (g[*mode_it] == _current_control_mode)
+				ha->_current_control_mode = mode;
+		}
+
+		// the out-going switches of each mode are added in their order, which decides which switch fires first
+		const AdjacencyListGraph& clone_graph = ha->_graph.graph();
+		for (boost::tie(mode_it, mode_end) = boost::vertices(g); mode_it != mode_end; ++mode_it)
+		{
+			const ControlMode::Ptr& source = clone_graph[*mode_it];
+			OutEdgeIterator edge_it, edge_end;
+			for (boost::tie(edge_it, edge_end) = boost::out_edges(*mode_it, g); edge_it != edge_end; ++edge_it)
+			{
+				ControlSwitch::Ptr control_switch = g[*edge_it]->clone();
+
+				const std::vector<JumpConditionPtr>& conditions = control_switch->getJumpConditions();
+				for (std::vector<JumpConditionPtr>::const_iterator jc = conditions.begin(); jc != conditions.end(); ++jc)
+				{
+					Sensor::Ptr sensor;
+					if ((*jc)->getSensor())
+						sensor = cloneSensor((*jc)->getSensor(), sensors);
+
+					// controller goals refer to the controllers of the source mode
+					Controller::ConstPtr controller = (*jc)->getGoalController();
+					if (controller && source->getControlSet())
+						controller = source->getControlSet()->getControllerByName(controller->getName());
+
+					(*jc)->rebind(sensor, controller);
+				}
+
+				ha->addControlSwitch(source->getName(), control_switch, clone_graph[boost::target(*edge_it, g)]->getName());
+			}
+		}
+
+		return ha;
+	}
 
     void HybridAutomaton::addControlMode(const ControlMode::Ptr& control_mode)
 	{
         AdjacencyListGraph& g = _graph.graph();
         ModeHandle mh = boost::add_vertex(control_mode->getName(), control_mode, _graph);
         g[mh] = control_mode;
+
+		if (_trace_recorder)
+			_trace_recorder->setName(control_mode.get(), control_mode->getName());
 	}
 
 	void HybridAutomaton::addControlSwitch(const std::string& source_mode, const ControlSwitch::Ptr& control_switch, const std::string& target_mode) 
@@ -192,6 +384,9 @@ namespace ha {
         g[sh] = control_switch;
 
 		_switchMap.insert(std::pair<std::string, SwitchHandle>(control_switch->getName(), sh));
+
+		if (_trace_recorder)
+			_trace_recorder->setName(control_switch.get(), control_switch->getName());
 	}
 
 	void HybridAutomaton::addControlSwitchAndMode(const std::string& source_mode, const ControlSwitch::Ptr& control_switch, const ControlMode::Ptr& target_mode) 
@@ -204,58 +399,399 @@ namespace ha {
 
 	::Eigen::MatrixXd HybridAutomaton::step(const double& t) 
 	{
+		HA_PROFILE_SCOPE(_step_profile, "HybridAutomaton.step", _name);
+
 		if (_active)
 		{
-			// check if any out-going jump condition is true
-			::std::pair<OutEdgeIterator, OutEdgeIterator> out_edges = ::boost::out_edges(_graph.vertex(_current_control_mode->getName()), _graph);
-			for(; out_edges.first != out_edges.second; ++out_edges.first) {
-				SwitchHandle switch_handle = *out_edges.first;
-				ControlSwitch::Ptr control_switch = _graph[switch_handle];
+			if (_supervision_thread)
+			{
+				if (_supervision_thread->hasFailed())
+					HA_THROW_ERROR("HybridAutomaton.step", "Supervision thread failed.");
+
+				_applySupervisionResult(t);
+			}
+			else
+			{
+				_superviseCurrentControlMode(t);
+			}
 
-				control_switch->step(t);
+			if (_trace_recorder)
+				_trace_recorder->recordTick(t, _current_control_mode.get());
 
-				if (control_switch->isActive())
-				{
-					// Copy the pointer to return it if someone asks for it
-					_last_active_control_switch = control_switch;
+			if (!_current_control_mode->getWatchdog())
+				return _current_control_mode->step(t); 
 
-					// switch to the next control mode
-					ModeHandle mode_handle = boost::target(switch_handle, _graph);
+			// a supervised control mode falls back instead of throwing
+			::Eigen::MatrixXd control;
+			if (_tryStepControlMode(t, control))
+				return control;
 
-					ha::ControlMode::Ptr next_control_mode = _graph.graph()[mode_handle];					
-					//switchControlMode realizes smooth transitions between control modes
-					next_control_mode->switchControlMode(_current_control_mode);
-					
-					_current_control_mode->terminate();
+			_reportError(t);
+			if (!_enterFallbackControlMode(t))
+				HA_THROW_ERROR(_last_error.origin, _last_error.message);
 
-					_current_control_mode = next_control_mode;
-					
-					_activateCurrentControlMode(t);
+			HA_WARN("HybridAutomaton.step", "Fell back to control mode '" << _current_control_mode->getName() << "' after: [" << _last_error.origin << "] " << _last_error.message);
+			return _current_control_mode->step(t);
+		}
+		HA_THROW_ERROR("HybridAutomaton.step", "No current control mode defined.");
+	}
 
-					break;
+	StepResult HybridAutomaton::tryStep(const double& t, ::Eigen::MatrixXd& control)
+	{
+		HA_PROFILE_SCOPE(_step_profile, "HybridAutomaton.step", _name);
+
+		if (!_active)
+		{
+			_last_error.set(ErrorRecord::FAULT_NOT_ACTIVE, "HybridAutomaton.tryStep", "No current control mode defined.");
+			_reportError(t);
+			return StepResult(StepResult::STEP_FAILED, _last_error.code);
+		}
+
+		if (_tryStepCurrentControlMode(t, control, true))
+			return _safe_mode_active ? StepResult(StepResult::STEP_SAFE_MODE, _last_error.code) : StepResult();
+
+		_reportError(t);
+		ErrorRecord::Code fault = _last_error.code;
+		if (!_enterFallbackControlMode(t))
+			return StepResult(StepResult::STEP_FAILED, fault);
+
+		// the safe control mode computes the output of this cycle, its switches are evaluated from the next one on
+		if (!_tryStepCurrentControlMode(t, control, false))
+		{
+			_reportError(t);
+			return StepResult(StepResult::STEP_FAILED, fault);
+		}
+		return StepResult(StepResult::STEP_SAFE_MODE, fault);
+	}
+
+	bool HybridAutomaton::_tryStepCurrentControlMode(const double& t, ::Eigen::MatrixXd& control, bool supervise)
+	{
+		// user code (controllers, sensors, systems) may still throw - catch it here instead of in the control loop
+		try
+		{
+			if (supervise && _supervision_thread)
+			{
+				if (_supervision_thread->hasFailed())
+				{
+					_last_error = _supervision_thread->getError();
+					return false;
 				}
+
+				_applySupervisionResult(t);
+			}
+			else if (supervise && !_trySuperviseCurrentControlMode(t, _last_error))
+			{
+				return false;
 			}
-			return _current_control_mode->step(t); 
+
+			if (_trace_recorder)
+				_trace_recorder->recordTick(t, _current_control_mode.get());
 		}
-		HA_THROW_ERROR("HybridAutomaton.step", "No current control mode defined.");
+		catch (const std::string& e)
+		{
+			_last_error.set(ErrorRecord::FAULT_EXCEPTION, "HybridAutomaton.tryStep", "%s", e.c_str());
+			return false;
+		}
+		catch (const std::exception& e)
+		{
+			_last_error.set(ErrorRecord::FAULT_EXCEPTION, "HybridAutomaton.tryStep", "%s", e.what());
+			return false;
+		}
+		catch (...)
+		{
+			_last_error.set(ErrorRecord::FAULT_EXCEPTION, "HybridAutomaton.tryStep", "Unknown exception in control mode '%s'.", _current_control_mode->getName().c_str());
+			return false;
+		}
+		return _tryStepControlMode(t, control);
+	}
+
+	bool HybridAutomaton::_tryStepControlMode(const double& t, ::Eigen::MatrixXd& control)
+	{
+		try
+		{
+			const Watchdog::Ptr& watchdog = _current_control_mode->getWatchdog();
+			if (!watchdog)
+				return _current_control_mode->tryStep(t, control, _last_error);
+
+			if (!watchdog->checkSensors(t, _last_error))
+				return false;
+
+			boost::uint64_t start = Profiler::now();
+			if (!_current_control_mode->tryStep(t, control, _last_error))
+				return false;
+			return watchdog->checkTickTime(static_cast<double>(Profiler::now() - start) * 1e-9, _last_error);
+		}
+		catch (const std::string& e)
+		{
+			_last_error.set(ErrorRecord::FAULT_EXCEPTION, "HybridAutomaton.tryStep", "%s", e.c_str());
+		}
+		catch (const std::exception& e)
+		{
+			_last_error.set(ErrorRecord::FAULT_EXCEPTION, "HybridAutomaton.tryStep", "%s", e.what());
+		}
+		catch (...)
+		{
+			_last_error.set(ErrorRecord::FAULT_EXCEPTION, "HybridAutomaton.tryStep", "Unknown exception in control mode '%s'.", _current_control_mode->getName().c_str());
+		}
+		return false;
+	}
+
+	void HybridAutomaton::_reportError(const double& t)
+	{
+		_last_error.time = t;
+		if (_error_queue)
+			_error_queue->push(_last_error);
+	}
+
+	bool HybridAutomaton::_enterFallbackControlMode(const double& t)
+	{
+		const Watchdog::Ptr& watchdog = _current_control_mode->getWatchdog();
+		const std::string& fallback = (watchdog && !watchdog->getFallbackControlMode().empty()) ? watchdog->getFallbackControlMode() : _safe_control_mode;
+		if (fallback.empty() || _current_control_mode->getName() == fallback)
+			return false;
+
+		try
+		{
+			// the supervision thread has stopped after its fault - supervise synchronously from now on
+			if (_supervision_thread && _supervision_thread->hasFailed())
+			{
+				_supervision_thread->stop();
+				_supervision_thread.reset();
+			}
+
+			// wait until the supervision thread is done with the switches that are terminated now
+			boost::unique_lock<boost::mutex> lock;
+			if (_supervision_thread)
+				lock = boost::unique_lock<boost::mutex>(_supervision_thread->getMutex());
+
+			ControlMode::Ptr fallback_control_mode = _graph[fallback];
+			fallback_control_mode->switchControlMode(_current_control_mode);
+			_current_control_mode->terminate();
+			_current_control_mode = fallback_control_mode;
+			_activateCurrentControlMode(t);
+
+			if (_supervision_thread)
+				_supervision_thread->publish(_graph.vertex(_current_control_mode->getName()), t);
+		}
+		catch (const std::string& e)
+		{
+			_last_error.set(ErrorRecord::FAULT_EXCEPTION, "HybridAutomaton.tryStep", "Switching to the fallback control mode failed: %s", e.c_str());
+			_reportError(t);
+			return false;
+		}
+		catch (...)
+		{
+			_last_error.set(ErrorRecord::FAULT_EXCEPTION, "HybridAutomaton.tryStep", "Switching to the fallback control mode failed.");
+			_reportError(t);
+			return false;
+		}
+
+		if (_trace_recorder)
+			_trace_recorder->recordTick(t, _current_control_mode.get());
+
+		_safe_mode_active = true;
+		return true;
+	}
+
+	void HybridAutomaton::setSafeControlMode(const std::string& control_mode)
+	{
+		if (!control_mode.empty() && !existsControlMode(control_mode)) {
+			HA_THROW_ERROR("HybridAutomaton.setSafeControlMode", "Control mode '" << control_mode << "' does not exist! Cannot set safe control mode.");
+		}
+		_safe_control_mode = control_mode;
+	}
+
+	const std::string& HybridAutomaton::getSafeControlMode() const
+	{
+		return _safe_control_mode;
+	}
+
+	void HybridAutomaton::setErrorQueue(const ErrorQueue::Ptr& queue)
+	{
+		_error_queue = queue;
+	}
+
+	ErrorQueue::Ptr HybridAutomaton::getErrorQueue() const
+	{
+		return _error_queue;
+	}
+
+	const ErrorRecord& HybridAutomaton::getLastError() const
+	{
+		return _last_error;
+	}
+
+	void HybridAutomaton::_applySupervisionResult(const double& t)
+	{
+		// apply a transition the supervision thread found for the current control mode - unless it is
+		// evaluating the switches right now, then the transition stays pending until the next cycle
+		boost::mutex::scoped_try_lock lock(_supervision_thread->getMutex());
+		std::size_t out_edge_index;
+		if (lock.owns_lock() && _supervision_thread->fetchActiveSwitch(out_edge_index))
+			_switchControlMode(_graph.vertex(_current_control_mode->getName()), out_edge_index, t);
+
+		_supervision_thread->publish(_graph.vertex(_current_control_mode->getName()), t);
+	}
+
+	void HybridAutomaton::_superviseCurrentControlMode(const double& t)
+	{
+		ErrorRecord error;
+		if (!_trySuperviseCurrentControlMode(t, error))
+			HA_THROW_ERROR(error.origin, error.message);
+	}
+
+	bool HybridAutomaton::_trySuperviseCurrentControlMode(const double& t, ErrorRecord& error)
+	{
+		bool found;
+		std::size_t out_edge_index;
+		ModeHandle current_mode = _graph.vertex(_current_control_mode->getName());
+		if (!_tryFindActiveControlSwitch(current_mode, t, found, out_edge_index, error))
+			return false;
+		if (found)
+			_switchControlMode(current_mode, out_edge_index, t);
+		return true;
+	}
+
+	bool HybridAutomaton::_findActiveControlSwitch(const ModeHandle& mode, const double& t, std::size_t& out_edge_index)
+	{
+		ErrorRecord error;
+		bool found;
+		if (!_tryFindActiveControlSwitch(mode, t, found, out_edge_index, error))
+			HA_THROW_ERROR(error.origin, error.message);
+		return found;
+	}
+
+	bool HybridAutomaton::_tryFindActiveControlSwitch(const ModeHandle& mode, const double& t, bool& found, std::size_t& out_edge_index, ErrorRecord& error)
+	{
+		found = false;
+
+		// check if any out-going jump condition is true - in the order of their priorities
+		const std::vector<std::size_t>* order = _getCompiledEvaluationOrder(mode);
+		OutEdgeIterator first_edge = ::boost::out_edges(mode, _graph).first;
+		std::size_t num_switches = ::boost::out_degree(mode, _graph.graph());
+		for(std::size_t k = 0; k < num_switches; ++k) {
+			std::size_t i = order ? (*order)[k] : k;
+			OutEdgeIterator out_edge = first_edge;
+			std::advance(out_edge, i);
+			const ControlSwitch::Ptr& control_switch = _graph[*out_edge];
+
+			// switches with a lower evaluation rate keep their last decision (inactive) in between
+			if (!control_switch->isEvaluationDue(t))
+				continue;
+
+			if (!control_switch->tryStep(t, error))
+				return false;
+			control_switch->scheduleNextEvaluation(t);
+
+			bool active;
+			if (!control_switch->tryIsActive(active, error))
+				return false;
+			control_switch->recordEvaluation(active);
+			if (_trace_recorder)
+				_traceControlSwitch(control_switch, t);
+
+			if (active)
+			{
+				found = true;
+				out_edge_index = i;
+				return true;
+			}
+		}
+		return true;
+	}
+
+	void HybridAutomaton::_traceControlSwitch(const ControlSwitch::Ptr& control_switch, const double& t)
+	{
+		// isActive short-circuits - conditions it did not evaluate still hold the values of an earlier tick
+		const std::vector<JumpConditionPtr>& jump_conditions = control_switch->getJumpConditions();
+		for (std::size_t i = 0; i < jump_conditions.size(); ++i)
+		{
+			const JumpConditionPtr& jump_condition = jump_conditions[i];
+			if (!jump_condition->wasEvaluated())
+				continue;
+			_trace_recorder->recordCondition(t, control_switch.get(), i, jump_condition->getLastCriterionValue(), jump_condition->getEpsilon(), jump_condition->wasLastEvaluationActive());
+		}
+	}
+
+	void HybridAutomaton::_switchControlMode(const ModeHandle& mode, std::size_t out_edge_index, const double& t)
+	{
+		OutEdgeIterator out_edge = ::boost::out_edges(mode, _graph).first;
+		std::advance(out_edge, out_edge_index);
+		_switchControlMode(*out_edge, t);
+	}
+
+	void HybridAutomaton::_switchControlMode(const SwitchHandle& switch_handle, const double& t)
+	{
+		// Copy the pointer to return it if someone asks for it
+		_last_active_control_switch = _graph[switch_handle];
+
+		if (_trace_recorder)
+			_trace_recorder->recordTransition(t, _last_active_control_switch.get());
+
+		// switch to the next control mode
+		ModeHandle mode_handle = boost::target(switch_handle, _graph);
+
+		ha::ControlMode::Ptr next_control_mode = _graph.graph()[mode_handle];					
+		//switchControlMode realizes smooth transitions between control modes
+		next_control_mode->switchControlMode(_current_control_mode);
+
+		_current_control_mode->terminate();
+
+		_current_control_mode = next_control_mode;
+		_safe_mode_active = false;
+
+		_activateCurrentControlMode(t);
+	}
+
+	void HybridAutomaton::setAsynchronousSupervision(bool b)
+	{
+		if (_active) {
+			HA_THROW_ERROR("HybridAutomaton.setAsynchronousSupervision", "Cannot change the supervision mode of an active hybrid automaton!");
+		}
+		_asynchronous_supervision = b;
+	}
+
+	bool HybridAutomaton::getAsynchronousSupervision() const
+	{
+		return _asynchronous_supervision;
+	}
+
+	void HybridAutomaton::setTraceRecorder(const TraceRecorder::Ptr& recorder)
+	{
+		_trace_recorder = recorder;
+		if (!_trace_recorder)
+			return;
+
+		for (std::pair<ModeIterator, ModeIterator> modes = ::boost::vertices(_graph); modes.first != modes.second; ++modes.first)
+		{
+			const ControlMode::Ptr& control_mode = _graph.graph()[*modes.first];
+			_trace_recorder->setName(control_mode.get(), control_mode->getName());
+		}
+		for (std::pair<SwitchIterator, SwitchIterator> switches = ::boost::edges(_graph); switches.first != switches.second; ++switches.first)
+		{
+			const ControlSwitch::Ptr& control_switch = _graph.graph()[*switches.first];
+			_trace_recorder->setName(control_switch.get(), control_switch->getName());
+		}
+	}
+
+	TraceRecorder::Ptr HybridAutomaton::getTraceRecorder() const
+	{
+		return _trace_recorder;
 	}
 
 
 	DescriptionTreeNode::Ptr HybridAutomaton::serialize(const DescriptionTree::ConstPtr& factory) const 
 	{
 		DescriptionTreeNode::Ptr tree_node = factory->createNode("HybridAutomaton");
-		tree_node->setAttribute<std::string>(std::string("name"), this->getName());
-
-		if (_current_control_mode)
-			tree_node->setAttribute<std::string>(std::string("current_control_mode"), _current_control_mode->getName());
+		_serializeAttributes(tree_node);
 
 		// Iterate over the vertices and serialize them
 		::std::pair<ModeIterator, ModeIterator> v_pair;
-		for(v_pair = ::boost::vertices(this->_graph); v_pair.first != v_pair.second; ++v_pair.first)
+		for(v_pair = ::boost::vertices(this->_graph.graph()); v_pair.first != v_pair.second; ++v_pair.first)
 		{
 			tree_node->addChildNode(_graph.graph()[*v_pair.first]->serialize(factory));
 
-			for(::std::pair<OutEdgeIterator, OutEdgeIterator> out_edges = ::boost::out_edges(_graph.vertex(_graph.graph()[*v_pair.first]->getName()), _graph); out_edges.first != out_edges.second; ++out_edges.first) 
+			for(::std::pair<OutEdgeIterator, OutEdgeIterator> out_edges = ::boost::out_edges(*v_pair.first, _graph.graph()); out_edges.first != out_edges.second; ++out_edges.first) 
 			{
 				tree_node->addChildNode(_graph.graph()[*out_edges.first]->serialize(factory));
 			}
@@ -264,13 +800,46 @@ namespace ha {
 		return tree_node;
 	}
 
+	void HybridAutomaton::serialize(std::ostream& out) const
+	{
+		DescriptionTreeStream::ConstPtr factory(new DescriptionTreeStream);
+		DescriptionTreeNode::Ptr tree_node = factory->createNode("HybridAutomaton");
+		_serializeAttributes(tree_node);
+		DescriptionTreeStream::writeStartElement(tree_node, out);
+
+		// the same elements as serialize(factory) - each one is written and dropped right away
+		::std::pair<ModeIterator, ModeIterator> v_pair;
+		for(v_pair = ::boost::vertices(this->_graph.graph()); v_pair.first != v_pair.second; ++v_pair.first)
+		{
+			DescriptionTreeStream::writeXML(_graph.graph()[*v_pair.first]->serialize(factory), out, 1);
+
+			for(::std::pair<OutEdgeIterator, OutEdgeIterator> out_edges = ::boost::out_edges(*v_pair.first, _graph.graph()); out_edges.first != out_edges.second; ++out_edges.first) 
+			{
+				DescriptionTreeStream::writeXML(_graph.graph()[*out_edges.first]->serialize(factory), out, 1);
+			}
+		}
+
+		DescriptionTreeStream::writeEndElement("HybridAutomaton", out);
+	}
+
+	void HybridAutomaton::_serializeAttributes(const DescriptionTreeNode::Ptr& tree_node) const
+	{
+		tree_node->setAttribute<std::string>(std::string("name"), this->getName());
+
+		if (_current_control_mode)
+			tree_node->setAttribute<std::string>(std::string("current_control_mode"), _current_control_mode->getName());
+
+		if (!_safe_control_mode.empty())
+			tree_node->setAttribute<std::string>(std::string("safe_control_mode"), _safe_control_mode);
+	}
+
 	void HybridAutomaton::deserialize(const DescriptionTreeNode::ConstPtr& tree, const System::ConstPtr& system, const HybridAutomaton* ha)
 	{
 		if (tree->getType() != "HybridAutomaton") {
 			HA_THROW_ERROR("HybridAutomaton.deserialize", "DescriptionTreeNode must have type 'HybridAutomaton', not '" << tree->getType() << "'!");
 		}
 
-		tree->getAttribute<std::string>("name", _name);
+		_beginDeserialization(tree);
 
 		// control modes
 		DescriptionTreeNode::ConstNodeList control_modes;
@@ -281,40 +850,170 @@ namespace ha {
 			HA_THROW_ERROR("HybridAutomaton.deserialize", "No control modes found!");
 		}
 
-		DescriptionTreeNode::ConstNodeList::iterator cm_it;
-		for (cm_it = control_modes.begin(); cm_it != control_modes.end(); ++cm_it) 
-		{
-			ControlMode::Ptr cm(new ControlMode);
-			cm->deserialize(*cm_it, system, this);
-			this->addControlMode(cm);
-		}
+		// the modes are independent until the switches are added, so they can be created in parallel
+		std::vector<DescriptionTreeNode::ConstPtr> control_mode_nodes(control_modes.begin(), control_modes.end());
+		std::vector<ControlMode::Ptr> modes;
+		_createControlModes(control_mode_nodes, system, modes);
+		for (std::size_t i = 0; i < modes.size(); ++i)
+			this->addControlMode(modes[i]);
 
 		// control switches
 		DescriptionTreeNode::ConstNodeList control_switches;
 		tree->getChildrenNodes("ControlSwitch", control_switches);
 		DescriptionTreeNode::ConstNodeList::iterator cs_it;
 		for (cs_it = control_switches.begin(); cs_it != control_switches.end(); ++cs_it) 
+			_deserializeControlSwitch(*cs_it, system);
+
+		_finishDeserialization(tree);
+	}
+
+	void HybridAutomaton::_beginDeserialization(const DescriptionTreeNode::ConstPtr& tree)
+	{
+		tree->getAttribute<std::string>("name", _name);
+
+		_shared_sensors.clear();
+		_controller_prototypes.clear();
+		_safe_control_mode.clear();
+	}
+
+	void HybridAutomaton::_deserializeControlMode(const DescriptionTreeNode::ConstPtr& node, const System::ConstPtr& system)
+	{
+		this->addControlMode(_createControlMode(node, system));
+	}
+
+	ControlMode::Ptr HybridAutomaton::_createControlMode(const DescriptionTreeNode::ConstPtr& node, const System::ConstPtr& system) const
+	{
+		// control modes with a nested automaton or regions instead of a control set
+		DescriptionTreeNode::ConstNodeList sub_automaton, regions;
+		node->getChildrenNodes("HybridAutomaton", sub_automaton);
+		node->getChildrenNodes("Region", regions);
+
+		ControlMode::Ptr cm;
+		if (!sub_automaton.empty())
+			cm.reset(new HierarchicalControlMode);
+		else if (!regions.empty())
+			cm.reset(new ParallelControlMode);
+		else
+			cm.reset(new ControlMode);
+		cm->deserialize(node, system, this);
+		return cm;
+	}
+
+	namespace {
+		struct ControlModeCreator
 		{
-			ControlSwitch::Ptr cs(new ControlSwitch);
-			std::string cs_name;
-			(*cs_it)->getAttribute<std::string>("name", cs_name, "");
-			cs->setName(cs_name);
+			ControlMode::Ptr (HybridAutomaton::*create)(const DescriptionTreeNode::ConstPtr&, const System::ConstPtr&) const;
+			const HybridAutomaton* ha;
+			const std::vector<DescriptionTreeNode::ConstPtr>* nodes;
+			const System::ConstPtr* system;
+			std::vector<ControlMode::Ptr>* modes;
+			std::vector<std::string>* errors;
+			boost::atomic<std::size_t>* next;
+
+			void operator()() const
+			{
+				// the modes take about the same time to create, so the workers simply take the next one
+				for (std::size_t i = next->fetch_add(1); i < nodes->size(); i = next->fetch_add(1))
+				{
+					try {
+						(*modes)[i] = (ha->*create)((*nodes)[i], *system);
+					}
+					catch (const std::string& error) {
+						(*errors)[i] = error;
+					}
+					catch (const std::exception& e) {
+						(*errors)[i] = e.what();
+					}
+					catch (...) {
+						// nothing may escape a worker thread - report it like the other errors
+						(*errors)[i] = "Unknown exception while creating a control mode.";
+					}
+				}
+			}
+		};
+	}
 
-			// check if source and target are in graph
-			std::string source, target;
-			(*cs_it)->getAttribute<std::string>("source", source, "");
-			(*cs_it)->getAttribute<std::string>("target", target, "");
+	void HybridAutomaton::_createControlModes(const std::vector<DescriptionTreeNode::ConstPtr>& nodes, const System::ConstPtr& system, std::vector<ControlMode::Ptr>& modes) const
+	{
+		modes.assign(nodes.size(), ControlMode::Ptr());
 
-			if (!existsControlMode(source))
-				HA_THROW_ERROR("HybridAutomaton.deserialize", "Control mode '" << source << "' does not exist! Cannot set source control mode.");	
-			if (!existsControlMode(target))
-				HA_THROW_ERROR("HybridAutomaton.deserialize", "Control mode '" << target << "' does not exist! Cannot set target control mode.");	
+		unsigned int number_of_threads = _deserialization_threads;
+		if (number_of_threads == 0)
+			number_of_threads = std::max(1u, boost::thread::hardware_concurrency());
+		if (number_of_threads > nodes.size())
+			number_of_threads = nodes.size();
 
-			this->addControlSwitch(source, cs, target);
+		if (number_of_threads <= 1)
+		{
+			for (std::size_t i = 0; i < nodes.size(); ++i)
+				modes[i] = _createControlMode(nodes[i], system);
+			return;
+		}
 
-			cs->deserialize(*cs_it, system, this);
+		std::vector<std::string> errors(nodes.size());
+		boost::atomic<std::size_t> next(0);
+
+		ControlModeCreator creator;
+		creator.create = &HybridAutomaton::_createControlMode;
+		creator.ha = this;
+		creator.nodes = &nodes;
+		creator.system = &system;
+		creator.modes = &modes;
+		creator.errors = &errors;
+		creator.next = &next;
+
+		boost::thread_group threads;
+		for (unsigned int i = 1; i < number_of_threads; ++i)
+			threads.create_thread(creator);
+		// the calling thread is one of the workers
+		creator();
+		threads.join_all();
+
+		// report the first failure in document order, as the serial deserialization would
+		for (std::size_t i = 0; i < nodes.size(); ++i)
+		{
+			if (!modes[i])
+				throw errors[i];
 		}
-		
+	}
+
+	void HybridAutomaton::setDeserializationThreads(unsigned int number_of_threads)
+	{
+		_deserialization_threads = number_of_threads;
+	}
+
+	unsigned int HybridAutomaton::getDeserializationThreads() const
+	{
+		return _deserialization_threads;
+	}
+
+	void HybridAutomaton::_deserializeControlSwitch(const DescriptionTreeNode::ConstPtr& node, const System::ConstPtr& system)
+	{
+		ControlSwitch::Ptr cs(new ControlSwitch);
+		std::string cs_name;
+		node->getAttribute<std::string>("name", cs_name, "");
+		cs->setName(cs_name);
+
+		// check if source and target are in graph
+		std::string source, target;
+		node->getAttribute<std::string>("source", source, "");
+		node->getAttribute<std::string>("target", target, "");
+
+		if (!existsControlMode(source))
+			HA_THROW_ERROR("HybridAutomaton.deserialize", "Control mode '" << source << "' does not exist! Cannot set source control mode.");	
+		if (!existsControlMode(target))
+			HA_THROW_ERROR("HybridAutomaton.deserialize", "Control mode '" << target << "' does not exist! Cannot set target control mode.");	
+
+		this->addControlSwitch(source, cs, target);
+
+		cs->deserialize(node, system, this);
+	}
+
+	void HybridAutomaton::_finishDeserialization(const DescriptionTreeNode::ConstPtr& tree)
+	{
+		// the modes own their clones - the prototypes are not needed anymore
+		_controller_prototypes.clear();
+
 		std::string current_control_mode_name;
 		if (tree->getAttribute<std::string>("current_control_mode", current_control_mode_name))
 		{
@@ -322,6 +1021,93 @@ namespace ha {
 		}
 		else
 			HA_THROW_ERROR("HybridAutomaton.deserialize", "Control mode '" << current_control_mode_name << "' does not exist! Cannot set current control mode.");	
+
+		std::string safe_control_mode_name;
+		if (tree->getAttribute<std::string>("safe_control_mode", safe_control_mode_name))
+			this->setSafeControlMode(safe_control_mode_name);
+
+		// only errors stop the deserialization - sink and unreachable modes are often intended, call validate() to see them
+		ValidationReport report;
+		this->validate(report);
+		if (report.hasErrors()) {
+			const std::vector<ValidationReport::Issue>& issues = report.getIssues();
+			std::ostringstream errors;
+			for (std::size_t i = 0; i < issues.size(); ++i) {
+				if (issues[i].severity == ValidationReport::SEVERITY_ERROR)
+					errors << std::endl << issues[i].origin << ": " << issues[i].message;
+			}
+			HA_THROW_ERROR("HybridAutomaton.deserialize", "Validation of '" << _name << "' failed:" << errors.str());
+		}
+	}
+
+	void HybridAutomaton::validate(ValidationReport& report)
+	{
+		std::size_t number_of_modes = ::boost::num_vertices(_graph.graph());
+		std::vector<bool> reachable(number_of_modes, false);
+
+		// the mode each mode's watchdog falls back to (null_vertex() if there is none)
+		std::vector<ModeHandle> fallback(number_of_modes, GraphTraits::null_vertex());
+		std::vector<bool> is_fallback(number_of_modes, false);
+		if (!_safe_control_mode.empty())
+			is_fallback[_graph.vertex(_safe_control_mode)] = true;
+		for (::std::pair<ModeIterator, ModeIterator> v_pair = ::boost::vertices(_graph.graph()); v_pair.first != v_pair.second; ++v_pair.first)
+		{
+			const ControlMode::Ptr& mode = _graph.graph()[*v_pair.first];
+			const Watchdog::Ptr& watchdog = mode->getWatchdog();
+			if (!watchdog || watchdog->getFallbackControlMode().empty())
+				continue;
+
+			if (!existsControlMode(watchdog->getFallbackControlMode())) {
+				report.addError("ControlMode '" + mode->getName() + "'", "Fallback control mode '" + watchdog->getFallbackControlMode() + "' of the watchdog does not exist.");
+				continue;
+			}
+			fallback[*v_pair.first] = _graph.vertex(watchdog->getFallbackControlMode());
+			is_fallback[fallback[*v_pair.first]] = true;
+		}
+
+		if (_current_control_mode)
+		{
+			// depth first search from the current control mode and the safe control mode tryStep falls back to
+			std::vector<ModeHandle> stack(1, _graph.vertex(_current_control_mode->getName()));
+			if (!_safe_control_mode.empty())
+				stack.push_back(_graph.vertex(_safe_control_mode));
+			for (std::size_t i = 0; i < stack.size(); ++i)
+				reachable[stack[i]] = true;
+			while (!stack.empty())
+			{
+				ModeHandle mode = stack.back();
+				stack.pop_back();
+				if (fallback[mode] != GraphTraits::null_vertex() && !reachable[fallback[mode]]) {
+					reachable[fallback[mode]] = true;
+					stack.push_back(fallback[mode]);
+				}
+				for (::std::pair<OutEdgeIterator, OutEdgeIterator> out_edges = ::boost::out_edges(mode, _graph.graph()); out_edges.first != out_edges.second; ++out_edges.first)
+				{
+					ModeHandle target = ::boost::target(*out_edges.first, _graph.graph());
+					if (!reachable[target]) {
+						reachable[target] = true;
+						stack.push_back(target);
+					}
+				}
+			}
+		}
+
+		for (::std::pair<ModeIterator, ModeIterator> v_pair = ::boost::vertices(_graph.graph()); v_pair.first != v_pair.second; ++v_pair.first)
+		{
+			const ControlMode::Ptr& mode = _graph.graph()[*v_pair.first];
+			std::string origin = "ControlMode '" + mode->getName() + "'";
+
+			if (_current_control_mode && !reachable[*v_pair.first])
+				report.addWarning(origin, "Not reachable from the current control mode '" + _current_control_mode->getName() + "'.");
+
+			::std::pair<OutEdgeIterator, OutEdgeIterator> out_edges = ::boost::out_edges(*v_pair.first, _graph.graph());
+			// staying in a safe or fallback control mode is intended
+			if (out_edges.first == out_edges.second && !is_fallback[*v_pair.first])
+				report.addWarning(origin, "No outgoing control switches - the automaton stays in this mode.");
+
+			for (; out_edges.first != out_edges.second; ++out_edges.first)
+				_graph.graph()[*out_edges.first]->validate(report);
+		}
 	}
 
 	void HybridAutomaton::setName(const std::string& name) 
@@ -339,12 +1125,122 @@ namespace ha {
 		if (!_current_control_mode) {
 			HA_THROW_ERROR("HybridAutomaton.initialize", "No current control mode defined!");
 		}
+		_bindWatchdogs();
+		_compileTransitionTable();
 		_activateCurrentControlMode(t);
 		_active = true;
+		_safe_mode_active = false;
+
+		if (_asynchronous_supervision)
+		{
+			_supervision_thread.reset(new SupervisionThread(this));
+			_supervision_thread->start(_graph.vertex(_current_control_mode->getName()), t);
+		}
+	}
+
+	namespace {
+		// orders out-edge indices by descending priority of their switches
+		struct HigherSwitchPriority
+		{
+			const std::vector<int>& priorities;
+			explicit HigherSwitchPriority(const std::vector<int>& priorities) : priorities(priorities) {}
+			bool operator()(std::size_t i, std::size_t j) const { return priorities[i] > priorities[j]; }
+		};
+	}
+
+	void HybridAutomaton::_getEvaluationOrder(const ModeHandle& mode, std::vector<std::size_t>& order) const
+	{
+		std::vector<int> priorities;
+		for (std::pair<OutEdgeIterator, OutEdgeIterator> out_edges = ::boost::out_edges(mode, _graph.graph()); out_edges.first != out_edges.second; ++out_edges.first)
+			priorities.push_back(_graph.graph()[*out_edges.first]->getPriority());
+
+		order.resize(priorities.size());
+		for (std::size_t i = 0; i < order.size(); ++i)
+			order[i] = i;
+		std::stable_sort(order.begin(), order.end(), HigherSwitchPriority(priorities));
+	}
+
+	void HybridAutomaton::_compileTransitionTable()
+	{
+		_transition_table.resize(::boost::num_vertices(_graph.graph()));
+		for (std::pair<ModeIterator, ModeIterator> modes = ::boost::vertices(_graph); modes.first != modes.second; ++modes.first)
+			_getEvaluationOrder(*modes.first, _transition_table[*modes.first]);
+	}
+
+	const std::vector<std::size_t>* HybridAutomaton::_getCompiledEvaluationOrder(const ModeHandle& mode) const
+	{
+		if (mode >= _transition_table.size() || _transition_table[mode].size() != ::boost::out_degree(mode, _graph.graph()))
+			return NULL;
+		return &_transition_table[mode];
+	}
+
+	void HybridAutomaton::reportControlSwitchStatistics(std::ostream& out) const
+	{
+		out << "Control switch statistics of '" << _name << "' (evaluations / activations):" << std::endl;
+		std::vector<std::size_t> order;
+		for (std::pair<ModeIterator, ModeIterator> modes = ::boost::vertices(_graph); modes.first != modes.second; ++modes.first)
+		{
+			OutEdgeIterator first_edge = ::boost::out_edges(*modes.first, _graph.graph()).first;
+			_getEvaluationOrder(*modes.first, order);
+			if (order.empty())
+				continue;
+
+			out << _graph.graph()[*modes.first]->getName() << ":" << std::endl;
+			for (std::size_t k = 0; k < order.size(); ++k)
+			{
+				OutEdgeIterator out_edge = first_edge;
+				std::advance(out_edge, order[k]);
+				const ControlSwitch::Ptr& control_switch = _graph.graph()[*out_edge];
+				unsigned long evaluations = control_switch->getNumberOfEvaluations();
+				unsigned long activations = control_switch->getNumberOfActivations();
+
+				out << "  " << control_switch->getName() << " (priority " << control_switch->getPriority() << "): "
+					<< evaluations << " / " << activations;
+				if (evaluations > 0)
+					out << " (" << (100.0 * activations) / evaluations << "%)";
+				out << std::endl;
+			}
+		}
+	}
+
+	void HybridAutomaton::resetControlSwitchStatistics()
+	{
+		for (std::pair<SwitchIterator, SwitchIterator> switches = ::boost::edges(_graph.graph()); switches.first != switches.second; ++switches.first)
+			_graph.graph()[*switches.first]->resetStatistics();
+	}
+
+	void HybridAutomaton::_bindWatchdogs()
+	{
+		for (std::pair<ModeIterator, ModeIterator> modes = ::boost::vertices(_graph); modes.first != modes.second; ++modes.first)
+		{
+			const Watchdog::Ptr& watchdog = _graph.graph()[*modes.first]->getWatchdog();
+			if (!watchdog)
+				continue;
+
+			std::vector<Sensor::ConstPtr> sensors;
+			for (std::pair<OutEdgeIterator, OutEdgeIterator> out_edges = ::boost::out_edges(*modes.first, _graph); out_edges.first != out_edges.second; ++out_edges.first)
+			{
+				const std::vector<JumpConditionPtr>& jump_conditions = _graph[*out_edges.first]->getJumpConditions();
+				for (std::size_t i = 0; i < jump_conditions.size(); ++i)
+				{
+					Sensor::ConstPtr sensor = jump_conditions[i]->getSensor();
+					if (sensor && std::find(sensors.begin(), sensors.end(), sensor) == sensors.end())
+						sensors.push_back(sensor);
+				}
+			}
+			watchdog->setSensors(sensors);
+		}
 	}
 
 	void HybridAutomaton::terminate() 
 	{
+		// the supervision thread must not touch the switches anymore
+		if (_supervision_thread)
+		{
+			_supervision_thread->stop();
+			_supervision_thread.reset();
+		}
+
 		if (_current_control_mode)
 			_current_control_mode->terminate();
 		_active = false;
@@ -393,6 +1289,9 @@ namespace ha {
 		HA_INFO("HybridAutomaton._activeCurrentControlMode", "Current mode: "<< _current_control_mode->getName());
 		_current_control_mode->initialize();
 
+		if (_current_control_mode->getWatchdog())
+			_current_control_mode->getWatchdog()->reset(t);
+
 		// initialize all outgoing edges
 		::std::pair<OutEdgeIterator, OutEdgeIterator> out_edges = ::boost::out_edges(_graph.vertex(_current_control_mode->getName()), _graph);
 		for(; out_edges.first != out_edges.second; ++out_edges.first) {
@@ -475,10 +1374,6 @@ namespace ha {
     public:
         vertex_writer(Graph& g, ControlModePtr current_cm) : _g(g), _current_cm(current_cm) {}
 
-        static bool compareControllers(ControllerPtr c1, ControllerPtr c2) {
-            return c1->getPriority() > c2->getPriority();
-        }
-
         template <class V>
         void operator()(std::ostream& out, const V& v) const {
             ControlMode::Ptr cm = _g[v];
@@ -510,17 +1405,12 @@ namespace ha {
                 out << "node [label=<<i>empty</i>>] " << v << ";" << std::endl;
             } else {
 
-                // iterate over controllers
-                // sort by priority
-                std::vector<Controller::Ptr> controllers;
-                for (std::map<std::string, Controller::Ptr>::const_iterator it = controller_map.begin(); it != controller_map.end(); it++) {
-                    controllers.push_back(it->second);
-                }
-                std::sort(controllers.begin(), controllers.end(), vertex_writer::compareControllers);
+                // iterate over controllers by priority
+                const std::vector<Controller::Ptr>& controllers = cs->getControllersByPriority();
 
                 int i=0;
-                for (std::vector<Controller::Ptr>::iterator it = controllers.begin(); it != controllers.end(); it++) {
-                    Controller::Ptr& ctrl = *it;
+                for (std::vector<Controller::Ptr>::const_iterator it = controllers.begin(); it != controllers.end(); it++) {
+                    const Controller::Ptr& ctrl = *it;
 
                     out << "node [label=<" << ctrl->getName() << "<BR/><BR/>";
                     out << "<FONT POINT-SIZE=\"8\">" << std::endl;
@@ -44,6 +44,7 @@
 #include "hybrid_automaton/HybridAutomatonRBOFactory.h"
 
 #include <exception>
+#include <sstream>
 namespace ha
 {
 HybridAutomatonAbstractFactory::HybridAutomatonAbstractFactory()
@@ -573,18 +574,17 @@ Eigen::MatrixXd HybridAutomatonAbstractFactory::_combineArmAndBase(const Eigen::
 
 std::string HybridAutomatonAbstractFactory::HybridAutomatonToString(ha::HybridAutomaton::ConstPtr ha)
 {
-    ha::DescriptionTreeXML::Ptr tree(new ha::DescriptionTreeXML);
-    ha::DescriptionTreeNode::Ptr ha_serialized;
-
+    // written directly, without building a DescriptionTreeXML
+    std::ostringstream xml;
     try{
-        ha_serialized = ha->serialize(tree);
+        ha->serialize(xml);
     }
     catch(std::string err)
     {
         std::cerr << "[HybridAutomatonAbstractFactory.HybridAutomatonToString] Failed to serialize Hybrid Automaton: " << err << std::endl;
+        return std::string();
     }
 
-    tree->setRootNode(ha_serialized);
-    return tree->writeTreeXML();
+    return xml.str();
 }
 }
@@ -0,0 +1,170 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "hybrid_automaton/HybridAutomatonCache.h"
+#include "hybrid_automaton/HybridAutomatonXMLReader.h"
+
+namespace ha {
+
+	HybridAutomatonCache::HybridAutomatonCache(const System::ConstPtr& system, std::size_t memory_budget)
+		: _system(system), _deserialize_default_entities(false), _memory_budget(memory_budget)
+	{
+	}
+
+	HybridAutomatonCache::~HybridAutomatonCache()
+	{
+	}
+
+	HybridAutomaton::Ptr HybridAutomatonCache::get(const std::string& description)
+	{
+		boost::uint64_t key = hash(description);
+		bool deserialize_default_entities;
+
+		{
+			boost::mutex::scoped_lock lock(_mutex);
+			std::map<boost::uint64_t, EntryList::iterator>::iterator it = _index.find(key);
+			if (it != _index.end() && it->second->description == description)
+			{
+				_entries.splice(_entries.begin(), _entries, it->second);
+				++_statistics.hits;
+				HybridAutomaton::ConstPtr prototype = it->second->prototype;
+				lock.unlock();
+				return prototype->clone();
+			}
+			++_statistics.misses;
+			deserialize_default_entities = _deserialize_default_entities;
+		}
+
+		// deserialize without holding the lock - another thread may add the same description meanwhile
+		HybridAutomaton::Ptr prototype(new HybridAutomaton);
+		prototype->setDeserializeDefaultEntities(deserialize_default_entities);
+		HybridAutomatonXMLReader reader(_system);
+		reader.read(description, *prototype);
+
+		Entry entry;
+		entry.hash = key;
+		entry.prototype = prototype;
+		entry.memory = _estimateMemory(description);
+
+		{
+			boost::mutex::scoped_lock lock(_mutex);
+			if (deserialize_default_entities == _deserialize_default_entities && entry.memory <= _memory_budget)
+			{
+				// replaces an entry with the same key - the same description or a hash collision
+				std::map<boost::uint64_t, EntryList::iterator>::iterator it = _index.find(key);
+				if (it != _index.end())
+				{
+					_statistics.memory -= it->second->memory;
+					_entries.erase(it->second);
+					_index.erase(it);
+				}
+
+				entry.description = description;
+				_entries.push_front(entry);
+				_index[key] = _entries.begin();
+				_statistics.memory += entry.memory;
+				_evict();
+			}
+		}
+
+		return prototype->clone();
+	}
+
+	void HybridAutomatonCache::setDeserializeDefaultEntities(bool b)
+	{
+		boost::mutex::scoped_lock lock(_mutex);
+		if (b != _deserialize_default_entities)
+		{
+			_deserialize_default_entities = b;
+			_entries.clear();
+			_index.clear();
+			_statistics.memory = 0;
+		}
+	}
+
+	bool HybridAutomatonCache::getDeserializeDefaultEntities() const
+	{
+		boost::mutex::scoped_lock lock(_mutex);
+		return _deserialize_default_entities;
+	}
+
+	void HybridAutomatonCache::setMemoryBudget(std::size_t memory_budget)
+	{
+		boost::mutex::scoped_lock lock(_mutex);
+		_memory_budget = memory_budget;
+		_evict();
+	}
+
+	std::size_t HybridAutomatonCache::getMemoryBudget() const
+	{
+		boost::mutex::scoped_lock lock(_mutex);
+		return _memory_budget;
+	}
+
+	void HybridAutomatonCache::clear()
+	{
+		boost::mutex::scoped_lock lock(_mutex);
+		_entries.clear();
+		_index.clear();
+		_statistics.memory = 0;
+	}
+
+	HybridAutomatonCache::Statistics HybridAutomatonCache::getStatistics() const
+	{
+		boost::mutex::scoped_lock lock(_mutex);
+		Statistics statistics = _statistics;
+		statistics.entries = _entries.size();
+		return statistics;
+	}
+
+	boost::uint64_t HybridAutomatonCache::hash(const std::string& description)
+	{
+		boost::uint64_t h = 14695981039346656037ULL;
+		for (std::string::const_iterator it = description.begin(); it != description.end(); ++it)
+		{
+			h ^= static_cast<unsigned char>(*it);
+			h *= 1099511628211ULL;
+		}
+		return h;
+	}
+
+	std::size_t HybridAutomatonCache::_estimateMemory(const std::string& description)
+	{
+		return sizeof(Entry) + 2 * description.size();
+	}
+
+	void HybridAutomatonCache::_evict()
+	{
+		while (_statistics.memory > _memory_budget && !_entries.empty())
+		{
+			const Entry& oldest = _entries.back();
+			_statistics.memory -= oldest.memory;
+			_index.erase(oldest.hash);
+			_entries.pop_back();
+			++_statistics.evictions;
+		}
+	}
+
+}
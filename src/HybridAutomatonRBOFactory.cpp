@@ -34,6 +34,7 @@
 #include "hybrid_automaton/JointVelocitySensor.h"
 #include "hybrid_automaton/SubjointConfigurationSensor.h"
 #include "hybrid_automaton/SubjointVelocitySensor.h"
+#include "hybrid_automaton/IndexPlan.h"
 #include "hybrid_automaton/ForceTorqueSensor.h"
 #include "hybrid_automaton/ClockSensor.h"
 #include "hybrid_automaton/FrameDisplacementSensor.h"
@@ -208,11 +209,16 @@ ha::Controller::Ptr HybridAutomatonRBOFactory::createSubjointSpaceController(con
     index_vec_ss << index_vec;
     ctrl->setArgument("index", index_vec_ss.str());
     ctrl->setGoal(goal_js);
-    Eigen::VectorXd kp_js_masked = mask_by_index(p.kp_js,index_vec);
+    // build and check the index once for all gains
+    ha::IndexPlan index_plan;
+    index_plan.setIndex(index_vec);
+    index_plan.validate(p.kp_js.size());
+    Eigen::MatrixXd kp_js_masked, kv_js_masked, max_vel_js_masked;
+    index_plan.gather(p.kp_js, kp_js_masked);
     ctrl->setKp(kp_js_masked);
-    Eigen::VectorXd kv_js_masked = mask_by_index(p.kv_js,index_vec);
+    index_plan.gather(p.kv_js, kv_js_masked);
     ctrl->setKv(kv_js_masked);
-    Eigen::VectorXd max_vel_js_masked = mask_by_index(p.max_vel_js,index_vec);
+    index_plan.gather(p.max_vel_js, max_vel_js_masked);
     ctrl->setMaximumVelocity(max_vel_js_masked);
     ctrl->setGoalIsRelative(is_relative);
     return ctrl;
@@ -492,12 +498,12 @@ Eigen::MatrixXd _combineArmAndBase(const Eigen::MatrixXd& arm_vector, const Eige
 }
 Eigen::MatrixXd mask_by_index(const Eigen::MatrixXd m, const Eigen::MatrixXd index_vec)
 {
-    Eigen::VectorXd masked;
-        masked.resize(index_vec.size());
-        for (int i=0;i<index_vec.size();++i){
-            masked(i)=m(index_vec(i));
-        }
-        return masked;
+    ha::IndexPlan plan;
+    plan.setIndex(index_vec);
+    plan.validate(m.size());
+    Eigen::MatrixXd masked;
+    plan.gather(m, masked);
+    return masked;
 }
 
 std::string HybridAutomatonRBOFactory::HybridAutomatonToString(ha::HybridAutomaton::ConstPtr ha)
@@ -25,6 +25,9 @@
  */
 #include "hybrid_automaton/HybridAutomatonStringStream.h"
 
+#include <clocale>
+#include <cstdio>
+#include <cstring>
 
 namespace ha{
 	template <>
@@ -92,4 +95,53 @@ namespace ha{
 
 		return *this;
 	}
+
+	void ha_append(std::string& out, const std::string& value)
+	{
+		out += value;
+	}
+
+	void ha_append(std::string& out, const double& value)
+	{
+		// %g is the default floating point format of the streams
+		char buffer[32];
+		int length = std::sprintf(buffer, "%g", value);
+
+		// sprintf uses the C locale of the program, ha_stringstream the "C" locale
+		const char* decimal_point = std::localeconv()->decimal_point;
+		if (decimal_point[0] != '.' && decimal_point[0] != '\0' && decimal_point[1] == '\0') {
+			char* c = std::strchr(buffer, decimal_point[0]);
+			if (c)
+				*c = '.';
+		}
+		out.append(buffer, length);
+	}
+
+	void ha_append(std::string& out, const int& value)
+	{
+		char buffer[16];
+		out.append(buffer, std::sprintf(buffer, "%d", value));
+	}
+
+	void ha_append(std::string& out, const bool& value)
+	{
+		out += value ? '1' : '0';
+	}
+
+	void ha_append(std::string& out, const ::Eigen::MatrixXd& value)
+	{
+		char buffer[48];
+		out.append(buffer, std::sprintf(buffer, "[%ld,%ld]", static_cast<long>(value.rows()), static_cast<long>(value.cols())));
+		for (int rows_it = 0; rows_it < value.rows(); ++rows_it)
+		{
+			for (int cols_it = 0; cols_it < value.cols(); ++cols_it)
+			{
+				ha_append(out, value(rows_it, cols_it));
+				if (cols_it != value.cols() - 1)
+					out += ',';
+			}
+			if (rows_it != value.rows() - 1)
+				out += ';';
+		}
+	}
 }
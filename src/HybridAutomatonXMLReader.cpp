@@ -0,0 +1,148 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "hybrid_automaton/HybridAutomatonXMLReader.h"
+#include "hybrid_automaton/error_handling.h"
+
+#include <sstream>
+
+namespace ha {
+
+	HybridAutomatonXMLReader::HybridAutomatonXMLReader(const System::ConstPtr& system)
+		: _system(system), _ha(NULL), _number_of_control_modes(0), _number_of_deferred_switches(0)
+	{
+	}
+
+	HybridAutomatonXMLReader::~HybridAutomatonXMLReader()
+	{
+	}
+
+	void HybridAutomatonXMLReader::read(const std::string& input, HybridAutomaton& ha)
+	{
+		std::istringstream in(input);
+		this->read(in, ha);
+	}
+
+	void HybridAutomatonXMLReader::read(std::istream& input, HybridAutomaton& ha)
+	{
+		_ha = &ha;
+		_root.reset();
+		_open_nodes.clear();
+		_number_of_control_modes = 0;
+		_deferred_switches.clear();
+		_deferred_sources.clear();
+		_number_of_deferred_switches = 0;
+
+		try
+		{
+			_parser.parse(input, *this);
+		}
+		catch (...)
+		{
+			_ha = NULL;
+			_open_nodes.clear();
+			_deferred_switches.clear();
+			throw;
+		}
+		_ha = NULL;
+	}
+
+	std::size_t HybridAutomatonXMLReader::getNumberOfDeferredControlSwitches() const
+	{
+		return _number_of_deferred_switches;
+	}
+
+	void HybridAutomatonXMLReader::startElement(const std::string& name, const AttributeList& attributes)
+	{
+		if (!_root)
+		{
+			if (name != "HybridAutomaton")
+				HA_THROW_ERROR("HybridAutomatonXMLReader.read", "Root element must have type 'HybridAutomaton', not '" << name << "'!");
+			_root.reset(new DescriptionTreeNodeStream(name, attributes));
+			_ha->_beginDeserialization(_root);
+			return;
+		}
+
+		DescriptionTreeNodeStream::Ptr node(new DescriptionTreeNodeStream(name, attributes));
+		if (!_open_nodes.empty())
+			_open_nodes.back()->addChildNode(node);
+		_open_nodes.push_back(node);
+	}
+
+	void HybridAutomatonXMLReader::endElement(const std::string& name)
+	{
+		if (_open_nodes.empty())
+		{
+			_finish();
+			return;
+		}
+
+		DescriptionTreeNodeStream::Ptr node = _open_nodes.back();
+		_open_nodes.pop_back();
+		if (_open_nodes.empty())
+			_deserializeElement(node);
+	}
+
+	void HybridAutomatonXMLReader::_deserializeElement(const DescriptionTreeNodeStream::Ptr& node)
+	{
+		const std::string type = node->getType();
+		if (type == "ControlMode")
+		{
+			_ha->_deserializeControlMode(node, _system);
+			++_number_of_control_modes;
+		}
+		else if (type == "ControlSwitch")
+		{
+			std::string source, target;
+			node->getAttribute<std::string>("source", source, "");
+			node->getAttribute<std::string>("target", target, "");
+
+			if (_ha->existsControlMode(source) && _ha->existsControlMode(target) && _deferred_sources.find(source) == _deferred_sources.end())
+			{
+				_ha->_deserializeControlSwitch(node, _system);
+			}
+			else
+			{
+				_deferred_switches.push_back(node);
+				_deferred_sources.insert(source);
+				++_number_of_deferred_switches;
+			}
+		}
+		// other elements are ignored, as in HybridAutomaton::deserialize
+	}
+
+	void HybridAutomatonXMLReader::_finish()
+	{
+		if (_number_of_control_modes == 0)
+			HA_THROW_ERROR("HybridAutomatonXMLReader.read", "No control modes found!");
+
+		for (std::size_t i = 0; i < _deferred_switches.size(); ++i)
+			_ha->_deserializeControlSwitch(_deferred_switches[i], _system);
+		_deferred_switches.clear();
+		_deferred_sources.clear();
+
+		_ha->_finishDeserialization(_root);
+	}
+}
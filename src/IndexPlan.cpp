@@ -0,0 +1,154 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "hybrid_automaton/IndexPlan.h"
+#include "hybrid_automaton/error_handling.h"
+
+#include <boost/dynamic_bitset.hpp>
+
+#include <cmath>
+
+namespace ha
+{
+
+	IndexPlan::IndexPlan()
+	{
+	}
+
+	IndexPlan::IndexPlan(const std::vector<int>& index)
+	{
+		setIndex(index);
+	}
+
+	IndexPlan::~IndexPlan()
+	{
+	}
+
+	void IndexPlan::setIndex(const std::vector<int>& index)
+	{
+		_index = index;
+		_computeRuns();
+	}
+
+	void IndexPlan::setIndex(const ::Eigen::MatrixXd& index)
+	{
+		std::vector<int> index_vec(index.size());
+		for(int i = 0; i < index.size(); i++)
+		{
+			if(fabs(index(i) - floor(index(i))) > 0.01)
+				HA_THROW_ERROR("IndexPlan.setIndex", "Value in index not an integer - instead it's " << index(i) << " !");
+			index_vec[i] = (int)floor(index(i));
+		}
+		setIndex(index_vec);
+	}
+
+	const std::vector<int>& IndexPlan::getIndex() const
+	{
+		return _index;
+	}
+
+	::Eigen::MatrixXd IndexPlan::getIndexMatrix() const
+	{
+		::Eigen::MatrixXd index_mat(_index.size(), 1);
+		for(std::size_t j = 0; j < _index.size(); j++)
+			index_mat(j) = _index[j];
+		return index_mat;
+	}
+
+	std::size_t IndexPlan::size() const
+	{
+		return _index.size();
+	}
+
+	std::size_t IndexPlan::getNumberOfRuns() const
+	{
+		return _runs.size();
+	}
+
+	void IndexPlan::validate(int dimension) const
+	{
+		boost::dynamic_bitset<> used(dimension > 0 ? dimension : 0);
+		for(std::size_t i = 0; i < _index.size(); i++)
+		{
+			if(_index[i] >= dimension || _index[i] < 0)
+				HA_THROW_ERROR("IndexPlan.validate", "Value in index does not match a joint index - instead it's " << _index[i] << " !");
+			if(used.test(_index[i]))
+				HA_THROW_ERROR("IndexPlan.validate", "Value in index occurs twice: " << _index[i] << ". These should be unique !");
+			used.set(_index[i]);
+		}
+	}
+
+	void IndexPlan::gather(const ::Eigen::MatrixXd& in, ::Eigen::MatrixXd& out) const
+	{
+		if(out.rows() != (int)_index.size() || out.cols() != 1)
+			out.resize(_index.size(), 1);
+
+		// linear access, in may be a row or a column vector
+		::Eigen::Map<const ::Eigen::VectorXd> in_vec(in.data(), in.size());
+		for(std::size_t i = 0; i < _runs.size(); i++)
+		{
+			const Run& run = _runs[i];
+			if(run.length == 1)
+				out(run.target) = in_vec(run.source);
+			else
+				out.col(0).segment(run.target, run.length) = in_vec.segment(run.source, run.length);
+		}
+	}
+
+	void IndexPlan::scatterAdd(const ::Eigen::MatrixXd& in, ::Eigen::MatrixXd& out) const
+	{
+		::Eigen::Map<const ::Eigen::VectorXd> in_vec(in.data(), in.size());
+		::Eigen::Map< ::Eigen::VectorXd> out_vec(out.data(), out.size());
+		for(std::size_t i = 0; i < _runs.size(); i++)
+		{
+			const Run& run = _runs[i];
+			if(run.length == 1)
+				out_vec(run.source) += in_vec(run.target);
+			else
+				out_vec.segment(run.source, run.length) += in_vec.segment(run.target, run.length);
+		}
+	}
+
+	void IndexPlan::_computeRuns()
+	{
+		_runs.clear();
+		for(std::size_t i = 0; i < _index.size(); i++)
+		{
+			if(!_runs.empty() && _runs.back().source + _runs.back().length == _index[i])
+			{
+				_runs.back().length++;
+			}
+			else
+			{
+				Run run;
+				run.source = _index[i];
+				run.target = i;
+				run.length = 1;
+				_runs.push_back(run);
+			}
+		}
+	}
+
+}
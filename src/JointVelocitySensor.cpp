@@ -48,6 +48,15 @@ namespace ha
 		return this->_system->getJointVelocity();
 	}
 
+	bool JointVelocitySensor::getDimensions(int& rows, int& cols) const
+	{
+		if (!_system || _system->getDof() <= 0)
+			return false;
+		rows = _system->getDof();
+		cols = 1;
+		return true;
+	}
+
 	DescriptionTreeNode::Ptr JointVelocitySensor::serialize(const DescriptionTree::ConstPtr& factory) const
 	{
 		DescriptionTreeNode::Ptr tree = factory->createNode("Sensor");
@@ -24,7 +24,12 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 #include "hybrid_automaton/JumpCondition.h"
+#include "hybrid_automaton/JumpCriterionEvaluator.h"
 #include "hybrid_automaton/HybridAutomaton.h"
+#include "hybrid_automaton/Profiler.h"
+
+#include <limits>
+#include <typeinfo>
 
 namespace ha {
 
@@ -33,7 +38,23 @@ namespace ha {
 		_jump_criterion(NORM_L1),
 		_epsilon(0.0),
         _is_goal_relative(false),
-        _negate(false)
+        _negate(false),
+		_hold_ticks(0),
+		_hold_time(0.0),
+		_hysteresis(0.0),
+		_filter_type(NO_FILTER),
+		_filter_window(1),
+		_filter_alpha(1.0),
+		_criterion_met(false),
+		_qualified_active(false),
+		_hold_ticks_count(0),
+		_hold_start_time(0.0),
+		_dimensions_validated(false),
+		_last_criterion_value(std::numeric_limits<double>::quiet_NaN()),
+		_last_evaluation_active(false),
+		_evaluated(false),
+		_missing_goal_count(0),
+		_filter_seeded(false)
 	{
 
 	}
@@ -48,13 +69,35 @@ namespace ha {
 		this->_goalSource = jc._goalSource;
 		this->_goal = jc._goal;
 		this->_controller = jc._controller;
+		this->_ros_tf_goal_child = jc._ros_tf_goal_child;
+		this->_ros_tf_goal_parent = jc._ros_tf_goal_parent;
 		this->_sensor = jc._sensor;
+		this->_system = jc._system;
+		this->_sourceModeName = jc._sourceModeName;
+		this->_is_goal_relative = jc._is_goal_relative;
 		this->_jump_criterion = jc._jump_criterion;
 		this->_norm_weights = jc._norm_weights;
 		this->_epsilon = jc._epsilon;
 		this->_ros_topic_goal_name = jc._ros_topic_goal_name;
 		this->_ros_topic_goal_type = jc._ros_topic_goal_type;
         this->_negate=jc._negate;
+		this->_hold_ticks = jc._hold_ticks;
+		this->_hold_time = jc._hold_time;
+		this->_hysteresis = jc._hysteresis;
+		this->_filter_type = jc._filter_type;
+		this->_filter_window = jc._filter_window;
+		this->_filter_alpha = jc._filter_alpha;
+		this->_criterion_met = false;
+		this->_qualified_active = false;
+		this->_hold_ticks_count = 0;
+		this->_hold_start_time = 0.0;
+		this->_dimensions_validated = jc._dimensions_validated;
+		this->_criterion_evaluator = jc._criterion_evaluator;
+		this->_last_criterion_value = std::numeric_limits<double>::quiet_NaN();
+		this->_last_evaluation_active = false;
+		this->_evaluated = false;
+		this->_missing_goal_count = 0;
+		this->_filter_seeded = false;
 	}
 
 	void JumpCondition::initialize(const double& t) 
@@ -66,6 +109,26 @@ namespace ha {
 		if (this->_goalSource == ROSTOPIC_TF) {
 			_system->subscribeToTransform(_ros_tf_goal_child, _ros_tf_goal_parent);
 		}
+
+		_criterion_met = false;
+		_qualified_active = false;
+		_hold_ticks_count = 0;
+		_hold_start_time = t;
+		_last_criterion_value = std::numeric_limits<double>::quiet_NaN();
+		_last_evaluation_active = false;
+		_evaluated = false;
+
+		// allocate the filter state once - step() must not allocate
+		if (_filter_type == FILTER_MOVING_AVERAGE)
+			_filter.reset(new MovingAverageFilter(_filter_window));
+		else if (_filter_type == FILTER_EXPONENTIAL)
+			_filter.reset(new ExponentialFilter(_filter_alpha));
+		else
+			_filter.reset();
+
+		if (_filter)
+			_filter->initialize(this->_sensor->getInitialValue(), t, _filtered_value);
+		_filter_seeded = false;
 	}
 
 	void JumpCondition::terminate() 
@@ -74,63 +137,253 @@ namespace ha {
 	}
 
 	void JumpCondition::step(const double& t) 
+	{
+		ErrorRecord error;
+		if (!_step(t, error))
+			HA_THROW_ERROR(error.origin, error.message);
+	}
+
+	bool JumpCondition::tryStep(const double& t, ErrorRecord& error)
+	{
+		// sensors may still throw, a subclass may override step() - only then the virtual call is needed
+		try
+		{
+			if (typeid(*this) == typeid(JumpCondition))
+				return _step(t, error);
+			this->step(t);
+			return true;
+		}
+		catch (const std::string& e)
+		{
+			error.set(ErrorRecord::FAULT_JUMP_CONDITION, "JumpCondition.step", "%s", e.c_str());
+		}
+		catch (const std::exception& e)
+		{
+			error.set(ErrorRecord::FAULT_JUMP_CONDITION, "JumpCondition.step", "%s", e.what());
+		}
+		catch (...)
+		{
+			error.set(ErrorRecord::FAULT_JUMP_CONDITION, "JumpCondition.step", "Unknown exception.");
+		}
+		return false;
+	}
+
+	bool JumpCondition::_step(const double& t, ErrorRecord& error)
 	{
 		this->_sensor->step(t);
+
+		// the qualifiers need to see every evaluation, so they are updated here and not in isActive
+		// (the ControlSwitch skips isActive of the JumpConditions its expression short-circuits)
+		if (_hasTemporalQualifiers())
+			return _updateTemporalQualifiers(t, error);
+		return true;
 	}
 
 	bool JumpCondition::isActive() const 
 	{
+		bool active;
+		ErrorRecord error;
+		if (!_isActive(active, error))
+			HA_THROW_ERROR(error.origin, error.message);
+		return active;
+	}
+
+	bool JumpCondition::tryIsActive(bool& active, ErrorRecord& error) const
+	{
+		_evaluated = true;
+		active = false;
+		// sensors may still throw, a subclass may override isActive() - only then the virtual call is needed
+		try
+		{
+			if (typeid(*this) == typeid(JumpCondition))
+				return _isActive(active, error);
+			active = this->isActive();
+			return true;
+		}
+		catch (const std::string& e)
+		{
+			error.set(ErrorRecord::FAULT_JUMP_CONDITION, "JumpCondition.isActive", "%s", e.c_str());
+		}
+		catch (const std::exception& e)
+		{
+			error.set(ErrorRecord::FAULT_JUMP_CONDITION, "JumpCondition.isActive", "%s", e.what());
+		}
+		catch (...)
+		{
+			error.set(ErrorRecord::FAULT_JUMP_CONDITION, "JumpCondition.isActive", "Unknown exception.");
+		}
+		active = false;
+		return false;
+	}
+
+	bool JumpCondition::_isActive(bool& active, ErrorRecord& error) const
+	{
+		HA_PROFILE_SCOPE(_is_active_profile, "JumpCondition.isActive", this->_sensor->getType());
+
+		active = _last_evaluation_active = false;
+
 		if (!this->_sensor->isActive()) {
-			return false;
+			_last_criterion_value = std::numeric_limits<double>::quiet_NaN();
+			return true;
 		}
 
-		::Eigen::MatrixXd current = this->_sensor->getCurrentValue();
-		::Eigen::MatrixXd initial = this->_sensor->getInitialValue();
-		::Eigen::MatrixXd desired = this->getGoal();
+		if (_hasTemporalQualifiers()) {
+			active = _last_evaluation_active = _qualified_active;
+			return true;
+		}
+
+		_last_criterion_value = std::numeric_limits<double>::quiet_NaN();
+		::Eigen::MatrixXd current, desired;
+		bool has_goal;
+		if (!_getCurrentAndGoal(current, desired, has_goal, error))
+			return false;
+		if (!has_goal)
+			return true;
+
+		if (!this->_computeJumpCriterion(current, desired, _last_criterion_value, error))
+			return false;
+		active = _last_evaluation_active = _compareToEpsilon(_last_criterion_value, false);
+		return true;
+	}
+
+	bool JumpCondition::_getCurrentAndGoal(::Eigen::MatrixXd& current, ::Eigen::MatrixXd& desired, bool& has_goal, ErrorRecord& error) const
+	{
+		has_goal = false;
 
-		if(desired.cols()== 0 && desired.rows() ==0)
 		{
-			static int not_yet_ctr = 0;
+			HA_PROFILE_SCOPE(_sensor_profile, "Sensor.getCurrentValue", this->_sensor->getType());
+			current = this->_sensor->getCurrentValue();
+		}
+		desired = this->getGoal();
 
-			if(not_yet_ctr++%500 == 0)
+		if(desired.cols()== 0 && desired.rows() ==0)
+		{
+			if(_missing_goal_count++%500 == 0)
 			{
 				HA_INFO("JumpCondition.isActive","Goal is not set yet. Returning false. Are you running a BB controller?");
 			}
-			return false;
+			return true;
+		}
+		has_goal = true;
+
+		// validate() has checked the dimensions already
+		if (_dimensions_validated)
+		{
+			if(this->_is_goal_relative)
+				current = this->_sensor->getRelativeCurrentValue();
+			return true;
 		}
 
 		if(desired.rows() != current.rows() || desired.cols() != current.cols())
 		{
-			HA_THROW_ERROR("JumpCondition.isActive", "Dimension mismatch in sensor and goal - sensor: "
-			<<current.rows()<<"x"<<current.cols()<<", current: "<<desired.rows()<<"x"<<desired.cols()<<"!"
-			<< " Sensor Type: " << this->_sensor->getType());
+			error.set(ErrorRecord::FAULT_JUMP_CONDITION, "JumpCondition.isActive", "Dimension mismatch in sensor and goal - sensor: %dx%d, goal: %dx%d!",
+				static_cast<int>(current.rows()), static_cast<int>(current.cols()), static_cast<int>(desired.rows()), static_cast<int>(desired.cols()));
+			return false;
 		}
-		 
+
+		::Eigen::MatrixXd initial = this->_sensor->getInitialValue();
 		if(initial.rows() != current.rows() || initial.cols() != current.cols())
 		{
-			HA_THROW_ERROR("JumpCondition.isActive", "Dimension mismatch in initial and current sensor values: "
-			<<current.rows()<<"x"<<current.cols()<<", current: "<<initial.rows()<<"x"<<initial.cols()<<"!");
+			error.set(ErrorRecord::FAULT_JUMP_CONDITION, "JumpCondition.isActive", "Dimension mismatch in initial and current sensor values: %dx%d, initial: %dx%d!",
+				static_cast<int>(current.rows()), static_cast<int>(current.cols()), static_cast<int>(initial.rows()), static_cast<int>(initial.cols()));
+			return false;
 		}
 		 
 		if(this->_is_goal_relative)
+			current = this->_sensor->getRelativeCurrentValue();
+
+		return true;
+	}
+
+	bool JumpCondition::_compareToEpsilon(double criterion, bool was_met) const
+	{
+		// widen the band once the criterion was met to avoid chattering around epsilon
+		double band = was_met ? _hysteresis : 0.0;
+
+		if (!_negate)
+			return (criterion <= _epsilon + band);
+		else
+			return (criterion > _epsilon - band);
+	}
+
+	bool JumpCondition::_hasTemporalQualifiers() const
+	{
+		return (_hold_ticks > 1 || _hold_time > 0.0 || _hysteresis > 0.0 || _filter_type != NO_FILTER);
+	}
+
+	bool JumpCondition::_updateTemporalQualifiers(const double& t, ErrorRecord& error)
+	{
+		_last_criterion_value = std::numeric_limits<double>::quiet_NaN();
+
+		if (!this->_sensor->isActive())
 		{
-            if (!_negate){
-                return (this->_computeJumpCriterion(this->_sensor->getRelativeCurrentValue(), desired) <= _epsilon);
-            } else {
-                return (this->_computeJumpCriterion(this->_sensor->getRelativeCurrentValue(), desired) > _epsilon);
-            }
-		}else{
-            if (!_negate){
-                return (this->_computeJumpCriterion( this->_sensor->getCurrentValue(), desired) <= _epsilon);
-            } else {
-                return (this->_computeJumpCriterion( this->_sensor->getCurrentValue(), desired) > _epsilon);
-            }
+			_criterion_met = false;
+			_qualified_active = false;
+			_hold_ticks_count = 0;
+			return true;
+		}
 
+		::Eigen::MatrixXd current, desired;
+		bool has_goal;
+		_qualified_active = false;
+		if (!_getCurrentAndGoal(current, desired, has_goal, error))
+			return false;
+		if (!has_goal)
+			return true;
+
+		const ::Eigen::MatrixXd* value = _filterSensorValue(current, t, error);
+		if (!value || !this->_computeJumpCriterion(*value, desired, _last_criterion_value, error))
+			return false;
+		_criterion_met = _compareToEpsilon(_last_criterion_value, _criterion_met);
+
+		if (!_criterion_met)
+		{
+			_hold_ticks_count = 0;
+			return true;
 		}
+
+		if (_hold_ticks_count == 0)
+			_hold_start_time = t;
+		if (_hold_ticks_count < std::max(_hold_ticks, 1))
+			_hold_ticks_count++;
+
+		_qualified_active = (_hold_ticks_count >= _hold_ticks) && (t - _hold_start_time >= _hold_time - 1e-9);
+		return true;
 	}
 
-	double JumpCondition::_computeJumpCriterion(const ::Eigen::MatrixXd& x, const ::Eigen::MatrixXd& y) const
+	const ::Eigen::MatrixXd* JumpCondition::_filterSensorValue(const ::Eigen::MatrixXd& current, const double& t, ErrorRecord& error)
 	{
+		if (_filter_type == NO_FILTER)
+			return &current;
+
+		if (!_filter)
+		{
+			error.set(ErrorRecord::FAULT_JUMP_CONDITION, "JumpCondition.filterSensorValue", "The filter was set after initialization!");
+			return NULL;
+		}
+
+		// checked here as the filter would throw
+		if (current.rows() != _filtered_value.rows() || current.cols() != _filtered_value.cols())
+		{
+			error.set(ErrorRecord::FAULT_JUMP_CONDITION, "JumpCondition.filterSensorValue", "Dimension of sensor value changed to %dx%d after initialization of the filter!",
+				static_cast<int>(current.rows()), static_cast<int>(current.cols()));
+			return NULL;
+		}
+
+		// the first evaluated value restarts the filter - it was only sized with the initial value of the sensor
+		if (_filter_seeded)
+			_filter->step(current, t, _filtered_value);
+		else
+			_filter->initialize(current, t, _filtered_value);
+		_filter_seeded = true;
+		return &_filtered_value;
+	}
+
+	bool JumpCondition::_computeJumpCriterion(const ::Eigen::MatrixXd& x, const ::Eigen::MatrixXd& y, double& criterion, ErrorRecord& error) const
+	{
+		if (_dimensions_validated && _criterion_evaluator && _criterion_evaluator->evaluate(x, y, criterion))
+			return true;
+
 		//First check if weights are given - otherwise use default weights (=1.0)
 		::Eigen::MatrixXd weights;
 		if(_norm_weights.rows() == 0)
@@ -177,10 +430,11 @@ namespace ha {
 				break;
 			case NORM_ROTATION:
 				{
-					if(x.cols() != 3 || x.rows() != 3|| y.cols() != 3|| x.rows() != 3)
+					if(!_dimensions_validated && (x.cols() != 3 || x.rows() != 3|| y.cols() != 3|| x.rows() != 3))
 					{
-						HA_THROW_ERROR("JumpCondition._computeJumpCriterion", "Either the goal or the current value is not a rotation matrix." <<
-							"x dim = " << x.cols()  << "x" <<  x.rows()<<". y dim = " << y.cols()  << "x" <<  y.rows());
+						error.set(ErrorRecord::FAULT_JUMP_CONDITION, "JumpCondition._computeJumpCriterion", "Either the goal or the current value is not a rotation matrix. x dim = %dx%d. y dim = %dx%d",
+							static_cast<int>(x.cols()), static_cast<int>(x.rows()), static_cast<int>(y.cols()), static_cast<int>(y.rows()));
+						return false;
 					}
 
 					//Compute relative Rotation from x0 to xf
@@ -197,10 +451,11 @@ namespace ha {
 				break;
 			case NORM_TRANSFORM:
 				{
-					if(x.cols() != 4 || x.rows() != 4|| y.cols() != 4|| x.rows() != 4)
+					if(!_dimensions_validated && (x.cols() != 4 || x.rows() != 4|| y.cols() != 4|| x.rows() != 4))
 					{
-						HA_THROW_ERROR("JumpCondition._computeJumpCriterion", "Either the goal or the current value is not a homogeneous transformation matrix." <<
-							"x dim = " << x.cols()  << "x" <<  x.rows()<<". y dim = " << y.cols()  << "x" <<  y.rows());
+						error.set(ErrorRecord::FAULT_JUMP_CONDITION, "JumpCondition._computeJumpCriterion", "Either the goal or the current value is not a homogeneous transformation matrix. x dim = %dx%d. y dim = %dx%d",
+							static_cast<int>(x.cols()), static_cast<int>(x.rows()), static_cast<int>(y.cols()), static_cast<int>(y.rows()));
+						return false;
 					}
 
 					//Compute relative Rotation from x0 to xf
@@ -210,8 +465,6 @@ namespace ha {
 					Eigen::AngleAxisd xRotAA;
 					xRotAA = xRot;
 
-					static int rate_print = 0;
-
 					double angle_diff = xRotAA.angle();
 
 					
@@ -227,13 +480,6 @@ namespace ha {
 						weights << 0.1, 1.;
 					}
 					ret = weights(0,0) * angle_diff + weights(1,0) * disp_diff;
-
-					if(rate_print++%500 == 0)
-					{
-					  //HA_INFO("JumpCondition._computeJumpCriterion", "Angle between goal and current: " << angle_diff);
-					  //HA_INFO("JumpCondition._computeJumpCriterion", "Distance between goal and current: " << disp_diff);
-					  //HA_INFO("JumpCondition._computeJumpCriterion", "Weighted difference: " << ret << " (epsilon=" << _epsilon << ")");
-					}
 				}
 				break;
 
@@ -260,22 +506,40 @@ namespace ha {
 				}
 				break;
 			default:
-				HA_THROW_ERROR("JumpCondition._computeJumpCriterion", "Not Implemented: unknown jump criterion");
+				error.set(ErrorRecord::FAULT_JUMP_CONDITION, "JumpCondition._computeJumpCriterion", "Not Implemented: unknown jump criterion");
+				return false;
 		}
 
-		return ret;
+		criterion = ret;
+		return true;
 	}
 
 	void JumpCondition::setControllerGoal(const Controller::ConstPtr& controller)
 	{
 		_goalSource = CONTROLLER;
 		_controller = controller;
+		_dimensions_validated = false;
+	}
+
+	Controller::ConstPtr JumpCondition::getGoalController() const
+	{
+		if (_goalSource != CONTROLLER)
+			return Controller::ConstPtr();
+		return _controller;
+	}
+
+	void JumpCondition::rebind(const Sensor::Ptr& sensor, const Controller::ConstPtr& controller)
+	{
+		_sensor = sensor;
+		if (controller && _goalSource == CONTROLLER)
+			_controller = controller;
 	}
 
 	void JumpCondition::setConstantGoal(const ::Eigen::MatrixXd goal)
 	{
 		_goalSource = CONSTANT;
 		_goal = goal;
+		_dimensions_validated = false;
 	}
 
 	void JumpCondition::setConstantGoal(double goal)
@@ -283,6 +547,7 @@ namespace ha {
 		_goalSource = CONSTANT;
 		_goal.resize(1,1);
 		_goal<<goal;
+		_dimensions_validated = false;
 	}
 
 	void JumpCondition::setROSTopicGoal(const std::string& topic, const std::string& topic_type) {
@@ -338,6 +603,7 @@ namespace ha {
 	void JumpCondition::setSensor(const Sensor::Ptr sensor) 
 	{
 		_sensor = sensor;
+		_dimensions_validated = false;
 	}
 
 	Sensor::ConstPtr JumpCondition::getSensor() const 
@@ -351,6 +617,7 @@ namespace ha {
 //			HA_WARN("JumpCondition::setJumpCriterion", "No value given for weights. Using default weights of 1.");
 		_jump_criterion = jump_criterion;
 		_norm_weights = weights;
+		_dimensions_validated = false;
 	}
 	
 	JumpCondition::JumpCriterion JumpCondition::getJumpCriterion() const
@@ -373,11 +640,178 @@ namespace ha {
 		return _epsilon;
 	}
 
+	double JumpCondition::getLastCriterionValue() const
+	{
+		return _last_criterion_value;
+	}
+
+	bool JumpCondition::wasLastEvaluationActive() const
+	{
+		return _last_evaluation_active;
+	}
+
+	bool JumpCondition::wasEvaluated() const
+	{
+		return _evaluated;
+	}
+
+	void JumpCondition::clearEvaluated()
+	{
+		_evaluated = false;
+	}
+
+	void JumpCondition::setHoldTicks(int ticks)
+	{
+		if (ticks < 0) {
+			HA_THROW_ERROR("JumpCondition.setHoldTicks", "Number of ticks must not be negative!");
+		}
+		_hold_ticks = ticks;
+	}
+
+	int JumpCondition::getHoldTicks() const
+	{
+		return _hold_ticks;
+	}
+
+	void JumpCondition::setHoldTime(double time)
+	{
+		if (time < 0.0) {
+			HA_THROW_ERROR("JumpCondition.setHoldTime", "Hold time must not be negative!");
+		}
+		_hold_time = time;
+	}
+
+	double JumpCondition::getHoldTime() const
+	{
+		return _hold_time;
+	}
+
+	void JumpCondition::setHysteresis(double hysteresis)
+	{
+		if (hysteresis < 0.0) {
+			HA_THROW_ERROR("JumpCondition.setHysteresis", "Hysteresis must not be negative!");
+		}
+		_hysteresis = hysteresis;
+	}
+
+	double JumpCondition::getHysteresis() const
+	{
+		return _hysteresis;
+	}
+
+	void JumpCondition::setMovingAverageFilter(int window)
+	{
+		if (window < 1) {
+			HA_THROW_ERROR("JumpCondition.setMovingAverageFilter", "Filter window must be at least 1!");
+		}
+		_filter_type = FILTER_MOVING_AVERAGE;
+		_filter_window = window;
+	}
+
+	void JumpCondition::setExponentialFilter(double alpha)
+	{
+		if (alpha <= 0.0 || alpha > 1.0) {
+			HA_THROW_ERROR("JumpCondition.setExponentialFilter", "Filter factor alpha must be in (0, 1]!");
+		}
+		_filter_type = FILTER_EXPONENTIAL;
+		_filter_alpha = alpha;
+	}
+
+	void JumpCondition::removeFilter()
+	{
+		_filter_type = NO_FILTER;
+	}
+
+	JumpCondition::FilterType JumpCondition::getFilterType() const
+	{
+		return _filter_type;
+	}
+
 	void JumpCondition::setSourceModeName(const std::string& sourceModeName)
 	{
 		_sourceModeName = sourceModeName;
 	}
 
+	void JumpCondition::validate(ValidationReport& report, const std::string& origin)
+	{
+		_dimensions_validated = false;
+		_criterion_evaluator.reset();
+
+		if (!_sensor) {
+			report.addError(origin, "No sensor set!");
+			return;
+		}
+
+		int rows, cols;
+		try {
+			// dimensions that depend on the sensor data can only be checked at run time
+			if (!_sensor->getDimensions(rows, cols))
+				return;
+		}
+		catch (const std::string& error) {
+			report.addError(origin, error);
+			return;
+		}
+
+		std::size_t errors = report.getNumberOfErrors();
+
+		if (_jump_criterion == NORM_ROTATION && (rows != 3 || cols != 3)) {
+			std::ostringstream message;
+			message << "NORM_ROTATION needs a 3x3 rotation matrix, but sensor " << _sensor->getType() << " returns "
+				<< rows << "x" << cols << "!";
+			report.addError(origin, message.str());
+		}
+		if (_jump_criterion == NORM_TRANSFORM && (rows != 4 || cols != 4)) {
+			std::ostringstream message;
+			message << "NORM_TRANSFORM needs a 4x4 homogeneous transform, but sensor " << _sensor->getType() << " returns "
+				<< rows << "x" << cols << "!";
+			report.addError(origin, message.str());
+		}
+
+		if (_norm_weights.size() > 0) {
+			if (_jump_criterion == NORM_TRANSFORM) {
+				if (_norm_weights.rows() != 2 || _norm_weights.cols() != 1)
+					report.addWarning(origin, "NORM_TRANSFORM uses 2x1 weights (rotation, translation) - the given weights are ignored.");
+			}
+			else if (_jump_criterion != NORM_ROTATION && (_norm_weights.rows() != rows || _norm_weights.cols() != cols)) {
+				std::ostringstream message;
+				message << "Dimension mismatch in sensor and weights - sensor: " << rows << "x" << cols << ", weights: "
+					<< _norm_weights.rows() << "x" << _norm_weights.cols() << "!";
+				report.addError(origin, message.str());
+			}
+		}
+
+		// goals of controllers and ROS are only known at run time
+		if (_goalSource != CONSTANT)
+			return;
+
+		if (_goal.size() == 0) {
+			report.addWarning(origin, "No goal set - the JumpCondition will never be active.");
+			return;
+		}
+
+		if (_goal.rows() != rows || _goal.cols() != cols) {
+			std::ostringstream message;
+			message << "Dimension mismatch in sensor and goal - sensor: " << rows << "x" << cols << ", goal: "
+				<< _goal.rows() << "x" << _goal.cols() << "! Sensor Type: " << _sensor->getType();
+			report.addError(origin, message.str());
+		}
+
+		_dimensions_validated = (report.getNumberOfErrors() == errors);
+		if (_dimensions_validated)
+			_criterion_evaluator = JumpCriterionEvaluator::create(_jump_criterion, rows, cols, _norm_weights);
+	}
+
+	bool JumpCondition::areDimensionsValidated() const
+	{
+		return _dimensions_validated;
+	}
+
+	bool JumpCondition::hasSpecializedCriterion() const
+	{
+		return _dimensions_validated && _criterion_evaluator;
+	}
+
 	DescriptionTreeNode::Ptr JumpCondition::serialize(const DescriptionTree::ConstPtr& factory) const 
 	{ 
 		DescriptionTreeNode::Ptr tree = factory->createNode("JumpCondition");
@@ -421,6 +855,26 @@ namespace ha {
 
         tree->setAttribute<bool>(std::string("negate"), this->_negate);
 
+		if (_hold_ticks > 1)
+			tree->setAttribute<int>(std::string("hold_ticks"), _hold_ticks);
+		if (_hold_time > 0.0)
+			tree->setAttribute<double>(std::string("hold_time"), _hold_time);
+		if (_hysteresis > 0.0)
+			tree->setAttribute<double>(std::string("hysteresis"), _hysteresis);
+
+		switch(_filter_type) {
+			case FILTER_MOVING_AVERAGE:
+				tree->setAttribute<std::string>(std::string("filter"), "moving_average");
+				tree->setAttribute<int>(std::string("filter_window"), _filter_window);
+				break;
+			case FILTER_EXPONENTIAL:
+				tree->setAttribute<std::string>(std::string("filter"), "exponential");
+				tree->setAttribute<double>(std::string("filter_alpha"), _filter_alpha);
+				break;
+			default:
+				break;
+		}
+
 		tree->addChildNode(this->_sensor->serialize(factory));
 
 		return tree;
@@ -432,6 +886,8 @@ namespace ha {
 			HA_THROW_ERROR("JumpCondition.deserialize", "JumpCondition must have type 'JumpCondition', not '" << tree->getType() << "'!");
 		}
 
+		_dimensions_validated = false;
+
 		//////////////////////////////
 		////SENSORS///////////////////
 		//////////////////////////////
@@ -561,6 +1017,42 @@ namespace ha {
         if(!tree->getAttribute<bool>("negate", _negate))
             HA_WARN("JumpCondition.deserialize", "No \"negate\" parameter given in JumpCondition - using default values");
 
+		//////////////////////////////
+		////TEMPORAL QUALIFIERS///////
+		//////////////////////////////
+		int hold_ticks;
+		tree->getAttribute<int>("hold_ticks", hold_ticks, 0);
+		this->setHoldTicks(hold_ticks);
+
+		double hold_time;
+		tree->getAttribute<double>("hold_time", hold_time, 0.0);
+		this->setHoldTime(hold_time);
+
+		double hysteresis;
+		tree->getAttribute<double>("hysteresis", hysteresis, 0.0);
+		this->setHysteresis(hysteresis);
+
+		std::string filter;
+		if(tree->getAttribute<std::string>("filter", filter) && filter != "none")
+		{
+			if (filter == "moving_average")
+			{
+				int window;
+				if(!tree->getAttribute<int>("filter_window", window))
+					HA_THROW_ERROR("JumpCondition.deserialize", "If you use a moving_average filter filter_window must be set!");
+				this->setMovingAverageFilter(window);
+			}
+			else if (filter == "exponential")
+			{
+				double alpha;
+				if(!tree->getAttribute<double>("filter_alpha", alpha))
+					HA_THROW_ERROR("JumpCondition.deserialize", "If you use an exponential filter filter_alpha must be set!");
+				this->setExponentialFilter(alpha);
+			}
+			else
+				HA_THROW_ERROR("JumpCondition.deserialize", "Unknown filter: '" << filter << "'");
+		}
+
 	}
 
     std::string JumpCondition::toString(bool ) {
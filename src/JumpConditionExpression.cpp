@@ -0,0 +1,442 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "hybrid_automaton/JumpConditionExpression.h"
+
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+
+namespace ha {
+
+	struct JumpConditionExpression::Node
+	{
+		enum Kind {CONDITION, NOT, AND, OR, AT_LEAST};
+
+		Kind kind;
+		int value;		// index of the JumpCondition or k of AT_LEAST
+		std::vector<NodePtr> children;
+		std::string key;
+
+		Node(Kind kind, int value = 0) : kind(kind), value(value) {}
+	};
+
+	// recursive descent parser:
+	//   or      := and (("or" | "|") and)*
+	//   and     := unary (("and" | "&") unary)*
+	//   unary   := ("not" | "!") unary | primary
+	//   primary := index | "(" or ")" | "atleast" "(" k ("," or)+ ")"
+	class JumpConditionExpression::Parser
+	{
+	public:
+		explicit Parser(const std::string& text) : _text(text), _pos(0) {}
+
+		NodePtr parse()
+		{
+			NodePtr node = _parseOr();
+			_skipSpace();
+			if (_pos != _text.size())
+				_fail("unexpected '" + _text.substr(_pos, 1) + "'");
+			return node;
+		}
+
+	private:
+		const std::string& _text;
+		std::size_t _pos;
+
+		void _fail(const std::string& message) const
+		{
+			HA_THROW_ERROR("JumpConditionExpression.compile", message << " at position " << _pos << " in '" << _text << "'!");
+		}
+
+		void _skipSpace()
+		{
+			while (_pos < _text.size() && std::isspace(static_cast<unsigned char>(_text[_pos])))
+				_pos++;
+		}
+
+		// consumes the symbol or the keyword (which must not continue with a letter)
+		bool _accept(char symbol, const char* keyword)
+		{
+			_skipSpace();
+			if (_pos < _text.size() && _text[_pos] == symbol) {
+				_pos++;
+				return true;
+			}
+			if (!keyword)
+				return false;
+
+			std::size_t length = std::string(keyword).size();
+			if (_text.compare(_pos, length, keyword) != 0)
+				return false;
+			if (_pos + length < _text.size() && std::isalnum(static_cast<unsigned char>(_text[_pos + length])))
+				return false;
+			_pos += length;
+			return true;
+		}
+
+		void _expect(char symbol)
+		{
+			if (!_accept(symbol, NULL))
+				_fail(std::string("expected '") + symbol + "'");
+		}
+
+		int _parseNumber()
+		{
+			_skipSpace();
+			if (_pos >= _text.size() || !std::isdigit(static_cast<unsigned char>(_text[_pos])))
+				_fail("expected the index of a JumpCondition");
+
+			int number = 0;
+			while (_pos < _text.size() && std::isdigit(static_cast<unsigned char>(_text[_pos]))) {
+				number = 10 * number + (_text[_pos++] - '0');
+				if (number > 1000000)
+					_fail("number too large");
+			}
+			return number;
+		}
+
+		NodePtr _parseOr()
+		{
+			NodePtr node = _parseAnd();
+			if (!_accept('|', "or"))
+				return node;
+
+			NodePtr disjunction(new Node(Node::OR));
+			disjunction->children.push_back(node);
+			do {
+				disjunction->children.push_back(_parseAnd());
+			} while (_accept('|', "or"));
+			return disjunction;
+		}
+
+		NodePtr _parseAnd()
+		{
+			NodePtr node = _parseUnary();
+			if (!_accept('&', "and"))
+				return node;
+
+			NodePtr conjunction(new Node(Node::AND));
+			conjunction->children.push_back(node);
+			do {
+				conjunction->children.push_back(_parseUnary());
+			} while (_accept('&', "and"));
+			return conjunction;
+		}
+
+		NodePtr _parseUnary()
+		{
+			if (_accept('!', "not")) {
+				NodePtr negation(new Node(Node::NOT));
+				negation->children.push_back(_parseUnary());
+				return negation;
+			}
+			return _parsePrimary();
+		}
+
+		NodePtr _parsePrimary()
+		{
+			if (_accept('(', NULL)) {
+				NodePtr node = _parseOr();
+				_expect(')');
+				return node;
+			}
+
+			if (_accept('\0', "atleast")) {
+				_expect('(');
+				NodePtr at_least(new Node(Node::AT_LEAST, _parseNumber()));
+				_expect(',');
+				do {
+					at_least->children.push_back(_parseOr());
+				} while (_accept(',', NULL));
+				_expect(')');
+
+				if (at_least->value > static_cast<int>(at_least->children.size())) {
+					std::ostringstream message;
+					message << "atleast(" << at_least->value << ", ...) has only " << at_least->children.size() << " operands";
+					_fail(message.str());
+				}
+				return at_least;
+			}
+
+			return NodePtr(new Node(Node::CONDITION, _parseNumber()));
+		}
+	};
+
+	JumpConditionExpression::JumpConditionExpression()
+	{
+	}
+
+	void JumpConditionExpression::compile(const std::string& expression)
+	{
+		// compile into a new program - if the expression is invalid, this one stays unchanged
+		JumpConditionExpression compiled;
+
+		std::string trimmed = expression;
+		trimmed.erase(0, std::min(trimmed.size(), trimmed.find_first_not_of(" \t\r\n")));
+		if (trimmed.empty()) {
+			swap(compiled);
+			return;
+		}
+
+		NodePtr root = Parser(expression).parse();
+
+		std::map<std::string, int> occurrences, shared_slots;
+		_countSubexpressions(root, occurrences);
+		compiled._expression = expression;
+		compiled._emit(root, occurrences, shared_slots);
+
+		// every instruction pushes at most one value
+		compiled._stack.resize(compiled._program.size() + 1);
+		compiled._condition_results.resize(compiled._used_conditions.size());
+		compiled._shared_results.resize(shared_slots.size());
+
+		swap(compiled);
+	}
+
+	void JumpConditionExpression::swap(JumpConditionExpression& other)
+	{
+		_expression.swap(other._expression);
+		_program.swap(other._program);
+		_used_conditions.swap(other._used_conditions);
+		_stack.swap(other._stack);
+		_condition_results.swap(other._condition_results);
+		_shared_results.swap(other._shared_results);
+	}
+
+	const std::string& JumpConditionExpression::getExpression() const
+	{
+		return _expression;
+	}
+
+	bool JumpConditionExpression::empty() const
+	{
+		return _program.empty();
+	}
+
+	std::size_t JumpConditionExpression::getNumberOfConditions() const
+	{
+		return _used_conditions.size();
+	}
+
+	bool JumpConditionExpression::usesCondition(std::size_t index) const
+	{
+		return index < _used_conditions.size() && _used_conditions[index];
+	}
+
+	std::size_t JumpConditionExpression::getNumberOfInstructions() const
+	{
+		return _program.size();
+	}
+
+	void JumpConditionExpression::_countSubexpressions(const NodePtr& node, std::map<std::string, int>& occurrences)
+	{
+		std::ostringstream key;
+		switch (node->kind) {
+			case Node::CONDITION: key << node->value; break;
+			case Node::NOT: key << "!"; break;
+			case Node::AND: key << "&"; break;
+			case Node::OR: key << "|"; break;
+			case Node::AT_LEAST: key << "atleast" << node->value; break;
+		}
+
+		if (!node->children.empty()) {
+			key << "(";
+			for (std::size_t i = 0; i < node->children.size(); ++i) {
+				_countSubexpressions(node->children[i], occurrences);
+				key << (i ? "," : "") << node->children[i]->key;
+			}
+			key << ")";
+			occurrences[key.str()]++;
+		}
+		node->key = key.str();
+	}
+
+	void JumpConditionExpression::_emit(const NodePtr& node, const std::map<std::string, int>& occurrences, std::map<std::string, int>& shared_slots)
+	{
+		if (node->kind == Node::CONDITION) {
+			if (static_cast<std::size_t>(node->value) >= _used_conditions.size())
+				_used_conditions.resize(node->value + 1, false);
+			_used_conditions[node->value] = true;
+
+			Instruction instruction = {OP_CONDITION, node->value, 0, 0};
+			_program.push_back(instruction);
+			return;
+		}
+
+		std::map<std::string, int>::const_iterator count = occurrences.find(node->key);
+		if (count == occurrences.end() || count->second < 2) {
+			_emitOperator(node, occurrences, shared_slots);
+			return;
+		}
+
+		// the first evaluation stores the result, all others load it
+		std::map<std::string, int>::iterator slot = shared_slots.find(node->key);
+		if (slot == shared_slots.end())
+			slot = shared_slots.insert(std::make_pair(node->key, static_cast<int>(shared_slots.size()))).first;
+
+		std::size_t load = _program.size();
+		Instruction load_instruction = {OP_LOAD_SHARED, slot->second, 0, 0};
+		_program.push_back(load_instruction);
+		_emitOperator(node, occurrences, shared_slots);
+		Instruction store_instruction = {OP_STORE_SHARED, slot->second, 0, 0};
+		_program.push_back(store_instruction);
+		_program[load].target = static_cast<int>(_program.size());
+	}
+
+	void JumpConditionExpression::_emitOperator(const NodePtr& node, const std::map<std::string, int>& occurrences, std::map<std::string, int>& shared_slots)
+	{
+		std::size_t num_children = node->children.size();
+		std::vector<std::size_t> jumps;
+
+		switch (node->kind) {
+			case Node::NOT:
+			{
+				_emit(node->children[0], occurrences, shared_slots);
+				Instruction instruction = {OP_NOT, 0, 0, 0};
+				_program.push_back(instruction);
+				return;
+			}
+			case Node::AND:
+			case Node::OR:
+			{
+				Instruction instruction = {(node->kind == Node::AND) ? OP_AND : OP_OR, 0, 0, 0};
+				for (std::size_t i = 0; i < num_children; ++i) {
+					_emit(node->children[i], occurrences, shared_slots);
+					if (i + 1 < num_children) {
+						jumps.push_back(_program.size());
+						_program.push_back(instruction);
+					}
+				}
+				break;
+			}
+			case Node::AT_LEAST:
+			{
+				if (node->value <= 0) {
+					Instruction instruction = {OP_CONSTANT, 1, 0, 0};
+					_program.push_back(instruction);
+					return;
+				}
+
+				Instruction count = {OP_CONSTANT, 0, 0, 0};
+				_program.push_back(count);
+				for (std::size_t i = 0; i < num_children; ++i) {
+					_emit(node->children[i], occurrences, shared_slots);
+					Instruction instruction = {OP_AT_LEAST, node->value, static_cast<int>(num_children - i - 1), 0};
+					jumps.push_back(_program.size());
+					_program.push_back(instruction);
+				}
+				break;
+			}
+			default:
+				break;
+		}
+
+		for (std::size_t i = 0; i < jumps.size(); ++i)
+			_program[jumps[i]].target = static_cast<int>(_program.size());
+	}
+
+	bool JumpConditionExpression::evaluate(const std::vector<JumpConditionPtr>& conditions, bool& active, ErrorRecord& error) const
+	{
+		active = false;
+
+		if (conditions.size() < _condition_results.size()) {
+			error.set(ErrorRecord::FAULT_JUMP_CONDITION, "JumpConditionExpression.evaluate", "The expression refers to JumpCondition %d, but there are only %d!",
+				static_cast<int>(_condition_results.size()) - 1, static_cast<int>(conditions.size()));
+			return false;
+		}
+
+		std::fill(_condition_results.begin(), _condition_results.end(), -1);
+		std::fill(_shared_results.begin(), _shared_results.end(), -1);
+
+		int top = -1;
+		std::size_t pc = 0;
+		while (pc < _program.size()) {
+			const Instruction& instruction = _program[pc++];
+			switch (instruction.opcode) {
+				case OP_CONDITION:
+				{
+					signed char& result = _condition_results[instruction.argument];
+					if (result < 0) {
+						bool condition_active = false;
+						if (!conditions[instruction.argument]->tryIsActive(condition_active, error))
+							return false;
+						result = condition_active ? 1 : 0;
+					}
+					_stack[++top] = result;
+					break;
+				}
+				case OP_CONSTANT:
+					_stack[++top] = instruction.argument;
+					break;
+				case OP_NOT:
+					_stack[top] = !_stack[top];
+					break;
+				case OP_AND:
+					if (!_stack[top])
+						pc = instruction.target;
+					else
+						top--;
+					break;
+				case OP_OR:
+					if (_stack[top])
+						pc = instruction.target;
+					else
+						top--;
+					break;
+				case OP_AT_LEAST:
+				{
+					int count = _stack[top - 1] + _stack[top];
+					top--;
+					if (count >= instruction.argument) {
+						_stack[top] = 1;
+						pc = instruction.target;
+					}
+					else if (count + instruction.remaining < instruction.argument) {
+						_stack[top] = 0;
+						pc = instruction.target;
+					}
+					else {
+						_stack[top] = count;
+					}
+					break;
+				}
+				case OP_LOAD_SHARED:
+					if (_shared_results[instruction.argument] >= 0) {
+						_stack[++top] = _shared_results[instruction.argument];
+						pc = instruction.target;
+					}
+					break;
+				case OP_STORE_SHARED:
+					_shared_results[instruction.argument] = static_cast<signed char>(_stack[top]);
+					break;
+			}
+		}
+
+		active = (top >= 0 && _stack[top] != 0);
+		return true;
+	}
+
+}
@@ -0,0 +1,184 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "hybrid_automaton/JumpCriterionEvaluator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ha {
+
+	namespace {
+
+		// checks the size and maps the values to fixed-size matrices - Derived implements compute()
+		template <class Derived, int Rows, int Cols>
+		class FixedSizeEvaluator : public JumpCriterionEvaluator
+		{
+		public:
+			typedef ::Eigen::Matrix<double, Rows, Cols> Matrix;
+			typedef ::Eigen::Map<const Matrix> ConstMap;
+
+			virtual bool evaluate(const ::Eigen::MatrixXd& x, const ::Eigen::MatrixXd& y, double& criterion) const
+			{
+				if (x.rows() != Rows || x.cols() != Cols || y.rows() != Rows || y.cols() != Cols)
+					return false;
+
+				criterion = static_cast<const Derived*>(this)->compute(ConstMap(x.data()), ConstMap(y.data()));
+				return true;
+			}
+		};
+
+		// NORM_L1, NORM_L2, NORM_L_INF, THRESH_UPPER_BOUND and THRESH_LOWER_BOUND
+		template <JumpCondition::JumpCriterion Criterion, int Rows, int Cols>
+		class ElementwiseEvaluator : public FixedSizeEvaluator<ElementwiseEvaluator<Criterion, Rows, Cols>, Rows, Cols>
+		{
+		public:
+			EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+			typedef ::Eigen::Matrix<double, Rows, Cols> Matrix;
+			typedef ::Eigen::Map<const Matrix> ConstMap;
+
+			// no weights means weights of 1.0
+			explicit ElementwiseEvaluator(const ::Eigen::MatrixXd& weights)
+			{
+				if (weights.size() == 0)
+					_weights.setOnes();
+				else
+					_weights = weights;
+			}
+
+			double compute(const ConstMap& x, const ConstMap& y) const
+			{
+				// Criterion is a constant - the compiler removes the other cases
+				switch (Criterion) {
+					case JumpCondition::NORM_L1:
+						return (_weights.array() * (x - y).array().abs()).sum();
+					case JumpCondition::NORM_L2:
+						return std::sqrt((_weights.array() * (x - y).array().square()).sum());
+					case JumpCondition::NORM_L_INF:
+						return std::max(0.0, (_weights.array() * (x - y).array().abs()).maxCoeff());
+					case JumpCondition::THRESH_UPPER_BOUND:
+						return std::max(0.0, (_weights.array() * (y - x).array()).maxCoeff());
+					case JumpCondition::THRESH_LOWER_BOUND:
+						return std::max(0.0, (_weights.array() * (x - y).array()).maxCoeff());
+					default:
+						return 0.0;
+				}
+			}
+
+		private:
+			Matrix _weights;
+		};
+
+		class RotationEvaluator : public FixedSizeEvaluator<RotationEvaluator, 3, 3>
+		{
+		public:
+			double compute(const ConstMap& x, const ConstMap& y) const
+			{
+				::Eigen::AngleAxisd rotation;
+				rotation = ::Eigen::Matrix3d(x.inverse() * y);
+				return rotation.angle();
+			}
+		};
+
+		class TransformEvaluator : public FixedSizeEvaluator<TransformEvaluator, 4, 4>
+		{
+		public:
+			// rotation and translation weight - the defaults of JumpCondition if not given as 2x1
+			explicit TransformEvaluator(const ::Eigen::MatrixXd& weights):
+				_rotation_weight(0.1),
+				_translation_weight(1.0)
+			{
+				if (weights.rows() == 2 && weights.cols() == 1) {
+					_rotation_weight = weights(0, 0);
+					_translation_weight = weights(1, 0);
+				}
+			}
+
+			double compute(const ConstMap& x, const ConstMap& y) const
+			{
+				::Eigen::AngleAxisd rotation;
+				rotation = ::Eigen::Matrix3d(x.topLeftCorner<3, 3>().inverse() * y.topLeftCorner<3, 3>());
+				double translation = (x.topRightCorner<3, 1>() - y.topRightCorner<3, 1>()).norm();
+				return _rotation_weight * rotation.angle() + _translation_weight * translation;
+			}
+
+		private:
+			double _rotation_weight;
+			double _translation_weight;
+		};
+
+		template <int Rows, int Cols>
+		JumpCriterionEvaluator::ConstPtr createElementwise(JumpCondition::JumpCriterion criterion, const ::Eigen::MatrixXd& weights)
+		{
+			if (weights.size() != 0 && (weights.rows() != Rows || weights.cols() != Cols))
+				return JumpCriterionEvaluator::ConstPtr();
+
+			switch (criterion) {
+				case JumpCondition::NORM_L1:
+					return JumpCriterionEvaluator::ConstPtr(new ElementwiseEvaluator<JumpCondition::NORM_L1, Rows, Cols>(weights));
+				case JumpCondition::NORM_L2:
+					return JumpCriterionEvaluator::ConstPtr(new ElementwiseEvaluator<JumpCondition::NORM_L2, Rows, Cols>(weights));
+				case JumpCondition::NORM_L_INF:
+					return JumpCriterionEvaluator::ConstPtr(new ElementwiseEvaluator<JumpCondition::NORM_L_INF, Rows, Cols>(weights));
+				case JumpCondition::THRESH_UPPER_BOUND:
+					return JumpCriterionEvaluator::ConstPtr(new ElementwiseEvaluator<JumpCondition::THRESH_UPPER_BOUND, Rows, Cols>(weights));
+				case JumpCondition::THRESH_LOWER_BOUND:
+					return JumpCriterionEvaluator::ConstPtr(new ElementwiseEvaluator<JumpCondition::THRESH_LOWER_BOUND, Rows, Cols>(weights));
+				default:
+					return JumpCriterionEvaluator::ConstPtr();
+			}
+		}
+	}
+
+	JumpCriterionEvaluator::~JumpCriterionEvaluator()
+	{
+	}
+
+	JumpCriterionEvaluator::ConstPtr JumpCriterionEvaluator::create(JumpCondition::JumpCriterion criterion, int rows, int cols, const ::Eigen::MatrixXd& weights)
+	{
+		if (criterion == JumpCondition::NORM_ROTATION)
+			return (rows == 3 && cols == 3) ? ConstPtr(new RotationEvaluator) : ConstPtr();
+		if (criterion == JumpCondition::NORM_TRANSFORM)
+			return (rows == 4 && cols == 4) ? ConstPtr(new TransformEvaluator(weights)) : ConstPtr();
+
+		if (cols == 1) {
+			switch (rows) {
+				case 1: return createElementwise<1, 1>(criterion, weights);
+				case 3: return createElementwise<3, 1>(criterion, weights);
+				case 6: return createElementwise<6, 1>(criterion, weights);
+				case 7: return createElementwise<7, 1>(criterion, weights);
+			}
+		}
+		if (rows == 3 && cols == 3)
+			return createElementwise<3, 3>(criterion, weights);
+		if (rows == 4 && cols == 4)
+			return createElementwise<4, 4>(criterion, weights);
+
+		// unknown size - JumpCondition uses its generic implementation
+		return ConstPtr();
+	}
+
+}
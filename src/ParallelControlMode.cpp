@@ -0,0 +1,421 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "hybrid_automaton/ParallelControlMode.h"
+#include "hybrid_automaton/error_handling.h"
+#include "hybrid_automaton/Profiler.h"
+
+#include <algorithm>
+
+namespace ha {
+
+	ParallelControlMode::ParallelControlMode()
+		: _dimension(0), _threads(1), _command_dimension(0), _start_pending(false), _stopping(false), _tick_time(0.0), _tick_nothrow(false)
+	{
+	}
+
+	ParallelControlMode::ParallelControlMode(const std::string& name)
+		: ControlMode(name), _dimension(0), _threads(1), _command_dimension(0), _start_pending(false), _stopping(false), _tick_time(0.0), _tick_nothrow(false)
+	{
+	}
+
+	ParallelControlMode::ParallelControlMode(const ParallelControlMode& cm)
+		: ControlMode(cm), _regions(cm._regions), _dimension(cm._dimension), _threads(cm._threads), _command_dimension(0),
+		_start_pending(false), _stopping(false), _tick_time(0.0), _tick_nothrow(false)
+	{
+		// the clone must not share the state of the regions - the workers are started by initialize()
+		for (std::size_t i = 0; i < _regions.size(); ++i)
+			_regions[i].automaton = cm._regions[i].automaton->clone();
+	}
+
+	ParallelControlMode::~ParallelControlMode()
+	{
+		_stopWorkers();
+	}
+
+	void ParallelControlMode::addRegion(const HybridAutomaton::Ptr& automaton, const std::vector<int>& index)
+	{
+		if (!automaton || !automaton->getCurrentControlMode()) {
+			HA_THROW_ERROR("ParallelControlMode.addRegion", "The regions of control mode '" << _name << "' need a current control mode!");
+		}
+
+		Region region;
+		region.automaton = automaton;
+		region.index.setIndex(index);
+		region.initial_control_mode = automaton->getCurrentControlMode()->getName();
+		region.failed = false;
+		_regions.push_back(region);
+	}
+
+	std::size_t ParallelControlMode::getNumberOfRegions() const
+	{
+		return _regions.size();
+	}
+
+	HybridAutomaton::Ptr ParallelControlMode::getRegion(std::size_t region) const
+	{
+		return _regions.at(region).automaton;
+	}
+
+	const std::vector<int>& ParallelControlMode::getRegionIndex(std::size_t region) const
+	{
+		return _regions.at(region).index.getIndex();
+	}
+
+	void ParallelControlMode::setDimension(int dimension)
+	{
+		if (dimension < 0) {
+			HA_THROW_ERROR("ParallelControlMode.setDimension", "Dimension must not be negative!");
+		}
+		_dimension = dimension;
+	}
+
+	int ParallelControlMode::getDimension() const
+	{
+		return _dimension;
+	}
+
+	void ParallelControlMode::setNumberOfThreads(int threads)
+	{
+		if (threads < 1) {
+			HA_THROW_ERROR("ParallelControlMode.setNumberOfThreads", "Number of threads must be at least 1!");
+		}
+		if (threads != _threads)
+			_stopWorkers();
+		_threads = threads;
+	}
+
+	int ParallelControlMode::getNumberOfThreads() const
+	{
+		return _threads;
+	}
+
+	void ParallelControlMode::initialize()
+	{
+		if (_regions.empty()) {
+			HA_THROW_ERROR("ParallelControlMode.initialize", "Control mode '" << _name << "' has no regions.");
+		}
+
+		// without a dimension the command is as long as the largest index requires
+		_command_dimension = _dimension;
+		for (std::size_t i = 0; _dimension == 0 && i < _regions.size(); ++i)
+		{
+			const std::vector<int>& index = _regions[i].index.getIndex();
+			if (!index.empty())
+				_command_dimension = std::max(_command_dimension, *std::max_element(index.begin(), index.end()) + 1);
+		}
+
+		for (std::size_t i = 0; i < _regions.size(); ++i)
+		{
+			Region& region = _regions[i];
+			if (region.automaton->getCurrentControlMode()->getName() != region.initial_control_mode)
+				region.automaton->setCurrentControlMode(region.initial_control_mode);
+
+			// rejects negative and duplicate indices - scatterAdd does not check them
+			region.index.validate(_command_dimension);
+		}
+		_start_pending = true;
+
+		if (_threads > 1 && _regions.size() > 1 && _workers.empty())
+			_startWorkers();
+	}
+
+	void ParallelControlMode::terminate()
+	{
+		_start_pending = false;
+		for (std::size_t i = 0; i < _regions.size(); ++i)
+		{
+			if (_regions[i].automaton->isActive())
+				_regions[i].automaton->terminate();
+		}
+	}
+
+	::Eigen::MatrixXd ParallelControlMode::step(const double& t)
+	{
+		HA_PROFILE_SCOPE(_step_profile, "ControlMode.step", _name);
+		_stepRegions(t, false);
+
+		for (std::size_t i = 0; i < _regions.size(); ++i)
+		{
+			if (_regions[i].failed) {
+				HA_THROW_ERROR("ParallelControlMode.step", "Region " << i << " of control mode '" << _name << "' failed: " << _regions[i].exception);
+			}
+		}
+
+		::Eigen::MatrixXd control;
+		ErrorRecord error;
+		if (!_compose(control, error)) {
+			HA_THROW_ERROR(error.origin, error.message);
+		}
+		return control;
+	}
+
+	bool ParallelControlMode::tryStep(const double& t, ::Eigen::MatrixXd& control, ErrorRecord& error)
+	{
+		_stepRegions(t, true);
+
+		for (std::size_t i = 0; i < _regions.size(); ++i)
+		{
+			if (_regions[i].failed) {
+				error = _regions[i].automaton->getLastError();
+				return false;
+			}
+		}
+		return _compose(control, error);
+	}
+
+	void ParallelControlMode::_stepRegions(const double& t, bool nothrow)
+	{
+		// the regions need the time to start, so they are initialized in the first step after initialize()
+		if (_start_pending)
+		{
+			_start_pending = false;
+			for (std::size_t i = 0; i < _regions.size(); ++i)
+				_regions[i].automaton->initialize(t);
+		}
+
+		if (_workers.empty())
+		{
+			_stepRegions(0, 1, t, nothrow);
+			return;
+		}
+
+		// the barriers order the hand-over of the time and the outputs
+		_tick_time = t;
+		_tick_nothrow = nothrow;
+		_tick_started->wait();
+		_stepRegions(0, _workers.size() + 1, t, nothrow);
+		_tick_done->wait();
+	}
+
+	void ParallelControlMode::_stepRegions(std::size_t worker, std::size_t threads, const double& t, bool nothrow)
+	{
+		for (std::size_t i = worker; i < _regions.size(); i += threads)
+		{
+			Region& region = _regions[i];
+			region.failed = false;
+
+			if (nothrow)
+			{
+				region.failed = !region.automaton->tryStep(t, region.output).ok();
+				continue;
+			}
+
+			// errors must not escape a worker thread - they are thrown by step() in the control thread
+			try
+			{
+				region.output = region.automaton->step(t);
+			}
+			catch (const std::string& e)
+			{
+				region.failed = true;
+				region.exception = e;
+			}
+			catch (const std::exception& e)
+			{
+				region.failed = true;
+				region.exception = e.what();
+			}
+			catch (...)
+			{
+				region.failed = true;
+				region.exception = "Unknown exception";
+			}
+		}
+	}
+
+	bool ParallelControlMode::_compose(::Eigen::MatrixXd& control, ErrorRecord& error) const
+	{
+		int dimension = _command_dimension;
+		for (std::size_t i = 0; dimension == 0 && i < _regions.size(); ++i)
+			dimension = _regions[i].output.size();
+
+		if (control.rows() != dimension || control.cols() != 1)
+			control.resize(dimension, 1);
+		control.setZero();
+
+		for (std::size_t i = 0; i < _regions.size(); ++i)
+		{
+			const Region& region = _regions[i];
+
+			// a region whose current mode has no output (e.g. an idle gripper) does not contribute
+			if (region.output.size() == 0)
+				continue;
+
+			std::size_t size = region.index.size() > 0 ? region.index.size() : static_cast<std::size_t>(dimension);
+			if (static_cast<std::size_t>(region.output.size()) != size)
+			{
+				error.set(ErrorRecord::FAULT_CONTROL_MODE, "ParallelControlMode.step", "Output of region %u has %d values, expected %u.",
+					static_cast<unsigned int>(i), static_cast<int>(region.output.size()), static_cast<unsigned int>(size));
+				return false;
+			}
+
+			if (region.index.size() > 0)
+				region.index.scatterAdd(region.output, control);
+			else
+				control.col(0) += ::Eigen::Map<const ::Eigen::VectorXd>(region.output.data(), dimension);
+		}
+		return true;
+	}
+
+	void ParallelControlMode::_startWorkers()
+	{
+		std::size_t threads = std::min(static_cast<std::size_t>(_threads), _regions.size());
+		_stopping.store(false);
+		_tick_started.reset(new boost::barrier(threads));
+		_tick_done.reset(new boost::barrier(threads));
+		for (std::size_t worker = 1; worker < threads; ++worker)
+			_workers.push_back(boost::shared_ptr<boost::thread>(new boost::thread(&ParallelControlMode::_workerLoop, this, worker, threads)));
+	}
+
+	void ParallelControlMode::_stopWorkers()
+	{
+		if (_workers.empty())
+			return;
+
+		_stopping.store(true);
+		_tick_started->wait();
+		for (std::size_t i = 0; i < _workers.size(); ++i)
+			_workers[i]->join();
+		_workers.clear();
+		_tick_started.reset();
+		_tick_done.reset();
+	}
+
+	void ParallelControlMode::_workerLoop(std::size_t worker, std::size_t threads)
+	{
+		while (true)
+		{
+			_tick_started->wait();
+			if (_stopping.load())
+				return;
+			_stepRegions(worker, threads, _tick_time, _tick_nothrow);
+			_tick_done->wait();
+		}
+	}
+
+	void ParallelControlMode::switchControlMode(ControlMode::Ptr otherMode)
+	{
+		// the initial mode of every region takes over from the previous mode
+		for (std::size_t i = 0; i < _regions.size(); ++i)
+			_regions[i].automaton->getCurrentControlMode()->switchControlMode(otherMode);
+	}
+
+	ControlSet::Ptr ParallelControlMode::getControlSet() const
+	{
+		if (_regions.empty())
+			return ControlSet::Ptr();
+		return _regions[0].automaton->getCurrentControlMode()->getControlSet();
+	}
+
+	Controller::ConstPtr ParallelControlMode::getControllerByName(const std::string& name) const
+	{
+		for (std::size_t i = 0; i < _regions.size(); ++i)
+		{
+			ControlSet::Ptr control_set = _regions[i].automaton->getCurrentControlMode()->getControlSet();
+			Controller::ConstPtr controller = control_set ? control_set->getControllerByName(name) : Controller::ConstPtr();
+			if (controller)
+				return controller;
+		}
+		return Controller::ConstPtr();
+	}
+
+	DescriptionTreeNode::Ptr ParallelControlMode::serialize(const DescriptionTree::ConstPtr& factory) const
+	{
+		DescriptionTreeNode::Ptr tree_node = factory->createNode("ControlMode");
+		tree_node->setAttribute<std::string>(std::string("name"), this->getName());
+
+		if (_dimension > 0)
+			tree_node->setAttribute<int>(std::string("dimension"), _dimension);
+		if (_threads > 1)
+			tree_node->setAttribute<int>(std::string("threads"), _threads);
+
+		for (std::size_t i = 0; i < _regions.size(); ++i)
+		{
+			const Region& region = _regions[i];
+			DescriptionTreeNode::Ptr region_node = factory->createNode("Region");
+			if (region.index.size() > 0)
+				region_node->setAttribute< ::Eigen::MatrixXd>(std::string("index"), region.index.getIndexMatrix());
+
+			// serialize the region starting in its initial control mode
+			DescriptionTreeNode::Ptr automaton_node = region.automaton->serialize(factory);
+			automaton_node->setAttribute<std::string>(std::string("current_control_mode"), region.initial_control_mode);
+			region_node->addChildNode(automaton_node);
+
+			tree_node->addChildNode(region_node);
+		}
+
+		if (_watchdog)
+			tree_node->addChildNode(_watchdog->serialize(factory));
+		return tree_node;
+	}
+
+	void ParallelControlMode::deserialize(const DescriptionTreeNode::ConstPtr& tree, const System::ConstPtr& system, const HybridAutomaton* ha)
+	{
+		if (tree->getType() != "ControlMode") {
+			HA_THROW_ERROR("ParallelControlMode.deserialize", "DescriptionTreeNode must have type 'ControlMode', not '" << tree->getType() << "'!");
+		}
+
+		if(!tree->getAttribute<std::string>("name", _name))
+			HA_WARN("ParallelControlMode.deserialize", "No \"name\" parameter given in ControlMode - using default value");
+
+		int dimension, threads;
+		tree->getAttribute<int>("dimension", dimension, 0);
+		setDimension(dimension);
+		tree->getAttribute<int>("threads", threads, 1);
+		setNumberOfThreads(threads);
+
+		DescriptionTreeNode::ConstNodeList regions;
+		tree->getChildrenNodes("Region", regions);
+
+		_regions.clear();
+		for (DescriptionTreeNode::ConstNodeList::iterator it = regions.begin(); it != regions.end(); ++it)
+		{
+			DescriptionTreeNode::ConstNodeList automaton;
+			(*it)->getChildrenNodes("HybridAutomaton", automaton);
+			if (automaton.size() != 1) {
+				HA_THROW_ERROR("ParallelControlMode.deserialize", "Each region of control mode '" << _name << "' needs exactly one HybridAutomaton, found " << automaton.size() << "!");
+			}
+
+			::Eigen::MatrixXd index_mat;
+			IndexPlan index;
+			if ((*it)->getAttribute< ::Eigen::MatrixXd>("index", index_mat))
+				index.setIndex(index_mat);
+
+			HybridAutomaton::Ptr region(new HybridAutomaton);
+			if (ha)
+				region->setDeserializeDefaultEntities(ha->getDeserializeDefaultEntities());
+			region->deserialize(*automaton.begin(), system);
+			addRegion(region, index.getIndex());
+		}
+
+		if (_regions.empty()) {
+			HA_THROW_ERROR("ParallelControlMode.deserialize", "Control mode '" << _name << "' has no regions!");
+		}
+
+		_deserializeWatchdog(tree, system, ha);
+	}
+
+}
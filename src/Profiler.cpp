@@ -0,0 +1,190 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "hybrid_automaton/Profiler.h"
+
+#include <boost/chrono.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <iomanip>
+#include <limits>
+#include <map>
+
+namespace ha
+{
+
+	namespace
+	{
+		typedef std::map<std::pair<std::string, std::string>, boost::shared_ptr<Profiler::Entry> > EntryMap;
+
+		// the entries are never removed, so cached references stay valid
+		struct Registry
+		{
+			boost::mutex mutex;
+			EntryMap entries;
+		};
+
+		Registry& getRegistry()
+		{
+			static Registry registry;
+			return registry;
+		}
+	}
+
+	Profiler::Entry::Entry()
+	{
+		reset();
+	}
+
+	void Profiler::Entry::add(boost::uint64_t nanoseconds)
+	{
+		// several threads may measure the same entity
+		count.fetch_add(1, boost::memory_order_relaxed);
+		total.fetch_add(nanoseconds, boost::memory_order_relaxed);
+		boost::uint64_t current = min.load(boost::memory_order_relaxed);
+		while (nanoseconds < current && !min.compare_exchange_weak(current, nanoseconds, boost::memory_order_relaxed)) {}
+		current = max.load(boost::memory_order_relaxed);
+		while (nanoseconds > current && !max.compare_exchange_weak(current, nanoseconds, boost::memory_order_relaxed)) {}
+		histogram[getBin(nanoseconds)].fetch_add(1, boost::memory_order_relaxed);
+	}
+
+	void Profiler::Entry::reset()
+	{
+		count.store(0, boost::memory_order_relaxed);
+		total.store(0, boost::memory_order_relaxed);
+		min.store(std::numeric_limits<boost::uint64_t>::max(), boost::memory_order_relaxed);
+		max.store(0, boost::memory_order_relaxed);
+		for (int i = 0; i < NUMBER_OF_BINS; ++i)
+			histogram[i].store(0, boost::memory_order_relaxed);
+	}
+
+	boost::uint64_t Profiler::Statistics::getPercentile(double fraction) const
+	{
+		boost::uint64_t threshold = (boost::uint64_t)(fraction * count);
+		boost::uint64_t sum = 0;
+		for (std::size_t i = 0; i < histogram.size(); ++i)
+		{
+			sum += histogram[i];
+			if (sum > threshold || sum == count)
+				return std::min(max, (boost::uint64_t(1) << (i + 1)) - 1);
+		}
+		return max;
+	}
+
+	bool Profiler::isEnabled()
+	{
+#ifdef HA_ENABLE_PROFILING
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	Profiler::Entry& Profiler::getEntry(const char* category, const std::string& name)
+	{
+		Registry& registry = getRegistry();
+		boost::mutex::scoped_lock lock(registry.mutex);
+		boost::shared_ptr<Entry>& entry = registry.entries[std::make_pair(std::string(category), name)];
+		if (!entry)
+			entry.reset(new Entry);
+		return *entry;
+	}
+
+	boost::uint64_t Profiler::now()
+	{
+		return boost::chrono::duration_cast<boost::chrono::nanoseconds>(boost::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	std::vector<Profiler::Statistics> Profiler::getStatistics()
+	{
+		std::vector<Statistics> result;
+
+		Registry& registry = getRegistry();
+		boost::mutex::scoped_lock lock(registry.mutex);
+		for (EntryMap::const_iterator it = registry.entries.begin(); it != registry.entries.end(); ++it)
+		{
+			const Entry& entry = *it->second;
+			if (entry.count.load(boost::memory_order_relaxed) == 0)
+				continue;
+
+			Statistics statistics;
+			statistics.category = it->first.first;
+			statistics.name = it->first.second;
+			statistics.count = entry.count.load(boost::memory_order_relaxed);
+			statistics.total = entry.total.load(boost::memory_order_relaxed);
+			statistics.min = entry.min.load(boost::memory_order_relaxed);
+			statistics.max = entry.max.load(boost::memory_order_relaxed);
+			statistics.histogram.resize(NUMBER_OF_BINS);
+			for (int i = 0; i < NUMBER_OF_BINS; ++i)
+				statistics.histogram[i] = entry.histogram[i].load(boost::memory_order_relaxed);
+			result.push_back(statistics);
+		}
+		return result;
+	}
+
+	void Profiler::report(std::ostream& out)
+	{
+		std::vector<Statistics> statistics = getStatistics();
+
+		out << std::left << std::setw(24) << "category" << std::setw(24) << "name" << std::right
+			<< std::setw(10) << "count" << std::setw(12) << "total[ms]" << std::setw(11) << "mean[us]"
+			<< std::setw(11) << "min[us]" << std::setw(11) << "p50[us]" << std::setw(11) << "p99[us]"
+			<< std::setw(11) << "max[us]" << std::endl;
+
+		out << std::fixed << std::setprecision(3);
+		for (std::size_t i = 0; i < statistics.size(); ++i)
+		{
+			const Statistics& s = statistics[i];
+			out << std::left << std::setw(24) << s.category << std::setw(24) << s.name << std::right
+				<< std::setw(10) << s.count
+				<< std::setw(12) << s.total * 1e-6
+				<< std::setw(11) << (double)s.total / s.count * 1e-3
+				<< std::setw(11) << s.min * 1e-3
+				<< std::setw(11) << s.getPercentile(0.5) * 1e-3
+				<< std::setw(11) << s.getPercentile(0.99) * 1e-3
+				<< std::setw(11) << s.max * 1e-3 << std::endl;
+		}
+	}
+
+	void Profiler::reset()
+	{
+		Registry& registry = getRegistry();
+		boost::mutex::scoped_lock lock(registry.mutex);
+		for (EntryMap::iterator it = registry.entries.begin(); it != registry.entries.end(); ++it)
+			it->second->reset();
+	}
+
+	int Profiler::getBin(boost::uint64_t nanoseconds)
+	{
+		int bin = 0;
+		while (nanoseconds > 1 && bin < NUMBER_OF_BINS - 1)
+		{
+			nanoseconds >>= 1;
+			++bin;
+		}
+		return bin;
+	}
+
+}
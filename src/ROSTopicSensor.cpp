@@ -35,7 +35,7 @@ namespace ha
 	ROSTopicSensor::~ROSTopicSensor() {}
 
 	ROSTopicSensor::ROSTopicSensor(const ROSTopicSensor& ss)
-		:Sensor(ss)
+		:Sensor(ss), _ros_topic_name(ss._ros_topic_name), _ros_topic_type(ss._ros_topic_type), _is_subscribed(false)
 	{
 	}
 
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "hybrid_automaton/ReplayDriver.h"
+
+namespace ha {
+
+	ReplayDriver::Result ReplayDriver::run(const HybridAutomaton::Ptr& ha, const ReplaySystem::Ptr& system)
+	{
+		Result result;
+		if (system->getNumberOfSamples() == 0)
+			return result;
+
+		system->setSample(0);
+		result.start_time = system->getTime();
+		// the supervision thread would make the transition times depend on the scheduler
+		ha->setAsynchronousSupervision(false);
+		ha->initialize(result.start_time);
+
+		ControlMode::Ptr mode = ha->getCurrentControlMode();
+		result.initial_mode = mode->getName();
+
+		double last_time = result.start_time;
+		try {
+			do {
+				double t = system->getTime();
+				result.time_in_mode[mode->getName()] += t - last_time;
+				last_time = t;
+
+				// a self-loop keeps the control mode, so a transition is recognized by the switch that fired:
+				// either another switch than before or one more activation of the same one
+				ControlSwitch::Ptr last_switch = ha->getLastActiveControlSwitch();
+				unsigned long last_activations = last_switch ? last_switch->getNumberOfActivations() : 0;
+
+				ha->step(t);
+				++result.steps;
+
+				std::string source_mode = mode->getName();
+				ControlSwitch::Ptr control_switch = ha->getLastActiveControlSwitch();
+				if (control_switch && (control_switch != last_switch || control_switch->getNumberOfActivations() != last_activations)) {
+					Transition transition;
+					transition.time = t;
+					transition.control_switch = control_switch->getName();
+					transition.source_mode = source_mode;
+					transition.target_mode = ha->getTargetControlMode(transition.control_switch)->getName();
+					result.transitions.push_back(transition);
+					source_mode = transition.target_mode;
+				}
+
+				// a watchdog or the safe control mode changes the mode without a switch - also after a switch fired
+				mode = ha->getCurrentControlMode();
+				if (mode->getName() != source_mode) {
+					Transition transition;
+					transition.time = t;
+					transition.source_mode = source_mode;
+					transition.target_mode = mode->getName();
+					transition.fallback = true;
+					result.transitions.push_back(transition);
+				}
+			} while (system->next());
+		}
+		catch (...) {
+			// leave the automaton inactive, also when a control mode or switch failed during the replay
+			ha->terminate();
+			throw;
+		}
+
+		result.end_time = last_time;
+		result.terminal_mode = mode->getName();
+
+		ha->terminate();
+		return result;
+	}
+
+	void ReplayDriver::Result::report(std::ostream& out) const
+	{
+		out << "replayed " << steps << " steps from t=" << start_time << " to t=" << end_time << std::endl;
+		out << "initial mode: " << initial_mode << std::endl;
+		for (std::size_t i = 0; i < transitions.size(); ++i) {
+			out << "t=" << transitions[i].time << ": " << transitions[i].source_mode << " -> " << transitions[i].target_mode
+				<< " (" << (transitions[i].fallback ? "fallback" : transitions[i].control_switch) << ")" << std::endl;
+		}
+		out << "terminal mode: " << terminal_mode << std::endl;
+		for (std::map<std::string, double>::const_iterator it = time_in_mode.begin(); it != time_in_mode.end(); ++it)
+			out << "time in " << it->first << ": " << it->second << std::endl;
+	}
+
+}
@@ -0,0 +1,309 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "hybrid_automaton/ReplaySystem.h"
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <cstring>
+
+namespace ha {
+
+	static const char REPLAY_LOG_MAGIC[8] = { 'H', 'A', 'L', 'O', 'G', '0', '0', '1' };
+
+	static std::size_t getReplaySampleSize(int dof, std::size_t number_of_ports, std::size_t number_of_frames)
+	{
+		return 1 + 2 * dof + 6 * number_of_ports + 16 * number_of_frames;
+	}
+
+	ReplayLogWriter::ReplayLogWriter(const std::string& filename, int dof, const std::vector<int>& ft_ports, const std::vector<std::string>& frame_ids)
+		: _file(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc),
+		  _dof(dof),
+		  _ft_ports(ft_ports),
+		  _frame_ids(frame_ids)
+	{
+		if (!_file) {
+			HA_THROW_ERROR("ReplayLogWriter.ReplayLogWriter", "Cannot open '" << filename << "' for writing!");
+		}
+		if (dof < 0) {
+			HA_THROW_ERROR("ReplayLogWriter.ReplayLogWriter", "Invalid number of degrees of freedom: " << dof);
+		}
+
+		_file.write(REPLAY_LOG_MAGIC, sizeof(REPLAY_LOG_MAGIC));
+
+		boost::int32_t value = dof;
+		_file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+
+		value = static_cast<boost::int32_t>(_ft_ports.size());
+		_file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+		for (std::size_t i = 0; i < _ft_ports.size(); ++i) {
+			value = _ft_ports[i];
+			_file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+		}
+
+		value = static_cast<boost::int32_t>(_frame_ids.size());
+		_file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+		for (std::size_t i = 0; i < _frame_ids.size(); ++i) {
+			value = static_cast<boost::int32_t>(_frame_ids[i].size());
+			_file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+			_file.write(_frame_ids[i].data(), _frame_ids[i].size());
+		}
+
+		// align the samples to 8 bytes, so they can be read in place from the mapped file
+		std::streamoff header_size = _file.tellp();
+		static const char padding[8] = { 0 };
+		_file.write(padding, (8 - header_size % 8) % 8);
+	}
+
+	ReplayLogWriter::~ReplayLogWriter()
+	{
+		close();
+	}
+
+	void ReplayLogWriter::write(const System& system, double t)
+	{
+		_file.write(reinterpret_cast<const char*>(&t), sizeof(t));
+
+		_writeMatrix(system.getJointConfiguration(), _dof, 1, "joint configuration");
+		_writeMatrix(system.getJointVelocity(), _dof, 1, "joint velocity");
+
+		if (!_ft_ports.empty()) {
+			::Eigen::MatrixXd measurements;
+			system.getForceTorqueMeasurementsInto(_ft_ports, measurements);
+			_writeMatrix(measurements, 6, _ft_ports.size(), "force/torque measurements");
+		}
+
+		::Eigen::Matrix4d pose;
+		for (std::size_t i = 0; i < _frame_ids.size(); ++i) {
+			system.getFramePoseInto(_frame_ids[i], pose);
+			_file.write(reinterpret_cast<const char*>(pose.data()), 16 * sizeof(double));
+		}
+
+		if (!_file) {
+			HA_THROW_ERROR("ReplayLogWriter.write", "Writing the sample at t=" << t << " failed!");
+		}
+	}
+
+	void ReplayLogWriter::close()
+	{
+		if (_file.is_open())
+			_file.close();
+	}
+
+	void ReplayLogWriter::_writeMatrix(const ::Eigen::MatrixXd& matrix, int rows, int cols, const char* what)
+	{
+		if (matrix.rows() != rows || matrix.cols() != cols) {
+			HA_THROW_ERROR("ReplayLogWriter.write", "The " << what << " must be " << rows << "x" << cols << ", not "
+				<< matrix.rows() << "x" << matrix.cols() << "!");
+		}
+		_file.write(reinterpret_cast<const char*>(matrix.data()), matrix.size() * sizeof(double));
+	}
+
+	ReplaySystem::ReplaySystem(const std::string& filename)
+		: _dof(0),
+		  _data_offset(0),
+		  _sample_size(0),
+		  _number_of_samples(0),
+		  _sample(0)
+	{
+		try {
+			_file.reset(new boost::interprocess::file_mapping(filename.c_str(), boost::interprocess::read_only));
+			_region.reset(new boost::interprocess::mapped_region(*_file, boost::interprocess::read_only));
+		}
+		catch (const boost::interprocess::interprocess_exception& e) {
+			HA_THROW_ERROR("ReplaySystem.ReplaySystem", "Cannot map '" << filename << "': " << e.what());
+		}
+
+		const char* data = static_cast<const char*>(_region->get_address());
+		std::size_t size = _region->get_size();
+		std::size_t offset = 0;
+
+		if (size < sizeof(REPLAY_LOG_MAGIC) || std::memcmp(data, REPLAY_LOG_MAGIC, sizeof(REPLAY_LOG_MAGIC)) != 0) {
+			HA_THROW_ERROR("ReplaySystem.ReplaySystem", "'" << filename << "' is not a replay log!");
+		}
+		offset += sizeof(REPLAY_LOG_MAGIC);
+
+		boost::int32_t value;
+#define HA_REPLAY_READ_INT(target) \
+		if (offset + sizeof(value) > size) { \
+			HA_THROW_ERROR("ReplaySystem.ReplaySystem", "Truncated header in '" << filename << "'!"); \
+		} \
+		std::memcpy(&value, data + offset, sizeof(value)); \
+		offset += sizeof(value); \
+		if (value < 0 || static_cast<std::size_t>(value) > size) { \
+			HA_THROW_ERROR("ReplaySystem.ReplaySystem", "Corrupt header in '" << filename << "'!"); \
+		} \
+		target = value;
+
+		HA_REPLAY_READ_INT(_dof);
+
+		std::size_t number_of_ports;
+		HA_REPLAY_READ_INT(number_of_ports);
+		_ft_ports.resize(number_of_ports);
+		for (std::size_t i = 0; i < number_of_ports; ++i) {
+			HA_REPLAY_READ_INT(_ft_ports[i]);
+		}
+
+		std::size_t number_of_frames;
+		HA_REPLAY_READ_INT(number_of_frames);
+		_frame_ids.resize(number_of_frames);
+		for (std::size_t i = 0; i < number_of_frames; ++i) {
+			std::size_t length;
+			HA_REPLAY_READ_INT(length);
+			if (offset + length > size) {
+				HA_THROW_ERROR("ReplaySystem.ReplaySystem", "Truncated header in '" << filename << "'!");
+			}
+			_frame_ids[i].assign(data + offset, length);
+			offset += length;
+		}
+#undef HA_REPLAY_READ_INT
+
+		_data_offset = offset + (8 - offset % 8) % 8;
+		_sample_size = getReplaySampleSize(_dof, number_of_ports, number_of_frames);
+
+		// a sample that was only partially written (e.g. the recording was killed) is ignored
+		if (size > _data_offset)
+			_number_of_samples = (size - _data_offset) / (_sample_size * sizeof(double));
+
+		int value_offset = 1 + 2 * _dof;
+		for (std::size_t i = 0; i < number_of_ports; ++i, value_offset += 6)
+			_port_offsets[_ft_ports[i]] = value_offset;
+		for (std::size_t i = 0; i < number_of_frames; ++i, value_offset += 16)
+			_frame_offsets[_frame_ids[i]] = value_offset;
+	}
+
+	ReplaySystem::~ReplaySystem()
+	{
+	}
+
+	std::size_t ReplaySystem::getNumberOfSamples() const
+	{
+		return _number_of_samples;
+	}
+
+	void ReplaySystem::setSample(std::size_t sample)
+	{
+		if (sample >= _number_of_samples) {
+			HA_THROW_ERROR("ReplaySystem.setSample", "Sample " << sample << " is out of range, the log has "
+				<< _number_of_samples << " samples!");
+		}
+		_sample = sample;
+	}
+
+	std::size_t ReplaySystem::getSample() const
+	{
+		return _sample;
+	}
+
+	bool ReplaySystem::next()
+	{
+		if (_sample + 1 >= _number_of_samples)
+			return false;
+		++_sample;
+		return true;
+	}
+
+	double ReplaySystem::getTime() const
+	{
+		return _getSampleData()[0];
+	}
+
+	const std::vector<int>& ReplaySystem::getForceTorquePorts() const
+	{
+		return _ft_ports;
+	}
+
+	const std::vector<std::string>& ReplaySystem::getFrameIds() const
+	{
+		return _frame_ids;
+	}
+
+	int ReplaySystem::getDof() const
+	{
+		return _dof;
+	}
+
+	::Eigen::MatrixXd ReplaySystem::getJointConfiguration() const
+	{
+		return ::Eigen::Map<const ::Eigen::VectorXd>(_getSampleData() + 1, _dof);
+	}
+
+	::Eigen::MatrixXd ReplaySystem::getJointVelocity() const
+	{
+		return ::Eigen::Map<const ::Eigen::VectorXd>(_getSampleData() + 1 + _dof, _dof);
+	}
+
+	::Eigen::MatrixXd ReplaySystem::getForceTorqueMeasurement(const int& port) const
+	{
+		return ::Eigen::Map<const ::Eigen::VectorXd>(_getSampleData() + _getPortOffset(port), 6);
+	}
+
+	void ReplaySystem::getForceTorqueMeasurementsInto(const std::vector<int>& ports, ::Eigen::MatrixXd& measurements) const
+	{
+		measurements.resize(6, ports.size());
+		const double* data = _getSampleData();
+		for (std::size_t i = 0; i < ports.size(); ++i)
+			measurements.col(i) = ::Eigen::Map<const ::Eigen::VectorXd>(data + _getPortOffset(ports[i]), 6);
+	}
+
+	::Eigen::MatrixXd ReplaySystem::getFramePose(const std::string& frame_id) const
+	{
+		return ::Eigen::Map<const ::Eigen::Matrix4d>(_getSampleData() + _getFrameOffset(frame_id));
+	}
+
+	void ReplaySystem::getFramePoseInto(const std::string& frame_id, ::Eigen::Matrix4d& pose) const
+	{
+		pose = ::Eigen::Map<const ::Eigen::Matrix4d>(_getSampleData() + _getFrameOffset(frame_id));
+	}
+
+	const double* ReplaySystem::_getSampleData() const
+	{
+		if (_number_of_samples == 0) {
+			HA_THROW_ERROR("ReplaySystem.getSample", "The log contains no samples!");
+		}
+		const char* data = static_cast<const char*>(_region->get_address()) + _data_offset;
+		return reinterpret_cast<const double*>(data) + _sample * _sample_size;
+	}
+
+	int ReplaySystem::_getPortOffset(int port) const
+	{
+		std::map<int, int>::const_iterator it = _port_offsets.find(port);
+		if (it == _port_offsets.end()) {
+			HA_THROW_ERROR("ReplaySystem.getForceTorqueMeasurement", "Port " << port << " was not recorded!");
+		}
+		return it->second;
+	}
+
+	int ReplaySystem::_getFrameOffset(const std::string& frame_id) const
+	{
+		std::map<std::string, int>::const_iterator it = _frame_offsets.find(frame_id);
+		if (it == _frame_offsets.end()) {
+			HA_THROW_ERROR("ReplaySystem.getFramePose", "Frame '" << frame_id << "' was not recorded!");
+		}
+		return it->second;
+	}
+
+}
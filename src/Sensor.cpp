@@ -39,6 +39,8 @@ namespace ha{
 	* Copy constructor
 	*/
 	Sensor::Sensor(const Sensor& ss):
+		_system(ss._system),
+		_type(ss._type),
 		_initial_sensor_value(ss._initial_sensor_value)
 	{
 	}
@@ -81,4 +83,9 @@ namespace ha{
 		return (this->getCurrentValue() - this->_initial_sensor_value);
 	}
 
+	bool Sensor::getDimensions(int& rows, int& cols) const
+	{
+		return false;
+	}
+
 }
\ No newline at end of file
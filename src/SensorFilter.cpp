@@ -0,0 +1,459 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "hybrid_automaton/SensorFilter.h"
+
+#include <algorithm>
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace ha {
+
+	SensorFilter::SensorFilter()
+		: _rows(0), _cols(0), _last_time(0.0)
+	{
+	}
+
+	SensorFilter::~SensorFilter()
+	{
+	}
+
+	bool SensorFilter::getOutputDimensions(int& rows, int& cols) const
+	{
+		return true;
+	}
+
+	SensorFilter::Ptr SensorFilter::create(const DescriptionTreeNode::ConstPtr& node, const System::ConstPtr& system, const HybridAutomaton* ha)
+	{
+		if (node->getType() != "Filter") {
+			HA_THROW_ERROR("SensorFilter.create", "DescriptionTreeNode must have type 'Filter', not '" << node->getType() << "'!");
+		}
+
+		std::string type;
+		if (!node->getAttribute<std::string>("type", type)) {
+			HA_THROW_ERROR("SensorFilter.create", "Cannot get filter type from node");
+		}
+
+		SensorFilter::Ptr filter;
+		if (type == "lowpass")
+			filter.reset(new LowPassFilter);
+		else if (type == "median")
+			filter.reset(new MedianFilter);
+		else if (type == "moving_average")
+			filter.reset(new MovingAverageFilter);
+		else if (type == "exponential")
+			filter.reset(new ExponentialFilter);
+		else if (type == "derivative")
+			filter.reset(new DerivativeFilter);
+		else if (type == "integrator")
+			filter.reset(new IntegratorFilter);
+		else if (type == "transform")
+			filter.reset(new TransformFilter);
+		else
+			HA_THROW_ERROR("SensorFilter.create", "Unknown filter type: '" << type << "'");
+
+		filter->deserialize(node, system, ha);
+		return filter;
+	}
+
+	void SensorFilter::_checkDimensions(const ::Eigen::MatrixXd& input) const
+	{
+		if (input.rows() != _rows || input.cols() != _cols) {
+			HA_THROW_ERROR("SensorFilter.step", "Dimension of " << this->getType() << " filter input changed from "
+				<< _rows << "x" << _cols << " to " << input.rows() << "x" << input.cols() << "!");
+		}
+	}
+
+	//////////////////////////////
+	////LOWPASS///////////////////
+	//////////////////////////////
+	LowPassFilter::LowPassFilter(double cutoff)
+		: _cutoff(cutoff)
+	{
+	}
+
+	void LowPassFilter::initialize(const ::Eigen::MatrixXd& input, const double& t, ::Eigen::MatrixXd& output)
+	{
+		_rows = input.rows();
+		_cols = input.cols();
+		_last_time = t;
+		output = input;
+	}
+
+	void LowPassFilter::step(const ::Eigen::MatrixXd& input, const double& t, ::Eigen::MatrixXd& output)
+	{
+		_checkDimensions(input);
+
+		double dt = t - _last_time;
+		_last_time = t;
+		if (dt <= 0.0)
+			return;
+
+		double alpha = dt / (dt + 1.0 / (2.0 * M_PI * _cutoff));
+		output.array() += alpha * (input.array() - output.array());
+	}
+
+	DescriptionTreeNode::Ptr LowPassFilter::serialize(const DescriptionTree::ConstPtr& factory) const
+	{
+		DescriptionTreeNode::Ptr tree = factory->createNode("Filter");
+		tree->setAttribute<std::string>(std::string("type"), this->getType());
+		tree->setAttribute<double>(std::string("cutoff"), _cutoff);
+		return tree;
+	}
+
+	void LowPassFilter::deserialize(const DescriptionTreeNode::ConstPtr& tree, const System::ConstPtr& system, const HybridAutomaton* ha)
+	{
+		if (!tree->getAttribute<double>("cutoff", _cutoff)) {
+			HA_THROW_ERROR("LowPassFilter.deserialize", "A lowpass filter needs a cutoff frequency!");
+		}
+		if (_cutoff <= 0.0) {
+			HA_THROW_ERROR("LowPassFilter.deserialize", "Cutoff frequency must be positive, not " << _cutoff << "!");
+		}
+	}
+
+	//////////////////////////////
+	////MEDIAN////////////////////
+	//////////////////////////////
+	MedianFilter::MedianFilter(int window)
+		: _window(window), _head(0), _count(0)
+	{
+	}
+
+	void MedianFilter::initialize(const ::Eigen::MatrixXd& input, const double& t, ::Eigen::MatrixXd& output)
+	{
+		_rows = input.rows();
+		_cols = input.cols();
+		_last_time = t;
+
+		_buffer.resize(_rows * _cols, _window);
+		_buffer.col(0) = ::Eigen::Map<const ::Eigen::VectorXd>(input.data(), _rows * _cols);
+		_head = 1 % _window;
+		_count = 1;
+		_scratch.resize(_window);
+		output = input;
+	}
+
+	void MedianFilter::step(const ::Eigen::MatrixXd& input, const double& t, ::Eigen::MatrixXd& output)
+	{
+		_checkDimensions(input);
+		_last_time = t;
+
+		int size = _rows * _cols;
+		_buffer.col(_head) = ::Eigen::Map<const ::Eigen::VectorXd>(input.data(), size);
+		_head = (_head + 1) % _window;
+		if (_count < _window)
+			_count++;
+
+		double* out = output.data();
+		for (int i = 0; i < size; i++)
+		{
+			for (int j = 0; j < _count; j++)
+				_scratch[j] = _buffer(i, j);
+			std::vector<double>::iterator median = _scratch.begin() + _count / 2;
+			std::nth_element(_scratch.begin(), median, _scratch.begin() + _count);
+			out[i] = *median;
+		}
+	}
+
+	DescriptionTreeNode::Ptr MedianFilter::serialize(const DescriptionTree::ConstPtr& factory) const
+	{
+		DescriptionTreeNode::Ptr tree = factory->createNode("Filter");
+		tree->setAttribute<std::string>(std::string("type"), this->getType());
+		tree->setAttribute<int>(std::string("window"), _window);
+		return tree;
+	}
+
+	void MedianFilter::deserialize(const DescriptionTreeNode::ConstPtr& tree, const System::ConstPtr& system, const HybridAutomaton* ha)
+	{
+		if (!tree->getAttribute<int>("window", _window)) {
+			HA_THROW_ERROR("MedianFilter.deserialize", "A median filter needs a window size!");
+		}
+		if (_window < 1) {
+			HA_THROW_ERROR("MedianFilter.deserialize", "Window size must be at least 1, not " << _window << "!");
+		}
+	}
+
+	//////////////////////////////
+	////MOVING AVERAGE////////////
+	//////////////////////////////
+	MovingAverageFilter::MovingAverageFilter(int window)
+		: _window(window), _head(0), _count(0)
+	{
+	}
+
+	void MovingAverageFilter::initialize(const ::Eigen::MatrixXd& input, const double& t, ::Eigen::MatrixXd& output)
+	{
+		_rows = input.rows();
+		_cols = input.cols();
+		_last_time = t;
+
+		int size = _rows * _cols;
+		_buffer.setZero(size, _window);
+		_buffer.col(0) = ::Eigen::Map<const ::Eigen::VectorXd>(input.data(), size);
+		_sum = _buffer.col(0);
+		_head = 1 % _window;
+		_count = 1;
+		output = input;
+	}
+
+	void MovingAverageFilter::step(const ::Eigen::MatrixXd& input, const double& t, ::Eigen::MatrixXd& output)
+	{
+		_checkDimensions(input);
+		_last_time = t;
+
+		int size = _rows * _cols;
+		::Eigen::Map<const ::Eigen::VectorXd> sample(input.data(), size);
+		if (_count == _window)
+			_sum -= _buffer.col(_head);
+		else
+			_count++;
+
+		_buffer.col(_head) = sample;
+		_sum += sample;
+		_head = (_head + 1) % _window;
+
+		// recompute the sum once per window so rounding errors cannot accumulate
+		if (_head == 0)
+			_sum = _buffer.rowwise().sum();
+
+		::Eigen::Map< ::Eigen::VectorXd>(output.data(), size) = _sum / static_cast<double>(_count);
+	}
+
+	DescriptionTreeNode::Ptr MovingAverageFilter::serialize(const DescriptionTree::ConstPtr& factory) const
+	{
+		DescriptionTreeNode::Ptr tree = factory->createNode("Filter");
+		tree->setAttribute<std::string>(std::string("type"), this->getType());
+		tree->setAttribute<int>(std::string("window"), _window);
+		return tree;
+	}
+
+	void MovingAverageFilter::deserialize(const DescriptionTreeNode::ConstPtr& tree, const System::ConstPtr& system, const HybridAutomaton* ha)
+	{
+		if (!tree->getAttribute<int>("window", _window)) {
+			HA_THROW_ERROR("MovingAverageFilter.deserialize", "A moving_average filter needs a window size!");
+		}
+		if (_window < 1) {
+			HA_THROW_ERROR("MovingAverageFilter.deserialize", "Window size must be at least 1, not " << _window << "!");
+		}
+	}
+
+	//////////////////////////////
+	////EXPONENTIAL///////////////
+	//////////////////////////////
+	ExponentialFilter::ExponentialFilter(double alpha)
+		: _alpha(alpha)
+	{
+	}
+
+	void ExponentialFilter::initialize(const ::Eigen::MatrixXd& input, const double& t, ::Eigen::MatrixXd& output)
+	{
+		_rows = input.rows();
+		_cols = input.cols();
+		_last_time = t;
+		output = input;
+	}
+
+	void ExponentialFilter::step(const ::Eigen::MatrixXd& input, const double& t, ::Eigen::MatrixXd& output)
+	{
+		_checkDimensions(input);
+		_last_time = t;
+
+		output.array() += _alpha * (input.array() - output.array());
+	}
+
+	DescriptionTreeNode::Ptr ExponentialFilter::serialize(const DescriptionTree::ConstPtr& factory) const
+	{
+		DescriptionTreeNode::Ptr tree = factory->createNode("Filter");
+		tree->setAttribute<std::string>(std::string("type"), this->getType());
+		tree->setAttribute<double>(std::string("alpha"), _alpha);
+		return tree;
+	}
+
+	void ExponentialFilter::deserialize(const DescriptionTreeNode::ConstPtr& tree, const System::ConstPtr& system, const HybridAutomaton* ha)
+	{
+		if (!tree->getAttribute<double>("alpha", _alpha)) {
+			HA_THROW_ERROR("ExponentialFilter.deserialize", "An exponential filter needs a factor alpha!");
+		}
+		if (_alpha <= 0.0 || _alpha > 1.0) {
+			HA_THROW_ERROR("ExponentialFilter.deserialize", "Factor alpha must be in (0, 1], not " << _alpha << "!");
+		}
+	}
+
+	//////////////////////////////
+	////DERIVATIVE////////////////
+	//////////////////////////////
+	void DerivativeFilter::initialize(const ::Eigen::MatrixXd& input, const double& t, ::Eigen::MatrixXd& output)
+	{
+		_rows = input.rows();
+		_cols = input.cols();
+		_last_time = t;
+		_previous = input;
+		output.setZero(_rows, _cols);
+	}
+
+	void DerivativeFilter::step(const ::Eigen::MatrixXd& input, const double& t, ::Eigen::MatrixXd& output)
+	{
+		_checkDimensions(input);
+
+		double dt = t - _last_time;
+		if (dt <= 0.0)
+			return;
+
+		output.array() = (input.array() - _previous.array()) / dt;
+		_previous = input;
+		_last_time = t;
+	}
+
+	DescriptionTreeNode::Ptr DerivativeFilter::serialize(const DescriptionTree::ConstPtr& factory) const
+	{
+		DescriptionTreeNode::Ptr tree = factory->createNode("Filter");
+		tree->setAttribute<std::string>(std::string("type"), this->getType());
+		return tree;
+	}
+
+	void DerivativeFilter::deserialize(const DescriptionTreeNode::ConstPtr& tree, const System::ConstPtr& system, const HybridAutomaton* ha)
+	{
+	}
+
+	//////////////////////////////
+	////INTEGRATOR////////////////
+	//////////////////////////////
+	void IntegratorFilter::initialize(const ::Eigen::MatrixXd& input, const double& t, ::Eigen::MatrixXd& output)
+	{
+		_rows = input.rows();
+		_cols = input.cols();
+		_last_time = t;
+		_previous = input;
+		output.setZero(_rows, _cols);
+	}
+
+	void IntegratorFilter::step(const ::Eigen::MatrixXd& input, const double& t, ::Eigen::MatrixXd& output)
+	{
+		_checkDimensions(input);
+
+		double dt = t - _last_time;
+		if (dt <= 0.0)
+			return;
+
+		output.array() += 0.5 * dt * (input.array() + _previous.array());
+		_previous = input;
+		_last_time = t;
+	}
+
+	DescriptionTreeNode::Ptr IntegratorFilter::serialize(const DescriptionTree::ConstPtr& factory) const
+	{
+		DescriptionTreeNode::Ptr tree = factory->createNode("Filter");
+		tree->setAttribute<std::string>(std::string("type"), this->getType());
+		return tree;
+	}
+
+	void IntegratorFilter::deserialize(const DescriptionTreeNode::ConstPtr& tree, const System::ConstPtr& system, const HybridAutomaton* ha)
+	{
+	}
+
+	//////////////////////////////
+	////TRANSFORM/////////////////
+	//////////////////////////////
+	TransformFilter::TransformFilter()
+		: _multiply_from_right(false)
+	{
+	}
+
+	TransformFilter::TransformFilter(const ::Eigen::MatrixXd& matrix, bool multiply_from_right)
+		: _matrix(matrix), _multiply_from_right(multiply_from_right)
+	{
+	}
+
+	void TransformFilter::initialize(const ::Eigen::MatrixXd& input, const double& t, ::Eigen::MatrixXd& output)
+	{
+		_rows = input.rows();
+		_cols = input.cols();
+		_last_time = t;
+
+		if ((!_multiply_from_right && _matrix.cols() != _rows) || (_multiply_from_right && _matrix.rows() != _cols)) {
+			HA_THROW_ERROR("TransformFilter.initialize", "Cannot multiply " << _matrix.rows() << "x" << _matrix.cols()
+				<< " matrix with " << _rows << "x" << _cols << " sensor value!");
+		}
+
+		if (_multiply_from_right)
+			output = input * _matrix;
+		else
+			output = _matrix * input;
+	}
+
+	void TransformFilter::step(const ::Eigen::MatrixXd& input, const double& t, ::Eigen::MatrixXd& output)
+	{
+		_checkDimensions(input);
+		_last_time = t;
+
+		if (_multiply_from_right)
+			output.noalias() = input * _matrix;
+		else
+			output.noalias() = _matrix * input;
+	}
+
+	bool TransformFilter::getOutputDimensions(int& rows, int& cols) const
+	{
+		if (_multiply_from_right) {
+			if (_matrix.rows() != cols)
+				return false;
+			cols = _matrix.cols();
+		}
+		else {
+			if (_matrix.cols() != rows)
+				return false;
+			rows = _matrix.rows();
+		}
+		return true;
+	}
+
+	DescriptionTreeNode::Ptr TransformFilter::serialize(const DescriptionTree::ConstPtr& factory) const
+	{
+		DescriptionTreeNode::Ptr tree = factory->createNode("Filter");
+		tree->setAttribute<std::string>(std::string("type"), this->getType());
+		tree->setAttribute< ::Eigen::MatrixXd>(std::string("matrix"), _matrix);
+		if (_multiply_from_right)
+			tree->setAttribute<std::string>(std::string("side"), "right");
+		return tree;
+	}
+
+	void TransformFilter::deserialize(const DescriptionTreeNode::ConstPtr& tree, const System::ConstPtr& system, const HybridAutomaton* ha)
+	{
+		if (!tree->getAttribute< ::Eigen::MatrixXd>("matrix", _matrix)) {
+			HA_THROW_ERROR("TransformFilter.deserialize", "A transform filter needs a matrix!");
+		}
+
+		std::string side;
+		tree->getAttribute<std::string>("side", side, "left");
+		if (side != "left" && side != "right") {
+			HA_THROW_ERROR("TransformFilter.deserialize", "Side must be 'left' or 'right', not '" << side << "'!");
+		}
+		_multiply_from_right = (side == "right");
+	}
+
+}
@@ -39,31 +39,40 @@ namespace ha
 	}
 
     SubjointConfigurationSensor::SubjointConfigurationSensor(const SubjointConfigurationSensor& ss)
-        :Sensor(ss), _index(ss._index)
+        :Sensor(ss), _index_plan(ss._index_plan)
 	{
 	}
 
-    ::Eigen::MatrixXd SubjointConfigurationSensor::getCurrentValue() const
+	void SubjointConfigurationSensor::initialize(const double& t)
 	{
-        ::Eigen::MatrixXd cfg = this->_system->getJointConfiguration();
-        ::Eigen::MatrixXd subcfg(_index.size(), 1);
-        for(size_t i=0; i< _index.size(); i++)
-            subcfg(i) = cfg(_index[i]);
+		// gather() does not check the index - an index set with setIndex() has not been validated yet
+		_index_plan.validate(_system->getDof());
+		Sensor::initialize(t);
+	}
 
+    ::Eigen::MatrixXd SubjointConfigurationSensor::getCurrentValue() const
+	{
+        ::Eigen::MatrixXd subcfg(_index_plan.size(), 1);
+        _index_plan.gather(this->_system->getJointConfiguration(), subcfg);
         return subcfg;
 	}
 
+	bool SubjointConfigurationSensor::getDimensions(int& rows, int& cols) const
+	{
+		if (_index_plan.size() == 0)
+			return false;
+		rows = _index_plan.size();
+		cols = 1;
+		return true;
+	}
+
     DescriptionTreeNode::Ptr SubjointConfigurationSensor::serialize(const DescriptionTree::ConstPtr& factory) const
 	{
 		DescriptionTreeNode::Ptr tree = factory->createNode("Sensor");
 
 		tree->setAttribute<std::string>(std::string("type"), this->getType());
 
-		Eigen::MatrixXd index_mat(_index.size(), 1);
-        for(int j=0; j<index_mat.rows(); j++)
-			index_mat(j) = _index[j];
-
-		tree->setAttribute< Eigen::MatrixXd >(std::string("index"), index_mat);
+		tree->setAttribute< Eigen::MatrixXd >(std::string("index"), _index_plan.getIndexMatrix());
 
 		return tree;
 	}
@@ -79,9 +88,8 @@ namespace ha
         if(!tree->getAttribute< ::Eigen::MatrixXd >("index", index_mat) )
             HA_THROW_ERROR("SubjointConfigurationSensor.deserialize", "This type of sensor needs a value 'index'!");
 
-		_index.resize(index_mat.rows());
-        for(int j=0; j<index_mat.rows(); j++)
-            _index[j]=(int)index_mat(j);
+		_index_plan.setIndex(index_mat);
+		_index_plan.validate(system->getDof());
 
 		if (_type == "" || !HybridAutomaton::isSensorRegistered(_type)) {
             HA_THROW_ERROR("SubjointConfigurationSensor.deserialize", "SensorType type '" << _type << "' "
@@ -0,0 +1,185 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "hybrid_automaton/SupervisionThread.h"
+#include "hybrid_automaton/HybridAutomaton.h"
+#include "hybrid_automaton/error_handling.h"
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+namespace ha {
+
+	SupervisionThread::SupervisionThread(HybridAutomaton* hybrid_automaton, const double& idle_time)
+		: _hybrid_automaton(hybrid_automaton), _idle_time(idle_time),
+		_running(false), _failed(false), _request(0), _request_time(0.0), _result(0),
+		_epoch(0), _mode(0)
+	{
+	}
+
+	SupervisionThread::~SupervisionThread()
+	{
+		this->stop();
+	}
+
+	boost::uint64_t SupervisionThread::_pack(boost::uint32_t epoch, std::size_t value)
+	{
+		return (static_cast<boost::uint64_t>(epoch) << 32) | static_cast<boost::uint32_t>(value);
+	}
+
+	void SupervisionThread::start(std::size_t mode, const double& t)
+	{
+		if (_thread) {
+			HA_THROW_ERROR("SupervisionThread.start", "Supervision thread is already running!");
+		}
+
+		_epoch = 0;
+		_mode = mode;
+		_result.store(0, boost::memory_order_relaxed);
+		_failed.store(false, boost::memory_order_relaxed);
+		_error.clear();
+		_request_time.store(t, boost::memory_order_relaxed);
+		_request.store(_pack(_epoch, _mode), boost::memory_order_relaxed);
+		_running.store(true, boost::memory_order_release);
+
+		_thread.reset(new boost::thread(&SupervisionThread::_run, this));
+	}
+
+	void SupervisionThread::stop()
+	{
+		if (!_thread)
+			return;
+
+		_running.store(false, boost::memory_order_release);
+		_thread->join();
+		_thread.reset();
+	}
+
+	bool SupervisionThread::isRunning() const
+	{
+		return _running.load(boost::memory_order_acquire);
+	}
+
+	bool SupervisionThread::hasFailed() const
+	{
+		return _failed.load(boost::memory_order_acquire);
+	}
+
+	const ErrorRecord& SupervisionThread::getError() const
+	{
+		return _error;
+	}
+
+	boost::mutex& SupervisionThread::getMutex()
+	{
+		return _mutex;
+	}
+
+	void SupervisionThread::publish(std::size_t mode, const double& t)
+	{
+		// store the time first: whoever sees the new control mode also sees a time it was initialized with
+		_request_time.store(t, boost::memory_order_release);
+
+		if (mode != _mode)
+		{
+			// a new control mode is active - results for the previous one are stale from now on
+			++_epoch;
+			_mode = mode;
+			_request.store(_pack(_epoch, _mode), boost::memory_order_release);
+		}
+	}
+
+	bool SupervisionThread::fetchActiveSwitch(std::size_t& out_edge_index)
+	{
+		boost::uint64_t result = _result.exchange(0, boost::memory_order_acq_rel);
+		if (result == 0 || static_cast<boost::uint32_t>(result >> 32) != _epoch)
+			return false;
+
+		out_edge_index = static_cast<std::size_t>(result & 0xffffffffu) - 1;
+		return true;
+	}
+
+	void SupervisionThread::_run()
+	{
+		boost::uint64_t last_request = ~static_cast<boost::uint64_t>(0);
+		double last_time = 0.0;
+
+		while (_running.load(boost::memory_order_acquire))
+		{
+			boost::uint64_t request = _request.load(boost::memory_order_acquire);
+			double t = _request_time.load(boost::memory_order_acquire);
+
+			// nothing new to supervise, or the control thread did not yet consume our last result
+			boost::uint64_t pending = _result.load(boost::memory_order_acquire);
+			if ((request == last_request && t == last_time) || (pending != 0 && (pending >> 32) == (request >> 32)))
+			{
+				boost::this_thread::sleep(boost::posix_time::microseconds(static_cast<long>(_idle_time * 1e6)));
+				continue;
+			}
+			last_request = request;
+			last_time = t;
+
+			HybridAutomaton::ModeHandle mode = static_cast<HybridAutomaton::ModeHandle>(request & 0xffffffffu);
+			std::size_t out_edge_index;
+			try
+			{
+				boost::mutex::scoped_lock lock(_mutex);
+
+				// the control thread changed the control mode while we waited - its switches may be terminated
+				if (_request.load(boost::memory_order_acquire) != request)
+					continue;
+
+				if (_hybrid_automaton->_findActiveControlSwitch(mode, t, out_edge_index))
+					_result.store(_pack(static_cast<boost::uint32_t>(request >> 32), out_edge_index + 1), boost::memory_order_release);
+			}
+			catch (const std::string& e)
+			{
+				HA_ERROR("SupervisionThread.run", "Evaluating control switches failed, stopping supervision: " << e);
+				// keep the error for HybridAutomaton::tryStep - this is not the control thread, so it may allocate
+				_error.set(ErrorRecord::FAULT_SUPERVISION, "SupervisionThread.run", "%s", e.c_str());
+				_error.time = t;
+				_failed.store(true, boost::memory_order_release);
+				return;
+			}
+			catch (const std::exception& e)
+			{
+				HA_ERROR("SupervisionThread.run", "Evaluating control switches failed, stopping supervision: " << e.what());
+				_error.set(ErrorRecord::FAULT_SUPERVISION, "SupervisionThread.run", "%s", e.what());
+				_error.time = t;
+				_failed.store(true, boost::memory_order_release);
+				return;
+			}
+			catch (...)
+			{
+				// nothing may escape the thread - it would terminate the process
+				HA_ERROR("SupervisionThread.run", "Evaluating control switches failed, stopping supervision: unknown exception");
+				_error.set(ErrorRecord::FAULT_SUPERVISION, "SupervisionThread.run", "Unknown exception while evaluating the control switches.");
+				_error.time = t;
+				_failed.store(true, boost::memory_order_release);
+				return;
+			}
+		}
+	}
+
+}
@@ -0,0 +1,267 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "hybrid_automaton/TraceRecorder.h"
+#include "hybrid_automaton/error_handling.h"
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+#include <cstring>
+#include <limits>
+
+namespace ha
+{
+
+	namespace
+	{
+		const char TRACE_MAGIC[8] = {'H', 'A', 'T', 'R', 'A', 'C', 'E', '1'};
+
+		// how often the flush thread looks for new records
+		const long FLUSH_PERIOD_MS = 10;
+
+		// number of records the flush thread writes at once
+		const std::size_t FLUSH_CHUNK_SIZE = 256;
+	}
+
+	TraceRecorder::TraceRecorder(std::size_t capacity)
+		: _queue(capacity), _recording(false), _dropped(0)
+	{
+	}
+
+	TraceRecorder::~TraceRecorder()
+	{
+		try {
+			stop();
+		}
+		catch (...) {
+		}
+	}
+
+	void TraceRecorder::start(const std::string& filename)
+	{
+		if (_recording.load())
+			HA_THROW_ERROR("TraceRecorder.start", "Trace recorder is already recording!");
+
+		_file.open(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!_file.good())
+			HA_THROW_ERROR("TraceRecorder.start", "Could not open trace file " << filename << "!");
+
+		_file.write(TRACE_MAGIC, sizeof(TRACE_MAGIC));
+
+		_queue.clear();
+		_dropped.store(0);
+		_recording.store(true);
+		_flush_thread.reset(new boost::thread(&TraceRecorder::_flushLoop, this));
+	}
+
+	void TraceRecorder::stop()
+	{
+		if (!_recording.exchange(false))
+			return;
+
+		_flush_thread->join();
+		_flush_thread.reset();
+
+		// the producers checked _recording before reserving their slot - wait for a record in flight
+		_flush();
+		while (!_queue.isEmpty())
+		{
+			boost::this_thread::yield();
+			_flush();
+		}
+
+		boost::mutex::scoped_lock lock(_names_mutex);
+
+		Record end;
+		std::memset(&end, 0, sizeof(end));
+		end.type = END;
+		end.id = _names.size();
+		end.value = static_cast<double>(_dropped.load());
+		_file.write(reinterpret_cast<const char*>(&end), sizeof(end));
+
+		for (std::map<boost::uint64_t, std::string>::const_iterator it = _names.begin(); it != _names.end(); ++it)
+		{
+			boost::uint32_t length = it->second.size();
+			_file.write(reinterpret_cast<const char*>(&it->first), sizeof(it->first));
+			_file.write(reinterpret_cast<const char*>(&length), sizeof(length));
+			_file.write(it->second.data(), length);
+		}
+		_file.close();
+	}
+
+	bool TraceRecorder::isRecording() const
+	{
+		return _recording.load(boost::memory_order_relaxed);
+	}
+
+	void TraceRecorder::setName(const void* entity, const std::string& name)
+	{
+		boost::mutex::scoped_lock lock(_names_mutex);
+		_names[reinterpret_cast<boost::uint64_t>(entity)] = name;
+	}
+
+	void TraceRecorder::recordTick(double t, const void* control_mode)
+	{
+		Record record;
+		record.type = TICK;
+		record.active = 0;
+		record.index = 0;
+		record.reserved = 0;
+		record.id = reinterpret_cast<boost::uint64_t>(control_mode);
+		record.time = t;
+		record.value = 0.0;
+		record.epsilon = 0.0;
+		_push(record);
+	}
+
+	void TraceRecorder::recordCondition(double t, const void* control_switch, int index, double value, double epsilon, bool active)
+	{
+		Record record;
+		record.type = CONDITION;
+		record.active = active ? 1 : 0;
+		record.index = static_cast<boost::uint16_t>(index);
+		record.reserved = 0;
+		record.id = reinterpret_cast<boost::uint64_t>(control_switch);
+		record.time = t;
+		record.value = value;
+		record.epsilon = epsilon;
+		_push(record);
+	}
+
+	void TraceRecorder::recordTransition(double t, const void* control_switch)
+	{
+		Record record;
+		record.type = TRANSITION;
+		record.active = 1;
+		record.index = 0;
+		record.reserved = 0;
+		record.id = reinterpret_cast<boost::uint64_t>(control_switch);
+		record.time = t;
+		record.value = 0.0;
+		record.epsilon = 0.0;
+		_push(record);
+	}
+
+	boost::uint64_t TraceRecorder::getNumberOfDroppedRecords() const
+	{
+		return _dropped.load();
+	}
+
+	void TraceRecorder::_push(const Record& record)
+	{
+		if (!_recording.load(boost::memory_order_relaxed))
+			return;
+
+		if (!_queue.push(record))
+			_dropped.fetch_add(1, boost::memory_order_relaxed);
+	}
+
+	void TraceRecorder::_flushLoop()
+	{
+		while (_recording.load())
+		{
+			_flush();
+			boost::this_thread::sleep(boost::posix_time::milliseconds(FLUSH_PERIOD_MS));
+		}
+	}
+
+	void TraceRecorder::_flush()
+	{
+		// write the records in chunks instead of one by one
+		Record chunk[FLUSH_CHUNK_SIZE];
+		std::size_t count;
+		do
+		{
+			for (count = 0; count < FLUSH_CHUNK_SIZE && _queue.pop(chunk[count]); ++count) {}
+			_file.write(reinterpret_cast<const char*>(chunk), count * sizeof(Record));
+		}
+		while (count == FLUSH_CHUNK_SIZE);
+		_file.flush();
+	}
+
+	void TraceRecorder::convertToCsv(std::istream& trace, std::ostream& csv)
+	{
+		char magic[sizeof(TRACE_MAGIC)];
+		if (!trace.read(magic, sizeof(magic)) || std::memcmp(magic, TRACE_MAGIC, sizeof(magic)) != 0)
+			HA_THROW_ERROR("TraceRecorder.convertToCsv", "Not a trace file!");
+
+		std::vector<Record> records;
+		Record record;
+		while (trace.read(reinterpret_cast<char*>(&record), sizeof(record)) && record.type != END)
+			records.push_back(record);
+
+		if (!trace || record.type != END)
+			HA_THROW_ERROR("TraceRecorder.convertToCsv", "Trace is truncated - was the recorder stopped?");
+
+		std::map<boost::uint64_t, std::string> names;
+		for (boost::uint64_t i = 0; i < record.id; ++i)
+		{
+			boost::uint64_t id;
+			boost::uint32_t length;
+			trace.read(reinterpret_cast<char*>(&id), sizeof(id));
+			trace.read(reinterpret_cast<char*>(&length), sizeof(length));
+			std::string name(length, ' ');
+			if (length > 0)
+				trace.read(&name[0], length);
+			if (!trace)
+				HA_THROW_ERROR("TraceRecorder.convertToCsv", "Trace is truncated - could not read names!");
+			names[id] = name;
+		}
+
+		if (record.value > 0.0)
+			HA_WARN("TraceRecorder.convertToCsv", "The recorder dropped " << record.value << " records.");
+
+		csv.precision(std::numeric_limits<double>::digits10 + 2);
+		csv << "time,event,name,condition,value,epsilon,active" << std::endl;
+		for (std::size_t i = 0; i < records.size(); ++i)
+		{
+			const Record& r = records[i];
+			std::map<boost::uint64_t, std::string>::const_iterator name = names.find(r.id);
+
+			csv << r.time << ",";
+			switch (r.type)
+			{
+			case TICK:
+				csv << "tick,";
+				break;
+			case CONDITION:
+				csv << "condition,";
+				break;
+			case TRANSITION:
+				csv << "transition,";
+				break;
+			default:
+				csv << "unknown,";
+			}
+			csv << (name != names.end() ? name->second : std::string("?")) << ",";
+			if (r.type == CONDITION)
+				csv << r.index << "," << r.value << "," << r.epsilon << "," << (int)r.active;
+			else
+				csv << ",,,";
+			csv << std::endl;
+		}
+	}
+
+}
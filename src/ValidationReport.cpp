@@ -0,0 +1,80 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "hybrid_automaton/ValidationReport.h"
+
+namespace ha {
+
+	void ValidationReport::addError(const std::string& origin, const std::string& message)
+	{
+		Issue issue;
+		issue.severity = SEVERITY_ERROR;
+		issue.origin = origin;
+		issue.message = message;
+		_issues.push_back(issue);
+	}
+
+	void ValidationReport::addWarning(const std::string& origin, const std::string& message)
+	{
+		Issue issue;
+		issue.severity = SEVERITY_WARNING;
+		issue.origin = origin;
+		issue.message = message;
+		_issues.push_back(issue);
+	}
+
+	const std::vector<ValidationReport::Issue>& ValidationReport::getIssues() const
+	{
+		return _issues;
+	}
+
+	bool ValidationReport::hasErrors() const
+	{
+		return getNumberOfErrors() > 0;
+	}
+
+	std::size_t ValidationReport::getNumberOfErrors() const
+	{
+		std::size_t errors = 0;
+		for (std::size_t i = 0; i < _issues.size(); ++i)
+			if (_issues[i].severity == SEVERITY_ERROR)
+				++errors;
+		return errors;
+	}
+
+	std::size_t ValidationReport::getNumberOfWarnings() const
+	{
+		return _issues.size() - getNumberOfErrors();
+	}
+
+	void ValidationReport::write(std::ostream& out) const
+	{
+		for (std::size_t i = 0; i < _issues.size(); ++i) {
+			out << (_issues[i].severity == SEVERITY_ERROR ? "ERROR " : "WARNING ") << _issues[i].origin << ": "
+				<< _issues[i].message << std::endl;
+		}
+	}
+
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "hybrid_automaton/Watchdog.h"
+#include "hybrid_automaton/error_handling.h"
+
+namespace ha {
+
+	Watchdog::Watchdog()
+		: _max_tick_time(0.0), _max_sensor_age(0.0)
+	{
+	}
+
+	Watchdog::~Watchdog()
+	{
+	}
+
+	void Watchdog::setMaxTickTime(const double& max_tick_time)
+	{
+		if (max_tick_time < 0.0) {
+			HA_THROW_ERROR("Watchdog.setMaxTickTime", "Maximum tick time must not be negative!");
+		}
+		_max_tick_time = max_tick_time;
+	}
+
+	double Watchdog::getMaxTickTime() const
+	{
+		return _max_tick_time;
+	}
+
+	void Watchdog::setMaxSensorAge(const double& max_sensor_age)
+	{
+		if (max_sensor_age < 0.0) {
+			HA_THROW_ERROR("Watchdog.setMaxSensorAge", "Maximum sensor age must not be negative!");
+		}
+		_max_sensor_age = max_sensor_age;
+	}
+
+	double Watchdog::getMaxSensorAge() const
+	{
+		return _max_sensor_age;
+	}
+
+	void Watchdog::setFallbackControlMode(const std::string& control_mode)
+	{
+		_fallback_control_mode = control_mode;
+	}
+
+	const std::string& Watchdog::getFallbackControlMode() const
+	{
+		return _fallback_control_mode;
+	}
+
+	void Watchdog::setSensors(const std::vector<Sensor::ConstPtr>& sensors)
+	{
+		_sensors = sensors;
+		_inactive_since.assign(_sensors.size(), 0.0);
+	}
+
+	const std::vector<Sensor::ConstPtr>& Watchdog::getSensors() const
+	{
+		return _sensors;
+	}
+
+	void Watchdog::reset(const double& t)
+	{
+		for (std::size_t i = 0; i < _inactive_since.size(); ++i)
+			_inactive_since[i] = t;
+	}
+
+	bool Watchdog::checkSensors(const double& t, ErrorRecord& error)
+	{
+		if (_max_sensor_age <= 0.0)
+			return true;
+
+		for (std::size_t i = 0; i < _sensors.size(); ++i)
+		{
+			if (_sensors[i]->isActive())
+			{
+				_inactive_since[i] = t;
+			}
+			else if (t - _inactive_since[i] > _max_sensor_age)
+			{
+				// getType() would copy the name - report the index within getSensors()
+				error.set(ErrorRecord::FAULT_WATCHDOG, "Watchdog.checkSensors", "Sensor %u has been inactive for %g s (maximum: %g s).",
+					static_cast<unsigned int>(i), t - _inactive_since[i], _max_sensor_age);
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool Watchdog::checkTickTime(const double& tick_time, ErrorRecord& error) const
+	{
+		if (_max_tick_time > 0.0 && tick_time > _max_tick_time)
+		{
+			error.set(ErrorRecord::FAULT_WATCHDOG, "Watchdog.checkTickTime", "Control mode took %g s to compute its output (maximum: %g s).",
+				tick_time, _max_tick_time);
+			return false;
+		}
+		return true;
+	}
+
+	DescriptionTreeNode::Ptr Watchdog::serialize(const DescriptionTree::ConstPtr& factory) const
+	{
+		DescriptionTreeNode::Ptr tree_node = factory->createNode("Watchdog");
+
+		if (!_fallback_control_mode.empty())
+			tree_node->setAttribute<std::string>(std::string("fallback"), _fallback_control_mode);
+		if (_max_tick_time > 0.0)
+			tree_node->setAttribute<double>(std::string("max_tick_time"), _max_tick_time);
+		if (_max_sensor_age > 0.0)
+			tree_node->setAttribute<double>(std::string("max_sensor_age"), _max_sensor_age);
+
+		return tree_node;
+	}
+
+	void Watchdog::deserialize(const DescriptionTreeNode::ConstPtr& tree, const System::ConstPtr& system, const HybridAutomaton* ha)
+	{
+		if (tree->getType() != "Watchdog") {
+			HA_THROW_ERROR("Watchdog.deserialize", "DescriptionTreeNode must have type 'Watchdog', not '" << tree->getType() << "'!");
+		}
+
+		tree->getAttribute<std::string>("fallback", _fallback_control_mode, "");
+
+		double value;
+		tree->getAttribute<double>("max_tick_time", value, 0.0);
+		setMaxTickTime(value);
+		tree->getAttribute<double>("max_sensor_age", value, 0.0);
+		setMaxSensorAge(value);
+	}
+
+}
@@ -0,0 +1,332 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "hybrid_automaton/XMLStreamParser.h"
+#include "hybrid_automaton/error_handling.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+namespace ha {
+
+	namespace {
+		bool isWhitespace(int c)
+		{
+			return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+		}
+
+		bool isNameCharacter(int c)
+		{
+			return c > 0x7F || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')
+				|| c == '_' || c == ':' || c == '-' || c == '.';
+		}
+
+		// append the code point \a c to \a out in UTF-8
+		void appendUTF8(unsigned long c, std::string& out)
+		{
+			if (c < 0x80) {
+				out += static_cast<char>(c);
+			} else if (c < 0x800) {
+				out += static_cast<char>(0xC0 | (c >> 6));
+				out += static_cast<char>(0x80 | (c & 0x3F));
+			} else if (c < 0x10000) {
+				out += static_cast<char>(0xE0 | (c >> 12));
+				out += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+				out += static_cast<char>(0x80 | (c & 0x3F));
+			} else {
+				out += static_cast<char>(0xF0 | (c >> 18));
+				out += static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+				out += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+				out += static_cast<char>(0x80 | (c & 0x3F));
+			}
+		}
+	}
+
+	XMLStreamParser::XMLStreamParser(std::size_t buffer_size)
+		: _input(NULL), _buffer(buffer_size > 0 ? buffer_size : 1), _position(0), _end(0), _line(1), _depth(0), _root_closed(false)
+	{
+	}
+
+	XMLStreamParser::~XMLStreamParser()
+	{
+	}
+
+	void XMLStreamParser::parse(const std::string& input, XMLStreamHandler& handler)
+	{
+		std::istringstream in(input);
+		this->parse(in, handler);
+	}
+
+	void XMLStreamParser::parse(std::istream& input, XMLStreamHandler& handler)
+	{
+		_input = &input;
+		_position = _end = 0;
+		_line = 1;
+		_depth = 0;
+		_root_closed = false;
+
+		bool found_root = false;
+		for (int c = _get(); c >= 0; c = _get())
+		{
+			if (c != '<') {
+				if (_depth == 0 && !isWhitespace(c))
+					HA_THROW_ERROR("XMLStreamParser.parse", "Unexpected character '" << static_cast<char>(c) << "' outside of the root element in line " << _line << ".");
+				continue;
+			}
+
+			int next = _expect("markup");
+			if (next == '?') {
+				_skipPast("?>", "processing instruction");
+			} else if (next == '!') {
+				_parseMarkup();
+			} else if (next == '/') {
+				_parseClosingElement(handler);
+			} else {
+				if (_root_closed)
+					HA_THROW_ERROR("XMLStreamParser.parse", "Second root element in line " << _line << ".");
+				found_root = true;
+				_parseElement(next, handler);
+			}
+		}
+
+		_input = NULL;
+		if (!found_root)
+			HA_THROW_ERROR("XMLStreamParser.parse", "The document has no root element.");
+		if (_depth > 0)
+			HA_THROW_ERROR("XMLStreamParser.parse", "Element '" << _open_elements[_depth - 1] << "' is not closed.");
+	}
+
+	int XMLStreamParser::_get()
+	{
+		if (_position == _end)
+		{
+			_input->read(&_buffer[0], _buffer.size());
+			_end = static_cast<std::size_t>(_input->gcount());
+			_position = 0;
+			if (_end == 0)
+				return -1;
+		}
+		char c = _buffer[_position++];
+		if (c == '\n')
+			++_line;
+		return static_cast<unsigned char>(c);
+	}
+
+	int XMLStreamParser::_peek()
+	{
+		if (_position == _end)
+		{
+			_input->read(&_buffer[0], _buffer.size());
+			_end = static_cast<std::size_t>(_input->gcount());
+			_position = 0;
+			if (_end == 0)
+				return -1;
+		}
+		return static_cast<unsigned char>(_buffer[_position]);
+	}
+
+	int XMLStreamParser::_expect(const char* context)
+	{
+		int c = _get();
+		if (c < 0)
+			HA_THROW_ERROR("XMLStreamParser.parse", "Unexpected end of the document in " << context << ".");
+		return c;
+	}
+
+	void XMLStreamParser::_skipWhitespace()
+	{
+		while (isWhitespace(_peek()))
+			_get();
+	}
+
+	void XMLStreamParser::_skipPast(const char* terminator, const char* context)
+	{
+		std::size_t length = std::strlen(terminator);
+		std::size_t matched = 0;
+		while (matched < length)
+		{
+			int c = _expect(context);
+			if (c == terminator[matched]) {
+				++matched;
+				continue;
+			}
+
+			// the longest prefix of the terminator that ends at c, e.g. "--" in "--->" for "-->"
+			std::string tail(terminator, matched);
+			tail += static_cast<char>(c);
+			for (matched = tail.size() - 1; matched > 0; --matched) {
+				if (tail.compare(tail.size() - matched, matched, terminator, matched) == 0)
+					break;
+			}
+		}
+	}
+
+	void XMLStreamParser::_readName(int first, std::string& name)
+	{
+		if (!isNameCharacter(first) || first == '-' || first == '.' || (first >= '0' && first <= '9'))
+			HA_THROW_ERROR("XMLStreamParser.parse", "Invalid name in line " << _line << ".");
+
+		name.clear();
+		name += static_cast<char>(first);
+		while (isNameCharacter(_peek()))
+			name += static_cast<char>(_get());
+	}
+
+	void XMLStreamParser::_readAttributeValue(int quote, std::string& value)
+	{
+		value.clear();
+		for (int c = _expect("attribute value"); c != quote; c = _expect("attribute value"))
+		{
+			if (c == '<')
+				HA_THROW_ERROR("XMLStreamParser.parse", "'<' in attribute value in line " << _line << ".");
+			if (c != '&') {
+				value += static_cast<char>(c);
+				continue;
+			}
+
+			std::string entity;
+			for (c = _expect("entity"); c != ';'; c = _expect("entity"))
+			{
+				entity += static_cast<char>(c);
+				if (entity.size() > 10)
+					HA_THROW_ERROR("XMLStreamParser.parse", "Unterminated entity in line " << _line << ".");
+			}
+
+			if (entity == "lt") value += '<';
+			else if (entity == "gt") value += '>';
+			else if (entity == "amp") value += '&';
+			else if (entity == "quot") value += '"';
+			else if (entity == "apos") value += '\'';
+			else if (entity.size() > 1 && entity[0] == '#')
+			{
+				const bool hex = (entity[1] == 'x');
+				char* end = NULL;
+				const char* digits = entity.c_str() + (hex ? 2 : 1);
+				unsigned long code = std::strtoul(digits, &end, hex ? 16 : 10);
+				if (*digits == '\0' || *end != '\0' || code == 0 || code > 0x10FFFF)
+					HA_THROW_ERROR("XMLStreamParser.parse", "Invalid character reference '&" << entity << ";' in line " << _line << ".");
+				appendUTF8(code, value);
+			}
+			else
+				HA_THROW_ERROR("XMLStreamParser.parse", "Unknown entity '&" << entity << ";' in line " << _line << ".");
+		}
+	}
+
+	void XMLStreamParser::_parseMarkup()
+	{
+		int c = _expect("markup");
+		if (c == '-') {
+			if (_expect("comment") != '-')
+				HA_THROW_ERROR("XMLStreamParser.parse", "Invalid comment in line " << _line << ".");
+			_skipPast("-->", "comment");
+		} else if (c == '[') {
+			for (const char* expected = "CDATA["; *expected != '\0'; ++expected) {
+				if (_expect("CDATA section") != *expected)
+					HA_THROW_ERROR("XMLStreamParser.parse", "Invalid CDATA section in line " << _line << ".");
+			}
+			_skipPast("]]>", "CDATA section");
+		} else {
+			// DOCTYPE and other declarations, possibly with an internal subset in brackets
+			int brackets = 0;
+			for (; c != '>' || brackets > 0; c = _expect("declaration")) {
+				if (c == '[') ++brackets;
+				else if (c == ']') --brackets;
+			}
+		}
+	}
+
+	void XMLStreamParser::_parseElement(int first, XMLStreamHandler& handler)
+	{
+		_readName(first, _name);
+		_attributes.clear();
+
+		bool empty = false;
+		for (;;)
+		{
+			bool separated = isWhitespace(_peek());
+			_skipWhitespace();
+			int c = _expect("element");
+			if (c == '>')
+				break;
+			if (c == '/') {
+				if (_expect("element") != '>')
+					HA_THROW_ERROR("XMLStreamParser.parse", "Expected '>' after '/' in element '" << _name << "' in line " << _line << ".");
+				empty = true;
+				break;
+			}
+			if (!separated)
+				HA_THROW_ERROR("XMLStreamParser.parse", "Missing whitespace before attribute in element '" << _name << "' in line " << _line << ".");
+
+			_attributes.push_back(std::pair<std::string, std::string>());
+			_readName(c, _attributes.back().first);
+			_skipWhitespace();
+			if (_expect("attribute") != '=')
+				HA_THROW_ERROR("XMLStreamParser.parse", "Expected '=' after attribute '" << _attributes.back().first << "' in line " << _line << ".");
+			_skipWhitespace();
+			int quote = _expect("attribute");
+			if (quote != '"' && quote != '\'')
+				HA_THROW_ERROR("XMLStreamParser.parse", "Expected a quoted value for attribute '" << _attributes.back().first << "' in line " << _line << ".");
+			_readAttributeValue(quote, _attributes.back().second);
+
+			for (std::size_t i = 0; i + 1 < _attributes.size(); ++i) {
+				if (_attributes[i].first == _attributes.back().first)
+					HA_THROW_ERROR("XMLStreamParser.parse", "Duplicate attribute '" << _attributes.back().first << "' in line " << _line << ".");
+			}
+		}
+
+		handler.startElement(_name, _attributes);
+		if (empty)
+		{
+			handler.endElement(_name);
+			if (_depth == 0)
+				_root_closed = true;
+			return;
+		}
+
+		if (_open_elements.size() == _depth)
+			_open_elements.push_back(_name);
+		else
+			_open_elements[_depth] = _name;
+		++_depth;
+	}
+
+	void XMLStreamParser::_parseClosingElement(XMLStreamHandler& handler)
+	{
+		_readName(_expect("closing element"), _name);
+		_skipWhitespace();
+		if (_expect("closing element") != '>')
+			HA_THROW_ERROR("XMLStreamParser.parse", "Expected '>' in closing element '" << _name << "' in line " << _line << ".");
+		if (_depth == 0)
+			HA_THROW_ERROR("XMLStreamParser.parse", "Unexpected closing element '" << _name << "' in line " << _line << ".");
+		if (_open_elements[_depth - 1] != _name)
+			HA_THROW_ERROR("XMLStreamParser.parse", "Closing element '" << _name << "' does not match '" << _open_elements[_depth - 1] << "' in line " << _line << ".");
+
+		--_depth;
+		handler.endElement(_name);
+		if (_depth == 0)
+			_root_closed = true;
+	}
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "hybrid_automaton/BatchReplay.h"
+#include "hybrid_automaton/DescriptionTreeXML.h"
+#include "hybrid_automaton/error_handling.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <fstream>
+#include <iterator>
+
+using namespace ha;
+
+int main(int argc, char *argv[]) {
+
+    std::vector<std::string> args(argv + 1, argv + argc);
+
+    unsigned int number_of_threads = 0;
+    if (args.size() >= 2 && args[0] == "-j") {
+        number_of_threads = std::atoi(args[1].c_str());
+        args.erase(args.begin(), args.begin() + 2);
+    }
+
+    if (args.size() < 3) {
+        std::cerr << "Usage: ./hybrid_automaton_replay [-j <threads>] <xml file> <summary file> <log file> [<log file> ...]" << std::endl;
+        return 1;
+    }
+
+    std::ifstream xml(args[0].c_str());
+    if (!xml.good()) {
+        std::cerr << "Cannot open " << args[0] << std::endl;
+        return 1;
+    }
+    std::string description((std::istreambuf_iterator<char>(xml)), std::istreambuf_iterator<char>());
+    xml.close();
+
+    std::vector<std::string> logs(args.begin() + 2, args.end());
+    std::vector<BatchReplay::Run> runs;
+    try {
+        // the XML is parsed once and shared by all replays
+        DescriptionTreeXML tree(description);
+        BatchReplay batch(tree.getRootNode());
+        runs = batch.run(logs, number_of_threads);
+    }
+    catch (const std::string& error) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+
+    std::ofstream summary(args[1].c_str());
+    if (!summary.good()) {
+        std::cerr << "Cannot open " << args[1] << std::endl;
+        return 1;
+    }
+    BatchReplay::writeSummary(runs, summary);
+    summary.close();
+
+    BatchReplay::Summary totals = BatchReplay::summarize(runs);
+    std::cout << "Replayed " << totals.logs << " logs (" << totals.failed << " failed), summary written to "
+              << args[1] << std::endl;
+
+    return totals.failed == 0 ? 0 : 2;
+}
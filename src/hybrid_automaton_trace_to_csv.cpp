@@ -0,0 +1,61 @@
+/*
+ * Copyright 2015-2017, Robotics and Biology Lab, TU Berlin
+ * 
+ * Redistribution and use in source and binary forms, with or without 
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ * this list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce the above copyright 
+ * notice, this list of conditions and the following disclaimer in the 
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE 
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE 
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "hybrid_automaton/TraceRecorder.h"
+#include "hybrid_automaton/error_handling.h"
+
+#include <iostream>
+#include <fstream>
+
+using namespace ha;
+
+int main(int argc, char *argv[]) {
+
+    if (argc < 2) {
+        std::cerr << "Usage: ./hybrid_automaton_trace_to_csv <trace file> [<csv file>]" << std::endl;
+        return 1;
+    }
+
+    std::ifstream trace(argv[1], std::ios::in | std::ios::binary);
+    if (!trace.good()) {
+        std::cerr << "File not found: " << argv[1] << std::endl;
+        return 1;
+    }
+
+    try {
+        if (argc == 3) {
+            std::ofstream csv(argv[2]);
+            TraceRecorder::convertToCsv(trace, csv);
+        } else {
+            TraceRecorder::convertToCsv(trace, std::cout);
+        }
+    }
+    catch (std::string err) {
+        std::cerr << err << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
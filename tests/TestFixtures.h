@@ -0,0 +1,60 @@
+#ifndef HYBRID_AUTOMATON_TESTS_TEST_FIXTURES_H_
+#define HYBRID_AUTOMATON_TESTS_TEST_FIXTURES_H_
+
+#include "gmock/gmock.h"
+
+#include "hybrid_automaton/ControlMode.h"
+#include "hybrid_automaton/System.h"
+
+namespace ha {
+
+	// a control mode that returns a constant output - or throws if it was told to fail
+	class TestControlMode : public ControlMode {
+
+	public:
+		TestControlMode(const std::string& name, const ::Eigen::MatrixXd& output = ::Eigen::MatrixXd(0,0)) : ControlMode(name), _output(output), _fail(false) {}
+		TestControlMode(const std::string& name, double output) : ControlMode(name), _output(::Eigen::MatrixXd::Constant(1, 1, output)), _fail(false) {}
+
+		virtual void initialize() {}
+		virtual void terminate() {}
+		virtual ::Eigen::MatrixXd step(const double& t) {
+			if (_fail)
+				throw std::string("controller diverged");
+			return _output;
+		}
+		virtual void switchControlMode(ControlMode::Ptr otherMode) {}
+
+		::Eigen::MatrixXd _output;
+		bool _fail;
+	};
+
+	// a system with settable joint values, wrench and frame pose - the wrench of port i is (i + 1) * ft
+	class TestSystem : public System {
+
+	public:
+		TestSystem(int dof = 3) : q(::Eigen::MatrixXd::Ones(dof,1)), qd(::Eigen::MatrixXd::Zero(dof,1)),
+			ft(::Eigen::MatrixXd::Zero(6,1)), pose(::Eigen::MatrixXd::Identity(4,4)) {}
+
+		virtual int getDof() const { return q.rows(); }
+		virtual ::Eigen::MatrixXd getJointConfiguration() const { return q; }
+		virtual ::Eigen::MatrixXd getJointVelocity() const { return qd; }
+		virtual ::Eigen::MatrixXd getForceTorqueMeasurement(const int& port) const { return ft * (port + 1); }
+		virtual ::Eigen::MatrixXd getFramePose(const std::string& frame_id) const { return pose; }
+
+		::Eigen::MatrixXd q, qd, ft, pose;
+	};
+
+	class MockSystem : public System {
+
+	public:
+		MOCK_CONST_METHOD0(getDof, int () );
+		MOCK_CONST_METHOD0(getJointConfiguration, ::Eigen::MatrixXd () );
+		MOCK_CONST_METHOD0(getJointVelocity, ::Eigen::MatrixXd () );
+		MOCK_CONST_METHOD1(getForceTorqueMeasurement, ::Eigen::MatrixXd (const int& port) );
+		MOCK_CONST_METHOD0(getCurrentTime, ::Eigen::MatrixXd () );
+		MOCK_CONST_METHOD1(getFramePose, ::Eigen::MatrixXd (const std::string& frame_id) );
+	};
+
+}
+
+#endif
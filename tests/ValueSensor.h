@@ -0,0 +1,37 @@
+#ifndef HYBRID_AUTOMATON_TESTS_VALUE_SENSOR_H_
+#define HYBRID_AUTOMATON_TESTS_VALUE_SENSOR_H_
+
+#include "hybrid_automaton/Sensor.h"
+
+namespace ha {
+
+	// a sensor that returns the value it was given - its dimensions are the ones of the value
+	class ValueSensor : public Sensor {
+
+	public:
+		typedef boost::shared_ptr<ValueSensor> Ptr;
+		typedef boost::shared_ptr<const ValueSensor> ConstPtr;
+
+		ValueSensor() : _value(::Eigen::MatrixXd::Zero(1,1)), _active(true) {}
+
+		virtual ::Eigen::MatrixXd getCurrentValue() const { return _value; }
+		virtual bool getDimensions(int& rows, int& cols) const { rows = _value.rows(); cols = _value.cols(); return true; }
+		virtual bool isActive() const { return _active; }
+
+		void setValue(const ::Eigen::MatrixXd& value) { _value = value; }
+		void setValue(double value) { _value = ::Eigen::MatrixXd::Constant(1, 1, value); }
+		void setActive(bool active) { _active = active; }
+
+		virtual DescriptionTreeNode::Ptr serialize(const DescriptionTree::ConstPtr& factory) const { return DescriptionTreeNode::Ptr(); }
+		virtual void deserialize(const DescriptionTreeNode::ConstPtr& tree, const System::ConstPtr& system, const HybridAutomaton* ha) {}
+
+	protected:
+		virtual Sensor* _doClone() const { return new ValueSensor(*this); }
+
+		::Eigen::MatrixXd _value;
+		bool _active;
+	};
+
+}
+
+#endif
@@ -202,3 +202,58 @@ TEST(ControlSet, Serialization) {
 	cs->serialize(tree);
 
 }
+
+TEST(ControlSet, ControllersByPriority) {
+	MockRegisteredControlSet cs;
+	const char* names[] = { "low", "high", "medium", "high2", "default" };
+	const double priorities[] = { 1.0, 3.0, 2.0, 3.0, 0.0 };
+	for (int i = 0; i < 5; ++i)
+	{
+		Controller::Ptr ctrl(new Controller);
+		ctrl->setName(names[i]);
+		ctrl->setPriority(priorities[i]);
+		cs.appendController(ctrl);
+	}
+
+	// descending priority, equal priorities in the order they were added
+	const std::vector<Controller::Ptr>& controllers = cs.getControllersByPriority();
+	ASSERT_EQ(5u, controllers.size());
+	EXPECT_EQ("high", controllers[0]->getName());
+	EXPECT_EQ("high2", controllers[1]->getName());
+	EXPECT_EQ("medium", controllers[2]->getName());
+	EXPECT_EQ("low", controllers[3]->getName());
+	EXPECT_EQ("default", controllers[4]->getName());
+	EXPECT_EQ(controllers[2], cs.getControllerByName("medium"));
+
+	// the const accessors do not copy
+	const ControlSet& const_cs = cs;
+	EXPECT_EQ(&const_cs.getControllers(), &const_cs.getControllers());
+	EXPECT_EQ(&controllers, &const_cs.getControllersByPriority());
+
+	// a copy has its own controllers in the same order
+	ControlSet::Ptr copy = cs.clone();
+	ASSERT_EQ(5u, copy->getControllersByPriority().size());
+	EXPECT_EQ("high2", copy->getControllersByPriority()[1]->getName());
+	EXPECT_NE(controllers[1], copy->getControllersByPriority()[1]);
+	EXPECT_EQ(copy->getControllersByPriority()[1], copy->getControllerByName("high2"));
+
+	EXPECT_ANY_THROW(cs.appendController(controllers[0]));
+	EXPECT_EQ(5u, cs.getControllersByPriority().size());
+
+	// a priority changed after appendController moves the controller, the others keep their order
+	cs.setControllerPriority("low", 4.0);
+	ASSERT_EQ(5u, cs.getControllersByPriority().size());
+	EXPECT_EQ("low", cs.getControllersByPriority()[0]->getName());
+	EXPECT_EQ("high", cs.getControllersByPriority()[1]->getName());
+	EXPECT_EQ("high2", cs.getControllersByPriority()[2]->getName());
+	EXPECT_EQ("default", cs.getControllersByPriority()[4]->getName());
+	EXPECT_ANY_THROW(cs.setControllerPriority("missing", 1.0));
+
+	// a priority set on the controller itself takes effect when the controllers are sorted again
+	cs.getControllersByPriority()[4]->setPriority(5.0);
+	EXPECT_EQ("low", cs.getControllersByPriority()[0]->getName());
+	cs.sortControllersByPriority();
+	EXPECT_EQ("default", cs.getControllersByPriority()[0]->getName());
+	EXPECT_EQ("low", cs.getControllersByPriority()[1]->getName());
+	EXPECT_EQ(5u, cs.getControllersByPriority().size());
+}
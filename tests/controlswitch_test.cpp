@@ -1,7 +1,167 @@
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 
+#include "hybrid_automaton/ControlSwitch.h"
+#include "hybrid_automaton/ValidationReport.h"
+#include "tests/ValueSensor.h"
+
+#include <stdexcept>
+
+using namespace ha;
+
+namespace ControlSwitchExpression {
+	// active if the sensor value is 1 - a goal of the wrong size makes the evaluation fail
+	JumpCondition::Ptr condition(const ValueSensor::Ptr& sensor, int goal_rows = 1) {
+		JumpCondition::Ptr jc(new JumpCondition);
+		jc->setSensor(sensor);
+		jc->setConstantGoal(::Eigen::MatrixXd::Ones(goal_rows, 1));
+		jc->setJumpCriterion(JumpCondition::NORM_L1);
+		jc->setEpsilon(0.1);
+		return jc;
+	}
+
+	// overrides only the throwing interface - tryIsActive() has to call it
+	class RangeSwitch : public ControlSwitch {
+	public:
+		RangeSwitch(const ValueSensor::Ptr& sensor) : _sensor(sensor) {}
+		virtual bool isActive() const {
+			if (_sensor->getCurrentValue()(0) < 0.0)
+				throw std::runtime_error("negative value");
+			return ControlSwitch::isActive();
+		}
+		ValueSensor::Ptr _sensor;
+	};
+}
 
 TEST(ControlSwitch, Serialization) {
 	// TODO
-}
\ No newline at end of file
+}
+
+TEST(ControlSwitch, EvaluationRate) {
+	ControlSwitch cs;
+
+	// by default a switch is evaluated in every control cycle
+	EXPECT_EQ(0.0, cs.getEvaluationRate());
+	cs.initialize(0.0);
+	EXPECT_TRUE(cs.isEvaluationDue(0.0));
+	cs.scheduleNextEvaluation(0.0);
+	EXPECT_TRUE(cs.isEvaluationDue(0.001));
+
+	EXPECT_ANY_THROW(cs.setEvaluationRate(-1.0));
+
+	cs.setEvaluationRate(10.0);
+	EXPECT_DOUBLE_EQ(10.0, cs.getEvaluationRate());
+
+	cs.initialize(1.0);
+	EXPECT_TRUE(cs.isEvaluationDue(1.0));
+	cs.scheduleNextEvaluation(1.0);
+	EXPECT_FALSE(cs.isEvaluationDue(1.05));
+	EXPECT_TRUE(cs.isEvaluationDue(1.1));
+
+	// after an overrun the schedule continues from the current time
+	cs.scheduleNextEvaluation(1.5);
+	EXPECT_FALSE(cs.isEvaluationDue(1.55));
+	EXPECT_TRUE(cs.isEvaluationDue(1.6));
+}
+
+TEST(ControlSwitch, Expression) {
+	using namespace ControlSwitchExpression;
+
+	ControlSwitch cs;
+	std::vector<ValueSensor::Ptr> sensors;
+	for (int i = 0; i < 4; i++) {
+		sensors.push_back(ValueSensor::Ptr(new ValueSensor));
+		cs.add(condition(sensors.back(), (i < 3) ? 1 : 2));
+	}
+	cs.initialize(0.0);
+
+	const char* expressions[] = {"0 and (1 or not 2)", "0 | 1 & 2", "atleast(2, 0, 1, 2)", "!(0 & 1) or (0&1)",
+		"(0 and 1) or (2 and (0 and 1)) or not (0 and 1)", "atleast(0, 0)", "not not 2"};
+
+	for (int c = 0; c < 8; c++) {
+		bool a = (c & 1), b = (c & 2), d = (c & 4);
+		sensors[0]->setValue(a);
+		sensors[1]->setValue(b);
+		sensors[2]->setValue(d);
+		bool expected[] = {a && (b || !d), a || (b && d), (a + b + d) >= 2, true, true, true, d};
+
+		for (int e = 0; e < 7; e++) {
+			cs.setExpression(expressions[e]);
+			bool active;
+			ErrorRecord error;
+			ASSERT_TRUE(cs.tryIsActive(active, error)) << expressions[e];
+			EXPECT_EQ(expected[e], active) << expressions[e] << " with " << a << b << d;
+		}
+	}
+
+	// the broken condition 3 is not evaluated once the result is known
+	bool active;
+	ErrorRecord error;
+	sensors[0]->setValue(1);
+	cs.setExpression("0 or 3");
+	EXPECT_TRUE(cs.tryIsActive(active, error));
+	EXPECT_TRUE(active);
+	cs.setExpression("atleast(1, 0, 3)");
+	EXPECT_TRUE(cs.tryIsActive(active, error));
+	cs.setExpression("not 0 and 3");
+	EXPECT_TRUE(cs.tryIsActive(active, error));
+	EXPECT_FALSE(active);
+	cs.setExpression("3 or 0");
+	EXPECT_FALSE(cs.tryIsActive(active, error));
+	cs.setExpression("7");
+	EXPECT_FALSE(cs.tryIsActive(active, error));
+
+	const char* invalid[] = {"0 and", "or 1", "(0", "0 xor 1", "atleast(3, 0, 1)", "atleast(1)", "0 1", "andy"};
+	for (int i = 0; i < 8; i++)
+		EXPECT_ANY_THROW(cs.setExpression(invalid[i])) << invalid[i];
+	// an invalid expression keeps the previous one
+	EXPECT_EQ("7", cs.getExpression());
+	EXPECT_FALSE(cs.tryIsActive(active, error));
+
+	// unused conditions are reported, copies keep the expression - the goal of condition 3 does not fit its sensor
+	cs.setExpression("0 or 1");
+	ValidationReport report;
+	cs.validate(report);
+	EXPECT_EQ(1u, report.getNumberOfErrors());
+	EXPECT_EQ(2u, report.getNumberOfWarnings());
+	EXPECT_EQ("0 or 1", cs.clone()->getExpression());
+
+	// an empty expression is the conjunction of all conditions
+	cs.setExpression("");
+	EXPECT_EQ("", cs.getExpression());
+	EXPECT_FALSE(cs.tryIsActive(active, error));
+}
+
+TEST(ControlSwitch, TryIsActive) {
+	using namespace ControlSwitchExpression;
+
+	ValueSensor::Ptr sensor(new ValueSensor);
+	ControlSwitch cs;
+	cs.add(condition(sensor));
+	cs.add(condition(sensor, 2));
+	cs.initialize(0.0);
+	sensor->setValue(1);
+
+	// the same failure is reported into the record or thrown, calls do not influence each other
+	bool active = true;
+	ErrorRecord error;
+	EXPECT_FALSE(cs.tryIsActive(active, error));
+	EXPECT_FALSE(active);
+	EXPECT_EQ(ErrorRecord::FAULT_JUMP_CONDITION, error.code);
+	EXPECT_NE(std::string::npos, std::string(error.message).find("Dimension mismatch"));
+	EXPECT_THROW(cs.isActive(), std::string);
+	ErrorRecord second;
+	EXPECT_FALSE(cs.tryIsActive(active, second));
+	EXPECT_STREQ(error.message, second.message);
+
+	// subclasses that override isActive() are called by tryIsActive()
+	RangeSwitch range(sensor);
+	range.add(condition(sensor));
+	range.initialize(0.0);
+	EXPECT_TRUE(range.tryIsActive(active, error));
+	EXPECT_TRUE(active);
+	sensor->setValue(-1);
+	EXPECT_FALSE(range.tryIsActive(active, error));
+	EXPECT_STREQ("negative value", error.message);
+	EXPECT_THROW(range.isActive(), std::runtime_error);
+}
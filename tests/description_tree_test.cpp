@@ -119,4 +119,31 @@ TEST(DescriptionTree, getAttributeMatrix) {
 	::Eigen::MatrixXd goal_false(5,2);
 	goal_false << 2., 2., 2., 2., 2., 2., 2., 2., 2., 2.;
 	EXPECT_NE(goal_result, goal_false);
-}
\ No newline at end of file
+}
+TEST(DescriptionTree, FormatLikeStringStream) {
+	using namespace ha;
+
+	double values[] = {0.0, -0.0, 1.0, 0.1, -2.5, 1e-7, 123456789.0, 1.0/3.0, 6.02214076e23};
+	for (std::size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i)
+	{
+		ha_stringstream ss;
+		ss << values[i];
+		std::string formatted;
+		ha_append(formatted, values[i]);
+		EXPECT_EQ(ss.str(), formatted);
+	}
+
+	::Eigen::MatrixXd m(2, 3);
+	m << 1.5, -2, 3e-9, 4, 5, 6;
+	ha_stringstream ss;
+	ss << m << 42 << true;
+	std::string formatted;
+	ha_append(formatted, m);
+	ha_append(formatted, 42);
+	ha_append(formatted, true);
+	EXPECT_EQ(ss.str(), formatted);
+
+	MockDescriptionTreeNode mock_dtn;
+	EXPECT_CALL(mock_dtn, setAttributeString(std::string("goal"), std::string("[2,3]1.5,-2,3e-09;4,5,6")));
+	mock_dtn.setAttribute< ::Eigen::MatrixXd>("goal", m);
+}
@@ -0,0 +1,154 @@
+#include "gtest/gtest.h"
+
+#include "hybrid_automaton/DescriptionTreeTransport.h"
+#include "hybrid_automaton/DescriptionTreeStream.h"
+
+#include <cstdlib>
+#include <sstream>
+
+using namespace ha;
+
+namespace DescriptionTreeTransportTest {
+	// a control set with many controllers that share their gains
+	DescriptionTreeNode::Ptr createTree(const DescriptionTree::Ptr& tree, int controllers)
+	{
+		const std::string gains = "[7,1]0.1;0.2;0.3;0.4;0.5;0.6;0.7";
+
+		DescriptionTreeNode::Ptr root = tree->createNode("HybridAutomaton");
+		root->setAttribute<std::string>("current_control_mode", "mode");
+		root->setAttribute<std::string>("name", "transport");
+
+		DescriptionTreeNode::Ptr mode = tree->createNode("ControlMode");
+		mode->setAttribute<std::string>("name", "mode");
+		DescriptionTreeNode::Ptr set = tree->createNode("ControlSet");
+		set->setAttribute<std::string>("name", "set");
+		set->setAttribute<std::string>("type", "JointSet");
+		for (int i = 0; i < controllers; ++i)
+		{
+			std::ostringstream name;
+			name << "ctrl" << i;
+			DescriptionTreeNode::Ptr ctrl = tree->createNode("Controller");
+			ctrl->setAttribute<std::string>("goal", gains);
+			ctrl->setAttribute<std::string>("kp", gains);
+			ctrl->setAttribute<std::string>("kv", gains);
+			ctrl->setAttribute<std::string>("name", name.str());
+			ctrl->setAttribute<std::string>("type", "JointController");
+			set->addChildNode(ctrl);
+		}
+		mode->addChildNode(set);
+		root->addChildNode(mode);
+		return root;
+	}
+
+	std::string toXML(const DescriptionTreeNode::ConstPtr& node)
+	{
+		std::ostringstream out;
+		DescriptionTreeStream::writeXML(node, out, 0);
+		return out.str();
+	}
+
+	std::string encode(bool compress, std::size_t chunk_size)
+	{
+		DescriptionTreeStream::Ptr tree(new DescriptionTreeStream);
+		DescriptionTreeTransport::Options options;
+		options.compress = compress;
+		options.chunk_size = chunk_size;
+		std::string encoded;
+		DescriptionTreeTransport::encode(createTree(tree, 20), encoded, options);
+		return encoded;
+	}
+}
+
+TEST(DescriptionTreeTransport, RoundTrip) {
+	using namespace DescriptionTreeTransportTest;
+
+	DescriptionTreeStream::Ptr tree(new DescriptionTreeStream);
+	DescriptionTreeNode::Ptr root = createTree(tree, 20);
+	const std::string xml = toXML(root);
+
+	for (int compress = 0; compress < 2; ++compress)
+	{
+		for (std::size_t chunk_size = 16; chunk_size <= 1024 * 1024; chunk_size *= 16)
+		{
+			DescriptionTreeTransport::Options options;
+			options.compress = (compress != 0);
+			options.chunk_size = chunk_size;
+			std::string encoded;
+			DescriptionTreeTransport::Statistics statistics;
+			DescriptionTreeTransport::encode(root, encoded, options, &statistics);
+
+			EXPECT_EQ(encoded.size(), statistics.encoded_bytes);
+			EXPECT_EQ(23u, statistics.nodes);
+			EXPECT_EQ(105u, statistics.attributes);
+			// the gains are pooled once
+			EXPECT_GT(statistics.attributes, statistics.pooled_strings);
+			EXPECT_EQ((statistics.tree_bytes + chunk_size - 1) / chunk_size, statistics.chunks);
+			EXPECT_GT(xml.size(), encoded.size());
+
+			DescriptionTreeNode::Ptr decoded = DescriptionTreeTransport::decode(encoded, tree);
+			EXPECT_EQ(xml, toXML(decoded));
+		}
+	}
+
+	// compression pays off for the repeated controllers
+	EXPECT_GT(encode(false, 64 * 1024).size(), encode(true, 64 * 1024).size());
+}
+
+TEST(DescriptionTreeTransport, Blocks) {
+	std::string repetitive;
+	for (int i = 0; i < 100; ++i)
+		repetitive += "<Controller kp=\"[7,1]0.1;0.2;0.3\"/>";
+	std::string noise;
+	std::srand(42);
+	for (int i = 0; i < 5000; ++i)
+		noise.push_back(static_cast<char>(std::rand() & 0xff));
+	const std::string blocks[] = { "", "a", "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa", "abcdefghijkl", repetitive, noise };
+
+	for (std::size_t i = 0; i < sizeof(blocks) / sizeof(blocks[0]); ++i)
+	{
+		std::string compressed;
+		DescriptionTreeTransport::compressBlock(blocks[i].data(), blocks[i].size(), compressed);
+		std::string decompressed = "prefix";
+		DescriptionTreeTransport::decompressBlock(compressed.data(), compressed.size(), blocks[i].size(), decompressed);
+		EXPECT_EQ("prefix" + blocks[i], decompressed);
+
+		// the expected size is checked
+		std::string wrong_size;
+		EXPECT_ANY_THROW(DescriptionTreeTransport::decompressBlock(compressed.data(), compressed.size(), blocks[i].size() + 1, wrong_size));
+
+		// an impossible size is rejected before anything is allocated
+		EXPECT_THROW(DescriptionTreeTransport::decompressBlock(compressed.data(), compressed.size(), 0xffffffffUL, wrong_size), std::string);
+	}
+
+	std::string compressed;
+	DescriptionTreeTransport::compressBlock(repetitive.data(), repetitive.size(), compressed);
+	EXPECT_GT(repetitive.size() / 10, compressed.size());
+}
+
+TEST(DescriptionTreeTransport, Corruption) {
+	using namespace DescriptionTreeTransportTest;
+
+	DescriptionTree::Ptr tree(new DescriptionTreeStream);
+	for (int compress = 0; compress < 2; ++compress)
+	{
+		const std::string encoded = encode(compress != 0, 256);
+		ASSERT_NO_THROW(DescriptionTreeTransport::decode(encoded, tree));
+
+		// every flipped bit of the chunk data is detected
+		for (std::size_t i = 18; i < encoded.size() - 12; i += 7)
+		{
+			std::string corrupted = encoded;
+			corrupted[i] ^= 0x10;
+			EXPECT_ANY_THROW(DescriptionTreeTransport::decode(corrupted, tree)) << "byte " << i;
+		}
+
+		EXPECT_ANY_THROW(DescriptionTreeTransport::decode(encoded.substr(0, encoded.size() - 1), tree));
+		EXPECT_ANY_THROW(DescriptionTreeTransport::decode(encoded + "x", tree));
+		EXPECT_ANY_THROW(DescriptionTreeTransport::decode("<HybridAutomaton/>", tree));
+
+		// a hostile length of the first chunk
+		std::string huge = encoded;
+		huge.replace(6, 4, "\xf0\xff\xff\xff", 4);
+		EXPECT_THROW(DescriptionTreeTransport::decode(huge, tree), std::string);
+	}
+}
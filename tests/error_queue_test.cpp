@@ -0,0 +1,160 @@
+#include "gtest/gtest.h"
+
+#include "hybrid_automaton/HybridAutomaton.h"
+#include "hybrid_automaton/JointConfigurationSensor.h"
+#include "hybrid_automaton/ErrorQueue.h"
+
+#include "tests/TestFixtures.h"
+
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+
+#include <cstdlib>
+#include <sstream>
+
+using namespace ha;
+
+namespace ErrorQueueTest {
+	// a switch from "run" to "done" that never fires - its goal does not fit the sensor unless the controller fails
+	HybridAutomaton::Ptr createAutomaton(bool controller_fails) {
+		HybridAutomaton::Ptr ha(new HybridAutomaton);
+		boost::shared_ptr<TestControlMode> run(new TestControlMode("run", 1.0));
+		run->_fail = controller_fails;
+		ha->addControlMode(run);
+		ha->addControlMode(ControlMode::Ptr(new TestControlMode("done", 2.0)));
+		ha->addControlMode(ControlMode::Ptr(new TestControlMode("hold", 3.0)));
+
+		JointConfigurationSensor::Ptr sensor(new JointConfigurationSensor);
+		sensor->setSystem(System::ConstPtr(new TestSystem));
+		JumpCondition::Ptr jc(new JumpCondition);
+		jc->setSensor(sensor);
+		jc->setConstantGoal(::Eigen::MatrixXd::Constant(controller_fails ? 3 : 2, 1, 5.0));
+		ControlSwitch::Ptr cs(new ControlSwitch);
+		cs->setName("run_to_done");
+		cs->add(jc);
+		ha->addControlSwitch("run", cs, "done");
+
+		ha->setCurrentControlMode("run");
+		return ha;
+	}
+
+	void pushRecords(ErrorQueue* queue, int producer, int count) {
+		ErrorRecord record;
+		for (int i = 0; i < count; ++i) {
+			record.set(ErrorRecord::FAULT_EXCEPTION, "Test", "%d", i);
+			record.time = producer;
+			queue->push(record);
+		}
+	}
+}
+
+TEST(ErrorQueue, PushPop) {
+	ErrorQueue queue(3);
+
+	ErrorRecord record;
+	record.set(ErrorRecord::FAULT_JUMP_CONDITION, "Test", "fault %d", 1);
+	record.time = 0.5;
+
+	// the capacity is rounded up to 4
+	for (int i = 0; i < 5; ++i)
+		queue.push(record);
+	EXPECT_EQ(1u, queue.getNumberOfDroppedRecords());
+
+	ErrorRecord popped;
+	int count = 0;
+	while (queue.pop(popped))
+		++count;
+	EXPECT_EQ(4, count);
+	EXPECT_EQ(ErrorRecord::FAULT_JUMP_CONDITION, popped.code);
+	EXPECT_STREQ("fault 1", popped.message);
+
+	std::ostringstream out;
+	ErrorQueue::write(popped, out);
+	EXPECT_EQ("[Test] ERROR: fault 1 (t=0.5, FAULT_JUMP_CONDITION)\n", out.str());
+
+	// the logging thread writes the pending records when it is stopped
+	std::ostringstream log;
+	queue.push(record);
+	queue.startLogging(log);
+	queue.stopLogging();
+	EXPECT_EQ(out.str(), log.str());
+}
+
+TEST(ErrorQueue, ConcurrentProducers) {
+	const int producers = 4;
+	const int count = 1000;
+	ErrorQueue queue(producers * count);
+
+	boost::thread_group threads;
+	for (int p = 0; p < producers; ++p)
+		threads.create_thread(boost::bind(&ErrorQueueTest::pushRecords, &queue, p, count));
+	threads.join_all();
+	EXPECT_EQ(0u, queue.getNumberOfDroppedRecords());
+
+	// every record arrives once and the records of one producer keep their order
+	std::vector<int> next(producers, 0);
+	ErrorRecord record;
+	while (queue.pop(record)) {
+		int producer = static_cast<int>(record.time);
+		ASSERT_EQ(next[producer], atoi(record.message));
+		++next[producer];
+	}
+	for (int p = 0; p < producers; ++p)
+		EXPECT_EQ(count, next[p]);
+}
+
+TEST(ErrorQueue, TryStepSafeMode) {
+	using namespace ErrorQueueTest;
+
+	::Eigen::MatrixXd control;
+
+	// not initialized
+	HybridAutomaton::Ptr ha = createAutomaton(false);
+	StepResult result = ha->tryStep(0.0, control);
+	EXPECT_EQ(StepResult::STEP_FAILED, result.status);
+	EXPECT_EQ(ErrorRecord::FAULT_NOT_ACTIVE, result.error);
+
+	// without a safe control mode a fault fails the step
+	ha->initialize(0.0);
+	result = ha->tryStep(0.0, control);
+	EXPECT_FALSE(result.ok());
+	EXPECT_EQ(ErrorRecord::FAULT_JUMP_CONDITION, result.error);
+	EXPECT_EQ("run", ha->getCurrentControlMode()->getName());
+
+	// with a safe control mode the fault is reported and the safe mode computes the output
+	ha = createAutomaton(false);
+	ErrorQueue::Ptr queue(new ErrorQueue);
+	ha->setErrorQueue(queue);
+	EXPECT_ANY_THROW(ha->setSafeControlMode("unknown"));
+	ha->setSafeControlMode("hold");
+	ha->initialize(0.0);
+
+	result = ha->tryStep(0.1, control);
+	EXPECT_TRUE(result.ok());
+	EXPECT_EQ(StepResult::STEP_SAFE_MODE, result.status);
+	EXPECT_EQ(ErrorRecord::FAULT_JUMP_CONDITION, result.error);
+	EXPECT_EQ("hold", ha->getCurrentControlMode()->getName());
+	EXPECT_DOUBLE_EQ(3.0, control(0, 0));
+
+	ErrorRecord record;
+	ASSERT_TRUE(queue->pop(record));
+	EXPECT_EQ(ErrorRecord::FAULT_JUMP_CONDITION, record.code);
+	EXPECT_DOUBLE_EQ(0.1, record.time);
+	EXPECT_STREQ("JumpCondition.isActive", record.origin);
+	EXPECT_FALSE(queue->pop(record));
+
+	// the automaton stays in the safe control mode
+	result = ha->tryStep(0.2, control);
+	EXPECT_EQ(StepResult::STEP_SAFE_MODE, result.status);
+	EXPECT_DOUBLE_EQ(3.0, control(0, 0));
+
+	// errors thrown by controllers are caught at the boundary
+	ha = createAutomaton(true);
+	ha->setSafeControlMode("hold");
+	ha->initialize(0.0);
+	result = ha->tryStep(0.0, control);
+	EXPECT_EQ(StepResult::STEP_SAFE_MODE, result.status);
+	EXPECT_EQ(ErrorRecord::FAULT_EXCEPTION, result.error);
+	EXPECT_STREQ("controller diverged", ha->getLastError().message);
+	EXPECT_DOUBLE_EQ(3.0, control(0, 0));
+}
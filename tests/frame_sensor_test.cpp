@@ -0,0 +1,79 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "hybrid_automaton/FramePoseSensor.h"
+#include "hybrid_automaton/FrameDisplacementSensor.h"
+#include "hybrid_automaton/FrameOrientationSensor.h"
+
+#include "tests/TestFixtures.h"
+
+#include <Eigen/Geometry>
+
+using namespace std;
+using namespace ha;
+
+using ::testing::Return;
+using ::testing::ReturnPointee;
+using ::testing::_;
+
+namespace FrameSensorTest {
+	::Eigen::MatrixXd makePose(double angle, const ::Eigen::Vector3d& axis, const ::Eigen::Vector3d& position)
+	{
+		::Eigen::MatrixXd pose = ::Eigen::MatrixXd::Identity(4,4);
+		pose.topLeftCorner(3,3) = ::Eigen::AngleAxisd(angle, axis.normalized()).toRotationMatrix();
+		pose.topRightCorner(3,1) = position;
+		return pose;
+	}
+}
+
+TEST(FrameSensor, RigidTransform) {
+	::Eigen::Matrix4d pose = FrameSensorTest::makePose(0.7, ::Eigen::Vector3d(1.0, -2.0, 0.5), ::Eigen::Vector3d(0.3, -1.2, 2.0));
+	::Eigen::Matrix4d other = FrameSensorTest::makePose(-1.3, ::Eigen::Vector3d(0.0, 1.0, 1.0), ::Eigen::Vector3d(-0.4, 0.1, 0.9));
+
+	::Eigen::Matrix4d inverse, product;
+	FrameSensor::invertRigidTransform(pose, inverse);
+	EXPECT_TRUE(inverse.isApprox(pose.inverse(), 1e-12));
+
+	FrameSensor::composeRigidTransforms(pose, other, product);
+	EXPECT_TRUE(product.isApprox(pose * other, 1e-12));
+}
+
+TEST(FrameSensor, RelativeValues) {
+	using namespace FrameSensorTest;
+	boost::shared_ptr<MockSystem> ms(new MockSystem());
+
+	::Eigen::MatrixXd initial = makePose(0.4, ::Eigen::Vector3d(0.2, 1.0, -0.3), ::Eigen::Vector3d(0.5, 0.2, 1.0));
+	::Eigen::MatrixXd current = initial;
+	EXPECT_CALL(*ms, getFramePose(_))
+		.WillRepeatedly(ReturnPointee(&current));
+
+	FramePoseSensor pose_sensor;
+	FrameDisplacementSensor displacement_sensor;
+	FrameOrientationSensor orientation_sensor;
+	pose_sensor.setSystem(ms);
+	displacement_sensor.setSystem(ms);
+	orientation_sensor.setSystem(ms);
+
+	pose_sensor.initialize(0.0);
+	displacement_sensor.initialize(0.0);
+	orientation_sensor.initialize(0.0);
+
+	EXPECT_TRUE(pose_sensor.getInitialValue().isApprox(initial));
+	EXPECT_TRUE(displacement_sensor.getInitialValue().isApprox(initial.topRightCorner(3,1)));
+	EXPECT_TRUE(orientation_sensor.getInitialValue().isApprox(initial.topLeftCorner(3,3)));
+
+	current = makePose(-0.9, ::Eigen::Vector3d(1.0, 0.0, 0.3), ::Eigen::Vector3d(-0.1, 0.7, 0.4));
+	::Eigen::MatrixXd relative = initial.inverse() * current;
+
+	EXPECT_TRUE(pose_sensor.getCurrentValue().isApprox(current));
+	EXPECT_TRUE(pose_sensor.getRelativeCurrentValue().isApprox(relative, 1e-12));
+	EXPECT_TRUE(displacement_sensor.getCurrentValue().isApprox(current.topRightCorner(3,1)));
+	EXPECT_TRUE(displacement_sensor.getRelativeCurrentValue().isApprox(relative.topRightCorner(3,1), 1e-12));
+	EXPECT_TRUE(orientation_sensor.getCurrentValue().isApprox(current.topLeftCorner(3,3)));
+	EXPECT_TRUE(orientation_sensor.getRelativeCurrentValue().isApprox(relative.topLeftCorner(3,3), 1e-12));
+
+	// the initial pose and the frame id survive cloning
+	FramePoseSensor::Ptr copy = pose_sensor.clone();
+	EXPECT_EQ(pose_sensor.getFrameId(), copy->getFrameId());
+	EXPECT_TRUE(copy->getRelativeCurrentValue().isApprox(relative, 1e-12));
+}
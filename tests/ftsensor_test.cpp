@@ -5,6 +5,8 @@
 #include "hybrid_automaton/Controller.h"
 #include "hybrid_automaton/ForceTorqueSensor.h"
 
+#include <Eigen/Geometry>
+
 #include "tests/MockDescriptionTree.h"
 #include "tests/MockDescriptionTreeNode.h"
 
@@ -12,6 +14,7 @@ using namespace std;
 using namespace ha;
 
 using ::testing::Return;
+using ::testing::ReturnPointee;
 using ::testing::DoAll;
 using ::testing::SetArgReferee;
 using ::testing::AtLeast;
@@ -118,4 +121,64 @@ TEST(ForceTorqueSensor, FrameId) {
 
 
 
+}
+
+TEST(ForceTorqueSensor, WrenchTransform) {
+    ForceTorqueSensorTest::MockSystem* _ms = new ForceTorqueSensorTest::MockSystem();
+    System::ConstPtr ms(_ms);
+
+    ::Eigen::MatrixXd wrench0(6,1), wrench1(6,1);
+    wrench0 << 1.0, 2.0, 3.0, 4.0, 5.0, 6.0;
+    wrench1 << -1.0, 0.5, 2.0, 0.0, -3.0, 1.0;
+    EXPECT_CALL(*_ms, getForceTorqueMeasurement(0))
+        .WillRepeatedly(Return(wrench0));
+    EXPECT_CALL(*_ms, getForceTorqueMeasurement(1))
+        .WillRepeatedly(Return(wrench1));
+
+    ::Eigen::MatrixXd eePose = ::Eigen::MatrixXd::Identity(4,4);
+    eePose.topLeftCorner(3,3) = ::Eigen::AngleAxisd(0.6, ::Eigen::Vector3d(0.0, 1.0, 1.0).normalized()).toRotationMatrix();
+    eePose.topRightCorner(3,1) << 0.3, -0.2, 0.8;
+    EXPECT_CALL(*_ms, getFramePose(std::string("EE")))
+        .WillRepeatedly(ReturnPointee(&eePose));
+
+    ::Eigen::MatrixXd frame = ::Eigen::MatrixXd::Identity(4,4);
+    frame.topLeftCorner(3,3) = ::Eigen::AngleAxisd(-1.1, ::Eigen::Vector3d(1.0, 0.0, 0.0)).toRotationMatrix();
+    frame.topRightCorner(3,1) << 0.0, 0.1, -0.5;
+
+    // reference implementation: f' = R^T f, m' = R^T (m - p x f')
+    struct Reference {
+        static ::Eigen::MatrixXd transform(const ::Eigen::MatrixXd& wrench, const ::Eigen::MatrixXd& t) {
+            ::Eigen::Matrix3d rot = t.topLeftCorner(3,3);
+            ::Eigen::Vector3d trans = t.topRightCorner(3,1);
+            ::Eigen::Vector3d force = rot.transpose() * wrench.topRows(3);
+            ::Eigen::Vector3d moment = rot.transpose() * (::Eigen::Vector3d(wrench.bottomRows(3)) - trans.cross(force));
+            ::Eigen::MatrixXd ret(6,1);
+            ret << force, moment;
+            return ret;
+        }
+    };
+
+    ForceTorqueSensor ftsensor;
+    ftsensor.setSystem(ms);
+    ftsensor.setFrameId("world");
+    ftsensor.setFrame(frame);
+
+    EXPECT_TRUE(ftsensor.getCurrentValue().isApprox(Reference::transform(Reference::transform(wrench0, eePose.inverse()), frame), 1e-12));
+
+    // the cached transformation follows the EE pose
+    eePose.topRightCorner(3,1) << -0.4, 0.0, 1.2;
+    EXPECT_TRUE(ftsensor.getCurrentValue().isApprox(Reference::transform(Reference::transform(wrench0, eePose.inverse()), frame), 1e-12));
+
+    // batched read of several ports
+    std::vector<int> ports;
+    ports.push_back(0);
+    ports.push_back(1);
+    ftsensor.setPorts(ports);
+    ::Eigen::MatrixXd ret = ftsensor.getCurrentValue();
+    ASSERT_EQ(12, ret.rows());
+    EXPECT_TRUE(ret.topRows(6).isApprox(Reference::transform(Reference::transform(wrench0, eePose.inverse()), frame), 1e-12));
+    EXPECT_TRUE(ret.bottomRows(6).isApprox(Reference::transform(Reference::transform(wrench1, eePose.inverse()), frame), 1e-12));
+
+    ports.push_back(3);
+    EXPECT_ANY_THROW(ftsensor.setPorts(ports));
 }
@@ -0,0 +1,76 @@
+#include "gtest/gtest.h"
+
+#include "hybrid_automaton/HybridAutomaton.h"
+#include "hybrid_automaton/HierarchicalControlMode.h"
+
+#include "tests/TestFixtures.h"
+
+using namespace ha;
+
+namespace HierarchicalControlModeTest {
+	// a control switch that counts its evaluations and becomes active at a given time
+	class TestControlSwitch : public ha::ControlSwitch {
+	public:
+		TestControlSwitch(const double& switching_time): _switching_time(switching_time), _time(0.0), _evaluations(0) {};
+		virtual void step(const double& t) { _time = t; _evaluations++; }
+		virtual bool isActive() const { return _time >= _switching_time; }
+		double _switching_time;
+		double _time;
+		int _evaluations;
+	};
+}
+
+TEST(HierarchicalControlMode, Step) {
+	using namespace HierarchicalControlModeTest;
+
+	// grasp: approach -> close at 0.2
+	HybridAutomaton::Ptr sub(new HybridAutomaton);
+	sub->addControlMode(ControlMode::Ptr(new TestControlMode("approach", 1.0)));
+	sub->addControlMode(ControlMode::Ptr(new TestControlMode("close", 2.0)));
+	sub->addControlSwitch("approach", ControlSwitch::Ptr(new TestControlSwitch(0.2)), "close");
+	sub->setCurrentControlMode("approach");
+
+	HierarchicalControlMode::Ptr grasp(new HierarchicalControlMode("grasp"));
+	EXPECT_ANY_THROW(grasp->setSubAutomaton(HybridAutomaton::Ptr(new HybridAutomaton)));
+	grasp->setSubAutomaton(sub);
+	EXPECT_EQ("approach", grasp->getInitialControlMode());
+
+	// one shared exit for all sub-modes
+	boost::shared_ptr<TestControlSwitch> timeout(new TestControlSwitch(0.5));
+	HybridAutomaton ha;
+	ha.addControlMode(grasp);
+	ha.addControlMode(ControlMode::Ptr(new TestControlMode("retreat", 3.0)));
+	ha.addControlSwitch("grasp", timeout, "retreat");
+	ha.setCurrentControlMode("grasp");
+	ha.initialize(0.0);
+
+	EXPECT_DOUBLE_EQ(1.0, ha.step(0.0)(0, 0));
+	EXPECT_DOUBLE_EQ(1.0, ha.step(0.1)(0, 0));
+	EXPECT_DOUBLE_EQ(2.0, ha.step(0.2)(0, 0));
+	EXPECT_EQ("close", grasp->getCurrentSubControlMode()->getName());
+
+	::Eigen::MatrixXd control;
+	EXPECT_TRUE(ha.tryStep(0.3, control).ok());
+	EXPECT_DOUBLE_EQ(2.0, control(0, 0));
+
+	// the shared switch is evaluated once per control cycle
+	EXPECT_EQ(4, timeout->_evaluations);
+
+	EXPECT_DOUBLE_EQ(3.0, ha.step(0.5)(0, 0));
+	EXPECT_EQ("retreat", ha.getCurrentControlMode()->getName());
+	EXPECT_FALSE(sub->isActive());
+
+	// entering the super-mode again starts in the initial sub-mode
+	grasp->initialize();
+	EXPECT_EQ("approach", grasp->getCurrentSubControlMode()->getName());
+	grasp->step(0.6);
+	EXPECT_TRUE(sub->isActive());
+	grasp->terminate();
+
+	// a clone has its own nested automaton
+	ControlMode::Ptr clone = grasp->clone();
+	HierarchicalControlMode::Ptr hierarchical_clone = boost::dynamic_pointer_cast<HierarchicalControlMode>(clone);
+	ASSERT_TRUE(hierarchical_clone);
+	EXPECT_NE(sub, hierarchical_clone->getSubAutomaton());
+	EXPECT_EQ("approach", hierarchical_clone->getInitialControlMode());
+}
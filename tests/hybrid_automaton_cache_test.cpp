@@ -0,0 +1,122 @@
+#include "gtest/gtest.h"
+
+#include "hybrid_automaton/HybridAutomatonCache.h"
+
+#include "tests/TestFixtures.h"
+
+#include <sstream>
+
+using namespace ha;
+
+namespace HybridAutomatonCacheTest {
+	std::string controlMode(const std::string& name) {
+		return "<ControlMode name=\"" + name + "\"><ControlSet type=\"Set\" name=\"" + name + "_set\">"
+			"<Controller type=\"Ctrl\" name=\"" + name + "_ctrl\" goal=\"[3,1]1;1;1\" kp=\"[3,1]1;1;1\" kv=\"[3,1]0;0;0\" completion_times=\"[1,1]1\" priority=\"0\"/>"
+			"</ControlSet></ControlMode>";
+	}
+
+	// both switches use the same filtered clock sensor
+	std::string description(const std::string& name) {
+		const std::string clock = "<JumpCondition goal=\"[1,1]1\" jump_criterion=\"THRESH_UPPER_BOUND\" epsilon=\"0\">"
+			"<Sensor type=\"ClockSensor\"><Filter type=\"lowpass\" cutoff=\"20\"/></Sensor></JumpCondition>";
+		return "<HybridAutomaton name=\"" + name + "\" current_control_mode=\"start\">"
+			+ controlMode("start") + controlMode("b")
+			+ "<ControlSwitch name=\"start_to_b\" source=\"start\" target=\"b\">"
+			+ "<JumpCondition controller=\"start_ctrl\" jump_criterion=\"NORM_L2\" epsilon=\"0.1\"><Sensor type=\"JointConfigurationSensor\"/></JumpCondition>"
+			+ clock + "</ControlSwitch>"
+			+ "<ControlSwitch name=\"b_to_start\" source=\"b\" target=\"start\">" + clock + "</ControlSwitch>"
+			+ "</HybridAutomaton>";
+	}
+
+	std::vector<JumpConditionPtr> jumpConditions(const HybridAutomaton::Ptr& ha, const std::string& control_switch) {
+		return boost::const_pointer_cast<ControlSwitch>(ha->getControlSwitchByName(control_switch))->getJumpConditions();
+	}
+
+	std::string toXML(const HybridAutomaton::Ptr& ha) {
+		std::ostringstream out;
+		ha->serialize(out);
+		return out.str();
+	}
+}
+
+TEST(HybridAutomatonCache, Clones) {
+	using namespace HybridAutomatonCacheTest;
+
+	HybridAutomatonCache cache(System::ConstPtr(new TestSystem));
+	cache.setDeserializeDefaultEntities(true);
+	const std::string xml = description("cached");
+
+	HybridAutomaton::Ptr first = cache.get(xml);
+	HybridAutomaton::Ptr second = cache.get(xml);
+	HybridAutomatonCache::Statistics statistics = cache.getStatistics();
+	EXPECT_EQ(1u, statistics.hits);
+	EXPECT_EQ(1u, statistics.misses);
+	EXPECT_EQ(1u, statistics.entries);
+	EXPECT_LT(xml.size(), statistics.memory);
+
+	// equal automata that share no state
+	EXPECT_EQ(toXML(first), toXML(second));
+	EXPECT_EQ("start", second->getCurrentControlMode()->getName());
+	EXPECT_NE(first->getCurrentControlMode(), second->getCurrentControlMode());
+	EXPECT_NE(first->getCurrentControlMode()->getControlSet(), second->getCurrentControlMode()->getControlSet());
+	EXPECT_NE(first->getControllerByName("start", "start_ctrl"), second->getControllerByName("start", "start_ctrl"));
+
+	std::vector<JumpConditionPtr> first_start_to_b = jumpConditions(first, "start_to_b");
+	std::vector<JumpConditionPtr> second_start_to_b = jumpConditions(second, "start_to_b");
+	ASSERT_EQ(2u, first_start_to_b.size());
+	EXPECT_NE(first_start_to_b[0], second_start_to_b[0]);
+	EXPECT_NE(first_start_to_b[0]->getSensor(), second_start_to_b[0]->getSensor());
+
+	// the controller goal refers to the clone's controller, the filtered sensor is still shared
+	EXPECT_EQ(first->getControllerByName("start", "start_ctrl"), first_start_to_b[0]->getGoalController());
+	EXPECT_EQ(second->getControllerByName("start", "start_ctrl"), second_start_to_b[0]->getGoalController());
+	EXPECT_EQ(first_start_to_b[1]->getSensor(), jumpConditions(first, "b_to_start")[0]->getSensor());
+	EXPECT_NE(first_start_to_b[1]->getSensor(), second_start_to_b[1]->getSensor());
+
+	// the switches know their new automaton
+	EXPECT_EQ("start", second->getSourceControlMode("start_to_b")->getName());
+	EXPECT_EQ(second->getControlModeByName("b"), second->getTargetControlMode("start_to_b"));
+}
+
+TEST(HybridAutomatonCache, Eviction) {
+	using namespace HybridAutomatonCacheTest;
+
+	HybridAutomatonCache cache(System::ConstPtr(new TestSystem), 0);
+	cache.setDeserializeDefaultEntities(true);
+
+	// nothing fits
+	cache.get(description("x1"));
+	cache.get(description("x1"));
+	EXPECT_EQ(2u, cache.getStatistics().misses);
+	EXPECT_EQ(0u, cache.getStatistics().entries);
+
+	// two descriptions fit
+	cache.setMemoryBudget(1024 * 1024);
+	cache.get(description("x1"));
+	std::size_t memory = cache.getStatistics().memory;
+	cache.setMemoryBudget(2 * memory);
+	cache.get(description("x2"));
+	cache.get(description("x1"));
+	cache.get(description("x3"));
+	HybridAutomatonCache::Statistics statistics = cache.getStatistics();
+	EXPECT_EQ(2u, statistics.entries);
+	EXPECT_EQ(1u, statistics.evictions);
+	EXPECT_EQ(2 * memory, statistics.memory);
+
+	// x2 was the least recently used
+	cache.get(description("x1"));
+	cache.get(description("x3"));
+	EXPECT_EQ(statistics.hits + 2, cache.getStatistics().hits);
+	cache.get(description("x2"));
+	EXPECT_EQ(statistics.misses + 1, cache.getStatistics().misses);
+	EXPECT_EQ("x2", cache.get(description("x2"))->getName());
+
+	// failures are not cached
+	EXPECT_ANY_THROW(cache.get("<HybridAutomaton"));
+	EXPECT_EQ(2u, cache.getStatistics().entries);
+
+	cache.clear();
+	EXPECT_EQ(0u, cache.getStatistics().entries);
+	EXPECT_EQ(0u, cache.getStatistics().memory);
+	EXPECT_NE(HybridAutomatonCache::hash("x1"), HybridAutomatonCache::hash("x2"));
+}
@@ -146,6 +146,12 @@ TEST(HybridAutomaton, DeserializationOnlyControlMode) {
 		.WillRepeatedly(DoAll(SetArgReferee<1>("CM1"),Return(true)));
 	EXPECT_CALL(*cm1_node, getChildrenNodes(std::string("ControlSet"), _))
 		.WillRepeatedly(DoAll(SetArgReferee<1>(cset_list),Return(true)));
+	EXPECT_CALL(*cm1_node, getChildrenNodes(std::string("Watchdog"), _))
+		.WillRepeatedly(Return(false));
+	EXPECT_CALL(*cm1_node, getChildrenNodes(std::string("HybridAutomaton"), _))
+		.WillRepeatedly(Return(false));
+	EXPECT_CALL(*cm1_node, getChildrenNodes(std::string("Region"), _))
+		.WillRepeatedly(Return(false));
 
 	cm_list.push_back(cm1_node);
 
@@ -226,6 +232,12 @@ protected:
 			.WillRepeatedly(DoAll(SetArgReferee<1>("CM1"),Return(true)));
 		EXPECT_CALL(*cm1_node, getChildrenNodes(std::string("ControlSet"), _))
 			.WillRepeatedly(DoAll(SetArgReferee<1>(cset_list),Return(true)));
+		EXPECT_CALL(*cm1_node, getChildrenNodes(std::string("Watchdog"), _))
+			.WillRepeatedly(Return(false));
+		EXPECT_CALL(*cm1_node, getChildrenNodes(std::string("HybridAutomaton"), _))
+			.WillRepeatedly(Return(false));
+		EXPECT_CALL(*cm1_node, getChildrenNodes(std::string("Region"), _))
+			.WillRepeatedly(Return(false));
 
 		cm2_node.reset(new MockDescriptionTreeNode);
 		EXPECT_CALL(*cm2_node, getType())
@@ -234,6 +246,12 @@ protected:
 			.WillRepeatedly(DoAll(SetArgReferee<1>("CM2"),Return(true)));
 		EXPECT_CALL(*cm2_node, getChildrenNodes(std::string("ControlSet"), _))
 			.WillRepeatedly(DoAll(SetArgReferee<1>(cset_list),Return(true)));
+		EXPECT_CALL(*cm2_node, getChildrenNodes(std::string("Watchdog"), _))
+			.WillRepeatedly(Return(false));
+		EXPECT_CALL(*cm2_node, getChildrenNodes(std::string("HybridAutomaton"), _))
+			.WillRepeatedly(Return(false));
+		EXPECT_CALL(*cm2_node, getChildrenNodes(std::string("Region"), _))
+			.WillRepeatedly(Return(false));
 
 		cm_list.push_back(cm1_node);
 		cm_list.push_back(cm2_node);
@@ -244,6 +262,12 @@ protected:
 			.WillRepeatedly(Return("ControlSwitch"));
 		EXPECT_CALL(*cs_node, getAttributeString(std::string("name"), _))
 			.WillRepeatedly(DoAll(SetArgReferee<1>(""),Return(true)));
+		EXPECT_CALL(*cs_node, getAttributeString(std::string("evaluation_rate"), _))
+			.WillRepeatedly(Return(false));
+		EXPECT_CALL(*cs_node, getAttributeString(std::string("expression"), _))
+			.WillRepeatedly(Return(false));
+		EXPECT_CALL(*cs_node, getAttributeString(std::string("priority"), _))
+			.WillRepeatedly(Return(false));
 
 		cs_list.push_back(cs_node);
 
@@ -269,6 +293,14 @@ protected:
 			.WillRepeatedly(Return(false));
         EXPECT_CALL(*js_node, getAttributeString(std::string("negate"), _))
             .WillRepeatedly(Return(false));
+		EXPECT_CALL(*js_node, getAttributeString(std::string("hold_ticks"), _))
+			.WillRepeatedly(Return(false));
+		EXPECT_CALL(*js_node, getAttributeString(std::string("hold_time"), _))
+			.WillRepeatedly(Return(false));
+		EXPECT_CALL(*js_node, getAttributeString(std::string("hysteresis"), _))
+			.WillRepeatedly(Return(false));
+		EXPECT_CALL(*js_node, getAttributeString(std::string("filter"), _))
+			.WillRepeatedly(Return(false));
 
 		js_list.push_back(js_node);
 
@@ -291,6 +323,8 @@ protected:
 			.WillRepeatedly(DoAll(SetArgReferee<1>("MyHA"),Return(true)));
 		EXPECT_CALL(*ha_node, getAttributeString(std::string("current_control_mode"), _))
 			.WillRepeatedly(DoAll(SetArgReferee<1>("CM1"),Return(true)));
+		EXPECT_CALL(*ha_node, getAttributeString(std::string("safe_control_mode"), _))
+			.WillRepeatedly(Return(false));
 		
 		EXPECT_CALL(*ha_node, getChildrenNodes(std::string("ControlMode"), _))
 			.WillRepeatedly(DoAll(SetArgReferee<1>(cm_list),Return(true)));
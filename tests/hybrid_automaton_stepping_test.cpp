@@ -7,6 +7,11 @@
 #include "hybrid_automaton/ControlMode.h"
 #include "hybrid_automaton/ControlSwitch.h"
 
+#include <boost/thread.hpp>
+
+#include <sstream>
+#include <stdexcept>
+
 
 using namespace std;
 
@@ -19,6 +24,39 @@ class TestControlMode : public ha::ControlMode {
 	virtual void initialize() {};
 	virtual void terminate() {};
 	virtual ::Eigen::MatrixXd step(const double& t)	{ return ::Eigen::MatrixXd(0,0); }
+	virtual void switchControlMode(ha::ControlMode::Ptr otherMode) {};
+};
+
+// ----------------------------------
+// a control switch that counts its evaluations and becomes active at a given time
+class TestControlSwitch : public ha::ControlSwitch {
+
+  public:
+	TestControlSwitch(const double& switching_time): _switching_time(switching_time), _time(0.0), _evaluations(0) {};
+	virtual void step(const double& t) { _time = t; _evaluations++; }
+	virtual bool isActive() const { return _time >= _switching_time; }
+	int getEvaluations() const { return _evaluations; }
+
+  protected:
+	double _switching_time;
+	double _time;
+	int _evaluations;
+};
+
+// ----------------------------------
+// a control switch that throws something else than a std::string when it is evaluated
+class ThrowingControlSwitch : public ha::ControlSwitch {
+
+  public:
+	ThrowingControlSwitch(bool std_exception): _std_exception(std_exception) {};
+	virtual void step(const double& t) {
+		if (_std_exception)
+			throw std::runtime_error("sensor disconnected");
+		throw 42;
+	}
+
+  protected:
+	bool _std_exception;
 };
 
 using namespace ha;
@@ -80,6 +118,151 @@ TEST_F(HybridAutomatonTest, step) {
     ASSERT_TRUE(expected_result == hybrid_automaton->step(0.0));
 }
 
+TEST(HybridAutomatonMultiRate, evaluationRate) {
+	TestControlMode::Ptr m1(new TestControlMode("m1"));
+	TestControlMode::Ptr m2(new TestControlMode("m2"));
+	boost::shared_ptr<TestControlSwitch> s1(new TestControlSwitch(0.5));
+	s1->setEvaluationRate(100.0);
+
+	HybridAutomaton ha;
+	ha.addControlMode(m1);
+	ha.addControlMode(m2);
+	ha.addControlSwitch(m1->getName(), s1, m2->getName());
+
+	ASSERT_NO_THROW(ha.setCurrentControlMode("m1"));
+	ASSERT_NO_THROW(ha.initialize(0.0));
+
+	// step at 1kHz for 0.3s: the switch must only be evaluated at 100Hz
+	for (int i = 0; i < 300; i++)
+		ha.step(i * 0.001);
+	EXPECT_EQ(30, s1->getEvaluations());
+	EXPECT_TRUE(m1 == ha.getCurrentControlMode());
+
+	// the transition happens in the first evaluation after the switching time
+	for (int i = 300; i <= 505; i++)
+		ha.step(i * 0.001);
+	EXPECT_TRUE(m2 == ha.getCurrentControlMode());
+	EXPECT_TRUE(s1 == ha.getLastActiveControlSwitch());
+}
+
+TEST(HybridAutomatonMultiRate, asynchronousSupervision) {
+	TestControlMode::Ptr m1(new TestControlMode("m1"));
+	TestControlMode::Ptr m2(new TestControlMode("m2"));
+	boost::shared_ptr<TestControlSwitch> s1(new TestControlSwitch(0.5));
+
+	HybridAutomaton ha;
+	ha.addControlMode(m1);
+	ha.addControlMode(m2);
+	ha.addControlSwitch(m1->getName(), s1, m2->getName());
+	ha.setAsynchronousSupervision(true);
+
+	ASSERT_NO_THROW(ha.setCurrentControlMode("m1"));
+	ASSERT_NO_THROW(ha.initialize(0.0));
+
+	// cannot change the supervision while running
+	EXPECT_ANY_THROW(ha.setAsynchronousSupervision(false));
+
+	// before the switching time no transition must be applied
+	for (int i = 0; i < 100; i++)
+		ha.step(i * 0.001);
+	EXPECT_TRUE(m1 == ha.getCurrentControlMode());
+
+	// after the switching time the transition arrives after some cycles - wait for it
+	for (int i = 0; i < 10000 && ha.getCurrentControlMode() == m1; i++) {
+		ha.step(0.5);
+		boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+	}
+	EXPECT_TRUE(m2 == ha.getCurrentControlMode());
+	EXPECT_TRUE(s1 == ha.getLastActiveControlSwitch());
+
+	ASSERT_NO_THROW(ha.terminate());
+	EXPECT_NO_THROW(ha.setAsynchronousSupervision(false));
+}
+
+TEST(HybridAutomatonMultiRate, asynchronousSupervisionFailure) {
+	for (int std_exception = 0; std_exception < 2; std_exception++) {
+		TestControlMode::Ptr m1(new TestControlMode("m1"));
+		TestControlMode::Ptr m2(new TestControlMode("m2"));
+		ControlSwitch::Ptr s1(new ThrowingControlSwitch(std_exception != 0));
+
+		HybridAutomaton ha;
+		ha.addControlMode(m1);
+		ha.addControlMode(m2);
+		ha.addControlSwitch(m1->getName(), s1, m2->getName());
+		ha.setAsynchronousSupervision(true);
+		ASSERT_NO_THROW(ha.setCurrentControlMode("m1"));
+		ASSERT_NO_THROW(ha.initialize(0.0));
+
+		// the supervision thread must report the exception instead of terminating the process
+		::Eigen::MatrixXd control;
+		StepResult result;
+		for (int i = 0; i < 10000 && result.ok(); i++) {
+			result = ha.tryStep(i * 0.001, control);
+			boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+		}
+		EXPECT_EQ(StepResult::STEP_FAILED, result.status);
+		EXPECT_EQ(ErrorRecord::FAULT_SUPERVISION, result.error);
+		EXPECT_ANY_THROW(ha.step(1.0));
+
+		ASSERT_NO_THROW(ha.terminate());
+	}
+}
+
+TEST(HybridAutomatonMultiRate, switchPriorities) {
+	TestControlMode::Ptr m1(new TestControlMode("m1"));
+	TestControlMode::Ptr m2(new TestControlMode("m2"));
+	TestControlMode::Ptr m3(new TestControlMode("m3"));
+	boost::shared_ptr<TestControlSwitch> first(new TestControlSwitch(0.0));
+	boost::shared_ptr<TestControlSwitch> urgent(new TestControlSwitch(0.1));
+	boost::shared_ptr<TestControlSwitch> never(new TestControlSwitch(1e6));
+	first->setName("first");
+	urgent->setName("urgent");
+	never->setName("never");
+	urgent->setPriority(5);
+	never->setPriority(10);
+
+	// "first" is added first and is active right away, but "never" and "urgent" are evaluated before it
+	HybridAutomaton ha;
+	ha.addControlMode(m1);
+	ha.addControlMode(m2);
+	ha.addControlMode(m3);
+	ha.addControlSwitch(m1->getName(), first, m2->getName());
+	ha.addControlSwitch(m1->getName(), urgent, m3->getName());
+	ha.addControlSwitch(m1->getName(), never, m3->getName());
+
+	ASSERT_NO_THROW(ha.setCurrentControlMode("m1"));
+	ASSERT_NO_THROW(ha.initialize(0.0));
+
+	ha.step(0.1);
+	EXPECT_TRUE(m3 == ha.getCurrentControlMode());
+	EXPECT_TRUE(urgent == ha.getLastActiveControlSwitch());
+	EXPECT_EQ(0, first->getEvaluations());
+	EXPECT_EQ(1u, never->getNumberOfEvaluations());
+	EXPECT_EQ(0u, never->getNumberOfActivations());
+	EXPECT_EQ(1u, urgent->getNumberOfEvaluations());
+	EXPECT_EQ(1u, urgent->getNumberOfActivations());
+	EXPECT_EQ(0u, first->getNumberOfEvaluations());
+
+	// equal priorities keep the insertion order
+	urgent->setPriority(0);
+	never->setPriority(0);
+	ha.setCurrentControlMode("m1");
+	ha.initialize(0.2);
+	ha.step(0.2);
+	EXPECT_TRUE(m2 == ha.getCurrentControlMode());
+	EXPECT_EQ(1u, first->getNumberOfActivations());
+	EXPECT_EQ(1u, never->getNumberOfEvaluations());
+
+	std::ostringstream report;
+	ha.reportControlSwitchStatistics(report);
+	EXPECT_NE(std::string::npos, report.str().find("urgent (priority 0): 1 / 1 (100%)"));
+	EXPECT_LT(report.str().find("first"), report.str().find("urgent"));
+
+	ha.resetControlSwitchStatistics();
+	EXPECT_EQ(0u, urgent->getNumberOfEvaluations());
+	EXPECT_EQ(0u, first->getNumberOfActivations());
+}
+
 //TEST_F(HybridAutomatonTest, stepAndSwitch) {
 //	double switching_time = 1.0;
 //	TimeConditionPtr time_switch(new TimeCondition(switching_time));
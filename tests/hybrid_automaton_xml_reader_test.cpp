@@ -0,0 +1,182 @@
+#include "gtest/gtest.h"
+
+#include "hybrid_automaton/HybridAutomaton.h"
+#include "hybrid_automaton/HybridAutomatonXMLReader.h"
+#include "hybrid_automaton/DescriptionTreeNodeStream.h"
+#include "hybrid_automaton/DescriptionTreeStream.h"
+#include "hybrid_automaton/XMLStreamParser.h"
+
+#include "tests/TestFixtures.h"
+
+#include <sstream>
+
+using namespace ha;
+
+namespace HybridAutomatonXMLReaderTest {
+	// records the parse events as "<name a=v>" and "</name>"
+	class RecordingHandler : public XMLStreamHandler {
+	public:
+		virtual void startElement(const std::string& name, const AttributeList& attributes) {
+			_events += "<" + name;
+			for (std::size_t i = 0; i < attributes.size(); ++i)
+				_events += " " + attributes[i].first + "=" + attributes[i].second;
+			_events += ">";
+		}
+		virtual void endElement(const std::string& name) { _events += "</" + name + ">"; }
+		std::string _events;
+	};
+
+	// serializes into DescriptionTreeNodeStreams
+	class StreamTree : public DescriptionTree {
+	public:
+		virtual DescriptionTreeNode::Ptr getRootNode() { return DescriptionTreeNode::Ptr(); }
+		virtual void setRootNode(const DescriptionTreeNode::Ptr& root_node) {}
+		virtual DescriptionTreeNode::Ptr createNode(const std::string& type) const { return DescriptionTreeNode::Ptr(new DescriptionTreeNodeStream(type)); }
+	};
+
+	std::string controlMode(const std::string& name) {
+		return "<ControlMode name=\"" + name + "\"><ControlSet type=\"Set\" name=\"" + name + "_set\">"
+			"<Controller type=\"Ctrl\" name=\"" + name + "_ctrl\" goal=\"[3,1]1;1;1\" kp=\"[3,1]1;1;1\" kv=\"[3,1]0;0;0\" completion_times=\"[1,1]1\" priority=\"0\"/>"
+			"</ControlSet></ControlMode>";
+	}
+
+	std::string clockSwitch(const std::string& name, const std::string& source, const std::string& target) {
+		return "<ControlSwitch name=\"" + name + "\" source=\"" + source + "\" target=\"" + target + "\">"
+			"<JumpCondition goal=\"[1,1]1\" jump_criterion=\"THRESH_UPPER_BOUND\" epsilon=\"0\"><Sensor type=\"ClockSensor\"/></JumpCondition>"
+			"</ControlSwitch>";
+	}
+}
+
+TEST(XMLStreamParser, Events) {
+	using namespace HybridAutomatonXMLReaderTest;
+
+	std::string xml =
+		"<?xml version=\"1.0\"?>\n"
+		"<!DOCTYPE ha [ <!ELEMENT ha ANY> ]>\n"
+		"<!-- a comment with -- inside --->\n"
+		"<ha name='x &amp; y' goal=\"&lt;&#65;&#x42;&gt;\">\n"
+		"\t<a/>text<![CDATA[<b>]]]]><b  c = \"1\" ></b>\n"
+		"</ha>\n";
+
+	// tiny buffers split every token across reads
+	for (std::size_t buffer_size = 1; buffer_size < 8; buffer_size += 3)
+	{
+		RecordingHandler handler;
+		XMLStreamParser parser(buffer_size);
+		parser.parse(xml, handler);
+		EXPECT_EQ("<ha name=x & y goal=<AB>><a></a><b c=1></b></ha>", handler._events) << buffer_size;
+	}
+
+	RecordingHandler handler;
+	XMLStreamParser parser;
+	EXPECT_ANY_THROW(parser.parse("", handler));
+	EXPECT_ANY_THROW(parser.parse("<a><b></a>", handler));
+	EXPECT_ANY_THROW(parser.parse("<a>", handler));
+	EXPECT_ANY_THROW(parser.parse("<a/><b/>", handler));
+	EXPECT_ANY_THROW(parser.parse("<a x=\"1\" x=\"2\"/>", handler));
+	EXPECT_ANY_THROW(parser.parse("<a x=\"&nbsp;\"/>", handler));
+	EXPECT_ANY_THROW(parser.parse("<a x=1/>", handler));
+	EXPECT_ANY_THROW(parser.parse("<a><!-- open </a>", handler));
+}
+
+TEST(HybridAutomatonXMLReader, Read) {
+	using namespace HybridAutomatonXMLReaderTest;
+
+	// "start_to_a" refers to a mode further down and is deferred - together with "start_to_b"
+	std::string xml =
+		"<?xml version=\"1.0\"?>\n"
+		"<HybridAutomaton name=\"reader\" current_control_mode=\"start\">\n"
+		+ controlMode("start") + controlMode("b")
+		+ clockSwitch("start_to_a", "start", "a")
+		+ clockSwitch("start_to_b", "start", "b")
+		+ clockSwitch("b_to_start", "b", "start")
+		+ controlMode("a") +
+		"<ControlSwitch name=\"a_to_b\" source=\"a\" target=\"b\">"
+		"<JumpCondition controller=\"a_ctrl\" jump_criterion=\"NORM_L2\" epsilon=\"0.1\"><Sensor type=\"JointConfigurationSensor\"/></JumpCondition>"
+		"</ControlSwitch>"
+		"</HybridAutomaton>\n";
+
+	HybridAutomaton ha;
+	ha.setDeserializeDefaultEntities(true);
+	HybridAutomatonXMLReader reader(System::ConstPtr(new TestSystem));
+	reader.read(xml, ha);
+
+	EXPECT_EQ("reader", ha.getName());
+	EXPECT_EQ("start", ha.getCurrentControlMode()->getName());
+	EXPECT_EQ(2u, reader.getNumberOfDeferredControlSwitches());
+	EXPECT_TRUE(ha.existsControlMode("a"));
+	EXPECT_EQ("a", ha.getTargetControlMode("start_to_a")->getName());
+	EXPECT_EQ("start", ha.getTargetControlMode("b_to_start")->getName());
+	EXPECT_TRUE(ha.getControllerByName("a", "a_ctrl"));
+
+	// the out-going switches of "start" are in document order
+	DescriptionTreeNode::ConstNodeList switches;
+	ha.serialize(DescriptionTree::ConstPtr(new StreamTree))->getChildrenNodes("ControlSwitch", switches);
+	ASSERT_EQ(4u, switches.size());
+	std::string name;
+	DescriptionTreeNode::ConstNodeList::iterator it = switches.begin();
+	(*it)->getAttribute<std::string>("name", name);
+	EXPECT_EQ("start_to_a", name);
+	(*++it)->getAttribute<std::string>("name", name);
+	EXPECT_EQ("start_to_b", name);
+}
+
+TEST(HybridAutomatonXMLReader, Errors) {
+	using namespace HybridAutomatonXMLReaderTest;
+
+	HybridAutomatonXMLReader reader(System::ConstPtr(new TestSystem));
+
+	HybridAutomaton ha;
+	ha.setDeserializeDefaultEntities(true);
+	EXPECT_ANY_THROW(reader.read("<Automaton current_control_mode=\"start\">" + controlMode("start") + "</Automaton>", ha));
+
+	HybridAutomaton ha2;
+	ha2.setDeserializeDefaultEntities(true);
+	EXPECT_ANY_THROW(reader.read("<HybridAutomaton current_control_mode=\"start\"></HybridAutomaton>", ha2));
+
+	// a switch to a mode that is never defined
+	HybridAutomaton ha3;
+	ha3.setDeserializeDefaultEntities(true);
+	EXPECT_ANY_THROW(reader.read("<HybridAutomaton current_control_mode=\"start\">" + controlMode("start")
+		+ clockSwitch("start_to_a", "start", "a") + "</HybridAutomaton>", ha3));
+
+	// truncated document
+	HybridAutomaton ha4;
+	ha4.setDeserializeDefaultEntities(true);
+	EXPECT_ANY_THROW(reader.read("<HybridAutomaton current_control_mode=\"start\">" + controlMode("start"), ha4));
+}
+
+TEST(HybridAutomatonXMLReader, StreamingWriterRoundTrip) {
+	using namespace HybridAutomatonXMLReaderTest;
+
+	std::string xml =
+		"<HybridAutomaton name=\"a&amp;b&lt;c&gt;\" current_control_mode=\"start\">"
+		+ controlMode("start") + controlMode("b")
+		+ clockSwitch("start_to_b", "start", "b")
+		+ clockSwitch("b_to_start", "b", "start")
+		+ "</HybridAutomaton>";
+
+	HybridAutomaton ha;
+	ha.setDeserializeDefaultEntities(true);
+	HybridAutomatonXMLReader reader(System::ConstPtr(new TestSystem));
+	reader.read(xml, ha);
+
+	// the streamed document equals the document written from the whole tree
+	std::ostringstream streamed;
+	ha.serialize(streamed);
+	DescriptionTreeStream::Ptr tree(new DescriptionTreeStream);
+	tree->setRootNode(ha.serialize(tree));
+	std::ostringstream written;
+	tree->writeTreeXML(written);
+	EXPECT_EQ(written.str(), streamed.str());
+	EXPECT_EQ(0u, streamed.str().find("<HybridAutomaton name=\"a&amp;b&lt;c&gt;\" current_control_mode=\"start\">\n\t<ControlMode name=\"start\">\n"));
+
+	// and reads back into the same automaton
+	HybridAutomaton copy;
+	copy.setDeserializeDefaultEntities(true);
+	reader.read(streamed.str(), copy);
+	std::ostringstream rewritten;
+	copy.serialize(rewritten);
+	EXPECT_EQ(streamed.str(), rewritten.str());
+	EXPECT_EQ("a&b<c>", copy.getName());
+}
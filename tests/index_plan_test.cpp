@@ -0,0 +1,98 @@
+#include "gtest/gtest.h"
+
+#include "hybrid_automaton/IndexPlan.h"
+#include "hybrid_automaton/SubjointConfigurationSensor.h"
+
+#include "tests/TestFixtures.h"
+
+using namespace ha;
+
+TEST(IndexPlan, Gather) {
+	std::vector<int> index;
+	index.push_back(2);
+	index.push_back(3);
+	index.push_back(4);
+	index.push_back(0);
+	index.push_back(6);
+	index.push_back(7);
+
+	IndexPlan plan(index);
+	EXPECT_EQ(6u, plan.size());
+	EXPECT_EQ(3u, plan.getNumberOfRuns());
+
+	::Eigen::MatrixXd in(8,1);
+	in << 10., 11., 12., 13., 14., 15., 16., 17.;
+	::Eigen::MatrixXd out;
+	plan.gather(in, out);
+	ASSERT_EQ(6, out.rows());
+	ASSERT_EQ(1, out.cols());
+	for(std::size_t i = 0; i < index.size(); i++)
+		EXPECT_EQ(in(index[i]), out(i));
+
+	// row vectors are gathered as well
+	::Eigen::MatrixXd in_row = in.transpose();
+	plan.gather(in_row, out);
+	for(std::size_t i = 0; i < index.size(); i++)
+		EXPECT_EQ(in(index[i]), out(i));
+
+	EXPECT_TRUE(plan.getIndexMatrix().isApprox(::Eigen::MatrixXd(::Eigen::Map< ::Eigen::VectorXi>(&index[0], index.size()).cast<double>())));
+}
+
+TEST(IndexPlan, ScatterAdd) {
+	std::vector<int> index;
+	index.push_back(4);
+	index.push_back(5);
+	index.push_back(0);
+
+	IndexPlan plan(index);
+
+	::Eigen::MatrixXd in(3,1);
+	in << 1., 2., 3.;
+	::Eigen::MatrixXd out = ::Eigen::MatrixXd::Ones(6,1);
+	plan.scatterAdd(in, out);
+
+	::Eigen::MatrixXd expected(6,1);
+	expected << 4., 1., 1., 1., 2., 3.;
+	EXPECT_TRUE(expected.isApprox(out));
+
+	// scatter is the inverse of gather
+	::Eigen::MatrixXd gathered;
+	plan.gather(out, gathered);
+	EXPECT_TRUE((in + ::Eigen::MatrixXd::Ones(3,1)).isApprox(gathered));
+}
+
+TEST(IndexPlan, Validation) {
+	::Eigen::MatrixXd index_mat(3,1);
+	index_mat << 1., 5., 3.;
+
+	IndexPlan plan;
+	plan.setIndex(index_mat);
+	EXPECT_NO_THROW(plan.validate(6));
+	EXPECT_ANY_THROW(plan.validate(5));
+
+	index_mat << 1., 5., 1.;
+	plan.setIndex(index_mat);
+	EXPECT_ANY_THROW(plan.validate(6));
+
+	index_mat << 1., 2.5, 3.;
+	EXPECT_ANY_THROW(plan.setIndex(index_mat));
+}
+
+TEST(IndexPlan, SubjointSensor) {
+	boost::shared_ptr<TestSystem> system(new TestSystem);
+	system->q << 1., 2., 3.;
+	SubjointConfigurationSensor sensor;
+	sensor.setSystem(system);
+
+	// the index is checked against the degrees of freedom before it is used
+	std::vector<int> index(2, 5);
+	index[0] = 2;
+	sensor.setIndex(index);
+	EXPECT_ANY_THROW(sensor.initialize(0.0));
+
+	index[1] = 0;
+	sensor.setIndex(index);
+	EXPECT_NO_THROW(sensor.initialize(0.0));
+	EXPECT_DOUBLE_EQ(3., sensor.getCurrentValue()(0));
+	EXPECT_DOUBLE_EQ(1., sensor.getCurrentValue()(1));
+}
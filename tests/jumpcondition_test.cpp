@@ -4,6 +4,7 @@
 #include <string>
 
 #include "hybrid_automaton/JumpCondition.h"
+#include "hybrid_automaton/ValidationReport.h"
 #include "hybrid_automaton/DescriptionTreeNode.h"
 #include "hybrid_automaton/JointConfigurationSensor.h"
 #include "hybrid_automaton/FrameOrientationSensor.h"
@@ -11,11 +12,13 @@
 #include "hybrid_automaton/FramePoseSensor.h"
 #include "tests/MockDescriptionTree.h"
 #include "tests/MockDescriptionTreeNode.h"
+#include "tests/ValueSensor.h"
 
 using ::testing::Return;
 using ::testing::DoAll;
 using ::testing::SetArgReferee;
 using ::testing::AtLeast;
+using ::testing::ReturnPointee;
 using ::testing::_;
 
 using namespace ::ha;
@@ -32,6 +35,44 @@ namespace JumpConditionSerialization1 {
 	};
 }
 
+namespace JumpConditionEvaluators {
+	::Eigen::MatrixXd pose(double angle, double x) {
+		::Eigen::MatrixXd pose = ::Eigen::MatrixXd::Identity(4,4);
+		pose.block(0,0,3,3) = ::Eigen::AngleAxisd(angle, ::Eigen::Vector3d(1.0, 2.0, 3.0).normalized()).toRotationMatrix();
+		pose(0,3) = x;
+		return pose;
+	}
+
+	// the criterion of the generic implementation (before validation) and of the specialized one (after)
+	void expectSameCriterion(JumpCondition::JumpCriterion criterion, const ::Eigen::MatrixXd& weights,
+		const ::Eigen::MatrixXd& current, const ::Eigen::MatrixXd& goal, bool specialized) {
+		ValueSensor::Ptr sensor(new ValueSensor);
+		sensor->setValue(current);
+		JumpCondition jc;
+		jc.setSensor(sensor);
+		jc.setConstantGoal(goal);
+		jc.setJumpCriterion(criterion, weights);
+		jc.initialize(0.0);
+
+		jc.isActive();
+		double generic = jc.getLastCriterionValue();
+
+		ValidationReport report;
+		jc.validate(report, "test");
+		ASSERT_TRUE(jc.areDimensionsValidated());
+		EXPECT_EQ(specialized, jc.hasSpecializedCriterion()) << criterion << " " << current.rows() << "x" << current.cols();
+
+		jc.isActive();
+		EXPECT_NEAR(generic, jc.getLastCriterionValue(), 1e-9) << criterion << " " << current.rows() << "x" << current.cols();
+
+		// a copy shares the evaluator, a change of the criterion requires a new validation
+		JumpCondition::Ptr copy = jc.clone();
+		EXPECT_EQ(specialized, copy->hasSpecializedCriterion());
+		jc.setJumpCriterion(criterion, weights);
+		EXPECT_FALSE(jc.hasSpecializedCriterion());
+	}
+}
+
 TEST(JumpCondition, Serialization) {
 	using namespace ha;
 	using namespace std;
@@ -287,3 +328,156 @@ TEST(JumpCondition, Activation) {
     jc1->setNegate(false);
 }
 
+TEST(JumpCondition, TemporalQualifiers) {
+	using namespace ha;
+	using namespace std;
+
+	JumpConditionSerialization1::MockSystem* _ms = new JumpConditionSerialization1::MockSystem();
+	System::ConstPtr ms(_ms);
+
+	// the sensor reading is changed during the test
+	::Eigen::MatrixXd sensorMat(1,1);
+	sensorMat << 0.0;
+	EXPECT_CALL(*_ms, getJointConfiguration())
+		.WillRepeatedly(ReturnPointee(&sensorMat));
+
+	JointConfigurationSensor::Ptr js_s(new JointConfigurationSensor());
+	js_s->setSystem(ms);
+
+	JumpCondition::Ptr jc1(new JumpCondition);
+	jc1->setSensor(js_s);
+	jc1->setConstantGoal(1.0);
+	jc1->setJumpCriterion(JumpCondition::NORM_L1);
+	jc1->setEpsilon(0.1);
+
+	/////////////////////////////////////////////////
+	//test 1: hold for 3 ticks - a single spike must not activate the condition
+	jc1->setHoldTicks(3);
+	jc1->initialize(0.0);
+
+	sensorMat << 1.0;
+	jc1->step(0.001);
+	EXPECT_FALSE(jc1->isActive());
+	sensorMat << 0.0;
+	jc1->step(0.002);
+	EXPECT_FALSE(jc1->isActive());
+
+	sensorMat << 1.0;
+	jc1->step(0.003);
+	jc1->step(0.004);
+	EXPECT_FALSE(jc1->isActive());
+	jc1->step(0.005);
+	EXPECT_TRUE(jc1->isActive());
+
+	/////////////////////////////////////////////////
+	//test 2: hold for 0.1 seconds
+	jc1->setHoldTicks(0);
+	jc1->setHoldTime(0.1);
+	jc1->initialize(0.0);
+
+	jc1->step(0.0);
+	EXPECT_FALSE(jc1->isActive());
+	jc1->step(0.05);
+	EXPECT_FALSE(jc1->isActive());
+	jc1->step(0.1);
+	EXPECT_TRUE(jc1->isActive());
+
+	/////////////////////////////////////////////////
+	//test 3: hysteresis - once active, stays active up to epsilon + hysteresis
+	jc1->setHoldTime(0.0);
+	jc1->setHysteresis(0.05);
+	jc1->initialize(0.0);
+
+	sensorMat << 0.87;
+	jc1->step(0.001);
+	EXPECT_FALSE(jc1->isActive());
+	sensorMat << 0.95;
+	jc1->step(0.002);
+	EXPECT_TRUE(jc1->isActive());
+	sensorMat << 0.87;
+	jc1->step(0.003);
+	EXPECT_TRUE(jc1->isActive());
+	sensorMat << 0.84;
+	jc1->step(0.004);
+	EXPECT_FALSE(jc1->isActive());
+	EXPECT_ANY_THROW(jc1->setHysteresis(-1.0));
+
+	/////////////////////////////////////////////////
+	//test 4: moving average over 4 values
+	jc1->setHysteresis(0.0);
+	jc1->setMovingAverageFilter(4);
+	EXPECT_EQ(JumpCondition::FILTER_MOVING_AVERAGE, jc1->getFilterType());
+	sensorMat << 0.0;
+	jc1->initialize(0.0);
+
+	sensorMat << 1.0;
+	jc1->step(0.001);
+	EXPECT_TRUE(jc1->isActive());
+	sensorMat << 0.0;
+	jc1->step(0.002);
+	EXPECT_FALSE(jc1->isActive());
+
+	// fill the window and wrap around the ring buffer
+	sensorMat << 1.0;
+	for (int i = 0; i < 3; i++) {
+		jc1->step(0.003 + i * 0.001);
+		EXPECT_FALSE(jc1->isActive());
+	}
+	jc1->step(0.006);
+	EXPECT_TRUE(jc1->isActive());
+	for (int i = 0; i < 10; i++) {
+		jc1->step(0.007 + i * 0.001);
+		EXPECT_TRUE(jc1->isActive());
+	}
+
+	/////////////////////////////////////////////////
+	//test 5: exponential filter
+	jc1->setExponentialFilter(0.5);
+	EXPECT_ANY_THROW(jc1->setExponentialFilter(0.0));
+	jc1->initialize(0.0);
+
+	sensorMat << 0.0;
+	jc1->step(0.001);
+	EXPECT_FALSE(jc1->isActive());
+	sensorMat << 1.0;
+	jc1->step(0.002);
+	jc1->step(0.003);
+	jc1->step(0.004);
+	EXPECT_FALSE(jc1->isActive());
+	jc1->step(0.005);
+	EXPECT_TRUE(jc1->isActive());
+
+	// the copy keeps the qualifiers
+	JumpCondition::Ptr jc2 = jc1->clone();
+	EXPECT_EQ(JumpCondition::FILTER_EXPONENTIAL, jc2->getFilterType());
+	EXPECT_EQ(0, jc2->getHoldTicks());
+}
+
+TEST(JumpCondition, SpecializedCriteria) {
+	using namespace JumpConditionEvaluators;
+
+	JumpCondition::JumpCriterion elementwise[] = {JumpCondition::NORM_L1, JumpCondition::NORM_L2, JumpCondition::NORM_L_INF,
+		JumpCondition::THRESH_UPPER_BOUND, JumpCondition::THRESH_LOWER_BOUND};
+	int sizes[][2] = {{1,1}, {3,1}, {6,1}, {7,1}, {3,3}, {4,4}, {2,1}, {5,2}};
+
+	srand(0);
+	for (int s = 0; s < 8; s++) {
+		int rows = sizes[s][0], cols = sizes[s][1];
+		bool specialized = (s < 6);
+		::Eigen::MatrixXd current = ::Eigen::MatrixXd::Random(rows, cols);
+		::Eigen::MatrixXd goal = ::Eigen::MatrixXd::Random(rows, cols);
+		::Eigen::MatrixXd weights = ::Eigen::MatrixXd::Random(rows, cols).cwiseAbs();
+
+		for (int c = 0; c < 5; c++) {
+			expectSameCriterion(elementwise[c], ::Eigen::MatrixXd(), current, goal, specialized);
+			expectSameCriterion(elementwise[c], weights, current, goal, specialized);
+		}
+	}
+
+	expectSameCriterion(JumpCondition::NORM_ROTATION, ::Eigen::MatrixXd(), pose(0.3, 0.0).block(0,0,3,3), pose(-0.2, 0.0).block(0,0,3,3), true);
+
+	::Eigen::MatrixXd transform_weights(2,1);
+	transform_weights << 0.5, 2.0;
+	expectSameCriterion(JumpCondition::NORM_TRANSFORM, ::Eigen::MatrixXd(), pose(0.3, 1.0), pose(-0.2, 0.5), true);
+	expectSameCriterion(JumpCondition::NORM_TRANSFORM, transform_weights, pose(0.3, 1.0), pose(-0.2, 0.5), true);
+}
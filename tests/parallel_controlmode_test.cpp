@@ -0,0 +1,159 @@
+#include "gtest/gtest.h"
+
+#include "hybrid_automaton/HybridAutomaton.h"
+#include "hybrid_automaton/ParallelControlMode.h"
+
+#include "tests/TestFixtures.h"
+
+using namespace ha;
+
+namespace ParallelControlModeTest {
+	// fails like a user controller that throws a standard exception
+	class ThrowingControlMode : public TestControlMode {
+	public:
+		ThrowingControlMode(const std::string& s): TestControlMode(s, ::Eigen::MatrixXd::Zero(1, 1)) {};
+		virtual ::Eigen::MatrixXd step(const double& t)	{ throw std::runtime_error("diverged"); }
+	};
+
+	class TimeSwitch : public ha::ControlSwitch {
+	public:
+		TimeSwitch(const double& switching_time): _switching_time(switching_time), _time(0.0) {};
+		virtual void step(const double& t) { _time = t; }
+		virtual bool isActive() const { return _time >= _switching_time; }
+		virtual bool tryStep(const double& t, ErrorRecord& error) { step(t); return true; }
+		virtual bool tryIsActive(bool& active, ErrorRecord& error) const { active = isActive(); return true; }
+		double _switching_time;
+		double _time;
+	};
+
+	::Eigen::MatrixXd vector2(double a, double b) {
+		::Eigen::MatrixXd v(2, 1);
+		v << a, b;
+		return v;
+	}
+
+	// arm (rows 0 and 1): reach -> hold at 0.2, gripper (row 4), base (all rows)
+	ParallelControlMode::Ptr createMode(int threads) {
+		HybridAutomaton::Ptr arm(new HybridAutomaton);
+		arm->addControlMode(ControlMode::Ptr(new TestControlMode("reach", vector2(1.0, 2.0))));
+		arm->addControlMode(ControlMode::Ptr(new TestControlMode("hold", vector2(3.0, 3.0))));
+		arm->addControlSwitch("reach", ControlSwitch::Ptr(new TimeSwitch(0.2)), "hold");
+		arm->setCurrentControlMode("reach");
+
+		HybridAutomaton::Ptr gripper(new HybridAutomaton);
+		gripper->addControlMode(ControlMode::Ptr(new TestControlMode("open", ::Eigen::MatrixXd::Constant(1, 1, 5.0))));
+		gripper->setCurrentControlMode("open");
+
+		HybridAutomaton::Ptr base(new HybridAutomaton);
+		base->addControlMode(ControlMode::Ptr(new TestControlMode("gravity", ::Eigen::MatrixXd::Constant(5, 1, 0.5))));
+		base->setCurrentControlMode("gravity");
+
+		ParallelControlMode::Ptr mode(new ParallelControlMode("pick"));
+		std::vector<int> arm_index;
+		arm_index.push_back(0);
+		arm_index.push_back(1);
+		mode->addRegion(arm, arm_index);
+		mode->addRegion(gripper, std::vector<int>(1, 4));
+		mode->addRegion(base);
+		mode->setDimension(5);
+		mode->setNumberOfThreads(threads);
+		return mode;
+	}
+}
+
+TEST(ParallelControlMode, Regions) {
+	using namespace ParallelControlModeTest;
+
+	for (int threads = 1; threads <= 3; ++threads)
+	{
+		ParallelControlMode::Ptr pick = createMode(threads);
+		EXPECT_EQ(3u, pick->getNumberOfRegions());
+
+		// one shared exit for all regions
+		HybridAutomaton ha;
+		ha.addControlMode(pick);
+		ha.addControlMode(ControlMode::Ptr(new TestControlMode("done", ::Eigen::MatrixXd::Zero(5, 1))));
+		ha.addControlSwitch("pick", ControlSwitch::Ptr(new TimeSwitch(0.5)), "done");
+		ha.setCurrentControlMode("pick");
+		ha.initialize(0.0);
+
+		::Eigen::MatrixXd expected(5, 1);
+		expected << 1.5, 2.5, 0.5, 0.5, 5.5;
+		EXPECT_TRUE(expected.isApprox(ha.step(0.0))) << threads << " threads";
+
+		// only the arm region switches
+		expected << 3.5, 3.5, 0.5, 0.5, 5.5;
+		EXPECT_TRUE(expected.isApprox(ha.step(0.2))) << threads << " threads";
+		EXPECT_EQ("hold", pick->getRegion(0)->getCurrentControlMode()->getName());
+		EXPECT_EQ("open", pick->getRegion(1)->getCurrentControlMode()->getName());
+
+		::Eigen::MatrixXd control;
+		EXPECT_TRUE(ha.tryStep(0.3, control).ok());
+		EXPECT_TRUE(expected.isApprox(control)) << threads << " threads";
+
+		EXPECT_TRUE(ha.step(0.5).isZero());
+		EXPECT_FALSE(pick->getRegion(0)->isActive());
+		ha.terminate();
+	}
+}
+
+TEST(ParallelControlMode, Dimensions) {
+	using namespace ParallelControlModeTest;
+
+	// the gripper index is out of range
+	ParallelControlMode::Ptr pick = createMode(1);
+	pick->setDimension(4);
+	EXPECT_ANY_THROW(pick->initialize());
+
+	// without a dimension the indices are checked as well
+	pick = createMode(1);
+	pick->setDimension(0);
+	pick->addRegion(pick->getRegion(1)->clone(), std::vector<int>(1, -1));
+	EXPECT_ANY_THROW(pick->initialize());
+
+	pick = createMode(1);
+	pick->setDimension(0);
+	pick->addRegion(pick->getRegion(1)->clone(), std::vector<int>(2, 4));
+	EXPECT_ANY_THROW(pick->initialize());
+
+	// the base region does not fit a command of size 6
+	pick = createMode(2);
+	pick->setDimension(6);
+	pick->initialize();
+	EXPECT_ANY_THROW(pick->step(0.0));
+	pick->terminate();
+
+	::Eigen::MatrixXd control;
+	ErrorRecord error;
+	pick->initialize();
+	EXPECT_FALSE(pick->tryStep(0.0, control, error));
+	EXPECT_EQ(ErrorRecord::FAULT_CONTROL_MODE, error.code);
+	pick->terminate();
+
+	// a clone has its own regions
+	ParallelControlMode::Ptr clone = boost::dynamic_pointer_cast<ParallelControlMode>(pick->clone());
+	ASSERT_TRUE(clone);
+	EXPECT_NE(pick->getRegion(0), clone->getRegion(0));
+	EXPECT_EQ(pick->getRegionIndex(0), clone->getRegionIndex(0));
+}
+
+TEST(ParallelControlMode, WorkerExceptions) {
+	using namespace ParallelControlModeTest;
+
+	// a standard exception in a worker thread is rethrown by step() in the control thread
+	ParallelControlMode::Ptr pick = createMode(2);
+	HybridAutomaton::Ptr failing(new HybridAutomaton);
+	failing->addControlMode(ControlMode::Ptr(new ThrowingControlMode("fail")));
+	failing->setCurrentControlMode("fail");
+	pick->addRegion(failing, std::vector<int>(1, 3));
+	pick->initialize();
+
+	try {
+		pick->step(0.0);
+		ADD_FAILURE() << "step() did not throw";
+	}
+	catch (const std::string& e) {
+		EXPECT_NE(std::string::npos, e.find("diverged")) << e;
+	}
+	pick->terminate();
+}
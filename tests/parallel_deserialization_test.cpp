@@ -0,0 +1,208 @@
+#include "gtest/gtest.h"
+
+#include "hybrid_automaton/HybridAutomaton.h"
+#include "hybrid_automaton/DescriptionTreeNodeStream.h"
+
+#include "tests/TestFixtures.h"
+
+#include <sstream>
+
+using namespace ha;
+
+namespace ParallelDeserializationTest {
+	class StreamTree : public DescriptionTree {
+	public:
+		virtual DescriptionTreeNode::Ptr getRootNode() { return DescriptionTreeNode::Ptr(); }
+		virtual void setRootNode(const DescriptionTreeNode::Ptr& root_node) {}
+		virtual DescriptionTreeNode::Ptr createNode(const std::string& type) const { return DescriptionTreeNode::Ptr(new DescriptionTreeNodeStream(type)); }
+	};
+
+	std::string modeName(int i) {
+		std::ostringstream name;
+		name << "mode" << i;
+		return name.str();
+	}
+
+	DescriptionTreeNode::Ptr controlSet(const std::string& mode) {
+		DescriptionTreeNode::Ptr cs(new DescriptionTreeNodeStream("ControlSet"));
+		cs->setAttribute<std::string>("type", "Set");
+		cs->setAttribute<std::string>("name", mode + "_set");
+		DescriptionTreeNode::Ptr ctrl(new DescriptionTreeNodeStream("Controller"));
+		ctrl->setAttribute<std::string>("type", "Ctrl");
+		ctrl->setAttribute<std::string>("name", mode + "_ctrl");
+		ctrl->setAttribute<std::string>("goal", "[3,1]1;1;1");
+		cs->addChildNode(ctrl);
+		return cs;
+	}
+
+	// a chain of modes, each left when its controller converged
+	DescriptionTreeNode::Ptr createDescription(int number_of_modes) {
+		DescriptionTreeNode::Ptr tree(new DescriptionTreeNodeStream("HybridAutomaton"));
+		tree->setAttribute<std::string>("name", "chain");
+		tree->setAttribute<std::string>("current_control_mode", modeName(0));
+		for (int i = 0; i < number_of_modes; ++i)
+		{
+			DescriptionTreeNode::Ptr cm(new DescriptionTreeNodeStream("ControlMode"));
+			cm->setAttribute<std::string>("name", modeName(i));
+			cm->addChildNode(controlSet(modeName(i)));
+			tree->addChildNode(cm);
+		}
+		for (int i = 0; i + 1 < number_of_modes; ++i)
+		{
+			DescriptionTreeNode::Ptr cs(new DescriptionTreeNodeStream("ControlSwitch"));
+			cs->setAttribute<std::string>("name", modeName(i) + "_done");
+			cs->setAttribute<std::string>("source", modeName(i));
+			cs->setAttribute<std::string>("target", modeName(i + 1));
+			DescriptionTreeNode::Ptr jc(new DescriptionTreeNodeStream("JumpCondition"));
+			jc->setAttribute<std::string>("controller", modeName(i) + "_ctrl");
+			jc->setAttribute<std::string>("epsilon", "0.01");
+			DescriptionTreeNode::Ptr sensor(new DescriptionTreeNodeStream("Sensor"));
+			sensor->setAttribute<std::string>("type", "JointConfigurationSensor");
+			jc->addChildNode(sensor);
+			cs->addChildNode(jc);
+			tree->addChildNode(cs);
+		}
+		return tree;
+	}
+
+	int created_controllers = 0;
+
+	Controller::Ptr createCountedController(const DescriptionTreeNode::ConstPtr node, const System::ConstPtr system, const HybridAutomaton* ha) {
+		++created_controllers;
+		Controller::Ptr ctrl(new Controller);
+		ctrl->deserialize(node, system, ha);
+		return ctrl;
+	}
+
+	ControlSet::Ptr createControlSet(const DescriptionTreeNode::ConstPtr node, const System::ConstPtr system, const HybridAutomaton* ha) {
+		ControlSet::Ptr cs(new ControlSet);
+		cs->deserialize(node, system, ha);
+		return cs;
+	}
+
+	std::vector<std::string> modeNames(HybridAutomaton& ha) {
+		DescriptionTreeNode::ConstNodeList modes;
+		ha.serialize(DescriptionTree::ConstPtr(new StreamTree))->getChildrenNodes("ControlMode", modes);
+		std::vector<std::string> names;
+		for (DescriptionTreeNode::ConstNodeList::iterator it = modes.begin(); it != modes.end(); ++it)
+		{
+			std::string name;
+			(*it)->getAttribute<std::string>("name", name);
+			names.push_back(name);
+		}
+		return names;
+	}
+}
+
+TEST(ParallelDeserialization, SameAsSerial) {
+	using namespace ParallelDeserializationTest;
+
+	DescriptionTreeNode::Ptr description = createDescription(60);
+	System::ConstPtr system(new TestSystem);
+
+	HybridAutomaton serial;
+	serial.setDeserializeDefaultEntities(true);
+	EXPECT_EQ(1u, serial.getDeserializationThreads());
+	serial.deserialize(description, system);
+
+	HybridAutomaton parallel;
+	parallel.setDeserializeDefaultEntities(true);
+	parallel.setDeserializationThreads(4);
+	parallel.deserialize(description, system);
+
+	EXPECT_EQ(modeNames(serial), modeNames(parallel));
+	EXPECT_EQ("mode0", parallel.getCurrentControlMode()->getName());
+	EXPECT_EQ("mode42", parallel.getTargetControlMode("mode41_done")->getName());
+	EXPECT_TRUE(parallel.getControllerByName("mode59", "mode59_ctrl"));
+}
+
+TEST(ParallelDeserialization, FirstErrorInDocumentOrder) {
+	using namespace ParallelDeserializationTest;
+
+	// mode3 has two control sets, mode40 none
+	DescriptionTreeNode::Ptr tree(new DescriptionTreeNodeStream("HybridAutomaton"));
+	tree->setAttribute<std::string>("current_control_mode", modeName(0));
+	for (int i = 0; i < 50; ++i)
+	{
+		DescriptionTreeNode::Ptr cm(new DescriptionTreeNodeStream("ControlMode"));
+		cm->setAttribute<std::string>("name", modeName(i));
+		if (i != 40)
+			cm->addChildNode(controlSet(modeName(i)));
+		if (i == 3)
+			cm->addChildNode(controlSet(modeName(i)));
+		tree->addChildNode(cm);
+	}
+
+	for (unsigned int threads = 1; threads <= 8; threads *= 2)
+	{
+		HybridAutomaton ha;
+		ha.setDeserializeDefaultEntities(true);
+		ha.setDeserializationThreads(threads);
+		try {
+			ha.deserialize(tree, System::ConstPtr(new TestSystem));
+			ADD_FAILURE() << "deserialize did not throw";
+		}
+		catch (const std::string& error) {
+			EXPECT_NE(std::string::npos, error.find("Too many")) << threads << " threads: " << error;
+		}
+	}
+}
+
+TEST(ParallelDeserialization, IdenticalControllers) {
+	using namespace ParallelDeserializationTest;
+
+	HybridAutomaton::registerController("CountedCtrl", &createCountedController);
+	HybridAutomaton::registerControlSet("CountedSet", &createControlSet);
+
+	// every mode has the same controller and one of its own
+	DescriptionTreeNode::Ptr tree(new DescriptionTreeNodeStream("HybridAutomaton"));
+	tree->setAttribute<std::string>("current_control_mode", modeName(0));
+	for (int i = 0; i < 20; ++i)
+	{
+		DescriptionTreeNode::Ptr cs(new DescriptionTreeNodeStream("ControlSet"));
+		cs->setAttribute<std::string>("type", "CountedSet");
+		cs->setAttribute<std::string>("name", modeName(i) + "_set");
+		DescriptionTreeNode::Ptr shared(new DescriptionTreeNodeStream("Controller"));
+		shared->setAttribute<std::string>("type", "CountedCtrl");
+		shared->setAttribute<std::string>("name", "hold");
+		shared->setAttribute<std::string>("goal", "[3,1]1;1;1");
+		shared->setAttribute<std::string>("kp", "[3,1]10;10;10");
+		cs->addChildNode(shared);
+		DescriptionTreeNode::Ptr own(new DescriptionTreeNodeStream("Controller"));
+		own->setAttribute<std::string>("type", "CountedCtrl");
+		own->setAttribute<std::string>("name", modeName(i) + "_ctrl");
+		cs->addChildNode(own);
+
+		DescriptionTreeNode::Ptr cm(new DescriptionTreeNodeStream("ControlMode"));
+		cm->setAttribute<std::string>("name", modeName(i));
+		cm->addChildNode(cs);
+		tree->addChildNode(cm);
+	}
+
+	System::ConstPtr system(new TestSystem);
+	created_controllers = 0;
+	HybridAutomaton ha;
+	ha.deserialize(tree, system);
+	EXPECT_EQ(21, created_controllers);
+
+	// the identical controllers are clones - they do not share state
+	const std::map<std::string, Controller::Ptr>& controllers0 = ha.getControlModeByName("mode0")->getControlSet()->getControllers();
+	const std::map<std::string, Controller::Ptr>& controllers1 = ha.getControlModeByName("mode1")->getControlSet()->getControllers();
+	ASSERT_EQ(1u, controllers0.count("hold"));
+	ASSERT_EQ(1u, controllers1.count("hold"));
+	Controller::Ptr hold0 = controllers0.find("hold")->second;
+	Controller::Ptr hold1 = controllers1.find("hold")->second;
+	EXPECT_NE(hold0, hold1);
+	EXPECT_EQ(hold0->getGoal(), hold1->getGoal());
+	EXPECT_EQ(hold0->getKp(), hold1->getKp());
+	hold0->setKp(::Eigen::MatrixXd::Zero(3,1));
+	EXPECT_EQ(::Eigen::MatrixXd::Constant(3,1,10.0), hold1->getKp());
+
+	// every automaton deserializes its own prototypes
+	HybridAutomaton ha2;
+	ha2.deserialize(tree, system);
+	EXPECT_EQ(42, created_controllers);
+
+	HybridAutomaton::unregisterController("CountedCtrl");
+	HybridAutomaton::unregisterControlSet("CountedSet");
+}
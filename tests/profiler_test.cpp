@@ -0,0 +1,132 @@
+#include "gtest/gtest.h"
+
+#include "hybrid_automaton/Profiler.h"
+#include "hybrid_automaton/HybridAutomaton.h"
+#include "hybrid_automaton/JointConfigurationSensor.h"
+
+#include "TestFixtures.h"
+
+#include <boost/thread.hpp>
+
+#include <sstream>
+
+using namespace ha;
+
+namespace ProfilerTest {
+	void work(int iterations)
+	{
+		for (int i = 0; i < iterations; ++i)
+		{
+			ProfileScope scope("ProfilerTest.work", "worker");
+		}
+	}
+
+	const Profiler::Statistics* find(const std::vector<Profiler::Statistics>& statistics, const std::string& category, const std::string& name)
+	{
+		for (std::size_t i = 0; i < statistics.size(); ++i)
+			if (statistics[i].category == category && statistics[i].name == name)
+				return &statistics[i];
+		return NULL;
+	}
+
+	const Profiler::Statistics* find(const std::vector<Profiler::Statistics>& statistics, const std::string& name)
+	{
+		return find(statistics, "ProfilerTest.work", name);
+	}
+}
+
+TEST(Profiler, Statistics) {
+#ifdef HA_ENABLE_PROFILING
+	EXPECT_TRUE(Profiler::isEnabled());
+#else
+	EXPECT_FALSE(Profiler::isEnabled());
+#endif
+
+	Profiler::reset();
+
+	// the counters of all threads are merged
+	ProfilerTest::work(100);
+	boost::thread worker(&ProfilerTest::work, 50);
+	worker.join();
+
+	std::vector<Profiler::Statistics> statistics = Profiler::getStatistics();
+	const Profiler::Statistics* worker_statistics = ProfilerTest::find(statistics, "worker");
+	ASSERT_TRUE(worker_statistics != NULL);
+	EXPECT_EQ(150u, worker_statistics->count);
+	EXPECT_LE(worker_statistics->min, worker_statistics->max);
+	EXPECT_LE(worker_statistics->getPercentile(0.5), worker_statistics->max);
+
+	boost::uint64_t histogram_count = 0;
+	for (std::size_t i = 0; i < worker_statistics->histogram.size(); ++i)
+		histogram_count += worker_statistics->histogram[i];
+	EXPECT_EQ(150u, histogram_count);
+
+	std::ostringstream report;
+	Profiler::report(report);
+	EXPECT_NE(std::string::npos, report.str().find("worker"));
+
+	Profiler::reset();
+	EXPECT_TRUE(ProfilerTest::find(Profiler::getStatistics(), "worker") == NULL);
+
+	EXPECT_EQ(0, Profiler::getBin(1));
+	EXPECT_EQ(10, Profiler::getBin(1024));
+	EXPECT_EQ(Profiler::NUMBER_OF_BINS - 1, Profiler::getBin(~boost::uint64_t(0)));
+}
+
+// the library is only instrumented if it was built with HA_ENABLE_PROFILING - tests/CMakeLists.txt builds
+// this file a second time against such a build (hybrid_automaton_profiling_tests)
+TEST(Profiler, Step) {
+	using namespace ProfilerTest;
+
+	System::ConstPtr system(new TestSystem(2));
+	JointConfigurationSensor::Ptr sensor(new JointConfigurationSensor);
+	sensor->setSystem(system);
+	JumpCondition::Ptr jc(new JumpCondition);
+	jc->setSensor(sensor);
+	jc->setConstantGoal(::Eigen::MatrixXd::Zero(2,1));
+	ControlSwitch::Ptr s1(new ControlSwitch);
+	s1->setName("s1");
+	s1->add(jc);
+
+	HybridAutomaton ha;
+	ha.setName("profiled");
+	ControlMode::Ptr m1(new TestControlMode("m1"));
+	ControlMode::Ptr m2(new TestControlMode("m2"));
+	ha.addControlMode(m1);
+	ha.addControlMode(m2);
+	ha.addControlSwitch("m1", s1, "m2");
+	ha.setCurrentControlMode("m1");
+	ha.initialize(0.0);
+
+	Profiler::reset();
+	ha.step(0.0);
+	ha.step(0.1);
+
+	std::vector<Profiler::Statistics> statistics = Profiler::getStatistics();
+	const Profiler::Statistics* ha_statistics = find(statistics, "HybridAutomaton.step", "profiled");
+	const Profiler::Statistics* switch_statistics = find(statistics, "ControlSwitch.step", "s1");
+	const Profiler::Statistics* is_active_statistics = find(statistics, "ControlSwitch.isActive", "s1");
+	const Profiler::Statistics* sensor_statistics = find(statistics, "Sensor.getCurrentValue", sensor->getType());
+#ifdef HA_ENABLE_PROFILING
+	ASSERT_TRUE(ha_statistics != NULL);
+	EXPECT_EQ(2u, ha_statistics->count);
+	EXPECT_LE(ha_statistics->min, ha_statistics->max);
+	EXPECT_LE(ha_statistics->max, ha_statistics->total);
+
+	// the switch is inactive, so it is evaluated in both steps
+	ASSERT_TRUE(switch_statistics != NULL);
+	EXPECT_EQ(2u, switch_statistics->count);
+	ASSERT_TRUE(is_active_statistics != NULL);
+	EXPECT_EQ(2u, is_active_statistics->count);
+	ASSERT_TRUE(sensor_statistics != NULL);
+	EXPECT_LE(2u, sensor_statistics->count);
+
+	// the step contains the evaluation of its switches
+	EXPECT_LE(switch_statistics->total, ha_statistics->total);
+#else
+	EXPECT_TRUE(ha_statistics == NULL);
+	EXPECT_TRUE(switch_statistics == NULL);
+	EXPECT_TRUE(is_active_statistics == NULL);
+	EXPECT_TRUE(sensor_statistics == NULL);
+#endif
+}
@@ -0,0 +1,310 @@
+#include "gtest/gtest.h"
+
+#include "hybrid_automaton/BatchReplay.h"
+#include "hybrid_automaton/HybridAutomaton.h"
+#include "hybrid_automaton/JointConfigurationSensor.h"
+#include "hybrid_automaton/ReplayDriver.h"
+#include "hybrid_automaton/ReplaySystem.h"
+#include "hybrid_automaton/Watchdog.h"
+
+#include "tests/TestFixtures.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+using namespace ha;
+
+namespace ReplayTest {
+	void writeLog(const std::string& filename, int samples) {
+		TestSystem system(2);
+		std::vector<int> ports(2);
+		ports[0] = 0;
+		ports[1] = 2;
+		std::vector<std::string> frames(1, "EE");
+		ReplayLogWriter writer(filename, system.getDof(), ports, frames);
+		for (int i = 0; i < samples; i++) {
+			system.q << 0.1 * i, -0.1 * i;
+			system.qd << 0.1, -0.1;
+			system.ft(2) = i;
+			system.pose(0,3) = 0.5 * i;
+			writer.write(system, 0.01 * i);
+		}
+	}
+
+	// switches from m1 to m2 when the joint configuration reaches (0.5, -0.5)
+	HybridAutomaton::Ptr createAutomaton(const System::ConstPtr& system, const ControlMode::Ptr& m2 = ControlMode::Ptr(new TestControlMode("m2"))) {
+		TestControlMode::Ptr m1(new TestControlMode("m1"));
+
+		JointConfigurationSensor::Ptr sensor(new JointConfigurationSensor);
+		sensor->setSystem(system);
+		JumpCondition::Ptr jc(new JumpCondition);
+		jc->setSensor(sensor);
+		::Eigen::MatrixXd goal(2,1);
+		goal << 0.5, -0.5;
+		jc->setConstantGoal(goal);
+		jc->setEpsilon(0.01);
+		ControlSwitch::Ptr s1(new ControlSwitch);
+		s1->setName("s1");
+		s1->add(jc);
+
+		HybridAutomaton::Ptr ha(new HybridAutomaton);
+		ha->addControlMode(m1);
+		ha->addControlMode(m2);
+		ha->addControlSwitch(m1->getName(), s1, m2->getName());
+		ha->setCurrentControlMode("m1");
+		return ha;
+	}
+
+	class TestBatchReplay : public ha::BatchReplay {
+	public:
+		virtual HybridAutomaton::Ptr createAutomaton(const System::ConstPtr& system) const {
+			return ReplayTest::createAutomaton(system);
+		}
+	};
+
+	// fails with an exception that is neither a std::string nor a std::exception
+	class ThrowingBatchReplay : public ha::BatchReplay {
+	public:
+		virtual HybridAutomaton::Ptr createAutomaton(const System::ConstPtr& system) const {
+			throw 42;
+		}
+	};
+}
+
+TEST(ReplaySystem, ReadLog) {
+	using namespace ReplayTest;
+
+	std::string filename("replay_test_1.log");
+	writeLog(filename, 10);
+
+	// a partially written sample at the end is ignored
+	{
+		std::ofstream log(filename.c_str(), std::ios::out | std::ios::binary | std::ios::app);
+		log.write("abc", 3);
+	}
+
+	{
+		ReplaySystem system(filename);
+		ASSERT_EQ(10u, system.getNumberOfSamples());
+		EXPECT_EQ(2, system.getDof());
+		ASSERT_EQ(2u, system.getForceTorquePorts().size());
+		EXPECT_EQ(2, system.getForceTorquePorts()[1]);
+		ASSERT_EQ(1u, system.getFrameIds().size());
+		EXPECT_EQ("EE", system.getFrameIds()[0]);
+
+		system.setSample(3);
+		EXPECT_DOUBLE_EQ(0.03, system.getTime());
+		EXPECT_DOUBLE_EQ(0.3, system.getJointConfiguration()(0));
+		EXPECT_DOUBLE_EQ(-0.3, system.getJointConfiguration()(1));
+		EXPECT_DOUBLE_EQ(-0.1, system.getJointVelocity()(1));
+		EXPECT_DOUBLE_EQ(3.0, system.getForceTorqueMeasurement(0)(2));
+		EXPECT_DOUBLE_EQ(9.0, system.getForceTorqueMeasurement(2)(2));
+		EXPECT_ANY_THROW(system.getForceTorqueMeasurement(1));
+
+		::Eigen::Matrix4d pose;
+		system.getFramePoseInto("EE", pose);
+		EXPECT_DOUBLE_EQ(1.5, pose(0,3));
+		EXPECT_DOUBLE_EQ(1.0, pose(3,3));
+		EXPECT_ANY_THROW(system.getFramePose("world"));
+
+		EXPECT_TRUE(system.next());
+		EXPECT_EQ(4u, system.getSample());
+		system.setSample(9);
+		EXPECT_FALSE(system.next());
+		EXPECT_ANY_THROW(system.setSample(10));
+	}
+	std::remove(filename.c_str());
+
+	std::ofstream invalid(filename.c_str(), std::ios::out | std::ios::binary);
+	invalid << "not a log";
+	invalid.close();
+	EXPECT_ANY_THROW(ReplaySystem system(filename));
+	std::remove(filename.c_str());
+}
+
+TEST(ReplayDriver, Transitions) {
+	using namespace ReplayTest;
+
+	std::string filename("replay_test_2.log");
+	writeLog(filename, 10);
+	ReplaySystem::Ptr system(new ReplaySystem(filename));
+
+	HybridAutomaton::Ptr ha = createAutomaton(system);
+
+	ReplayDriver::Result result = ReplayDriver::run(ha, system);
+	system.reset();
+	std::remove(filename.c_str());
+
+	EXPECT_EQ(10u, result.steps);
+	EXPECT_EQ("m1", result.initial_mode);
+	EXPECT_EQ("m2", result.terminal_mode);
+	ASSERT_EQ(1u, result.transitions.size());
+	EXPECT_DOUBLE_EQ(0.05, result.transitions[0].time);
+	EXPECT_EQ("s1", result.transitions[0].control_switch);
+	EXPECT_EQ("m1", result.transitions[0].source_mode);
+	EXPECT_EQ("m2", result.transitions[0].target_mode);
+	EXPECT_DOUBLE_EQ(0.05, result.time_in_mode["m1"]);
+	EXPECT_DOUBLE_EQ(0.04, result.time_in_mode["m2"]);
+
+	std::stringstream report;
+	result.report(report);
+	EXPECT_NE(std::string::npos, report.str().find("m1 -> m2 (s1)"));
+}
+
+TEST(ReplayDriver, SelfLoop) {
+	using namespace ReplayTest;
+
+	std::string filename("replay_test_3.log");
+	writeLog(filename, 4);
+	ReplaySystem::Ptr system(new ReplaySystem(filename));
+
+	// the switch from m1 back to m1 is active on every sample
+	boost::shared_ptr<TestControlMode> m1(new TestControlMode("m1"));
+	JointConfigurationSensor::Ptr sensor(new JointConfigurationSensor);
+	sensor->setSystem(system);
+	JumpCondition::Ptr jc(new JumpCondition);
+	jc->setSensor(sensor);
+	jc->setConstantGoal(::Eigen::MatrixXd::Zero(2,1));
+	jc->setEpsilon(100.0);
+	ControlSwitch::Ptr loop(new ControlSwitch);
+	loop->setName("loop");
+	loop->add(jc);
+
+	HybridAutomaton::Ptr ha(new HybridAutomaton);
+	ha->addControlMode(m1);
+	ha->addControlSwitch("m1", loop, "m1");
+	ha->setCurrentControlMode("m1");
+
+	ReplayDriver::Result result = ReplayDriver::run(ha, system);
+
+	EXPECT_EQ(4u, result.steps);
+	EXPECT_EQ("m1", result.terminal_mode);
+	ASSERT_EQ(4u, result.transitions.size());
+	for (std::size_t i = 0; i < result.transitions.size(); i++) {
+		EXPECT_DOUBLE_EQ(0.01 * i, result.transitions[i].time);
+		EXPECT_EQ("loop", result.transitions[i].control_switch);
+		EXPECT_EQ("m1", result.transitions[i].source_mode);
+		EXPECT_EQ("m1", result.transitions[i].target_mode);
+	}
+
+	// a failing step still terminates the automaton
+	m1->_fail = true;
+	EXPECT_THROW(ReplayDriver::run(ha, system), std::string);
+	EXPECT_FALSE(ha->isActive());
+
+	system.reset();
+	std::remove(filename.c_str());
+}
+
+TEST(ReplayDriver, Fallback) {
+	using namespace ReplayTest;
+
+	std::string filename("replay_test_4.log");
+	writeLog(filename, 10);
+	ReplaySystem::Ptr system(new ReplaySystem(filename));
+
+	// m2 fails right away, its watchdog falls back to the safe mode in the same cycle
+	boost::shared_ptr<TestControlMode> m2(new TestControlMode("m2"));
+	m2->_fail = true;
+	Watchdog::Ptr watchdog(new Watchdog);
+	watchdog->setFallbackControlMode("safe");
+	m2->setWatchdog(watchdog);
+	HybridAutomaton::Ptr ha = createAutomaton(system, m2);
+	ha->addControlMode(ControlMode::Ptr(new TestControlMode("safe")));
+
+	ReplayDriver::Result result = ReplayDriver::run(ha, system);
+	system.reset();
+	std::remove(filename.c_str());
+
+	EXPECT_EQ("safe", result.terminal_mode);
+	ASSERT_EQ(2u, result.transitions.size());
+	EXPECT_EQ("s1", result.transitions[0].control_switch);
+	EXPECT_EQ("m2", result.transitions[0].target_mode);
+	EXPECT_FALSE(result.transitions[0].fallback);
+	EXPECT_DOUBLE_EQ(0.05, result.transitions[1].time);
+	EXPECT_TRUE(result.transitions[1].fallback);
+	EXPECT_EQ("", result.transitions[1].control_switch);
+	EXPECT_EQ("m2", result.transitions[1].source_mode);
+	EXPECT_EQ("safe", result.transitions[1].target_mode);
+	EXPECT_DOUBLE_EQ(0.05, result.time_in_mode["m1"]);
+	EXPECT_DOUBLE_EQ(0.0, result.time_in_mode["m2"]);
+	EXPECT_NEAR(0.04, result.time_in_mode["safe"], 1e-9);
+
+	std::stringstream report;
+	result.report(report);
+	EXPECT_NE(std::string::npos, report.str().find("m2 -> safe (fallback)"));
+
+	BatchReplay::Run run;
+	run.result = result;
+	BatchReplay::Summary summary;
+	summary.add(run);
+	EXPECT_EQ(1u, summary.fallbacks);
+	EXPECT_EQ(1u, summary.switch_counts.size());
+}
+
+TEST(BatchReplay, Summary) {
+	using namespace ReplayTest;
+
+	// even logs reach the goal, odd ones end before
+	std::vector<std::string> logs;
+	for (int i = 0; i < 8; i++) {
+		std::stringstream filename;
+		filename << "replay_test_batch_" << i << ".log";
+		writeLog(filename.str(), i % 2 == 0 ? 10 : 3);
+		logs.push_back(filename.str());
+	}
+	logs.push_back("replay_test_missing.log");
+
+	TestBatchReplay batch;
+	std::vector<BatchReplay::Run> runs = batch.run(logs, 3);
+	for (int i = 0; i < 8; i++)
+		std::remove(logs[i].c_str());
+
+	ASSERT_EQ(9u, runs.size());
+	for (int i = 0; i < 8; i++) {
+		EXPECT_EQ(logs[i], runs[i].log);
+		EXPECT_FALSE(runs[i].failed) << runs[i].error;
+		EXPECT_EQ(i % 2 == 0 ? "m2" : "m1", runs[i].result.terminal_mode);
+	}
+	EXPECT_TRUE(runs[8].failed);
+
+	BatchReplay::Summary summary = BatchReplay::summarize(runs);
+	EXPECT_EQ(9u, summary.logs);
+	EXPECT_EQ(1u, summary.failed);
+	EXPECT_EQ(4u * 10u + 4u * 3u, summary.steps);
+	EXPECT_EQ(4u, summary.switch_counts["s1"]);
+	EXPECT_EQ(4u, summary.terminal_modes["m1"]);
+	EXPECT_EQ(4u, summary.terminal_modes["m2"]);
+	EXPECT_NEAR(4 * 0.05 + 4 * 0.02, summary.time_in_mode["m1"], 1e-9);
+	EXPECT_NEAR(4 * 0.04, summary.time_in_mode["m2"], 1e-9);
+
+	std::stringstream out;
+	BatchReplay::writeSummary(runs, out);
+	EXPECT_NE(std::string::npos, out.str().find("  s1: 4\n"));
+	EXPECT_NE(std::string::npos, out.str().find("fallbacks: 0\n"));
+	EXPECT_NE(std::string::npos, out.str().find("replay_test_missing.log: FAILED"));
+
+	// the automaton description is required by default
+	BatchReplay no_description;
+	EXPECT_ANY_THROW(no_description.createAutomaton(System::ConstPtr()));
+}
+
+TEST(BatchReplay, UnknownException) {
+	using namespace ReplayTest;
+
+	writeLog("replay_test_unknown.log", 3);
+	std::vector<std::string> logs(2, "replay_test_unknown.log");
+
+	ThrowingBatchReplay batch;
+	std::vector<BatchReplay::Run> runs = batch.run(logs, 2);
+	std::remove("replay_test_unknown.log");
+
+	ASSERT_EQ(2u, runs.size());
+	for (int i = 0; i < 2; i++) {
+		EXPECT_EQ(logs[i], runs[i].log);
+		EXPECT_TRUE(runs[i].failed);
+		EXPECT_EQ("Unknown exception.", runs[i].error);
+	}
+	EXPECT_EQ(2u, BatchReplay::summarize(runs).failed);
+}
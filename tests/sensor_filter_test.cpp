@@ -0,0 +1,162 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "hybrid_automaton/HybridAutomaton.h"
+#include "hybrid_automaton/SensorFilter.h"
+#include "hybrid_automaton/FilteredSensor.h"
+#include "hybrid_automaton/JointConfigurationSensor.h"
+
+#include "tests/MockDescriptionTree.h"
+#include "tests/MockDescriptionTreeNode.h"
+#include "tests/TestFixtures.h"
+
+using namespace std;
+using namespace ha;
+
+using ::testing::Return;
+using ::testing::ReturnPointee;
+using ::testing::DoAll;
+using ::testing::SetArgReferee;
+using ::testing::AtLeast;
+using ::testing::_;
+
+TEST(SensorFilter, Filters) {
+	::Eigen::MatrixXd in(2,1), out;
+
+	// median removes a single spike
+	MedianFilter median(3);
+	in << 1.0, 2.0;
+	median.initialize(in, 0.0, out);
+	median.step(in, 0.1, out);
+	in << 100.0, 2.0;
+	median.step(in, 0.2, out);
+	EXPECT_DOUBLE_EQ(1.0, out(0));
+	EXPECT_DOUBLE_EQ(2.0, out(1));
+
+	// moving average over a window of 2, wrapping around its ring buffer
+	MovingAverageFilter average(2);
+	in << 1.0, 2.0;
+	average.initialize(in, 0.0, out);
+	in << 3.0, 2.0;
+	average.step(in, 0.1, out);
+	EXPECT_DOUBLE_EQ(2.0, out(0));
+	in << 5.0, 2.0;
+	average.step(in, 0.2, out);
+	EXPECT_DOUBLE_EQ(4.0, out(0));
+	EXPECT_DOUBLE_EQ(2.0, out(1));
+
+	// exponential smoothing halves the distance to the input
+	ExponentialFilter exponential(0.5);
+	in << 0.0, 0.0;
+	exponential.initialize(in, 0.0, out);
+	in << 1.0, -1.0;
+	exponential.step(in, 0.1, out);
+	exponential.step(in, 0.2, out);
+	EXPECT_DOUBLE_EQ(0.75, out(0));
+	EXPECT_DOUBLE_EQ(-0.75, out(1));
+
+	// derivative and integrator of a ramp
+	DerivativeFilter derivative;
+	IntegratorFilter integrator;
+	::Eigen::MatrixXd d_out, i_out;
+	in << 0.0, 0.0;
+	derivative.initialize(in, 0.0, d_out);
+	integrator.initialize(in, 0.0, i_out);
+	for (int i = 1; i <= 10; i++) {
+		in << i * 0.1, -i * 0.2;
+		derivative.step(in, i * 0.1, d_out);
+		integrator.step(in, i * 0.1, i_out);
+	}
+	EXPECT_NEAR(1.0, d_out(0), 1e-9);
+	EXPECT_NEAR(-2.0, d_out(1), 1e-9);
+	EXPECT_NEAR(0.5, i_out(0), 1e-9);
+	EXPECT_NEAR(-1.0, i_out(1), 1e-9);
+
+	// low pass converges towards a step
+	LowPassFilter lowpass(10.0);
+	in << 0.0, 0.0;
+	lowpass.initialize(in, 0.0, out);
+	in << 1.0, 1.0;
+	lowpass.step(in, 0.001, out);
+	EXPECT_GT(out(0), 0.0);
+	EXPECT_LT(out(0), 0.1);
+	for (int i = 2; i <= 1000; i++)
+		lowpass.step(in, i * 0.001, out);
+	EXPECT_NEAR(1.0, out(0), 1e-6);
+
+	// transform and dimension checks
+	::Eigen::MatrixXd m(2,2);
+	m << 0.0, 1.0, 1.0, 0.0;
+	TransformFilter transform(m);
+	in << 1.0, 2.0;
+	transform.initialize(in, 0.0, out);
+	EXPECT_DOUBLE_EQ(2.0, out(0));
+	EXPECT_DOUBLE_EQ(1.0, out(1));
+	EXPECT_ANY_THROW(transform.step(::Eigen::MatrixXd(3,1), 0.1, out));
+	EXPECT_ANY_THROW(TransformFilter(m, true).initialize(in, 0.0, out));
+}
+
+TEST(SensorFilter, SharedFilteredSensor) {
+	MockSystem* _ms = new MockSystem();
+	System::ConstPtr ms(_ms);
+
+	::Eigen::MatrixXd sensorMat(1,1);
+	sensorMat << 0.0;
+	EXPECT_CALL(*_ms, getJointConfiguration())
+		.WillRepeatedly(ReturnPointee(&sensorMat));
+
+	JointConfigurationSensor jcs; // to enable registration
+
+	MockDescriptionTreeNode::Ptr filter_node(new MockDescriptionTreeNode);
+	EXPECT_CALL(*filter_node, getType()).WillRepeatedly(Return("Filter"));
+	EXPECT_CALL(*filter_node, getAttributeString(_, _))
+		.WillRepeatedly(Return(false));
+	EXPECT_CALL(*filter_node, getAttributeString(std::string("type"), _))
+		.WillRepeatedly(DoAll(SetArgReferee<1>("integrator"),Return(true)));
+	DescriptionTreeNode::ConstNodeList filter_list;
+	filter_list.push_back(filter_node);
+
+	std::map<std::string, std::string> attributes;
+	attributes["type"] = "JointConfigurationSensor";
+
+	MockDescriptionTreeNode::Ptr sensor_node(new MockDescriptionTreeNode);
+	EXPECT_CALL(*sensor_node, getType()).WillRepeatedly(Return("Sensor"));
+	EXPECT_CALL(*sensor_node, getAttributeString(_, _))
+		.WillRepeatedly(Return(false));
+	EXPECT_CALL(*sensor_node, getAttributeString(std::string("type"), _))
+		.WillRepeatedly(DoAll(SetArgReferee<1>("JointConfigurationSensor"),Return(true)));
+	EXPECT_CALL(*sensor_node, getAllAttributes(_))
+		.WillRepeatedly(SetArgReferee<0>(attributes));
+	EXPECT_CALL(*sensor_node, getChildrenNodes(std::string("Filter"), _))
+		.WillRepeatedly(DoAll(SetArgReferee<1>(filter_list),Return(true)));
+	EXPECT_CALL(*sensor_node, getChildrenNodes(_))
+		.WillRepeatedly(DoAll(SetArgReferee<0>(filter_list),Return(true)));
+
+	HybridAutomaton ha;
+	Sensor::Ptr s1 = HybridAutomaton::createSensor(sensor_node, ms, &ha);
+	Sensor::Ptr s2 = HybridAutomaton::createSensor(sensor_node, ms, &ha);
+
+	// identical filtered sensors are shared
+	ASSERT_TRUE(boost::dynamic_pointer_cast<FilteredSensor>(s1));
+	EXPECT_TRUE(s1 == s2);
+	EXPECT_EQ("JointConfigurationSensor", s1->getType());
+
+	// a second step at the same time must not run the pipeline again
+	sensorMat << 1.0;
+	s1->initialize(0.0);
+	s1->step(1.0);
+	s2->step(1.0);
+	EXPECT_DOUBLE_EQ(1.0, s1->getCurrentValue()(0));
+
+	// other automata do not share
+	HybridAutomaton ha2;
+	Sensor::Ptr s3 = HybridAutomaton::createSensor(sensor_node, ms, &ha2);
+	EXPECT_FALSE(s1 == s3);
+
+	// a clone has its own pipeline
+	Sensor::Ptr s4 = s1->clone();
+	s4->initialize(1.0);
+	s4->step(2.0);
+	EXPECT_DOUBLE_EQ(1.0, s4->getCurrentValue()(0));
+	EXPECT_DOUBLE_EQ(1.0, s1->getCurrentValue()(0));
+}
@@ -0,0 +1,170 @@
+#include "gtest/gtest.h"
+
+#include "hybrid_automaton/HybridAutomaton.h"
+#include "hybrid_automaton/TraceRecorder.h"
+#include "tests/ValueSensor.h"
+#include "tests/TestFixtures.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+using namespace ha;
+
+TEST(TraceRecorder, RecordAndConvert) {
+	TestControlMode::Ptr m1(new TestControlMode("m1"));
+	TestControlMode::Ptr m2(new TestControlMode("m2"));
+
+	ValueSensor::Ptr sensor(new ValueSensor);
+	JumpCondition::Ptr jc(new JumpCondition);
+	jc->setSensor(sensor);
+	jc->setConstantGoal(1.0);
+	jc->setEpsilon(0.1);
+	ControlSwitch::Ptr s1(new ControlSwitch);
+	s1->setName("s1");
+	s1->add(jc);
+
+	HybridAutomaton ha;
+	ha.addControlMode(m1);
+	ha.addControlMode(m2);
+	ha.addControlSwitch(m1->getName(), s1, m2->getName());
+
+	std::string filename("trace_recorder_test_1.bin");
+
+	TraceRecorder::Ptr recorder(new TraceRecorder(16));
+	ha.setTraceRecorder(recorder);
+	recorder->start(filename);
+
+	ha.setCurrentControlMode("m1");
+	ha.initialize(0.0);
+	ha.step(0.0);
+	sensor->setValue(1.05);
+	ha.step(0.001);
+	ha.step(0.002);
+	ha.terminate();
+
+	recorder->stop();
+	EXPECT_EQ(0u, recorder->getNumberOfDroppedRecords());
+
+	std::ifstream trace(filename.c_str(), std::ios::in | std::ios::binary);
+	std::stringstream csv;
+	ASSERT_NO_THROW(TraceRecorder::convertToCsv(trace, csv));
+	trace.close();
+	std::remove(filename.c_str());
+
+	std::vector<std::string> lines;
+	std::string line;
+	while (std::getline(csv, line))
+		lines.push_back(line);
+
+	ASSERT_EQ(7u, lines.size());
+	EXPECT_EQ("time,event,name,condition,value,epsilon,active", lines[0]);
+	EXPECT_EQ(0u, lines[1].find("0,condition,s1,0,1,0.1"));
+	EXPECT_EQ(',', lines[1][lines[1].size() - 2]);
+	EXPECT_EQ('0', lines[1][lines[1].size() - 1]);
+	EXPECT_EQ("0,tick,m1,,,,", lines[2]);
+	EXPECT_EQ(0u, lines[3].find("0.001,condition,s1,0,0.05")) << lines[3];
+	EXPECT_EQ("0.001,transition,s1,,,,", lines[4]);
+	EXPECT_EQ("0.001,tick,m2,,,,", lines[5]);
+	EXPECT_EQ("0.002,tick,m2,,,,", lines[6]);
+}
+
+TEST(TraceRecorder, ShortCircuitedConditions) {
+	TestControlMode::Ptr m1(new TestControlMode("m1"));
+	TestControlMode::Ptr m2(new TestControlMode("m2"));
+	ValueSensor::Ptr sensor_a(new ValueSensor);
+	ValueSensor::Ptr sensor_b(new ValueSensor);
+
+	HybridAutomaton ha;
+	ha.addControlMode(m1);
+	ha.addControlMode(m2);
+
+	// s1 = a or b and s2 = b or a
+	ValueSensor::Ptr sensors[2][2] = { { sensor_a, sensor_b }, { sensor_b, sensor_a } };
+	for (int i = 0; i < 2; i++)
+	{
+		ControlSwitch::Ptr cs(new ControlSwitch);
+		cs->setName(i == 0 ? "s1" : "s2");
+		for (int j = 0; j < 2; j++)
+		{
+			JumpCondition::Ptr jc(new JumpCondition);
+			jc->setSensor(sensors[i][j]);
+			jc->setConstantGoal(1.0);
+			jc->setEpsilon(0.5);
+			cs->add(jc);
+		}
+		cs->setExpression("0 or 1");
+		if (i == 0)
+			ha.addControlSwitch(m1->getName(), cs, m2->getName());
+		else
+			ha.addControlSwitch(m2->getName(), cs, m1->getName());
+	}
+
+	std::string filename("trace_recorder_test_3.bin");
+
+	TraceRecorder::Ptr recorder(new TraceRecorder(16));
+	ha.setTraceRecorder(recorder);
+	recorder->start(filename);
+
+	ha.setCurrentControlMode("m1");
+	ha.initialize(0.0);
+	ha.step(0.0);
+	sensor_b->setValue(1.0);
+	ha.step(0.001);
+	ha.step(0.002);
+	ha.terminate();
+
+	recorder->stop();
+
+	std::ifstream trace(filename.c_str(), std::ios::in | std::ios::binary);
+	std::stringstream csv;
+	ASSERT_NO_THROW(TraceRecorder::convertToCsv(trace, csv));
+	trace.close();
+	std::remove(filename.c_str());
+
+	std::vector<std::string> lines;
+	std::string line;
+	while (std::getline(csv, line))
+		lines.push_back(line);
+
+	ASSERT_EQ(11u, lines.size());
+	// both conditions of s1 are evaluated while none is active
+	EXPECT_EQ(0u, lines[1].find("0,condition,s1,0,1,0.5,0")) << lines[1];
+	EXPECT_EQ(0u, lines[2].find("0,condition,s1,1,1,0.5,0")) << lines[2];
+	EXPECT_EQ("0,tick,m1,,,,", lines[3]);
+	// the condition that fires is traced after the inactive one
+	EXPECT_EQ(0u, lines[4].find("0.001,condition,s1,0,1,0.5,0")) << lines[4];
+	EXPECT_EQ(0u, lines[5].find("0.001,condition,s1,1,0,0.5,1")) << lines[5];
+	EXPECT_EQ("0.001,transition,s1,,,,", lines[6]);
+	EXPECT_EQ("0.001,tick,m2,,,,", lines[7]);
+	// the first condition of s2 fires, the second one is skipped and not traced
+	EXPECT_EQ(0u, lines[8].find("0.002,condition,s2,0,0,0.5,1")) << lines[8];
+	EXPECT_EQ("0.002,transition,s2,,,,", lines[9]);
+	EXPECT_EQ("0.002,tick,m1,,,,", lines[10]);
+}
+
+TEST(TraceRecorder, DropsWhenFull) {
+	TraceRecorder recorder(4);
+	std::string filename("trace_recorder_test_2.bin");
+
+	// records outside of start/stop are ignored
+	recorder.recordTick(0.0, NULL);
+
+	recorder.start(filename);
+	EXPECT_ANY_THROW(recorder.start(filename));
+	for (int i = 0; i < 100000; i++)
+		recorder.recordTick(i, NULL);
+	recorder.stop();
+
+	std::ifstream trace(filename.c_str(), std::ios::in | std::ios::binary);
+	std::stringstream csv;
+	ASSERT_NO_THROW(TraceRecorder::convertToCsv(trace, csv));
+	trace.close();
+	std::remove(filename.c_str());
+
+	std::size_t lines = 0;
+	std::string line;
+	while (std::getline(csv, line))
+		lines++;
+	EXPECT_EQ(100000u, lines - 1 + recorder.getNumberOfDroppedRecords());
+}
@@ -0,0 +1,119 @@
+#include "gtest/gtest.h"
+
+#include "hybrid_automaton/HybridAutomaton.h"
+#include "hybrid_automaton/JointConfigurationSensor.h"
+#include "hybrid_automaton/FrameDisplacementSensor.h"
+#include "hybrid_automaton/FilteredSensor.h"
+#include "hybrid_automaton/SensorFilter.h"
+#include "hybrid_automaton/ValidationReport.h"
+
+#include "tests/TestFixtures.h"
+
+#include <sstream>
+
+using namespace ha;
+
+namespace ValidationTest {
+	JumpCondition::Ptr createJointJumpCondition(const System::ConstPtr& system, int goal_rows) {
+		JointConfigurationSensor::Ptr sensor(new JointConfigurationSensor);
+		sensor->setSystem(system);
+		JumpCondition::Ptr jc(new JumpCondition);
+		jc->setSensor(sensor);
+		jc->setConstantGoal(::Eigen::MatrixXd::Ones(goal_rows, 1));
+		jc->setEpsilon(0.01);
+		return jc;
+	}
+}
+
+TEST(Validation, JumpConditionDimensions) {
+	using namespace ValidationTest;
+	System::ConstPtr system(new TestSystem);
+
+	JumpCondition::Ptr jc = createJointJumpCondition(system, 3);
+	ValidationReport report;
+	jc->validate(report, "jc");
+	EXPECT_FALSE(report.hasErrors());
+	EXPECT_TRUE(jc->areDimensionsValidated());
+
+	// validated conditions are still evaluated correctly
+	jc->initialize(0.0);
+	EXPECT_TRUE(jc->isActive());
+
+	// changing the goal requires a new validation
+	jc->setConstantGoal(::Eigen::MatrixXd::Ones(2, 1));
+	EXPECT_FALSE(jc->areDimensionsValidated());
+	jc->validate(report, "jc");
+	EXPECT_EQ(1u, report.getNumberOfErrors());
+	EXPECT_FALSE(jc->areDimensionsValidated());
+	EXPECT_ANY_THROW(jc->isActive());
+
+	// weights must fit the sensor
+	ValidationReport weights_report;
+	jc = createJointJumpCondition(system, 3);
+	jc->setJumpCriterion(JumpCondition::NORM_L2, ::Eigen::MatrixXd::Ones(2, 1));
+	jc->validate(weights_report, "jc");
+	EXPECT_EQ(1u, weights_report.getNumberOfErrors());
+
+	// NORM_ROTATION needs a rotation matrix
+	ValidationReport rotation_report;
+	FrameDisplacementSensor::Ptr displacement(new FrameDisplacementSensor);
+	displacement->setSystem(system);
+	jc.reset(new JumpCondition);
+	jc->setSensor(displacement);
+	jc->setConstantGoal(::Eigen::MatrixXd::Zero(3, 1));
+	jc->setJumpCriterion(JumpCondition::NORM_ROTATION);
+	jc->validate(rotation_report, "jc");
+	EXPECT_EQ(1u, rotation_report.getNumberOfErrors());
+
+	// filters can change the dimensions
+	ValidationReport filter_report;
+	JointConfigurationSensor::Ptr joints(new JointConfigurationSensor);
+	joints->setSystem(system);
+	FilteredSensor::Ptr filtered(new FilteredSensor(joints));
+	filtered->addFilter(SensorFilter::Ptr(new TransformFilter(::Eigen::MatrixXd::Ones(2, 3))));
+	jc.reset(new JumpCondition);
+	jc->setSensor(filtered);
+	jc->setConstantGoal(::Eigen::MatrixXd::Zero(2, 1));
+	jc->validate(filter_report, "jc");
+	EXPECT_FALSE(filter_report.hasErrors());
+	EXPECT_TRUE(jc->areDimensionsValidated());
+
+	filtered->addFilter(SensorFilter::Ptr(new TransformFilter(::Eigen::MatrixXd::Ones(3, 3))));
+	jc->validate(filter_report, "jc");
+	EXPECT_EQ(1u, filter_report.getNumberOfErrors());
+}
+
+TEST(Validation, Graph) {
+	using namespace ValidationTest;
+	System::ConstPtr system(new TestSystem);
+
+	HybridAutomaton ha;
+	ha.addControlMode(TestControlMode::Ptr(new TestControlMode("m1")));
+	ha.addControlMode(TestControlMode::Ptr(new TestControlMode("m2")));
+	ha.addControlMode(TestControlMode::Ptr(new TestControlMode("m3")));
+
+	ControlSwitch::Ptr s1(new ControlSwitch);
+	s1->setName("s1");
+	s1->add(createJointJumpCondition(system, 3));
+	ha.addControlSwitch("m1", s1, "m2");
+
+	ControlSwitch::Ptr s2(new ControlSwitch);
+	s2->setName("s2");
+	s2->add(createJointJumpCondition(system, 2));
+	ha.addControlSwitch("m3", s2, "m1");
+
+	ha.setCurrentControlMode("m1");
+
+	ValidationReport report;
+	ha.validate(report);
+
+	std::stringstream out;
+	report.write(out);
+	std::string text = out.str();
+
+	EXPECT_EQ(1u, report.getNumberOfErrors()) << text;
+	EXPECT_EQ(2u, report.getNumberOfWarnings()) << text;
+	EXPECT_NE(std::string::npos, text.find("ERROR ControlSwitch 's2', JumpCondition 0: Dimension mismatch"));
+	EXPECT_NE(std::string::npos, text.find("WARNING ControlMode 'm3': Not reachable"));
+	EXPECT_NE(std::string::npos, text.find("WARNING ControlMode 'm2': No outgoing control switches"));
+}
@@ -0,0 +1,169 @@
+#include "gtest/gtest.h"
+
+#include "hybrid_automaton/HybridAutomaton.h"
+#include "hybrid_automaton/Watchdog.h"
+#include "hybrid_automaton/ValidationReport.h"
+#include "tests/TestFixtures.h"
+#include "tests/ValueSensor.h"
+
+#include <boost/thread.hpp>
+
+#include <stdexcept>
+
+using namespace ha;
+
+namespace WatchdogTest {
+	// a control mode that can also be too slow, or fail to take over from another mode
+	class FaultyControlMode : public ha::TestControlMode {
+	public:
+		enum SwitchError { NONE, STRING, RUNTIME_ERROR };
+
+		FaultyControlMode(const std::string& s, double output): ha::TestControlMode(s, output), _sleep(0), _switch_error(NONE) {};
+		virtual ::Eigen::MatrixXd step(const double& t)	{
+			if (_sleep > 0)
+				boost::this_thread::sleep(boost::posix_time::milliseconds(_sleep));
+			return ha::TestControlMode::step(t);
+		}
+		virtual void switchControlMode(ha::ControlMode::Ptr otherMode) {
+			if (_switch_error == STRING)
+				throw std::string("cannot take over from " + otherMode->getName());
+			if (_switch_error == RUNTIME_ERROR)
+				throw std::runtime_error("cannot take over from " + otherMode->getName());
+		};
+
+		int _sleep;
+		SwitchError _switch_error;
+	};
+
+	struct TestAutomaton {
+		HybridAutomaton ha;
+		boost::shared_ptr<FaultyControlMode> run;
+		boost::shared_ptr<FaultyControlMode> done;
+		// can be switched off, e.g. a topic that stopped publishing
+		ValueSensor::Ptr sensor;
+
+		TestAutomaton(const Watchdog::Ptr& watchdog) : run(new FaultyControlMode("run", 1.0)), done(new FaultyControlMode("done", 2.0)), sensor(new ValueSensor) {
+			run->setWatchdog(watchdog);
+			ha.addControlMode(run);
+			ha.addControlMode(done);
+			ha.addControlMode(ControlMode::Ptr(new TestControlMode("hold", 3.0)));
+
+			JumpCondition::Ptr jc(new JumpCondition);
+			jc->setSensor(sensor);
+			jc->setConstantGoal(::Eigen::MatrixXd::Constant(1, 1, 5.0));
+			ControlSwitch::Ptr cs(new ControlSwitch);
+			cs->add(jc);
+			ha.addControlSwitch("run", cs, "done");
+
+			ha.setCurrentControlMode("run");
+		}
+	};
+
+	Watchdog::Ptr createWatchdog() {
+		Watchdog::Ptr watchdog(new Watchdog);
+		watchdog->setFallbackControlMode("hold");
+		return watchdog;
+	}
+}
+
+TEST(Watchdog, SensorAge) {
+	using namespace WatchdogTest;
+
+	Watchdog::Ptr watchdog = createWatchdog();
+	watchdog->setMaxSensorAge(0.1);
+	EXPECT_ANY_THROW(watchdog->setMaxSensorAge(-1.0));
+	TestAutomaton test(watchdog);
+	test.ha.initialize(0.0);
+	ASSERT_EQ(1u, watchdog->getSensors().size());
+
+	EXPECT_DOUBLE_EQ(1.0, test.ha.step(0.0)(0, 0));
+
+	// the sensor stops at 0.05
+	test.ha.step(0.05);
+	test.sensor->setActive(false);
+	EXPECT_DOUBLE_EQ(1.0, test.ha.step(0.1)(0, 0));
+	EXPECT_DOUBLE_EQ(1.0, test.ha.step(0.15)(0, 0));
+	EXPECT_EQ("run", test.ha.getCurrentControlMode()->getName());
+
+	// the fallback mode computes the output of the tick in which the watchdog fires
+	EXPECT_DOUBLE_EQ(3.0, test.ha.step(0.16)(0, 0));
+	EXPECT_EQ("hold", test.ha.getCurrentControlMode()->getName());
+}
+
+TEST(Watchdog, ControllerFailure) {
+	using namespace WatchdogTest;
+
+	// step() falls back instead of throwing
+	TestAutomaton test(createWatchdog());
+	test.ha.initialize(0.0);
+	test.run->_fail = true;
+	EXPECT_DOUBLE_EQ(3.0, test.ha.step(0.0)(0, 0));
+	EXPECT_EQ("hold", test.ha.getCurrentControlMode()->getName());
+	EXPECT_EQ(ErrorRecord::FAULT_EXCEPTION, test.ha.getLastError().code);
+
+	// the fallback of the watchdog takes precedence over the safe control mode
+	TestAutomaton test2(createWatchdog());
+	test2.ha.setSafeControlMode("done");
+	test2.ha.initialize(0.0);
+	test2.run->_fail = true;
+	::Eigen::MatrixXd control;
+	StepResult result = test2.ha.tryStep(0.0, control);
+	EXPECT_EQ(StepResult::STEP_SAFE_MODE, result.status);
+	EXPECT_DOUBLE_EQ(3.0, control(0, 0));
+}
+
+TEST(Watchdog, SwitchFailure) {
+	using namespace WatchdogTest;
+
+	const FaultyControlMode::SwitchError errors[] = { FaultyControlMode::STRING, FaultyControlMode::RUNTIME_ERROR };
+	for (int i = 0; i < 2; ++i)
+	{
+		// without a fallback the failed switch is reported and no control mode is stepped
+		TestAutomaton test((Watchdog::Ptr()));
+		test.ha.initialize(0.0);
+		test.done->_switch_error = errors[i];
+		test.sensor->setValue(5.0);
+
+		::Eigen::MatrixXd control;
+		StepResult result = test.ha.tryStep(0.0, control);
+		EXPECT_EQ(StepResult::STEP_FAILED, result.status);
+		EXPECT_EQ(ErrorRecord::FAULT_EXCEPTION, result.error);
+		EXPECT_EQ(0, control.size());
+	}
+}
+
+TEST(Watchdog, TickTime) {
+	using namespace WatchdogTest;
+
+	Watchdog::Ptr watchdog = createWatchdog();
+	watchdog->setMaxTickTime(0.001);
+	TestAutomaton test(watchdog);
+	test.ha.initialize(0.0);
+
+	EXPECT_DOUBLE_EQ(1.0, test.ha.step(0.0)(0, 0));
+
+	test.run->_sleep = 5;
+	::Eigen::MatrixXd control;
+	StepResult result = test.ha.tryStep(0.001, control);
+	EXPECT_EQ(StepResult::STEP_SAFE_MODE, result.status);
+	EXPECT_EQ(ErrorRecord::FAULT_WATCHDOG, result.error);
+	EXPECT_DOUBLE_EQ(3.0, control(0, 0));
+}
+
+TEST(Watchdog, Validation) {
+	using namespace WatchdogTest;
+
+	Watchdog::Ptr watchdog = createWatchdog();
+	TestAutomaton test(watchdog);
+
+	// the fallback mode is reachable and may be a sink
+	ValidationReport report;
+	test.ha.validate(report);
+	EXPECT_FALSE(report.hasErrors());
+	EXPECT_EQ(1u, report.getNumberOfWarnings());
+
+	watchdog->setFallbackControlMode("unknown");
+	ValidationReport invalid_report;
+	test.ha.validate(invalid_report);
+	EXPECT_EQ(1u, invalid_report.getNumberOfErrors());
+}